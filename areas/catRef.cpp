@@ -19,10 +19,12 @@
 #include <boost/algorithm/string/case_conv.hpp>     // for to_lower_copy
 #include <boost/iterator/iterator_facade.hpp>       // for operator!=
 #include <boost/lexical_cast/bad_lexical_cast.hpp>  // for bad_lexical_cast
+#include <deque>                                    // for deque
 #include <ostream>                                  // for basic_ostream::op...
 
 #include <string>                                   // for string, allocator
 #include <string_view>                              // for operator==, strin...
+#include <unordered_map>                            // for unordered_map
 #include "area.hpp"                                 // for Area
 #include "catRef.hpp"                               // for CatRef
 #include "catRefInfo.hpp"                           // for CatRefInfo
@@ -38,6 +40,72 @@ std::ostream& operator<<(std::ostream& out, const CatRef& cr) {
     return(out);
 }
 
+//*********************************************************************
+//                      AreaName
+//*********************************************************************
+// Every area name we've seen, in the order we first saw it.  A deque never
+// moves its elements, so the names can be handed out by reference.
+
+static std::deque<std::string>& areaNames() {
+    static std::deque<std::string> names = { "" };
+    return(names);
+}
+
+// The hash of each name, by index
+static std::deque<size_t>& areaHashes() {
+    static std::deque<size_t> hashes = { std::hash<std::string_view>()("") };
+    return(hashes);
+}
+
+static std::unordered_map<std::string_view, uint32_t>& areaIndexes() {
+    static std::unordered_map<std::string_view, uint32_t> indexes = { { areaNames().front(), 0 } };
+    return(indexes);
+}
+
+uint32_t AreaName::intern(std::string_view name) {
+    auto& indexes = areaIndexes();
+    auto it = indexes.find(name);
+    if(it != indexes.end())
+        return(it->second);
+
+    auto& names = areaNames();
+    auto index = (uint32_t)names.size();
+    names.emplace_back(name);
+    indexes.emplace(names.back(), index);
+    areaHashes().push_back(std::hash<std::string_view>()(name));
+    return(index);
+}
+
+uint32_t AreaName::find(std::string_view name) {
+    auto& indexes = areaIndexes();
+    auto it = indexes.find(name);
+    return(it == indexes.end() ? UNKNOWN : it->second);
+}
+
+// Only looks the name up: areas that don't exist don't get into the table
+AreaName::AreaName(std::string_view name) {
+    index = find(name);
+    if(index == UNKNOWN)
+        text = std::make_shared<const std::string>(name);
+}
+
+const std::string& AreaName::str() const {
+    if(index == UNKNOWN)
+        return(*text);
+    return(areaNames()[index]);
+}
+
+size_t AreaName::hash() const {
+    if(index == UNKNOWN)
+        return(std::hash<std::string_view>()(*text));
+    return(areaHashes()[index]);
+}
+
+std::ostream& operator<<(std::ostream& out, const AreaName& name) {
+    out << name.str();
+    return(out);
+}
+
 //*********************************************************************
 //                      CatRef
 //*********************************************************************
@@ -152,7 +220,9 @@ bool CatRef::isArea(std::string_view c) const {
 //*********************************************************************
 
 void CatRef::load(xmlNodePtr curNode) {
-    xml::copyPropToString(area, curNode, "Area");
+    std::string name;
+    xml::copyPropToString(name, curNode, "Area");
+    area = name;
     xml::copyToNum(id, curNode);
 }
 
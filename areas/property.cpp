@@ -50,6 +50,7 @@
 #include "location.hpp"                     // for Location
 #include "login.hpp"                        // for CON_EDIT_PROPERTY
 #include "move.hpp"                         // for tooFarAway
+#include "mudFormat.hpp"                    // for formatLegacy
 #include "mud.hpp"                          // for ACC, GUILD_BANKER, GUILD_...
 #include "mudObjects/areaRooms.hpp"         // for AreaRoom
 #include "mudObjects/container.hpp"         // for ObjectSet
@@ -1582,14 +1583,10 @@ void Property::appendLog(std::string_view user, const char *fmt, ...) {
     if(logType == LOG_PARTIAL && isOwner(user))
         return;
 
-    char    *str;
     va_list ap;
 
     va_start(ap, fmt);
-    if(vasprintf(&str, fmt, ap) == -1) {
-        std::clog << "Error in Property::appendLog\n";
-        return;
-    }
+    std::string str = formatLegacy(0, fmt, ap);
     va_end(ap);
 
     long    t = time(nullptr);
@@ -24,7 +24,9 @@
 #include <set>                         // for set, set<>::iterator
 #include <sstream>                     // for operator<<, basic_ostream, ost...
 #include <string>                      // for allocator, operator<<, char_tr...
+#include <unordered_set>               // for unordered_set
 #include <utility>                     // for pair
+#include <vector>                      // for vector
 
 #include "area.hpp"                    // for Area, MapMarker
 #include "catRef.hpp"                  // for CatRef
@@ -37,6 +39,7 @@
 #include "lasttime.hpp"                // for crlasttime, lasttime
 #include "location.hpp"                // for Location
 #include "move.hpp"                    // for deletePortal
+#include "msdp.hpp"                    // for MsdpEvent
 #include "mud.hpp"                     // for DL_BROAD, LT_AGGRO_ACTION
 #include "mudObjects/areaRooms.hpp"    // for AreaRoom
 #include "mudObjects/container.hpp"    // for MonsterSet, PlayerSet, ObjectSet
@@ -144,11 +147,62 @@ void Player::finishAddPlayer(const std::shared_ptr<BaseRoom>& room) {
     }
 
     addTo(room);
+    markNearbyRooms(room);
+    publishMsdp(MsdpEvent::Room);
     display_rom(Containable::downcasted_shared_from_this<Player>());
 
     Hooks::run(room, "afterAddCreature", Containable::downcasted_shared_from_this<Player>(), "afterAddToRoom");
 }
 
+//*********************************************************************
+//                      markNearbyRooms
+//*********************************************************************
+// Count this player towards every room within NEARBY_ROOM_DISTANCE exits of
+// where they are.  Only rooms already in memory are looked at, nothing gets
+// loaded just to be counted.  Dormant monsters in a room nobody was near
+// rejoin the active list.
+
+static constexpr int NEARBY_ROOM_DISTANCE = 2;
+
+void Player::markNearbyRooms(const std::shared_ptr<BaseRoom>& room) {
+    clearNearbyRooms();
+
+    std::unordered_set<const BaseRoom*> seen{room.get()};
+    std::vector<std::shared_ptr<BaseRoom>> found{room};
+    size_t start = 0;
+
+    for(int distance = 0; distance < NEARBY_ROOM_DISTANCE; distance++) {
+        size_t end = found.size();
+        for(size_t i = start; i < end; i++) {
+            for(const auto& exit : found[i]->exits) {
+                std::shared_ptr<BaseRoom> next = exit->target.findRoom();
+                if(next && seen.insert(next.get()).second)
+                    found.push_back(next);
+            }
+        }
+        start = end;
+    }
+
+    nearbyRooms.reserve(found.size());
+    for(const auto& nearby : found) {
+        nearbyRooms.push_back(nearby);
+        if(nearby->addNearbyPlayer()) {
+            for(const auto& mons : nearby->monsters) {
+                if(mons->isDormant())
+                    gServer->addActive(mons);
+            }
+        }
+    }
+}
+
+void Player::clearNearbyRooms() {
+    for(const auto& weakRoom : nearbyRooms) {
+        if(auto nearby = weakRoom.lock())
+            nearby->removeNearbyPlayer();
+    }
+    nearbyRooms.clear();
+}
+
 void Player::addToRoom(const std::shared_ptr<BaseRoom>& room) {
     std::shared_ptr<AreaRoom> aRoom = room->getAsAreaRoom();
 
@@ -281,6 +335,8 @@ int Player::doDeleteFromRoom(std::shared_ptr<BaseRoom> room, bool delPortal) {
     long    t=0;
     int     i=0;
 
+    clearNearbyRooms();
+
     t = time(nullptr);
     if(inUniqueRoom() && !isStaff()) {
         strcpy(getUniqueRoomParent()->lastPly, getCName());
@@ -305,20 +361,7 @@ int Player::doDeleteFromRoom(std::shared_ptr<BaseRoom> room, bool delPortal) {
 
     if(room->players.empty()) {
         for(const auto& mons : room->monsters) {
-            /*
-             * pets and fast wanderers are always active
-             *
-            */
-            if( !mons->flagIsSet(M_FAST_WANDER) &&
-                !mons->isPet() &&
-                !mons->isPoisoned() &&
-                !mons->flagIsSet(M_FAST_TICK) &&
-                !mons->flagIsSet(M_ALWAYS_ACTIVE) &&
-                !mons->flagIsSet(M_REGENERATES) &&
-                !mons->isEffected("slow") &&
-                !mons->flagIsSet(M_PERMANENT_MONSTER) &&
-                !mons->flagIsSet(M_AGGRESSIVE)
-            )
+            if(!mons->staysActive())
                 gServer->delActive(mons.get());
         }
     }
@@ -120,6 +120,21 @@ bool UniqueRoom::operator< (const UniqueRoom& t) const {
     }
 }
 
+//*********************************************************************
+//                      getCacheCost
+//*********************************************************************
+// Roughly how much memory keeping this room loaded costs the room cache:
+// the room itself, its text, and whatever is sitting in it.
+
+size_t UniqueRoom::getCacheCost() const {
+    size_t cost = sizeof(UniqueRoom) + short_desc.capacity() + long_desc.capacity();
+    cost += exits.size() * sizeof(Exit);
+    cost += monsters.size() * sizeof(Monster);
+    cost += objects.size() * sizeof(Object);
+    cost += (permMonsters.size() + permObjects.size()) * (sizeof(CRLastTime) + 4 * sizeof(void*));
+    return(cost);
+}
+
 std::string UniqueRoom::getShortDescription() const { return(short_desc); }
 std::string UniqueRoom::getLongDescription() const { return(long_desc); }
 short UniqueRoom::getLowLevel() const { return(lowLevel); }
@@ -1141,6 +1156,27 @@ bool BaseRoom::isFastTick() const {
     );
 }
 
+//*********************************************************************
+//                      nearbyPlayers
+//*********************************************************************
+// Kept up to date as players move (see Player::markNearbyRooms), so the
+// active list can tell how close a monster is to any players without
+// having to go look.
+
+int BaseRoom::getNearbyPlayers() const {
+    return(nearbyPlayers);
+}
+
+// True if nobody was near this room before
+bool BaseRoom::addNearbyPlayer() {
+    return(++nearbyPlayers == 1);
+}
+
+void BaseRoom::removeNearbyPlayer() {
+    if(nearbyPlayers > 0)
+        nearbyPlayers--;
+}
+
 //*********************************************************************
 //                      canPortHere
 //*********************************************************************
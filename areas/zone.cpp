@@ -20,7 +20,7 @@
 #include <fstream>
 #include <string>
 
-#include "catRef.hpp"   // for CatRef
+#include "catRef.hpp"   // for AreaName, CatRef
 #include "config.hpp"
 #include "json.hpp"
 #include "paths.hpp"
@@ -45,6 +45,8 @@ bool Config::loadZones() {
 
     for (const auto& [key, zoneJson] : j.items()) {
         zones.emplace(key, zoneJson);
+        // Hand out area indexes up front so zones get the small, stable ones
+        AreaName::intern(key);
     }
 
     for (const auto& [name, zone] : zones) {
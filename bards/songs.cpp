@@ -132,7 +132,7 @@ bool Song::runScript(std::shared_ptr<MudObject> singer, std::shared_ptr<MudObjec
         return(false);
 
     try {
-        auto locals = py::dict();
+        PooledLocals locals;
         auto songModule = py::module::import("songLib");
         locals["songLib"] = songModule;
         locals["song"] = this;
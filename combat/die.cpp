@@ -1089,6 +1089,7 @@ void Player::dropBodyPart(const std::shared_ptr<Player>&killer) {
             strncpy(body_part->key[0], partName.c_str(), 20);
             strncpy(body_part->key[1], part.c_str(), 20);
             strncpy(body_part->key[2], part.c_str(), 20);
+            body_part->refreshKeyTxt();
 
             body_part->setAdjustment(Random::get<short>(1,2));
             if(Random::get(1,100) == 1)
@@ -1874,10 +1875,11 @@ void Player::die(DeathType dt) {
             if(loadObject(STATUE_OBJ, statue)) {
                 statue->setName("broken statue of " + getName());
                 statue->description = getName();
-                statue->description += " is forever frozen in stone.";
+                statue->description.edit() += " is forever frozen in stone.";
                 strncpy(statue->key[0], "broken", 20);
                 strncpy(statue->key[1], "statue", 20);
                 strncpy(statue->key[2], getCName(), 20);
+                statue->refreshKeyTxt();
 
                 statue->setWeight(100 + getWeight());
                 statue->setBulk(50);
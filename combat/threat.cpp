@@ -33,6 +33,7 @@
 #include "cmd.hpp"                   // for cmd
 #include "commands.hpp"              // for cmdAssist, cmdTarget
 #include "flags.hpp"                 // for P_COMPACT, P_NO_AUTO_TARGET
+#include "msdp.hpp"                  // for MsdpEvent
 #include "mudObjects/container.hpp"  // for Container, MonsterSet
 #include "mudObjects/creatures.hpp"  // for Creature
 #include "mudObjects/monsters.hpp"   // for Monster
@@ -392,6 +393,7 @@ std::shared_ptr<Creature> Creature::addTarget(const std::shared_ptr<Creature>& t
 
     }
     hasTarget = true;
+    publishMsdp(MsdpEvent::Target);
     return(lockedTarget);
 
 }
@@ -426,6 +428,7 @@ void Creature::clearTarget(bool clearTargetsList) {
         lockedTarget->clearTargetingThis(this);
     hasTarget = false;
     myTarget.reset();
+    publishMsdp(MsdpEvent::Target);
 }
 
 //*********************************************************************
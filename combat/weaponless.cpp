@@ -23,6 +23,7 @@
 #include <string>                    // for allocator, string
 #include <type_traits>               // for enable_if<>::type
 
+#include "broadcast.hpp"             // for broadcastFmt
 #include "commands.hpp"              // for cmdFocus, cmdFrenzy, cmdHowl
 #include "damage.hpp"                // for Damage
 #include "flags.hpp"                 // for M_PERMANENT_MONSTER, P_AFK, P_FO...
@@ -30,6 +31,7 @@
 #include "group.hpp"                 // for CreatureList, Group
 #include "lasttime.hpp"              // for lasttime
 #include "mud.hpp"                   // for LT_TOUCH_OF_DEATH, LT_MEDITATE
+#include "mudFormat.hpp"             // for CrtName
 #include "mudObjects/container.hpp"  // for MonsterSet
 #include "mudObjects/creatures.hpp"  // for Creature, ATTACK_MAUL, CHECK_DIE
 #include "mudObjects/monsters.hpp"   // for Monster
@@ -56,7 +58,7 @@ int cmdMeditate(const std::shared_ptr<Player>& player, cmd* cmnd) {
 
     if(!player->knowsSkill("meditate") || player->isUndead()) {
         player->print("You meditate.\n");
-        broadcast(player->getSock(), player->getParent(), "%M meditates.", player.get());
+        broadcastFmt(player->getSock(), player->getParent(), "{} meditates.", CrtName(player.get(), CAP));
         return(0);
     }
 
@@ -73,7 +75,7 @@ int cmdMeditate(const std::shared_ptr<Player>& player, cmd* cmnd) {
 
     int level = std::max(1,(int)player->getSkillLevel("meditate"));
 
-    broadcast(player->getSock(), player->getParent(), "%M meditates.", player.get());
+    broadcastFmt(player->getSock(), player->getParent(), "{} meditates.", CrtName(player.get(), CAP));
 
     if(Random::get(1,100) <= chance) {
 
@@ -133,7 +135,7 @@ int cmdTouchOfDeath(const std::shared_ptr<Player>& player, cmd* cmnd) {
 
     if(!player->knowsSkill("touch")) {
         player->print("You touch yourself.\n");
-        broadcast(player->getSock(), player->getParent(), "%M touches %sself", player.get(), player->himHer());
+        broadcastFmt(player->getSock(), player->getParent(), "{} touches {}self", CrtName(player.get(), CAP), player->himHer());
         return(0);
     }
 
@@ -207,10 +209,10 @@ int cmdTouchOfDeath(const std::shared_ptr<Player>& player, cmd* cmnd) {
         chance /= 2;
 
     if(Random::get(1,100) > chance) {
-        player->print("You failed to harm %N.\n", creature.get());
+        player->printFmt("You failed to harm {}.\n", CrtName(creature.get()));
         player->checkImprove("touch", false);
-        broadcast(player->getSock(), player->getParent(), "%M failed the touch of death on %N.\n",
-            player.get(), creature.get());
+        broadcastFmt(player->getSock(), player->getParent(), "{} failed the touch of death on {}.\n",
+            CrtName(player.get(), CAP), CrtName(creature.get()));
         player->lasttime[LT_TOUCH_OF_DEATH].interval = 25L;
         return(0);
     }
@@ -218,9 +220,9 @@ int cmdTouchOfDeath(const std::shared_ptr<Player>& player, cmd* cmnd) {
 
     if(!player->isCt()) {
         if(creature->chkSave(DEA, player, 0)) {
-            player->printColor("^y%M avoided your touch of death!\n", creature.get());
+            player->printColorFmt("^y{} avoided your touch of death!\n", CrtName(creature.get(), CAP));
             player->checkImprove("touch", false);
-            creature->print("You avoided %N's touch of death.\n", player.get());
+            creature->printFmt("You avoided {}'s touch of death.\n", CrtName(player.get()));
             player->lasttime[LT_TOUCH_OF_DEATH].interval = 25L;
             return(0);
         }
@@ -232,12 +234,12 @@ int cmdTouchOfDeath(const std::shared_ptr<Player>& player, cmd* cmnd) {
                 creature->isPlayer() )) ||
         player->isDm())
     {
-        player->print("You fatally wound %N.\n", creature.get());
+        player->printFmt("You fatally wound {}.\n", CrtName(creature.get()));
         player->checkImprove("touch", true);
         if(!player->isDm())
             log_immort(false,player, "%s fatally wounds %s.\n", player->getCName(), creature->getCName());
 
-        broadcast(player->getSock(), player->getParent(), "%M fatally wounds %N.", player.get(), creature.get());
+        broadcastFmt(player->getSock(), player->getParent(), "{} fatally wounds {}.", CrtName(player.get(), CAP), CrtName(creature.get()));
         if(creature->isMonster())
             creature->getAsMonster()->adjustThreat(player, creature->hp.getCur());
 
@@ -252,9 +254,9 @@ int cmdTouchOfDeath(const std::shared_ptr<Player>& player, cmd* cmnd) {
         creature->modifyDamage(player, ABILITY, damage);
         //player->statistics.attackDamage(dmg, "touch-of-death");
 
-        player->printColor("You touched %N for %s%d^x damage.\n", creature.get(), player->customColorize("*CC:DAMAGE*").c_str(), damage.get());
+        player->printColorFmt("You touched {} for {}{}^x damage.\n", CrtName(creature.get()), player->customColorize("*CC:DAMAGE*"), damage.get());
         player->checkImprove("touch", true);
-        broadcast(player->getSock(), player->getParent(), "%M uses the touch of death on %N.", player.get(), creature.get());
+        broadcastFmt(player->getSock(), player->getParent(), "{} uses the touch of death on {}.", CrtName(player.get(), CAP), CrtName(creature.get()));
 
         player->lasttime[LT_TOUCH_OF_DEATH].interval = 600L;
 
@@ -310,7 +312,7 @@ int cmdFocus(const std::shared_ptr<Player>& player, cmd* cmnd) {
     if(Random::get(1, 100) <= chance) {
         player->print("You begin to focus your energy.\n");
         player->checkImprove("focus", true);
-        broadcast(player->getSock(), player->getParent(), "%M focuses %s energy.", player.get(), player->hisHer());
+        broadcastFmt(player->getSock(), player->getParent(), "{} focuses {} energy.", CrtName(player.get(), CAP), player->hisHer());
         player->setFlag(P_FOCUSED);
         player->lasttime[LT_FOCUS].ltime = t;
         player->lasttime[LT_FOCUS].interval = 210L;
@@ -319,8 +321,8 @@ int cmdFocus(const std::shared_ptr<Player>& player, cmd* cmnd) {
     } else {
         player->print("You failed to focus your energy.\n");
         player->checkImprove("focus", false);
-        broadcast(player->getSock(), player->getParent(), "%M tried to focus %s energy.",
-            player.get(), player->hisHer());
+        broadcastFmt(player->getSock(), player->getParent(), "{} tried to focus {} energy.",
+            CrtName(player.get(), CAP), player->hisHer());
         player->lasttime[LT_FOCUS].ltime = t - 590L;
     }
 
@@ -388,14 +390,14 @@ int cmdFrenzy(const std::shared_ptr<Player>& player, cmd* cmnd) {
     if(Random::get(1, 100) <= chance) {
         player->print("You begin to attack in a frenzy.\n");
         player->checkImprove("frenzy", true);
-        broadcast(player->getSock(), player->getParent(), "%M attacks in a frenzy.", player.get());
+        broadcastFmt(player->getSock(), player->getParent(), "{} attacks in a frenzy.", CrtName(player.get(), CAP));
         player->addEffect("frenzy", 210L, 50);
         player->lasttime[LT_FRENZY].ltime = t;
         player->lasttime[LT_FRENZY].interval = 600 + 210L;
     } else {
         player->print("Your attempt to frenzy failed.\n");
         player->checkImprove("frenzy", false);
-        broadcast(player->getSock(), player->getParent(), "%M tried to attack in a frenzy.", player.get());
+        broadcastFmt(player->getSock(), player->getParent(), "{} tried to attack in a frenzy.", CrtName(player.get(), CAP));
         player->lasttime[LT_FRENZY].ltime = t - 590L;
     }
 
@@ -457,7 +459,7 @@ int cmdMaul(const std::shared_ptr<Player>& player, cmd* cmnd) {
         }
 
         if(player->vampireCharmed(pCreature) || (pCreature->hasCharm(player->getName()) && player->flagIsSet(P_CHARMED))) {
-            player->print("You like %N too much to do that.\n", pCreature.get());
+            player->printFmt("You like {} too much to do that.\n", CrtName(pCreature.get()));
             return(0);
         }
     }
@@ -495,7 +497,7 @@ int cmdMaul(const std::shared_ptr<Player>& player, cmd* cmnd) {
             player->setFlag(P_LAG_PROTECTION_ACTIVE);
 
         if(!player->isCt() && creature->flagIsSet(M_ONLY_HARMED_BY_MAGIC)) {
-            player->print("Your maul has no effect on %N.\n", creature.get());
+            player->printFmt("Your maul has no effect on {}.\n", CrtName(creature.get()));
             return(0);
         }
 
@@ -526,11 +528,11 @@ int cmdMaul(const std::shared_ptr<Player>& player, cmd* cmnd) {
             creature->addLycanthropy(player, 5);
         }
     } else {
-        player->print("You failed to maul %N.\n", creature.get());
+        player->printFmt("You failed to maul {}.\n", CrtName(creature.get()));
         player->checkImprove("maul", false);
-        creature->print("%M tried to maul you.\n", player.get());
-        broadcast(player->getSock(), creature->getSock(), creature->getRoomParent(),
-            "%M tried to maul %N.", player.get(), creature.get());
+        creature->printFmt("{} tried to maul you.\n", CrtName(player.get(), CAP));
+        broadcastFmt(player->getSock(), creature->getSock(), creature->getRoomParent(),
+            "{} tried to maul {}.", CrtName(player.get(), CAP), CrtName(creature.get()));
     }
 
     return(0);
@@ -586,7 +588,7 @@ int cmdHowl(const std::shared_ptr<Creature>& player, cmd* cmnd) {
 
     if((!player->knowsSkill("howl") || !player->isEffected("lycanthropy")) && !player->isStaff()) {
         player->print("You howl at the moon!\n");
-        broadcast(player->getSock(), player->getParent(), "%M howls at the moon.", player.get());
+        broadcastFmt(player->getSock(), player->getParent(), "{} howls at the moon.", CrtName(player.get(), CAP));
         return(0);
     }
 
@@ -606,7 +608,7 @@ int cmdHowl(const std::shared_ptr<Creature>& player, cmd* cmnd) {
     room->wake("You awaken suddenly!", true);
     player->print("You let out a blood-curdling supernatural howl!\n");
     player->checkImprove("howl", true);
-    broadcast(player->getSock(), room, "^Y%M lets out a blood-curdling supernatural howl!", player.get());
+    broadcastFmt(player->getSock(), room, "^Y{} lets out a blood-curdling supernatural howl!", CrtName(player.get(), CAP));
     maxEffected = level / 2;
 
     player->lasttime[LT_HOWLS].ltime = t;
@@ -650,7 +652,7 @@ int cmdHowl(const std::shared_ptr<Creature>& player, cmd* cmnd) {
 
         stunTime = Random::get(5, std::max(6, player->getLevel()/2));
         monster->stun(stunTime);
-        broadcast((std::shared_ptr<Socket>)nullptr, room, "^b%M is frozen in terror!", monster.get());
+        broadcastFmt((std::shared_ptr<Socket>)nullptr, room, "^b{} is frozen in terror!", CrtName(monster.get(), CAP));
     }
 
     return(0);
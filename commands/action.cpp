@@ -30,7 +30,7 @@
 #include "global.hpp"                // for CreatureClass, CreatureClass::CL...
 #include "hooks.hpp"                 // for Hooks
 #include "mud.hpp"                   // for DL_DEFEC, SHIT_OBJ
-#include "mudObjects/container.hpp"  // for MonsterPtrLess (ptr only), Playe...
+#include "mudObjects/container.hpp"  // for MonsterSet
 #include "mudObjects/creatures.hpp"  // for Creature, PetList
 #include "mudObjects/exits.hpp"      // for Exit
 #include "mudObjects/monsters.hpp"   // for Monster
@@ -56,7 +56,7 @@ void socialHooks(const std::shared_ptr<Creature>&creature, const std::shared_ptr
 void socialHooks(const std::shared_ptr<Creature>&target, const std::string &action, const std::string &result) {
     if(!target->getRoomParent())
         return;
-    Hooks::run<std::shared_ptr<Monster> ,MonsterPtrLess>(target->getRoomParent()->monsters, target, "roomSocial", action, result);
+    Hooks::run(target->getRoomParent()->monsters, target, "roomSocial", action, result);
 }
 
 //*********************************************************************
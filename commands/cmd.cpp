@@ -455,6 +455,8 @@ bool Config::initCommands() {
     staffCommands.emplace("*songs", 100, dmSongList, nullptr, "List songs in the game");
     staffCommands.emplace("*lottery", 100, dmLottery, isDm, "Run the lottery");
     staffCommands.emplace("*memory", 100, dmMemory, isCt, "Show memory usage");
+    staffCommands.emplace("*cachestats", 100, dmCacheStats, isCt, "Show room/monster/object cache hit rates");
+    staffCommands.emplace("*pystats", 100, dmScriptStats, isCt, "Show compiled python script call counts and times");
     staffCommands.emplace("*active", 100, list_act, isCt, "Show monsters on the active list");
     staffCommands.emplace("*classlist", 100, dmShowClasses, nullptr, "List all classes");
     staffCommands.emplace("*racelist", 100, dmShowRaces, nullptr, "List all races");
@@ -850,6 +852,7 @@ bool Config::initCommands() {
 
     generalCommands.emplace("dice", 100, cmdDice, nullptr, "Roll dice (help dice for details)");
 
+    rebuildCommandIndex();
 
     // Once we've built the command tables, write their help files to the help directory
     writeCommandFile(CreatureClass::NONE, Path::Help.c_str(), "commands");
@@ -863,6 +866,27 @@ void Config::clearCommands() {
     staffCommands.clear();
     playerCommands.clear();
     generalCommands.clear();
+    rebuildCommandIndex();
+}
+
+//*********************************************************************
+//                      rebuildCommandIndex
+//*********************************************************************
+// Added in the order getCommand has always searched the tables
+
+void Config::rebuildCommandIndex() {
+    commandIndex.clear();
+    for(const auto& command : generalCommands)
+        commandIndex.add(command, CommandTier::Creature);
+    for(const auto& command : skillCommands)
+        commandIndex.add(command, CommandTier::Creature);
+    for(const auto& command : playerCommands)
+        commandIndex.add(command, CommandTier::Player);
+    for(const auto& command : staffCommands)
+        commandIndex.add(command, CommandTier::Staff);
+    for(const auto& command : socials)
+        commandIndex.add(command, CommandTier::Creature);
+    commandIndex.compile();
 }
 
 bool MudMethod::exactMatch(const std::string& toMatch) const {
@@ -949,39 +973,15 @@ void examineList(std::set<Type, namableCmp>& mySet, const std::string &str, int&
 }
 
 void getCommand(const std::shared_ptr<Creature>& user, cmd* cmnd) {
-    std::string str;
-    // Match - Partial matches
-    int     match=0;
-    // Found - Exact match
-    bool    found=false;
-//  int     i=0;
-
     std::shared_ptr<Player> pUser = user->getAsPlayer();
-    str = cmnd->str[0];
-
-    //std::clog << "Looking for a match for '" << str << "'\n";
-
-    examineList<CrtCommand, Command>(gConfig->generalCommands, str, match, found, cmnd->myCommand);
-    if(!found)
-        examineList<SkillCommand, Command>(gConfig->skillCommands, str, match, found, cmnd->myCommand);
-    // If we're a player, examine a few extra lists
-    if(!found && pUser) {
-        if(!found) // No exact match so far, check player list
-            examineList<PlyCommand, Command>(gConfig->playerCommands, str, match, found, cmnd->myCommand);
-        if(!found && pUser->isStaff()) // Still no exact match, check staff commands
-            examineList<PlyCommand, Command>(gConfig->staffCommands, str, match, found, cmnd->myCommand);
-    }
-    if(!found)
-        examineList<SocialCommand, Command>(gConfig->socials, str, match, found, cmnd->myCommand);
+    CommandTier tier = CommandTier::Creature;
+    if(pUser)
+        tier = pUser->isStaff() ? CommandTier::Staff : CommandTier::Player;
 
-    if(!match)
-        cmnd->ret = CMD_NOT_FOUND;
-    else if(match > 1)
-        cmnd->ret = CMD_NOT_UNIQUE;
-    else if(cmnd->myCommand->auth && !cmnd->myCommand->auth(user))
+    cmnd->myCommand = gConfig->commandIndex.find(cmnd->str[0], tier, cmnd->ret);
+
+    if(!cmnd->ret && cmnd->myCommand->auth && !cmnd->myCommand->auth(user))
         cmnd->ret = CMD_NOT_AUTH;
-    else
-        cmnd->ret = 0;
 }
 
 
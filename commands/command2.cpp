@@ -1208,6 +1208,7 @@ int cmdBreak(const std::shared_ptr<Player>& player, cmd* cmnd) {
         object->setName(std::string(item) + object->getName());
 
         strncpy(object->key[2],"broken",20);
+        object->refreshKeyTxt();
 
 
         if(object->getType() == ObjectType::CONTAINER) {
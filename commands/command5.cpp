@@ -42,6 +42,7 @@
 #include "guilds.hpp"                  // for GuildCreation
 #include "lasttime.hpp"                // for lasttime
 #include "login.hpp"                   // for CON_PLAYING, CON_CHANGING_STAT...
+#include "logWriter.hpp"               // for LogWriter
 #include "mud.hpp"                     // for LT, LT_HYPNOTIZE, LT_SMOTHER
 #include "mudObjects/creatures.hpp"    // for PetList
 #include "mudObjects/monsters.hpp"     // for Monster
@@ -593,7 +594,9 @@ void Player::deletePlayer() {
     sock->clearPlayer();
 
     // get rid of any files the player was using
+    gServer->playerSaves.wait((Path::Player / name).replace_extension("xml"));
     fs::remove((Path::Player / name).replace_extension("xml"));
+    LogWriter::get().release((Path::Bank / name).replace_extension("txt"));
     fs::remove((Path::Bank / name).replace_extension("txt"));
     fs::remove((Path::Post / name).replace_extension("txt"));
     fs::remove((Path::History / name).replace_extension("txt"));
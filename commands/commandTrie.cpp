@@ -0,0 +1,183 @@
+/*
+ * commandTrie.cpp
+ *   Compiled index of the command tables used to resolve what a player typed
+ *   ____            _
+ *  |  _ \ ___  __ _| |_ __ ___  ___
+ *  | |_) / _ \/ _` | | '_ ` _ \/ __|
+ *  |  _ <  __/ (_| | | | | | | \__ \
+ *  |_| \_\___|\__,_|_|_| |_| |_|___/
+ *
+ * Permission to use, modify and distribute is granted via the
+ *  GNU Affero General Public License v3 or later
+ *
+ *  Copyright (C) 2007-2021 Jason Mitchell, Randi Mitchell
+ *     Contributions by Tim Callahan, Jonathan Hseu
+ *  Based on Mordor (C) Brooke Paul, Brett J. Vickers, John P. Freeman
+ *
+ */
+
+#include <algorithm>               // for copy, sort
+#include <cctype>                  // for tolower
+
+#include "cmd.hpp"                 // for CMD_NOT_FOUND, CMD_NOT_UNIQUE
+#include "commandTrie.hpp"         // for CommandTrie, CommandTier
+#include "structs.hpp"             // for Command
+
+static char lower(char c) {
+    return((char)tolower((unsigned char)c));
+}
+
+CommandTrie::CommandTrie() {
+    clear();
+}
+
+void CommandTrie::clear() {
+    building.clear();
+    building.emplace_back();
+    nodes.clear();
+    labels.clear();
+}
+
+//*********************************************************************
+//                      add
+//*********************************************************************
+
+// Same rules getCommand has always used for partial matches: lower priority
+// wins, then the shorter name, and anything left over is a tie
+void CommandTrie::offer(Match& match, const Command& command) {
+    if(!match.best ||
+       command.priority < match.best->priority ||
+       (command.priority == match.best->priority && command.name.length() < match.best->name.length()))
+    {
+        match.best = &command;
+        match.ties = 1;
+    } else if(command.priority == match.best->priority && command.name.length() == match.best->name.length()) {
+        match.ties++;
+    }
+}
+
+void CommandTrie::add(const Command& command, CommandTier tier) {
+    if(command.name.empty())
+        return;
+
+    uint32_t node = 0;
+    for(char c : command.name) {
+        c = lower(c);
+        uint32_t next = NONE;
+        for(const auto& [key, index] : building[node].next) {
+            if(key == c) {
+                next = index;
+                break;
+            }
+        }
+        if(next == NONE) {
+            next = (uint32_t)building.size();
+            building[node].next.emplace_back(c, next);
+            building.emplace_back();
+        }
+        node = next;
+
+        // Anything typed that leads here could mean this command
+        for(int t = (int)tier; t < TIERS; t++)
+            offer(building[node].match[t], command);
+    }
+
+    building[node].terminal = true;
+    for(int t = (int)tier; t < TIERS; t++) {
+        if(!building[node].match[t].exact)
+            building[node].match[t].exact = &command;
+    }
+}
+
+//*********************************************************************
+//                      compile
+//*********************************************************************
+// Lays the trie out breadth first with each node's children next to each
+// other, collapsing runs of nodes that have one child and no command ending
+// on them into a single edge.  Collapsing loses nothing: every command below
+// the top of such a run is also below its bottom.
+
+void CommandTrie::compile() {
+    nodes.clear();
+    labels.clear();
+
+    std::vector<uint32_t> from;     // The build node each compiled node ended up at
+    nodes.emplace_back();
+    from.push_back(0);
+
+    for(size_t i = 0; i < nodes.size(); i++) {
+        auto& next = building[from[i]].next;
+        std::sort(next.begin(), next.end());
+
+        nodes[i].firstChild = (uint32_t)nodes.size();
+        nodes[i].childCount = (uint32_t)next.size();
+
+        for(auto [c, index] : next) {
+            Node node;
+            node.labelStart = (uint32_t)labels.size();
+            labels += c;
+            while(!building[index].terminal && building[index].next.size() == 1) {
+                labels += building[index].next.front().first;
+                index = building[index].next.front().second;
+            }
+            node.labelLength = (uint32_t)labels.size() - node.labelStart;
+            std::copy(std::begin(building[index].match), std::end(building[index].match), std::begin(node.match));
+
+            nodes.push_back(node);
+            from.push_back(index);
+        }
+    }
+
+    building.clear();
+    building.shrink_to_fit();
+}
+
+//*********************************************************************
+//                      find
+//*********************************************************************
+
+uint32_t CommandTrie::child(uint32_t node, char c) const {
+    const Node& parent = nodes[node];
+    for(uint32_t i = parent.firstChild; i < parent.firstChild + parent.childCount; i++) {
+        if(labels[nodes[i].labelStart] == c)
+            return(i);
+    }
+    return(NONE);
+}
+
+const Command* CommandTrie::find(std::string_view str, CommandTier tier, int& ret) const {
+    ret = CMD_NOT_FOUND;
+    if(str.empty() || nodes.empty())
+        return(nullptr);
+
+    uint32_t node = 0;
+    bool midEdge = false;
+    size_t pos = 0;
+    while(pos < str.size()) {
+        node = child(node, lower(str[pos]));
+        if(node == NONE)
+            return(nullptr);
+
+        const Node& cur = nodes[node];
+        for(uint32_t i = 0; i < cur.labelLength; i++) {
+            if(pos == str.size()) {
+                midEdge = true;
+                break;
+            }
+            if(lower(str[pos]) != labels[cur.labelStart + i])
+                return(nullptr);
+            pos++;
+        }
+    }
+
+    const Match& match = nodes[node].match[(int)tier];
+    if(!midEdge && match.exact) {
+        ret = 0;
+        return(match.exact);
+    }
+    if(!match.best)
+        return(nullptr);
+
+    ret = match.ties > 1 ? CMD_NOT_UNIQUE : 0;
+    return(match.best);
+}
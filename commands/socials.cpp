@@ -41,6 +41,7 @@
 
 void Config::clearSocials() {
     socials.clear();
+    rebuildCommandIndex();
 }
 
 bool SocialCommand::getWakeTarget() const {
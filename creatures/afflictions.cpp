@@ -384,6 +384,7 @@ bool Effects::removePoison() {
             effect->remove();
             delete effect;
             eIt = effectList.erase(eIt);
+            reindex();
         } else
             eIt++;
     }
@@ -485,6 +486,7 @@ bool Effects::removeDisease() {
             effect->remove();
             delete effect;
             eIt = effectList.erase(eIt);
+            reindex();
         } else
             eIt++;
     }
@@ -512,6 +514,7 @@ bool Effects::removeCurse() {
             effect->remove();
             delete effect;
             eIt = effectList.erase(eIt);
+            reindex();
         } else
             eIt++;
     }
@@ -842,8 +842,8 @@ int Player::displayCreature(const std::shared_ptr<Creature>& target)  {
                  << " is " << pTarget->getAge() << " years old.^x\n";
         }
 
-        if(!pTarget->description.empty())
-            oStr << pTarget->description << "\n";
+        if(!pTarget->description->empty())
+            oStr << *pTarget->description << "\n";
     }
 
     if(target->isEffected("vampirism")) {
@@ -45,6 +45,7 @@
 #include "location.hpp"                        // for Location
 #include "monType.hpp"                         // for PLAYER, immuneCriticals
 #include "money.hpp"                           // for Money
+#include "msdp.hpp"                            // for MsdpEvent
 #include "mud.hpp"                             // for LT_UNCONSCIOUS
 #include "mudObjects/container.hpp"            // for Container, ObjectSet
 #include "mudObjects/creatures.hpp"            // for Creature, SkillMap
@@ -163,7 +164,10 @@ void Creature::subExperience(unsigned long e) {
 //                      setExperience
 //*********************************************************************
 
-void Creature::setExperience(unsigned long e) { experience = std::min<unsigned long>(2100000000, e); }
+void Creature::setExperience(unsigned long e) {
+    experience = std::min<unsigned long>(2100000000, e);
+    publishMsdp(MsdpEvent::Experience);
+}
 
 //*********************************************************************
 //                      setClass
@@ -199,7 +203,10 @@ void Creature::setClass(CreatureClass c) {
 
 void Creature::setClan(unsigned short c) { clan = c; }
 
-void Creature::setLevel(unsigned short l, bool isDm) { level = std::max(1, std::min<int>(l, isDm ? 127 : MAXALVL)); }
+void Creature::setLevel(unsigned short l, bool isDm) {
+    level = std::max(1, std::min<int>(l, isDm ? 127 : MAXALVL));
+    publishMsdp(MsdpEvent::Experience);
+}
 
 void Creature::setAlignment(short a) { alignment = std::max<short>(-1000, std::min<short>(1000, a)); }
 
@@ -229,9 +236,9 @@ void Creature::setType(mType t) { type = t; }
 
 
 void Creature::setDescription(std::string_view desc) {
-    description = desc;
+    description = std::string(desc);
     if(isMonster())
-        boost::replace_all(description, "*CR*", "\n");
+        boost::replace_all(description.edit(), "*CR*", "\n");
 }
 
 
@@ -488,7 +495,8 @@ void Creature::crtReset() {
 
     zero(key, sizeof(key));
 
-    poisonedBy = description = "";
+    poisonedBy = "";
+    description.reset();
     version = "0.00";
 
     fd = -1;
@@ -515,6 +523,8 @@ void Creature::crtReset() {
 
     hp.setName("Hp");
     mp.setName("Mp");
+    hp.setParent(this);
+    mp.setParent(this);
 
     if(isPlayer()) {
         // pThis evaluates to 0, and getAsPlayer() throws bad_weak_ptr
@@ -597,11 +607,7 @@ void Monster::monReset() {
     raceAggro.reset();
     deityAggro.reset();
 
-    std::list<TalkResponse*>::iterator tIt;
-    for(tIt = responses.begin() ; tIt != responses.end() ; tIt++) {
-        delete (*tIt);
-    }
-    responses.clear();
+    responses.reset();
 }
 
 //*********************************************************************
@@ -794,6 +800,23 @@ void Creature::crtCopy(const Creature &cr, bool assign) {
 
     attackPower = cr.attackPower;
     previousRoom = cr.previousRoom;
+    refreshKeyTxt();
+}
+
+//*********************************************************************
+//                      getKeyTxt
+//*********************************************************************
+
+const KeyTxt& Creature::getKeyTxt() const {
+    if(keyTxt.isStale())
+        keyTxt.set(key[0], key[1], key[2], getName());
+    return(keyTxt);
+}
+
+void Creature::refreshKeyTxt() {
+    keyTxt.invalidate();
+    if(std::shared_ptr<Container> container = getParent())
+        container->keyTxtChanged();
 }
 
 //*********************************************************************
@@ -992,9 +1015,7 @@ void Monster::monCopy(const Monster& cr, bool assign) {
     defenseSkill = cr.defenseSkill;
     weaponSkill = cr.weaponSkill;
 
-    for(TalkResponse* response : cr.responses) {
-        responses.push_back(new TalkResponse(*response));
-    }
+    responses = cr.responses;
     for(QuestInfo* quest : cr.quests) {
         quests.push_back(quest);
     }
@@ -1063,12 +1084,7 @@ Player& Player::operator=(const Player& cr) {
 Monster::~Monster() {
     if(gServer->isActive(this))
         gServer->delActive(this);
-    for(auto it = responses.begin(); it != responses.end();) {
-    	auto response = (*it);
-    	it++;
-    	delete response;
-    }
-    responses.clear();
+    responses.reset();
     specials.clear();
 }
 
@@ -1079,6 +1095,8 @@ Monster::~Monster() {
 Player::~Player() {
     int i = 0;
 
+    clearNearbyRooms();
+
     if(birthday) {
         delete birthday;
         birthday = nullptr;
@@ -79,8 +79,10 @@ bool Creature::canSeeRoom(const std::shared_ptr<BaseRoom>& room, bool p) const {
         return(false);
     }
 
+    static const EffectId infravision = Effect::intern("infravision"), lycanthropy = Effect::intern("lycanthropy");
+
     // magic vision overcomes all darkness
-    if(isEffected("infravision"))
+    if(isEffected(infravision))
         return(true);
 
     // magic dark can only be overcome by magic vision
@@ -96,7 +98,7 @@ bool Creature::canSeeRoom(const std::shared_ptr<BaseRoom>& room, bool p) const {
     if(room->isNormalDark()) {
         // there are several sources of normal vision
         bool    normal_sight = gConfig->getRace(race)->hasInfravision() ||
-            isUndead() || isEffected("lycanthropy") || (player && player->getLight());
+            isUndead() || isEffected(lycanthropy) || (player && player->getLight());
 
         // if they can't see, maybe someone else in the room has light for them
         if(!normal_sight) {
@@ -125,25 +127,29 @@ bool Creature::canSee(const std::shared_ptr<const MudObject> target, bool skip)
     if(!target)
         return(false);
 
+    // Checked for every creature, object and exit that gets displayed
+    static const EffectId incognito = Effect::intern("incognito"), detectInvisible = Effect::intern("detect-invisible"),
+        mist = Effect::intern("mist"), trueSight = Effect::intern("true-sight"), invisibility = Effect::intern("invisibility");
+
     if(target->isCreature()) {
         const std::shared_ptr<const Creature> & cTarget = target->getAsConstCreature();
         if(cTarget->isPlayer()) {
             if(cTarget->flagIsSet(P_DM_INVIS) && getClass() < cTarget->getClass()) 
                 return(false);
-            if(target->isEffected("incognito") && (getClass() < cTarget->getClass()) && getParent() != cTarget->getParent()) 
+            if(target->isEffected(incognito) && (getClass() < cTarget->getClass()) && getParent() != cTarget->getParent()) 
                 return(false);
 
             if(!skip) {
-                if(cTarget->isInvisible() && !isEffected("detect-invisible") && !isStaff()) 
+                if(cTarget->isInvisible() && !isEffected(detectInvisible) && !isStaff()) 
                     return(false);
-                if(target->isEffected("mist") && !isEffected("true-sight") && !isStaff()) 
+                if(target->isEffected(mist) && !isEffected(trueSight) && !isStaff()) 
                     return(false);
             }
 
         } else {
 
             if(!skip) {
-                if(cTarget->isInvisible() && !isEffected("detect-invisible") && !isStaff()) 
+                if(cTarget->isInvisible() && !isEffected(detectInvisible) && !isStaff()) 
                     return(false);
             }
 
@@ -158,7 +164,7 @@ bool Creature::canSee(const std::shared_ptr<const MudObject> target, bool skip)
         // handle NoSee right away
         if(exit->flagIsSet(X_NO_SEE)) 
             return(false);
-        if(exit->isEffected("invisibility") && !isEffected("detect-invisible")) 
+        if(exit->isEffected(invisibility) && !isEffected(detectInvisible)) 
             return(false);
     }
     if(target->isObject()) {
@@ -166,7 +172,7 @@ bool Creature::canSee(const std::shared_ptr<const MudObject> target, bool skip)
 
         if(isStaff()) 
             return(true);
-        if(object->isEffected("invisibility") && !isEffected("detect-invisible")) 
+        if(object->isEffected(invisibility) && !isEffected(detectInvisible)) 
             return(false);
 
     }
@@ -25,6 +25,7 @@
 
 #include "catRef.hpp"                  // for CatRef
 #include "cmd.hpp"                     // for cmd
+#include "effects.hpp"                 // for Effect, EffectId
 #include "factions.hpp"                // for Faction
 #include "flags.hpp"                   // for M_FAST_WANDER, M_PERMENANT_MON...
 #include "global.hpp"                  // for CreatureClass, CreatureClass::...
@@ -60,6 +61,13 @@ char Monster::mob_trade_str[][16]  = { "None", "Smithy", "Banker", "Armorer", "W
 bool Monster::operator <(const Monster& t) const {
     return(strcmp(this->getCName(), t.getCName()) < 0);
 }
+
+// Monster sets are in order of name then id, run together
+const std::string* Monster::refreshSortKey() {
+    sortKey = getName();
+    sortKey += getId();
+    return(&sortKey);
+}
 /*
  * mTypes formatted as case for use in functions below
  *
@@ -205,6 +213,77 @@ void Monster::pulseTick(long t) {
     }
 }
 
+//*********************************************************************
+//                      staysActive
+//*********************************************************************
+// Monsters that need updating even when no player is in the room with them
+
+bool Monster::staysActive() const {
+    static const EffectId slow = Effect::intern("slow");
+    return( flagIsSet(M_FAST_WANDER) ||
+            isPet() ||
+            isPoisoned() ||
+            flagIsSet(M_FAST_TICK) ||
+            flagIsSet(M_ALWAYS_ACTIVE) ||
+            flagIsSet(M_REGENERATES) ||
+            isEffected(slow) ||
+            flagIsSet(M_PERMANENT_MONSTER) ||
+            flagIsSet(M_AGGRESSIVE)
+    );
+}
+
+bool Monster::isDormant() const {
+    return(dormantSince != 0);
+}
+
+void Monster::goDormant(long t) {
+    dormantSince = t;
+}
+
+long Monster::getLastSimulated() const {
+    return(lastSimulated);
+}
+
+void Monster::setLastSimulated(long t) {
+    lastSimulated = t;
+}
+
+//*********************************************************************
+//                      fastForward
+//*********************************************************************
+// Catch a dormant monster up on the ticks it missed while nobody was nearby,
+// all at once rather than one pulse at a time.  Effects and wandering go off
+// elapsed time already, so they sort themselves out on the next update.
+
+void Monster::fastForward(long t) {
+    long elapsed = t - dormantSince;
+    dormantSince = 0;
+    lastSimulated = 0;
+
+    if(elapsed <= 0 || isEffected("petrification") || (isPoisoned() && !immuneToPoison()))
+        return;
+
+    double power = 0.8;
+    if(flagIsSet(M_FAST_TICK))
+        power = 1.0;
+    else if(flagIsSet(M_REGENERATES))
+        power = 0.9;
+
+    long perTick = static_cast<long>( pow( static_cast<double>(hp.getMax())*0.2, power ) );
+    long hpTicks = elapsed / std::max<long>(1, lasttime[LT_TICK].interval);
+    long mpTicks = elapsed / std::max<long>(1, lasttime[LT_TICK_SECONDARY].interval);
+
+    if(hpTicks && hp.getCur() < hp.getMax())
+        hp.increase(static_cast<int>(std::min<long>(perTick * hpTicks, hp.getMax() - hp.getCur())));
+    if(mpTicks && mp.getCur() < mp.getMax())
+        mp.increase(static_cast<int>(std::min<long>(perTick * mpTicks, mp.getMax() - mp.getCur())));
+
+    if(hpTicks)
+        lasttime[LT_TICK].ltime = t;
+    if(mpTicks)
+        lasttime[LT_TICK_SECONDARY].ltime = t;
+}
+
 
 
 //*********************************************************************
@@ -18,11 +18,13 @@
 
 #include <fmt/format.h>              // for format
 #include <cmath>                     // for ceil, floor, round
+#include <algorithm>                 // for sort
 #include <ctime>                     // for time
-#include <map>                       // for allocator, operator==, _Rb_tree_...
+#include <deque>                     // for deque
 #include <ostream>                   // for operator<<, basic_ostream, char_...
 #include <string>                    // for operator==, string, basic_string
 #include <string_view>               // for operator==, string_view, basic_s...
+#include <unordered_map>             // for unordered_map
 #include <utility>                   // for pair
 
 #include "config.hpp"                // for Config, gConfig
@@ -36,21 +38,68 @@
 #include "mudObjects/players.hpp"    // for Player
 #include "playerClass.hpp"           // for PlayerClass
 #include "statistics.hpp"            // for Statistics, LevelInfo
-#include "stats.hpp"                 // for Stat, StatModifier, ModifierMap
+#include "stats.hpp"                 // for Stat, StatModifier, StatSlot
 
 
 
 //#####################################################################
 // Stat Modifier
 //#####################################################################
+// Modifier names are interned to small keys.  The slot names go in first, so
+// a slot's key is its StatSlot.
+static std::deque<std::string>& modifierNames() {
+    static std::deque<std::string> names = { "CurModifier", "ConBonus", "IntBonus", "Rounding", "DmSet" };
+    return(names);
+}
+
+static std::unordered_map<std::string_view, uint16_t>& modifierKeys() {
+    static std::unordered_map<std::string_view, uint16_t> keys = [] {
+        std::unordered_map<std::string_view, uint16_t> k;
+        const auto& names = modifierNames();
+        for(uint16_t i = 0; i < names.size(); i++)
+            k.emplace(names[i], i);
+        return(k);
+    }();
+    return(keys);
+}
+
+// Key that no modifier has; returned for names that have never been seen
+static constexpr uint16_t NO_MODIFIER_KEY = 0xffff;
+
+static uint16_t lookupModifierKey(std::string_view name) {
+    auto& keys = modifierKeys();
+    auto it = keys.find(name);
+    return(it == keys.end() ? NO_MODIFIER_KEY : it->second);
+}
+
+uint16_t StatModifier::intern(std::string_view name) {
+    auto& keys = modifierKeys();
+    auto it = keys.find(name);
+    if(it != keys.end())
+        return(it->second);
+
+    auto& names = modifierNames();
+    auto key = (uint16_t)names.size();
+    names.emplace_back(name);
+    keys.emplace(names.back(), key);
+    return(key);
+}
+
 StatModifier::StatModifier() {
-    name = "none";
+    static const uint16_t none = intern("none");
+    key = none;
     modAmt = 0;
     modType = MOD_NONE;
 }
 
 StatModifier::StatModifier(std::string_view pName, int pModAmt, ModifierType pModType) {
-    name = pName;
+    key = intern(pName);
+    modAmt = pModAmt;
+    modType = pModType;
+}
+
+StatModifier::StatModifier(uint16_t pKey, int pModAmt, ModifierType pModType) {
+    key = pKey;
     modAmt = pModAmt;
     modType = pModType;
 }
@@ -66,15 +115,25 @@ void StatModifier::setType(ModifierType newType) {
     modType = newType;
 }
 
-std::string StatModifier::getName() {
-    return(name);
+const std::string& StatModifier::getName() const {
+    return(modifierNames()[key]);
 }
-int StatModifier::getModAmt() {
+uint16_t StatModifier::getKey() const {
+    return(key);
+}
+int StatModifier::getModAmt() const {
     return(modAmt);
 }
-ModifierType StatModifier:: getModType() {
+ModifierType StatModifier::getModType() const {
     return(modType);
 }
+// How much this adds to the stat's current and max values
+int StatModifier::curAmt() const {
+    return(modType == MOD_CUR || modType == MOD_CUR_MAX ? modAmt : 0);
+}
+int StatModifier::maxAmt() const {
+    return(modType == MOD_MAX || modType == MOD_CUR_MAX ? modAmt : 0);
+}
 
 double getConBonusPercentage(int pCon) {
     const double a = 0.000007672564844;
@@ -99,74 +158,180 @@ double getIntBonusPercentage(int pInt) {
 
 }
 
+//*********************************************************************
+//                      reCalc
+//*********************************************************************
+// The modifier totals are kept up to date as modifiers change, so this only
+// has to work out the con/int bonus and clamp cur.
+
 void Stat::reCalc() {
     if(!dirty) return;
 
+    StatSlot bonusSlot = NUM_STAT_SLOTS;
     if(influencedBy) {
         if(name == "Hp")
-            setModifier("ConBonus", 0, MOD_MAX);
+            bonusSlot = SLOT_CON_BONUS;
         else if(name == "Mp")
-            setModifier("IntBonus", 0, MOD_MAX);
+            bonusSlot = SLOT_INT_BONUS;
     }
 
-    cur = initial;
-    max = initial;
+    // The bonus is a percentage of everything else, so leave it out of the totals
+    if(bonusSlot != NUM_STAT_SLOTS)
+        setByKey(bonusSlot, 0, MOD_MAX);
 
-    for(const auto& [modId, mod] : modifiers) {
-        if(!mod) continue;
-        switch(mod->getModType()) {
-        case MOD_MAX:
-            max += mod->getModAmt();
-            break;
-        case MOD_CUR:
-            cur += mod->getModAmt();
-            break;
-        case MOD_CUR_MAX:
-            max += mod->getModAmt();
-            cur += mod->getModAmt();
-            break;
-        default:
-            break;
-        }
+    cur = initial + curTotal;
+    max = initial + maxTotal;
+
+    if(bonusSlot != NUM_STAT_SLOTS) {
+        double percentage = (bonusSlot == SLOT_CON_BONUS ? getConBonusPercentage(influencedBy->getCur()) :
+                                                           getIntBonusPercentage(influencedBy->getCur()));
+        const StatModifier* rounding = findModifier(SLOT_ROUNDING);
+        int bonus = (int)((double)(max - (rounding ? rounding->getModAmt() : 0)) * percentage);
+        setByKey(bonusSlot, bonus, MOD_MAX);
+
+        max += bonus;
     }
 
+    if(cur > max) {
+        int oldMax = maxTotal;
+        adjustByKey(SLOT_CUR, max - cur, MOD_CUR);
+        cur -= (cur - max);
+        setDirty();
+        // A CurModifier that was also raising max no longer does, so max has to be worked out again
+        if(maxTotal != oldMax)
+            return(reCalc());
+    }
+    dirty = false;
+}
+
+//*********************************************************************
+//                      findModifier
+//*********************************************************************
 
-    if(influencedBy && name == "Hp") {
-        double percentage = getConBonusPercentage(influencedBy->getCur());
-        int rounding = this->getModifierAmt("Rounding");
-        int conBonus = (int)((double)(max-rounding) * percentage);
-        setModifier("ConBonus", conBonus, MOD_MAX);
+StatModifier* Stat::findModifier(uint16_t key) {
+    if(key < NUM_STAT_SLOTS)
+        return(slotsUsed & (1 << key) ? &slots[key] : nullptr);
 
-        max += conBonus;
+    for(auto& mod : named) {
+        if(mod.getKey() == key)
+            return(&mod);
     }
-    if(influencedBy && name == "Mp") {
-        double percentage = getIntBonusPercentage(influencedBy->getCur());
-        int rounding = this->getModifierAmt("Rounding");
-        int intBonus = (int)((double)(max-rounding) * percentage);
-        setModifier("IntBonus", intBonus, MOD_MAX);
+    return(nullptr);
+}
 
-        max += intBonus;
+//*********************************************************************
+//                      insertModifier
+//*********************************************************************
+// These keep curTotal and maxTotal in step with the modifiers, but leave
+// marking the stat dirty to the caller.
+
+bool Stat::insertModifier(const StatModifier& mod) {
+    uint16_t key = mod.getKey();
+    if(findModifier(key))
+        return(false);
+
+    if(key < NUM_STAT_SLOTS) {
+        slots[key] = mod;
+        slotsUsed |= (uint8_t)(1 << key);
+    } else {
+        named.push_back(mod);
     }
+    curTotal += mod.curAmt();
+    maxTotal += mod.maxAmt();
+    return(true);
+}
 
-    if(cur > max) {
-        adjustModifier("CurModifier", max - cur);
-        cur -= (cur - max);
+bool Stat::eraseModifier(uint16_t key) {
+    StatModifier* mod = findModifier(key);
+    if(!mod)
+        return(false);
+
+    curTotal -= mod->curAmt();
+    maxTotal -= mod->maxAmt();
+    if(key < NUM_STAT_SLOTS) {
+        slotsUsed &= (uint8_t)~(1 << key);
+    } else {
+        *mod = named.back();
+        named.pop_back();
     }
-    dirty = false;
+    return(true);
+}
+
+// Returns false if there was nothing to do
+bool Stat::adjustByKey(uint16_t key, int modAmt, ModifierType modType) {
+    StatModifier* mod = findModifier(key);
+    if(!mod) {
+        if(modAmt == 0) return(false);
+        insertModifier(StatModifier(key, 0, modType));
+        mod = findModifier(key);
+    }
+
+    curTotal -= mod->curAmt();
+    maxTotal -= mod->maxAmt();
+    mod->adjust(modAmt);
+
+    if(mod->getModAmt() == 0) {
+        eraseModifier(key);
+        return(true);
+    }
+    mod->setType(modType);
+    curTotal += mod->curAmt();
+    maxTotal += mod->maxAmt();
+    return(true);
+}
+
+// Returns false if there was nothing to do
+bool Stat::setByKey(uint16_t key, int newAmt, ModifierType modType) {
+    StatModifier* mod = findModifier(key);
+    if(newAmt == 0)
+        return(mod ? eraseModifier(key) : false);
+
+    if(!mod) {
+        insertModifier(StatModifier(key, 0, modType));
+        mod = findModifier(key);
+    }
+
+    curTotal -= mod->curAmt();
+    maxTotal -= mod->maxAmt();
+    mod->set(newAmt);
+    mod->setType(modType);
+    curTotal += mod->curAmt();
+    maxTotal += mod->maxAmt();
+    return(true);
+}
+
+//*********************************************************************
+//                      sortedModifiers
+//*********************************************************************
+// Modifiers in the order they've always been saved and shown in
+
+std::vector<const StatModifier*> Stat::sortedModifiers() const {
+    std::vector<const StatModifier*> sorted;
+    sorted.reserve(NUM_STAT_SLOTS + named.size());
+    for(int i = 0; i < NUM_STAT_SLOTS; i++) {
+        if(slotsUsed & (1 << i))
+            sorted.push_back(&slots[i]);
+    }
+    for(const auto& mod : named)
+        sorted.push_back(&mod);
+
+    alphanum_less<std::string> less;
+    std::sort(sorted.begin(), sorted.end(), [&less](const StatModifier* a, const StatModifier* b) {
+        return(less(a->getName(), b->getName()));
+    });
+    return(sorted);
 }
+
 bool Stat::hasModifier(const std::string &pName) {
-    return (modifiers.find(pName) != modifiers.end());
+    return(getModifier(pName) != nullptr);
 }
-std::shared_ptr<StatModifier>& Stat::getModifier(const std::string &pName) {
-    auto it = modifiers.find(pName);
-    if(it == modifiers.end())
-        throw std::runtime_error("Requested unknown modifier " + pName);
-    return(it->second);
+StatModifier* Stat::getModifier(const std::string &pName) {
+    uint16_t key = lookupModifierKey(pName);
+    return(key == NO_MODIFIER_KEY ? nullptr : findModifier(key));
 }
 int Stat::getModifierAmt(const std::string &pName) {
-    if(!hasModifier(pName)) return(0);
-
-    return getModifier(pName)->getModAmt();
+    const StatModifier* mod = getModifier(pName);
+    return(mod ? mod->getModAmt() : 0);
 }
 Stat* Creature::getStat(std::string_view statName) {
     if     (statName == "strength")            return(&strength);
@@ -210,18 +375,19 @@ bool Creature::setStatDirty(std::string_view statName) {
 bool Stat::addModifier(StatModifier* toAdd) {
     if(!toAdd) return(false);
 
-    if(hasModifier(toAdd->getName())) {
+    if(!insertModifier(*toAdd)) {
         std::clog << "Not adding modifer " << toAdd->getName() << std::endl;
         delete toAdd;
         return(false);
     }
-    modifiers.insert(ModifierMap::value_type(toAdd->getName(), toAdd));
+    delete toAdd;
     setDirty();
     return(true);
 }
 void Stat::setDirty() {
     dirty = true;
     if(influences) influences->setDirty();
+    if(parent) parent->statChanged(*this);
 }
 bool Stat::addModifier(const std::string &pName, int modAmt, ModifierType modType) {
     if(hasModifier(pName)) return(false);
@@ -229,46 +395,26 @@ bool Stat::addModifier(const std::string &pName, int modAmt, ModifierType modTyp
 }
 
 bool Stat::removeModifier(const std::string &pName) {
-    auto it = modifiers.find(pName);
-    if(it == modifiers.end()) return(false);
+    uint16_t key = lookupModifierKey(pName);
+    if(key == NO_MODIFIER_KEY || !eraseModifier(key)) return(false);
 
-    modifiers.erase(it);
     setDirty();
     return(true);
 }
 void Stat::clearModifiers() {
-    modifiers.clear();
+    slotsUsed = 0;
+    named.clear();
+    curTotal = maxTotal = 0;
 }
 bool Stat::adjustModifier(const std::string &pName, int modAmt, ModifierType modType) {
-    if(!hasModifier(pName)) {
-        if(modAmt == 0) return(true);
-        auto mod = std::make_shared<StatModifier>(pName, 0, modType);
-        modifiers.insert(ModifierMap::value_type(pName, mod));
-    }
-    auto mod = getModifier(pName);
-    mod->adjust(modAmt);
-
-    if(mod->getModAmt() == 0) return(removeModifier(pName));
-    else mod->setType(modType);
-
-    setDirty();
+    if(adjustByKey(StatModifier::intern(pName), modAmt, modType))
+        setDirty();
     return(true);
 }
 
 bool Stat::setModifier(const std::string &pName, int newAmt, ModifierType modType) {
-    bool hasMod = hasModifier(pName);
-    if(newAmt == 0) {
-        if(!hasMod) return(true);
-        else return(removeModifier(pName));
-    }
-    if(!hasMod) {
-        auto mod = new StatModifier(pName, 0, modType);
-        modifiers.insert(ModifierMap::value_type(pName, mod));
-    }
-    auto mod = getModifier(pName);
-    mod->set(newAmt);
-    mod->setType(modType);
-    setDirty();
+    if(setByKey(StatModifier::intern(pName), newAmt, modType))
+        setDirty();
     return(true);
 
 }
@@ -278,14 +424,11 @@ bool Stat::setModifier(const std::string &pName, int newAmt, ModifierType modTyp
 //*********************************************************************
 Stat::Stat() {
      cur = max = initial = 0;
+     slotsUsed = 0;
+     curTotal = maxTotal = 0;
      dirty = true;
      influences = influencedBy = nullptr;
-}
-
-StatModifier::StatModifier(StatModifier &sm) {
-    name = sm.name;
-    modAmt = sm.modAmt;
-    modType = sm.modType;
+     parent = nullptr;
 }
 
 Stat& Stat::operator=(const Stat& st) {
@@ -295,10 +438,8 @@ Stat& Stat::operator=(const Stat& st) {
     return(*this);
 }
 void Stat::doCopy(const Stat& st) {
-    for(const auto& [modId, mod] : st.modifiers) {
-        auto newMod = std::make_shared<StatModifier>(*mod.get());
-        modifiers.insert(ModifierMap::value_type(newMod->getName(), newMod));
-    }
+    for(const StatModifier* mod : st.sortedModifiers())
+        insertModifier(*mod);
     name = st.name;
     cur = st.cur;
     max = st.max;
@@ -308,9 +449,7 @@ void Stat::doCopy(const Stat& st) {
     influencedBy = nullptr;
 }
 
-Stat::~Stat() {
-    modifiers.clear();
-}
+Stat::~Stat() = default;
 
 void Stat::setName(std::string_view pName) {
     name = pName;
@@ -333,7 +472,7 @@ int Stat::adjust(int amt) {
 int Stat::increase(int amt) {
     int increaseAmt = std::max<int>(0, std::min(amt, getMax() - getCur()));
         
-    adjustModifier("CurModifier", increaseAmt);
+    adjustCur(increaseAmt);
     
     return(increaseAmt);
 }
@@ -346,11 +485,31 @@ int Stat::increase(int amt) {
 int Stat::decrease(int amt) {
     int decreaseAmt = std::min(amt, getCur());
     
-    adjustModifier("CurModifier", -decreaseAmt);
+    adjustCur(-decreaseAmt);
     
     return(decreaseAmt);
 }
 
+//*********************************************************************
+//                      adjustCur
+//*********************************************************************
+// Damage, healing and regeneration only move CurModifier, which can't change
+// max, so cur is adjusted in place rather than recalculated.
+
+void Stat::adjustCur(int amt) {
+    int oldCur = curTotal, oldMax = maxTotal;
+    if(!adjustByKey(SLOT_CUR, amt, MOD_CUR))
+        return;
+
+    if(!dirty && maxTotal == oldMax && cur + (curTotal - oldCur) <= max) {
+        cur += curTotal - oldCur;
+        if(influences) influences->setDirty();
+        if(parent) parent->statChanged(*this);
+        return;
+    }
+    setDirty();
+}
+
 //*********************************************************************
 //                      getCur
 //*********************************************************************
@@ -391,8 +550,10 @@ double round(double r) {
 void Stat::setMax(int newMax, bool allowZero) {
     newMax = std::max<int>(allowZero ? 0 : 1, std::min<int>(newMax, 30000));
 
-    int dmSet = getModifierAmt("DmSet");
-    int rounding = getModifierAmt("Rounding");
+    const StatModifier* mod = findModifier(SLOT_DM_SET);
+    int dmSet = mod ? mod->getModAmt() : 0;
+    mod = findModifier(SLOT_ROUNDING);
+    int rounding = mod ? mod->getModAmt() : 0;
     int adjustment = 0;
     bool setHp = false, setMp = false;
     if(name == "Hp")
@@ -404,13 +565,14 @@ void Stat::setMax(int newMax, bool allowZero) {
         double percentage =  0;
         int bonus = 0;
         if(setHp) {
-            bonus = getModifierAmt("ConBonus");
+            mod = findModifier(SLOT_CON_BONUS);
             percentage = getConBonusPercentage(influencedBy->getCur());
         }
         if(setMp) {
-            bonus = getModifierAmt("IntBonus");
+            mod = findModifier(SLOT_INT_BONUS);
             percentage = getIntBonusPercentage(influencedBy->getCur());
         }
+        bonus = mod ? mod->getModAmt() : 0;
 
         // Target max value we want
         double targetMax = newMax;
@@ -425,18 +587,17 @@ void Stat::setMax(int newMax, bool allowZero) {
         // Calculated max based on new adjustment, without any rounding modifier
         int adjMax = (int)((curMax + adjustment) * (1.0+percentage));
 
-        this->setModifier("DmSet", adjustment, MOD_MAX);
+        if(setByKey(SLOT_DM_SET, adjustment, MOD_MAX))
+            setDirty();
 
         // Due to rounding with doubles we might miss the target by 1, this will adjust it
-        if(adjMax != newMax) {
-            setModifier("Rounding", newMax - adjMax, MOD_MAX);
-        } else {
-            setModifier("Rounding", 0, MOD_MAX);
-        }
+        if(setByKey(SLOT_ROUNDING, adjMax != newMax ? newMax - adjMax : 0, MOD_MAX))
+            setDirty();
     } else {
         int curMax = getMax() - dmSet;
         adjustment = (int)newMax - (int)curMax;
-        this->setModifier("DmSet", adjustment, MOD_MAX);
+        if(setByKey(SLOT_DM_SET, adjustment, MOD_MAX))
+            setDirty();
     }
 
 
@@ -449,7 +610,7 @@ void Stat::setMax(int newMax, bool allowZero) {
 void Stat::setCur(int newCur) {
     newCur = std::min(newCur, getMax());
     int modCur = (int)newCur - (int)getCur();
-    adjustModifier("CurModifier", modCur);
+    adjustCur(modCur);
 }
 
 void Stat::setInfluences(Stat* pInfluences) {
@@ -458,6 +619,9 @@ void Stat::setInfluences(Stat* pInfluences) {
 void Stat::setInfluencedBy(Stat* pInfluencedBy) {
     influencedBy = pInfluencedBy;
 }
+void Stat::setParent(Creature* pParent) {
+    parent = pParent;
+}
 
 std::ostream& operator<<(std::ostream& out, Stat& stat) {
     out << stat.toString();
@@ -469,7 +633,7 @@ std::string Stat::toString() {
 
     oStr << "^C" << name << ": ^c" << getCur() << "/" << getMax() << "(" << getInitial() << ")\n";
     int i = 1;
-    for(const auto& [modId, mod] : modifiers) {
+    for(const StatModifier* mod : sortedModifiers()) {
         oStr << "\t" << i++ << ") ";
         oStr << "^C" << mod->getName() << "^c ";
         switch(mod->getModType()) {
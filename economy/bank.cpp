@@ -33,6 +33,7 @@
 #include "flags.hpp"                 // for R_BANK, R_MAGIC_MONEY_MACHINE
 #include "global.hpp"                // for CreatureClass, CreatureClass::BU...
 #include "guilds.hpp"                // for Guild
+#include "logWriter.hpp"             // for LogWriter, LogKind
 #include "money.hpp"                 // for Money, GOLD
 #include "mud.hpp"                   // for GUILD_BANKER, ACC, GUILD_PEON
 #include "mudObjects/container.hpp"  // for MonsterSet
@@ -546,6 +547,7 @@ void Bank::statement(std::shared_ptr<Player> player, bool isGuild) {
     else
         sprintf(file, "%s/%s.txt", Path::Bank.c_str(), player->getCName());
 
+    LogWriter::get().flush();
     if(fs::exists(file)) {
         strcpy(player->getSock()->tempstr[3], "\0");
         player->getSock()->viewFileReverse(file);
@@ -588,6 +590,7 @@ void Bank::deleteStatement(std::shared_ptr<Player> player, bool isGuild) {
         sprintf(file, "%s/%s.txt", Path::Bank.c_str(), player->getCName());
 
     player->print("Statement deleted.\n");
+    LogWriter::get().release(file);
     unlink(file);
 }
 
@@ -683,21 +686,11 @@ void Player::computeInterest(long t, bool online) {
 //**********************************************************************
 //                      doLog
 //**********************************************************************
+// The statement is what the player sees; the copy under the log directory is for staff
 
-void Bank::doLog(const char *file, const char *str) {
-    int fd = open(file, O_RDWR | O_APPEND, 0);
-    
-    if(fd < 0) {
-        fd = open(file, O_RDWR | O_CREAT, ACC);
-        if(fd < 0)
-            return;
-    }
-
-    lseek(fd, 0L, 2);
-
-    write(fd, str, strlen(str));
-
-    close(fd);
+void Bank::doLog(const fs::path& statement, const fs::path& log, const char *str) {
+    LogWriter::get().append(statement, "bank", str, LogKind::Record);
+    LogWriter::get().append(log, "bank", str);
 }
 
 //**********************************************************************
@@ -705,25 +698,15 @@ void Bank::doLog(const char *file, const char *str) {
 //**********************************************************************
 
 void Bank::log(const char *name, const char *fmt, ...) {
-    char    file[80];
     char    str[2048];
-    long    t = time(nullptr);
     va_list ap;
 
     va_start(ap, fmt);
-
-    sprintf(file, "%s/%s.txt", Path::Bank.c_str(), name);
-
-    strcpy(str, ctime(&t));
-    str[24] = ':';
-    str[25] = ' ';
-    vsnprintf(str + 26, 2000, fmt, ap);
+    vsnprintf(str, sizeof(str), fmt, ap);
     va_end(ap);
 
-    Bank::doLog(file, str);
-
-    sprintf(file, "%s/%s.txt", Path::BankLog.c_str(), name);
-    Bank::doLog(file, str);
+    std::string file = std::string(name) + ".txt";
+    Bank::doLog(Path::Bank / file, Path::BankLog / file, str);
 }
 
 //**********************************************************************
@@ -731,23 +714,13 @@ void Bank::log(const char *name, const char *fmt, ...) {
 //**********************************************************************
 
 void Bank::guildLog(int guild, const char *fmt, ...) {
-    char    file[80];
     char    str[2048];
-    long    t = time(nullptr);
     va_list ap;
 
     va_start(ap, fmt);
-
-    sprintf(file, "%s/%d.txt", Path::GuildBank.c_str(), guild);
-
-    strcpy(str, ctime(&t));
-    str[24] = ':';
-    str[25] = ' ';
-    vsnprintf(str + 26, 2000, fmt, ap);
+    vsnprintf(str, sizeof(str), fmt, ap);
     va_end(ap);
 
-    Bank::doLog(file, str);
-
-    sprintf(file, "%s/%d.txt", Path::GuildBankLog.c_str(), guild);
-    Bank::doLog(file, str);
+    std::string file = std::to_string(guild) + ".txt";
+    Bank::doLog(Path::GuildBank / file, Path::GuildBankLog / file, str);
 }
@@ -31,6 +31,7 @@
 #include <string>                                   // for string, char_traits
 #include <string_view>                              // for operator==, strin...
 #include <type_traits>                              // for add_const<>::type
+#include <unordered_map>                            // for unordered_map
 #include <utility>                                  // for pair
 
 #include "cmd.hpp"                                  // for cmd
@@ -42,6 +43,7 @@
 #include "flags.hpp"                                // for O_WORN
 #include "global.hpp"                               // for CAP, DT_NONE, BURNED
 #include "join.hpp"                                 // for join
+#include "msdp.hpp"                                 // for MsdpEvent
 #include "mudObjects/container.hpp"                 // for Container, PlayerSet
 #include "mudObjects/creatures.hpp"                 // for Creature
 #include "mudObjects/exits.hpp"                     // for Exit
@@ -460,6 +462,7 @@ EffectInfo* Effects::addEffect(EffectInfo* newEffect, bool show, MudObject* pPar
     newEffect->apply();
 
     effectList.push_back(newEffect);
+    reindex();
     if(newEffect->getParent()->getAsRoom())
         newEffect->getParent()->getAsRoom()->addEffectsIndex();
     else if(newEffect->getParent()->getAsExit() && newEffect->getParent()->getAsExit()->getRoom())
@@ -468,6 +471,8 @@ EffectInfo* Effects::addEffect(EffectInfo* newEffect, bool show, MudObject* pPar
     // post-apply gets run after everything is done
     newEffect->postApply(keepApplier);
 
+    if(auto* creature = dynamic_cast<Creature*>(newEffect->getParent()))
+        creature->publishMsdp(MsdpEvent::Affects);
     return(newEffect);
 }
 
@@ -507,7 +512,10 @@ bool Effects::removeEffect(EffectInfo* toDel, bool show) {
         return(false);
 
     effectList.remove(toDel);
+    reindex();
     toDel->remove(show);
+    if(auto* creature = dynamic_cast<Creature*>(toDel->getParent()))
+        creature->publishMsdp(MsdpEvent::Affects);
     delete toDel;
     return(true);
 }
@@ -546,6 +554,10 @@ bool MudObject::isEffected(const std::string &effect, bool exactMatch) const {
     return(effects.isEffected(effect, exactMatch));
 }
 
+bool MudObject::isEffected(EffectId effect, bool exactMatch) const {
+    return(effects.isEffected(effect, exactMatch));
+}
+
 bool MudObject::isEffected(EffectInfo* effect) const {
     return(effects.isEffected(effect));
 }
@@ -554,7 +566,12 @@ bool MudObject::isEffected(EffectInfo* effect) const {
 // of this name
 
 bool Effects::isEffected(const std::string &effect, bool exactMatch) const {
-    //EffectList list;
+    // Every name an indexed effect answers to has an id, so a name without one can't match
+    if(!unindexed) {
+        EffectId id = Effect::lookupId(effect);
+        return(id < MAX_EFFECT_IDS && (exactMatch ? named : conferred).test(id));
+    }
+
     for(EffectInfo* eff : effectList) {
         if(eff->getName() == effect || (!exactMatch && eff->hasBaseEffect(effect)))
             return(true);
@@ -563,7 +580,17 @@ bool Effects::isEffected(const std::string &effect, bool exactMatch) const {
     return(false);
 }
 
+bool Effects::isEffected(EffectId effect, bool exactMatch) const {
+    if(!unindexed)
+        return(effect < MAX_EFFECT_IDS && (exactMatch ? named : conferred).test(effect));
+    return(effect != NO_EFFECT_ID && isEffected(Effect::getIdName(effect), exactMatch));
+}
+
 bool Effects::isEffected(EffectInfo* effect) const {
+    const Effect* info = effect->getEffect();
+    if(!unindexed && info && info->isIndexed())
+        return(conferred.test(info->getId()) || (info->getConfers() & named).any());
+
     for(EffectInfo* eff : effectList) {
         if(eff->getName() == effect->getName() || eff->hasBaseEffect(effect->getName()) || effect->hasBaseEffect(eff->getName()))
             return(true);
@@ -571,6 +598,26 @@ bool Effects::isEffected(EffectInfo* effect) const {
     return(false);
 }
 
+//*********************************************************************
+//                      reindex
+//*********************************************************************
+
+void Effects::reindex() {
+    named.reset();
+    conferred.reset();
+    unindexed = false;
+
+    for(EffectInfo* eff : effectList) {
+        const Effect* info = eff ? eff->getEffect() : nullptr;
+        if(!info || !info->isIndexed()) {
+            unindexed = true;
+            continue;
+        }
+        named.set(info->getId());
+        conferred |= info->getConfers();
+    }
+}
+
 //*********************************************************************
 //                      getBaseEffects
 //*********************************************************************
@@ -604,6 +651,12 @@ EffectInfo* MudObject::getEffect(std::string_view effect) const {
 // the base effect mentioned
 
 EffectInfo* Effects::getEffect(std::string_view effect) const {
+    if(!unindexed) {
+        EffectId id = Effect::lookupId(effect);
+        if(id >= MAX_EFFECT_IDS || !conferred.test(id))
+            return(nullptr);
+    }
+
     EffectInfo* toReturn = nullptr;
     for(const auto eff : effectList) {
         if(eff && (eff->getName() == effect || eff->hasBaseEffect(effect))) {
@@ -629,6 +682,12 @@ EffectInfo* MudObject::getExactEffect(std::string_view effect) const {
 
 // Returns the effect with an exact name match
 EffectInfo* Effects::getExactEffect(std::string_view effect) const {
+    if(!unindexed) {
+        EffectId id = Effect::lookupId(effect);
+        if(id >= MAX_EFFECT_IDS || !named.test(id))
+            return(nullptr);
+    }
+
     for(const auto eff : effectList) {
         if(eff && eff->getName() == effect)
             return(eff);
@@ -662,6 +721,7 @@ bool Creature::pulseEffects(time_t t) {
                 poison = true;
             delete effect;
             eIt = effects.effectList.erase(eIt);
+            effects.reindex();
         } else
             eIt++;
     }
@@ -726,6 +786,7 @@ void Effects::pulse(time_t t, const std::shared_ptr<MudObject>& pParent) {
             effect->remove();
             delete effect;
             it = effectList.erase(it);
+            reindex();
         } else
             it++;
     }
@@ -744,6 +805,7 @@ void Effects::removeAll() {
         (*eIt) = nullptr;
     }
     effectList.clear();
+    reindex();
 }
 
 //*********************************************************************
@@ -759,6 +821,7 @@ void Effects::copy(const Effects* source, MudObject* pParent) {
         effect->setParent(pParent);
         effectList.push_back(effect);
     }
+    reindex();
 }
 
 //*********************************************************************
@@ -1111,7 +1174,7 @@ bool EffectInfo::runScript(const std::string& pyScript, std::shared_ptr<MudObjec
         return(true);
 
     try {
-        auto locals = py::dict();
+        PooledLocals locals;
         auto effectModule = py::module::import("effectLib");
         locals["effectLib"] = effectModule;
         locals["effect"] = this;
@@ -1431,6 +1494,84 @@ bool Effect::hasBaseEffect(std::string_view effect) const {
     return(false);
 }
 
+//*********************************************************************
+//                      intern
+//*********************************************************************
+// Ids are handed out in the order names are first seen and are never reused,
+// same as area names.  Past MAX_EFFECT_IDS a name still gets an id, but it
+// can't be put in a mask; anything effected by it compares names instead.
+
+static std::deque<std::string>& effectIdNames() {
+    static std::deque<std::string> names;
+    return(names);
+}
+
+static std::unordered_map<std::string_view, EffectId>& effectIds() {
+    static std::unordered_map<std::string_view, EffectId> ids;
+    return(ids);
+}
+
+EffectId Effect::intern(std::string_view name) {
+    auto& ids = effectIds();
+    auto it = ids.find(name);
+    if(it != ids.end())
+        return(it->second);
+
+    auto& names = effectIdNames();
+    if(names.size() >= NO_EFFECT_ID)
+        return(NO_EFFECT_ID);
+    auto id = (EffectId)names.size();
+    names.emplace_back(name);
+    ids.emplace(names.back(), id);
+    if(id == MAX_EFFECT_IDS)
+        std::clog << "Effects: more than " << MAX_EFFECT_IDS << " effect names; raise MAX_EFFECT_IDS" << std::endl;
+    return(id);
+}
+
+EffectId Effect::lookupId(std::string_view name) {
+    auto& ids = effectIds();
+    auto it = ids.find(name);
+    return(it == ids.end() ? NO_EFFECT_ID : it->second);
+}
+
+const std::string& Effect::getIdName(EffectId effect) {
+    static const std::string none;
+    auto& names = effectIdNames();
+    return(effect < names.size() ? names[effect] : none);
+}
+
+//*********************************************************************
+//                      index
+//*********************************************************************
+
+void Effect::index() {
+    confers.reset();
+    id = intern(name);
+    indexed = id < MAX_EFFECT_IDS;
+    if(indexed)
+        confers.set(id);
+
+    for(std::string_view be : baseEffects) {
+        EffectId base = intern(be);
+        if(base < MAX_EFFECT_IDS)
+            confers.set(base);
+        else
+            indexed = false;
+    }
+}
+
+EffectId Effect::getId() const {
+    return(id);
+}
+
+const EffectMask& Effect::getConfers() const {
+    return(confers);
+}
+
+bool Effect::isIndexed() const {
+    return(indexed);
+}
+
 //*********************************************************************
 //                      getName
 //*********************************************************************
@@ -24,6 +24,7 @@
 #include "effects.hpp"                 // for Effect
 
 void addToSet(Effect&& eff, EffectMap &effectMap) {
+    eff.index();
     effectMap.emplace(eff.getName(), std::move(eff));
 }
 
@@ -26,6 +26,7 @@
 #include "creatureStreams.hpp"       // for Streamable, ColorOff, ColorOn
 #include "flags.hpp"                 // for P_DM_INVIS, P_NO_EXTRA_COLOR
 #include "group.hpp"                 // for Group, CreatureList, GROUP_MEMBER
+#include "msdp.hpp"                   // for MsdpEvent
 #include "mudObjects/creatures.hpp"  // for Creature, PetList
 #include "mudObjects/monsters.hpp"   // for Monster
 #include "proto.hpp"                 // for keyTxtEqual
@@ -84,6 +85,7 @@ bool Group::add(const std::weak_ptr<Creature>& newMember, bool addPets) {
             }
         }
         target->setGroupStatus(GROUP_MEMBER);
+        publishMsdp();
         return(true);
     } else {
         return false;
@@ -113,6 +115,8 @@ bool Group::remove(const std::weak_ptr<Creature>& pToRemove) {
 
         // Iterator is invalid now, do not try to access it after this
         members.erase(it);
+        toRemove->publishMsdp(MsdpEvent::Group);
+        publishMsdp();
         // Remove any pets this player had in the group
         for(const auto& mons : toRemove->pets) {
             if(remove(mons))
@@ -54,6 +54,7 @@ class Player;
 class MapMarker {
 public:
     MapMarker();
+    MapMarker(const MapMarker&) = default;
     MapMarker &operator=(const MapMarker &m);
     bool operator==(const MapMarker &m) const;
     bool operator!=(const MapMarker &m) const;
@@ -0,0 +1,114 @@
+/*
+ * banMatcher.h
+ *   Indexes for matching connecting sites against the ban list
+ *   ____            _
+ *  |  _ \ ___  __ _| |_ __ ___  ___
+ *  | |_) / _ \/ _` | | '_ ` _ \/ __|
+ *  |  _ <  __/ (_| | | | | | | \__ \
+ *  |_| \_\___|\__,_|_|_| |_| |_|___/
+ *
+ * Permission to use, modify and distribute is granted via the
+ *  GNU Affero General Public License v3 or later
+ *
+ *  Copyright (C) 2007-2021 Jason Mitchell, Randi Mitchell
+ *     Contributions by Tim Callahan, Jonathan Hseu
+ *  Based on Mordor (C) Brooke Paul, Brett J. Vickers, John P. Freeman
+ *
+ */
+
+#pragma once
+
+#include <array>
+#include <cstdint>
+#include <list>
+#include <string_view>
+#include <utility>
+#include <vector>
+
+class Ban;
+
+// An address block such as 10.0.0.0/8 or 2001:db8::/32.  IPv4 addresses are
+// stored IPv4-mapped so both families share one tree.
+struct Cidr {
+    typedef std::array<uint8_t, 16> Address;
+
+    Address addr{};
+    int bits = 0;
+
+    // Only accepts the address/length form
+    static bool parse(std::string_view str, Cidr& cidr);
+    static bool parseAddress(std::string_view str, Address& addr);
+    [[nodiscard]] bool contains(const Address& other) const;
+};
+
+// The ban list compiled into indexes, so checking a site costs about the same
+// however many bans there are.  Matches agree with Ban::matches, and when more
+// than one ban matches the earliest in the list wins, as it always has.
+// Rebuilt whenever the list changes; the Ban pointers belong to Config.
+class BanMatcher {
+public:
+    void build(const std::list<Ban*>& bans);
+    void clear();
+
+    // First ban matching either the hostname or the ip, nullptr if none
+    [[nodiscard]] Ban* find(std::string_view hostName, std::string_view ip) const;
+    [[nodiscard]] Ban* find(std::string_view site) const;
+
+private:
+    static constexpr uint32_t NONE = UINT32_MAX;
+
+    // A character trie.  Once link() has filled in the failure links it's also
+    // an Aho-Corasick automaton, for finding patterns anywhere in a string.
+    class Trie {
+    public:
+        Trie();
+        void clear();
+        void addExact(std::string_view pattern, uint32_t ban);
+        void addPrefix(std::string_view pattern, uint32_t ban, bool reversed = false);
+        void addContains(std::string_view pattern, uint32_t ban);
+        void link();
+
+        // Lowest ban that's an exact match or a prefix of str (a suffix if reversed)
+        [[nodiscard]] uint32_t matchPrefix(std::string_view str, bool reversed = false) const;
+        // Lowest ban whose pattern appears anywhere in str
+        [[nodiscard]] uint32_t matchContains(std::string_view str) const;
+
+    private:
+        struct Node {
+            std::vector<std::pair<char, uint32_t>> next;
+            uint32_t fail = 0;
+            uint32_t exact = NONE;
+            uint32_t prefix = NONE;     // Also used for contains patterns ending here
+            uint32_t out = NONE;        // Lowest contains pattern ending here or down the failure links
+        };
+
+        [[nodiscard]] uint32_t child(uint32_t node, char c) const;
+        uint32_t insert(std::string_view pattern, bool reversed);
+
+        std::vector<Node> nodes;
+    };
+
+    // Binary trie over 128 bit addresses, one level per bit
+    class AddressTree {
+    public:
+        void clear();
+        void add(const Cidr& cidr, uint32_t ban);
+        [[nodiscard]] uint32_t match(const Cidr::Address& addr) const;
+
+    private:
+        struct Node {
+            uint32_t child[2] = {NONE, NONE};
+            uint32_t ban = NONE;
+        };
+        std::vector<Node> nodes;
+    };
+
+    [[nodiscard]] uint32_t match(std::string_view site) const;
+
+    std::vector<Ban*> order;        // Position in the ban list -> ban
+    uint32_t everyone = NONE;       // A ban on "*"
+    Trie forward;                   // Exact and prefix bans
+    Trie backward;                  // Suffix bans, stored reversed
+    Trie anywhere;                  // Bans that are both prefix and suffix
+    AddressTree addresses;          // CIDR bans
+};
@@ -18,6 +18,7 @@
 
 #pragma once
 
+#include <filesystem>
 #include <memory>
 
 class BaseRoom;
@@ -41,7 +42,7 @@ namespace Bank {
     void statement(std::shared_ptr<Player> player, bool isGuild=false);
     void deleteStatement(std::shared_ptr<Player> player, bool isGuild=false);
 
-    void doLog(const char *file, const char *str);
+    void doLog(const std::filesystem::path& statement, const std::filesystem::path& log, const char *str);
     void log(const char *name, const char *fmt, ...);
     void guildLog(int guild, const char *fmt,...);
 };
@@ -27,6 +27,7 @@ class Ban {
     explicit Ban(xmlNodePtr curNode);
     void reset();
     bool matches(std::string_view toMatch);
+    [[nodiscard]] bool isExpired(long t) const;
     
 public: // for now
     std::string     site;
@@ -0,0 +1,129 @@
+/*
+ * broadcast.h
+ *   Renders a broadcast once per distinct viewer instead of once per socket
+ *   ____            _
+ *  |  _ \ ___  __ _| |_ __ ___  ___
+ *  | |_) / _ \/ _` | | '_ ` _ \/ __|
+ *  |  _ <  __/ (_| | | | | | | \__ \
+ *  |_| \_\___|\__,_|_|_| |_| |_|___/
+ *
+ * Permission to use, modify and distribute is granted via the
+ *  GNU Affero General Public License v3 or later
+ *
+ *  Copyright (C) 2007-2021 Jason Mitchell, Randi Mitchell
+ *     Contributions by Tim Callahan, Jonathan Hseu
+ *  Based on Mordor (C) Brooke Paul, Brett J. Vickers, John P. Freeman
+ *
+ */
+
+#pragma once
+
+#include <cstdarg>
+#include <functional>
+#include <memory>
+#include <string>
+#include <string_view>
+#include <utility>
+#include <vector>
+#include <fmt/format.h>
+
+#include "mudFormat.hpp"
+
+class Container;
+class Creature;
+class Player;
+class Socket;
+struct ColorTable;
+
+// A broadcast as rendered for one kind of viewer, shared by every socket it goes
+// to.  Each socket transcodes it for its client when it flushes; the first with a
+// given color table, MXP setting and active color does the work, and the rest
+// send the same bytes.  Game thread only.
+class SharedOutput {
+public:
+    explicit SharedOutput(std::string pText);
+
+    [[nodiscard]] const std::string& getText() const;
+    std::shared_ptr<const std::string> transcode(const ColorTable& colors, bool mxp, unsigned char& lastColor) const;
+
+private:
+    struct Encoding {
+        const ColorTable* colors;
+        bool mxp;
+        unsigned char lastIn;
+        unsigned char lastOut;
+        std::shared_ptr<const std::string> bytes;
+    };
+
+    std::string text;
+    mutable std::vector<Encoding> encodings;
+};
+
+// Everything that changes how a broadcast looks to a viewer: their custom colors
+// (already applied to the format), what they can detect, and where their text
+// wraps.  Color mode and MXP are handled later, when each socket writes its output.
+class BroadcastRenderer {
+public:
+    // Formats the colorized format (or the suffix) for a viewer's display flags
+    using Formatter = std::function<std::string(const std::string& format, int flags)>;
+
+    BroadcastRenderer(const char *pFmt, va_list pAp, const char *pSuffix = nullptr);
+    BroadcastRenderer(std::string_view pFmt, Formatter pFormatter, const char *pSuffix = nullptr);
+    ~BroadcastRenderer();
+    BroadcastRenderer(const BroadcastRenderer&) = delete;
+    BroadcastRenderer& operator=(const BroadcastRenderer&) = delete;
+
+    std::shared_ptr<const SharedOutput> render(const std::shared_ptr<const Player>& viewer, const Socket& sock);
+    void send(const std::shared_ptr<const Player>& viewer);
+
+    [[nodiscard]] size_t getNumVariants() const;
+
+private:
+    struct Variant {
+        std::string fmt;
+        int flags;
+        int wrap;
+        std::shared_ptr<const SharedOutput> text;
+    };
+
+    std::string format(const std::string& toFormat, int flags);
+
+    std::string_view fmt;
+    const char *suffix;
+    Formatter formatter;    // Set for fmt broadcasts; otherwise the printf arguments are in ap
+    va_list ap;
+    std::vector<Variant> variants;
+};
+
+// Sends a renderer's broadcast to a room, or to everyone
+void doBroadcast(bool showTo(std::shared_ptr<Socket>), std::shared_ptr<Socket> ignore1, std::shared_ptr<Socket> ignore2, const std::shared_ptr<const Container>& container, BroadcastRenderer& renderer);
+void doBroadCast(bool showTo(std::shared_ptr<Socket>), bool showAlso(std::shared_ptr<Socket>), BroadcastRenderer& renderer, const std::shared_ptr<Creature>& player = nullptr);
+
+// Type checked broadcasts: CrtName and ObjName arguments are shown the way each
+// viewer sees them, as %M and %O are
+template <typename... Args>
+void broadcastFmt(std::shared_ptr<Socket> ignore, const std::shared_ptr<const Container>& container, fmt::format_string<Args...> format, Args &&... args) {
+    fmt::string_view view = format;
+    BroadcastRenderer renderer(std::string_view(view.data(), view.size()), [&](const std::string& toFormat, int flags) {
+        return(formatFor(flags, toFormat, args...));
+    }, "^x\n");
+    doBroadcast(nullptr, std::move(ignore), nullptr, container, renderer);
+}
+
+template <typename... Args>
+void broadcastFmt(std::shared_ptr<Socket> ignore1, std::shared_ptr<Socket> ignore2, const std::shared_ptr<const Container>& container, fmt::format_string<Args...> format, Args &&... args) {
+    fmt::string_view view = format;
+    BroadcastRenderer renderer(std::string_view(view.data(), view.size()), [&](const std::string& toFormat, int flags) {
+        return(formatFor(flags, toFormat, args...));
+    }, "^x\n");
+    doBroadcast(nullptr, std::move(ignore1), std::move(ignore2), container, renderer);
+}
+
+template <typename... Args>
+void broadcastFmt(bool showTo(std::shared_ptr<Socket>), fmt::format_string<Args...> format, Args &&... args) {
+    fmt::string_view view = format;
+    BroadcastRenderer renderer(std::string_view(view.data(), view.size()), [&](const std::string& toFormat, int flags) {
+        return(formatFor(flags, toFormat, args...));
+    }, "^x\n");
+    doBroadCast(showTo, nullptr, renderer);
+}
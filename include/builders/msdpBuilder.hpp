@@ -47,6 +47,12 @@ class MsdpBuilder {
     BOOL_BUILDER(updateable);
     BOOL_BUILDER(isGroup);
 
+    // Recalculate the variable when this event is published instead of polling it
+    MsdpBuilder& on(MsdpEvent event) {
+        msdpVar.events |= msdpEventBit(event);
+        return *this;
+    }
+
     // NOLINTNEXTLINE - We want implicit conversion
     operator MsdpVariable&&() {
         if(msdpVar.name.empty()){
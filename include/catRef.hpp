@@ -19,18 +19,85 @@
 #pragma once
 
 #include <libxml/parser.h>  // for xmlNodePtr
+#include <cstdint>          // for uint32_t, uint64_t
 #include <iosfwd>           // for size_t
+#include <memory>           // for shared_ptr
 #include <string>           // for hash, string
+#include <string_view>      // for string_view
+#include <fmt/format.h>     // for formatter
 #include <nlohmann/json_fwd.hpp>
 
 class Creature;
 
+// An area name stored as its index in a table of the areas the mud has loaded.
+// Comparing one is an integer operation, its hash is worked out once when the
+// name is added, and it still reads like a string everywhere else.  Only the
+// loaders add to the table, and names are never removed, so the references it
+// hands out stay valid for the life of the process.  A name that isn't in the
+// table (a typo in a command, say) carries its own copy instead.
+class AreaName {
+public:
+    static constexpr uint32_t UNKNOWN = UINT32_MAX;
+
+    AreaName() = default;
+    AreaName(std::string_view name);
+    AreaName(const std::string& name) : AreaName(std::string_view(name)) {}
+    AreaName(const char* name) : AreaName(std::string_view(name)) {}
+
+    static uint32_t intern(std::string_view name);
+    static uint32_t find(std::string_view name);
+
+    [[nodiscard]] uint32_t getIndex() const { return(index); }
+    // Of the text, so a name hashes the same before and after its area is loaded
+    [[nodiscard]] size_t hash() const;
+    [[nodiscard]] const std::string& str() const;
+    [[nodiscard]] const char* c_str() const { return(str().c_str()); }
+    [[nodiscard]] bool empty() const { return(index == 0); }
+    [[nodiscard]] size_t length() const { return(str().length()); }
+    [[nodiscard]] size_t size() const { return(str().size()); }
+    char operator[](size_t i) const { return(str()[i]); }
+
+    operator const std::string&() const { return(str()); }
+    operator std::string_view() const { return(str()); }
+
+    bool operator==(const AreaName& o) const {
+        return(index == UNKNOWN || o.index == UNKNOWN ? str() == o.str() : index == o.index);
+    }
+    bool operator!=(const AreaName& o) const { return(!(*this == o)); }
+    bool operator==(std::string_view o) const { return(str() == o); }
+    bool operator!=(std::string_view o) const { return(str() != o); }
+    bool operator==(const std::string& o) const { return(str() == o); }
+    bool operator!=(const std::string& o) const { return(str() != o); }
+    bool operator==(const char* o) const { return(str() == o); }
+    bool operator!=(const char* o) const { return(str() != o); }
+    // Alphabetical, so anything sorted by area stays in the order it always has
+    bool operator<(const AreaName& o) const { return((index != o.index || index == UNKNOWN) && str() < o.str()); }
+
+    friend std::ostream& operator<<(std::ostream& out, const AreaName& name);
+    friend std::string operator+(const std::string& lhs, const AreaName& rhs) { return(lhs + rhs.str()); }
+    friend std::string operator+(const char* lhs, const AreaName& rhs) { return(lhs + rhs.str()); }
+    friend std::string operator+(const AreaName& lhs, const std::string& rhs) { return(lhs.str() + rhs); }
+    friend std::string operator+(const AreaName& lhs, const char* rhs) { return(lhs.str() + rhs); }
+
+private:
+    uint32_t index{};   // 0 is always the empty name
+    std::shared_ptr<const std::string> text;    // Only set when index is UNKNOWN
+};
+
+template <>
+struct fmt::formatter<AreaName> : fmt::formatter<std::string_view> {
+    auto format(const AreaName& name, fmt::format_context& ctx) const {
+        return(fmt::formatter<std::string_view>::format(std::string_view(name.str()), ctx));
+    }
+};
+
 class CatRef {
 public:
     friend std::ostream& operator<<(std::ostream& out, const CatRef& group);
 
     CatRef();
     CatRef(std::string& pArea, short pId);
+    CatRef(const CatRef&) = default;
     void    setDefault(const std::shared_ptr<Creature> & target);
     void    clear();
     void    load(xmlNodePtr curNode);
@@ -44,7 +111,8 @@ class CatRef {
     [[nodiscard]] bool    isArea(std::string_view c) const;
 
     void    setArea(std::string c);
-    std::string area;
+
+    AreaName area;
     short   id{};
 
 public:
@@ -53,15 +121,24 @@ class CatRef {
 };
 
 namespace std {
+    template <> struct hash<AreaName>{
+        size_t operator()(const AreaName &name) const {
+            return name.hash();
+        }
+    };
+
     template <> struct hash<CatRef>{
         size_t operator()(const CatRef &cr ) const {
-            return hash<string>()(cr.str());
+            size_t h = cr.area.hash();
+            return h ^ (hash<short>()(cr.id) + 0x9e3779b9 + (h << 6) + (h >> 2));
         }
     };
 
     template<> struct less<CatRef>{
         bool operator() (const CatRef& lhs, const CatRef& rhs) const {
-            return std::tie(lhs.area, lhs.id) < std::tie(rhs.area, rhs.id);
+            if(lhs.area == rhs.area)
+                return(lhs.id < rhs.id);
+            return(lhs.area < rhs.area);
         }
     };
 };
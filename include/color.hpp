@@ -18,9 +18,13 @@
 
 #pragma once
 
+#include <string>
+#include <string_view>
+
 
 // color.cpp
 std::string stripColor(std::string_view colored);
 std::string escapeColor(std::string_view colored);
 std::string padColor(const std::string &toPad, size_t pad);
 size_t lengthNoColor(std::string_view colored);
+const char* getAnsiColorCode(unsigned char ch);
@@ -0,0 +1,89 @@
+/*
+ * commandTrie.h
+ *   Compiled index of the command tables used to resolve what a player typed
+ *   ____            _
+ *  |  _ \ ___  __ _| |_ __ ___  ___
+ *  | |_) / _ \/ _` | | '_ ` _ \/ __|
+ *  |  _ <  __/ (_| | | | | | | \__ \
+ *  |_| \_\___|\__,_|_|_| |_| |_|___/
+ *
+ * Permission to use, modify and distribute is granted via the
+ *  GNU Affero General Public License v3 or later
+ *
+ *  Copyright (C) 2007-2021 Jason Mitchell, Randi Mitchell
+ *     Contributions by Tim Callahan, Jonathan Hseu
+ *  Based on Mordor (C) Brooke Paul, Brett J. Vickers, John P. Freeman
+ *
+ */
+
+#pragma once
+
+#include <cstdint>
+#include <string>
+#include <string_view>
+#include <utility>
+#include <vector>
+
+class Command;
+
+// Which command tables someone can see; each tier sees everything the ones
+// below it do
+enum class CommandTier : uint8_t {
+    Creature,       // General, skill and social commands
+    Player,         // ...and player commands
+    Staff,          // ...and staff commands
+};
+
+// Every command table compiled into one case insensitive, path compressed
+// trie.  Each node already knows, for every tier, which command an exact match
+// gives and which command wins a partial match (lowest priority, then shortest
+// name), and whether that partial match is a tie, so a lookup is a single walk
+// down the input.
+//
+// Commands must be added in the order the tables are searched; when more than
+// one command has the same name the first one added wins.  Rebuilt whenever a
+// command table changes; the Command pointers belong to Config.
+class CommandTrie {
+public:
+    CommandTrie();
+    void clear();
+    // Visible to tier and everything above it
+    void add(const Command& command, CommandTier tier);
+    // Call once everything has been added, before any lookups
+    void compile();
+
+    // ret is set to 0, CMD_NOT_FOUND or CMD_NOT_UNIQUE
+    [[nodiscard]] const Command* find(std::string_view str, CommandTier tier, int& ret) const;
+
+private:
+    static constexpr uint32_t NONE = UINT32_MAX;
+    static constexpr int TIERS = 3;
+
+    struct Match {
+        const Command* exact = nullptr;     // Name is exactly this prefix
+        const Command* best = nullptr;      // Best partial match for this prefix
+        uint32_t ties = 0;                  // Commands as good as best, including it
+    };
+
+    // Uncompressed, one character per node, while commands are being added
+    struct BuildNode {
+        std::vector<std::pair<char, uint32_t>> next;
+        Match match[TIERS];
+        bool terminal = false;              // Some command's name ends here
+    };
+
+    struct Node {
+        uint32_t labelStart = 0;            // Edge leading into this node, in labels
+        uint32_t labelLength = 0;
+        uint32_t firstChild = 0;            // Children are stored next to each other in nodes
+        uint32_t childCount = 0;
+        Match match[TIERS];
+    };
+
+    [[nodiscard]] uint32_t child(uint32_t node, char c) const;
+    static void offer(Match& match, const Command& command);
+
+    std::vector<BuildNode> building;
+    std::vector<Node> nodes;
+    std::string labels;
+};
@@ -25,6 +25,8 @@
 #include <vector>
 #include <cstring>  // strcasecmp
 
+#include "banMatcher.hpp"
+#include "commandTrie.hpp"
 #include "global.hpp"
 #include "money.hpp"
 #include "msdp.hpp"
@@ -190,6 +192,7 @@ class Config {
 // Commands
     bool initCommands();
     void clearCommands();
+    void rebuildCommandIndex();
 
 // Socials
     bool loadSocials();
@@ -231,6 +234,7 @@ class Config {
     bool deleteBan(int toDel);
     bool isBanned(std::string_view site);
     int isLockedOut(const std::shared_ptr<Socket>& sock);
+    void expireBans();
 
 
 // Guilds
@@ -253,6 +257,7 @@ class Config {
     bool loadBans();
     bool saveBans() const;
     void clearBanList();
+    void rebuildBanIndex();
 
 // Guilds
     bool loadGuilds();
@@ -502,6 +507,9 @@ class Config {
     short   minBroadcastLevel{};
     bool    saveOnDrop{};
     bool    logDeath{};
+    bool    logJson{};          // Write staff logs as JSON lines
+    int     logRotateSize{};    // Rotate staff logs at this many MB, 0 for never
+    int     logRotateDays{};    // ...or once they've been open this many days
     short   crashes{};
     short   supportRequiredForGuild{};
     int     numGuilds{};
@@ -597,6 +605,7 @@ class Config {
 
     // Bans
     std::list<Ban*> bans;
+    BanMatcher banIndex; // Rebuilt whenever bans changes
 
     // Effects
     EffectMap effects;
@@ -605,6 +614,7 @@ class Config {
     PlyCommandSet staffCommands;
     PlyCommandSet playerCommands;
     CrtCommandSet generalCommands;
+    CommandTrie commandIndex; // Rebuilt whenever a command table changes
 
     SpellSet spells;
     SongSet songs;
@@ -0,0 +1,258 @@
+/*
+ * containerSet.h
+ *   The sorted sets containers keep their players, monsters and objects in
+ *   ____            _
+ *  |  _ \ ___  __ _| |_ __ ___  ___
+ *  | |_) / _ \/ _` | | '_ ` _ \/ __|
+ *  |  _ <  __/ (_| | | | | | | \__ \
+ *  |_| \_\___|\__,_|_|_| |_| |_|___/
+ *
+ * Permission to use, modify and distribute is granted via the
+ *  GNU Affero General Public License v3 or later
+ *
+ *  Copyright (C) 2007-2021 Jason Mitchell, Randi Mitchell
+ *     Contributions by Tim Callahan, Jonathan Hseu
+ *  Based on Mordor (C) Brooke Paul, Brett J. Vickers, John P. Freeman
+ *
+ */
+
+#pragma once
+
+#include <algorithm>
+#include <cstddef>
+#include <cstdint>
+#include <iterator>
+#include <memory>
+#include <string>
+#include <type_traits>
+#include <utility>
+#include <vector>
+
+// A set kept as a vector sorted by the key each element caches for itself
+// (see Containable::refreshSortKey).  Comparing two entries is usually just
+// comparing the first eight bytes of their keys, which the entries carry, so
+// nothing builds strings or locks pointers, and once the vector has grown to
+// fit a room, adding, removing and walking it never allocate.
+//
+// Iterators behave like std::set's: they stay on their element while others
+// are added or removed, so "obj = *it++; remove obj" loops keep working.
+// Dereferencing hands back a copy of the pointer, so a loop variable can't
+// end up on a different element when the vector shifts under it.
+template<class Ptr>
+class ContainerSet {
+public:
+    using value_type = Ptr;
+    using size_type = size_t;
+    using element_type = typename Ptr::element_type;
+
+    class iterator {
+    public:
+        using iterator_category = std::forward_iterator_tag;
+        using value_type = Ptr;
+        using difference_type = std::ptrdiff_t;
+        using pointer = const Ptr*;
+        using reference = Ptr;
+
+        iterator() = default;
+
+        Ptr operator*() const { return(set->entries[resolve()].ptr); }
+        const Ptr* operator->() const { return(&set->entries[resolve()].ptr); }
+        iterator& operator++() {
+            pos = resolve();
+            if(ahead)
+                ahead = false;
+            else if(pos < set->entries.size())
+                pos++;
+            key = pos < set->entries.size() ? set->entries[pos].key : nullptr;
+            return(*this);
+        }
+        iterator operator++(int) {
+            iterator old = *this;
+            ++*this;
+            return(old);
+        }
+        bool operator==(const iterator& other) const {
+            if(!set || !other.set)
+                return(set == other.set);
+            return(resolve() == other.resolve());
+        }
+
+    private:
+        friend class ContainerSet;
+        iterator(const ContainerSet* pSet, size_t pPos): set(pSet), pos(pPos), version(pSet->version) {
+            key = pos < set->entries.size() ? set->entries[pos].key : nullptr;
+        }
+
+        // Find our element again if the set has changed since we last looked.
+        // Keys are only compared by address here, never read, so this is safe
+        // even if the element we were on has since been destroyed.
+        size_t resolve() const {
+            if(version == set->version)
+                return(pos);
+            version = set->version;
+
+            const auto& entries = set->entries;
+            if(!key)
+                return(pos = entries.size());
+            if(pos < entries.size() && entries[pos].key == key)
+                return(pos);
+            if(pos > 0 && pos - 1 < entries.size() && entries[pos - 1].key == key)
+                return(--pos);
+            if(pos + 1 < entries.size() && entries[pos + 1].key == key)
+                return(++pos);
+            for(size_t i = 0; i < entries.size(); i++) {
+                if(entries[i].key == key)
+                    return(pos = i);
+            }
+
+            // Our element was removed; we're now on whatever took its place,
+            // which the next ++ mustn't skip
+            if(key == set->erasedKey)
+                pos = set->erasedPos;
+            pos = std::min(pos, entries.size());
+            ahead = true;
+            key = pos < entries.size() ? entries[pos].key : nullptr;
+            return(pos);
+        }
+
+        const ContainerSet* set = nullptr;
+        mutable size_t pos = 0;
+        mutable uint32_t version = 0;
+        mutable const std::string* key = nullptr;   // The element we're on, or null at the end
+        mutable bool ahead = false;
+    };
+    using const_iterator = iterator;
+
+    ContainerSet() = default;
+    ContainerSet(const ContainerSet&) = default;
+    ContainerSet& operator=(const ContainerSet& other) {
+        entries = other.entries;
+        changed(nullptr, 0);
+        return(*this);
+    }
+
+    // Like std::set, refuses anything that sorts the same as something already here
+    std::pair<iterator, bool> insert(const Ptr& ptr) {
+        const std::string* key = nullptr;
+        if constexpr(WEAK) {
+            if(auto locked = ptr.lock())
+                key = locked->refreshSortKey();
+        } else if(ptr) {
+            key = ptr->refreshSortKey();
+        }
+        if(!key)
+            return(std::make_pair(end(), false));
+
+        uint64_t prefix = prefixOf(*key);
+        size_t pos = lowerBound(prefix, *key);
+        if(pos < entries.size() && compare(entries[pos], prefix, key) == 0)
+            return(std::make_pair(iterator(this, pos), false));
+
+        entries.insert(entries.begin() + pos, Entry{prefix, key, ptr});
+        changed(nullptr, 0);
+        return(std::make_pair(iterator(this, pos), true));
+    }
+
+    iterator erase(iterator it) {
+        size_t pos = it.resolve();
+        if(pos >= entries.size())
+            return(end());
+        return(eraseAt(pos));
+    }
+
+    // Remove this element, found by its key and then by address
+    size_t erase(const element_type* elem) {
+        if(!elem)
+            return(0);
+        if(const std::string* key = elem->getSortKey()) {
+            uint64_t prefix = prefixOf(*key);
+            for(size_t pos = lowerBound(prefix, *key); pos < entries.size() && compare(entries[pos], prefix, key) == 0; pos++) {
+                if(raw(entries[pos].ptr) == elem) {
+                    eraseAt(pos);
+                    return(1);
+                }
+            }
+        }
+        // Its key has changed since it was added; look for it the slow way
+        for(size_t pos = 0; pos < entries.size(); pos++) {
+            if(raw(entries[pos].ptr) == elem) {
+                eraseAt(pos);
+                return(1);
+            }
+        }
+        return(0);
+    }
+
+    // Keeps the storage, so refilling doesn't allocate
+    void clear() {
+        entries.clear();
+        changed(nullptr, 0);
+    }
+
+    [[nodiscard]] bool empty() const { return(entries.empty()); }
+    [[nodiscard]] size_t size() const { return(entries.size()); }
+    [[nodiscard]] iterator begin() const { return(iterator(this, 0)); }
+    [[nodiscard]] iterator end() const { return(iterator(this, entries.size())); }
+
+private:
+    static constexpr bool WEAK = std::is_same_v<Ptr, std::weak_ptr<element_type>>;
+
+    struct Entry {
+        uint64_t prefix;            // The first eight bytes of the key, big end first
+        const std::string* key;     // Owned by the element, or interned for players
+        Ptr ptr;
+    };
+
+    static uint64_t prefixOf(const std::string& key) {
+        uint64_t prefix = 0;
+        for(size_t i = 0; i < sizeof(prefix); i++) {
+            prefix <<= 8;
+            if(i < key.size())
+                prefix |= (unsigned char)key[i];
+        }
+        return(prefix);
+    }
+
+    // Orders the same as comparing the keys themselves
+    static int compare(const Entry& entry, uint64_t prefix, const std::string* key) {
+        if(entry.prefix != prefix)
+            return(entry.prefix < prefix ? -1 : 1);
+        if(entry.key == key)
+            return(0);
+        return(entry.key->compare(*key));
+    }
+
+    size_t lowerBound(uint64_t prefix, const std::string& key) const {
+        auto it = std::lower_bound(entries.begin(), entries.end(), key, [prefix](const Entry& entry, const std::string& k) {
+            return(compare(entry, prefix, &k) < 0);
+        });
+        return(it - entries.begin());
+    }
+
+    static const element_type* raw(const Ptr& ptr) {
+        if constexpr(WEAK)
+            return(ptr.lock().get());
+        else
+            return(ptr.get());
+    }
+
+    iterator eraseAt(size_t pos) {
+        // Out of the set before it's released, in case that looks at the set
+        Ptr doomed = std::move(entries[pos].ptr);
+        const std::string* key = entries[pos].key;
+        entries.erase(entries.begin() + pos);
+        changed(key, pos);
+        return(iterator(this, pos));
+    }
+
+    void changed(const std::string* key, size_t pos) {
+        version++;
+        erasedKey = key;
+        erasedPos = pos;
+    }
+
+    std::vector<Entry> entries;
+    uint32_t version = 0;
+    const std::string* erasedKey = nullptr;    // What was last removed and where, so
+    size_t erasedPos = 0;                      // iterators left on it know where to go
+};
@@ -0,0 +1,68 @@
+/*
+ * cow.h
+ *   Copy on write handle for data shared between a prototype and its copies
+ *   ____            _
+ *  |  _ \ ___  __ _| |_ __ ___  ___
+ *  | |_) / _ \/ _` | | '_ ` _ \/ __|
+ *  |  _ <  __/ (_| | | | | | | \__ \
+ *  |_| \_\___|\__,_|_|_| |_| |_|___/
+ *
+ * Permission to use, modify and distribute is granted via the
+ *  GNU Affero General Public License v3 or later
+ *
+ *  Copyright (C) 2007-2021 Jason Mitchell, Randi Mitchell
+ *     Contributions by Tim Callahan, Jonathan Hseu
+ *  Based on Mordor (C) Brooke Paul, Brett J. Vickers, John P. Freeman
+ *
+ */
+
+#pragma once
+
+#include <memory>
+#include <utility>
+
+// Monsters and objects are spawned by copying the prototype out of the cache,
+// and most of what gets copied (descriptions, hooks, talk) is never changed
+// afterwards.  A Cow shares the value between every copy and only makes a
+// private one the first time somebody asks to change it with edit().
+template <class T>
+class Cow {
+public:
+    Cow() = default;
+    Cow(const T& value) : ptr(std::make_shared<T>(value)) {}
+    Cow(T&& value) : ptr(std::make_shared<T>(std::move(value))) {}
+
+    Cow& operator=(const T& value) {
+        ptr = std::make_shared<T>(value);
+        return(*this);
+    }
+    Cow& operator=(T&& value) {
+        ptr = std::make_shared<T>(std::move(value));
+        return(*this);
+    }
+
+    [[nodiscard]] const T& get() const { return(ptr ? *ptr : empty()); }
+    const T& operator*() const { return(get()); }
+    const T* operator->() const { return(&get()); }
+    operator const T&() const { return(get()); }
+
+    // Anything that changes the value must go through here
+    T& edit() {
+        if(!ptr)
+            ptr = std::make_shared<T>();
+        else if(ptr.use_count() > 1)
+            ptr = std::make_shared<T>(*ptr);
+        return(*ptr);
+    }
+
+    void reset() { ptr.reset(); }
+    [[nodiscard]] bool isShared() const { return(ptr && ptr.use_count() > 1); }
+
+private:
+    static const T& empty() {
+        static const T value{};
+        return(value);
+    }
+
+    std::shared_ptr<T> ptr;
+};
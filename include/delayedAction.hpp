@@ -18,7 +18,10 @@
 
 #pragma once
 
+#include <list>
+
 #include "cmd.hpp"
+#include "timerWheel.hpp"
 
 class MudObject;
 
@@ -43,6 +46,7 @@ struct DelayedAction {
     bool canInterrupt;
     cmd cmnd;
     std::string script;
+    TimerHandle timer{};
 
     DelayedAction(void (*callback)(DelayedActionFn), std::weak_ptr<MudObject> target, cmd* cmnd, DelayedActionType type, long whenFinished, bool canInterrupt) {
         this->callback = callback;
@@ -64,3 +68,8 @@ struct DelayedAction {
         this->script = script;
     }
 };
+
+// The server owns the actions; their targets keep iterators into this list so
+// an action can be cancelled without searching for it
+typedef std::list<DelayedAction> DelayedActionQueue;
+typedef DelayedActionQueue::iterator DelayedActionRef;
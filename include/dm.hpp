@@ -59,6 +59,10 @@ int dmSetRecipe(const std::shared_ptr<Player>& player, cmd* cmnd);
 
 // memory.c
 int dmMemory(const std::shared_ptr<Player>& player, cmd* cmnd);
+int dmCacheStats(const std::shared_ptr<Player>& player, cmd* cmnd);
+
+// pythonHandler.cpp
+int dmScriptStats(const std::shared_ptr<Player>& player, cmd* cmnd);
 
 int dmGag(const std::shared_ptr<Player>& player, cmd* cmnd);
 
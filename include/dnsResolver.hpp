@@ -0,0 +1,84 @@
+/*
+ * dnsResolver.h
+ *   Pool of threads doing reverse DNS lookups for new connections
+ *   ____            _
+ *  |  _ \ ___  __ _| |_ __ ___  ___
+ *  | |_) / _ \/ _` | | '_ ` _ \/ __|
+ *  |  _ <  __/ (_| | | | | | | \__ \
+ *  |_| \_\___|\__,_|_|_| |_| |_|___/
+ *
+ * Permission to use, modify and distribute is granted via the
+ *  GNU Affero General Public License v3 or later
+ *
+ *  Copyright (C) 2007-2021 Jason Mitchell, Randi Mitchell
+ *     Contributions by Tim Callahan, Jonathan Hseu
+ *  Based on Mordor (C) Brooke Paul, Brett J. Vickers, John P. Freeman
+ *
+ */
+
+#pragma once
+
+#include <netinet/in.h>         // for sockaddr_in
+#include <atomic>
+#include <condition_variable>
+#include <deque>
+#include <mutex>
+#include <string>
+#include <string_view>
+#include <thread>
+#include <unordered_set>
+#include <vector>
+
+// Number of resolver threads; getnameinfo can block for seconds on a bad
+// nameserver, so a few lookups are allowed to be stuck at once
+const int DNS_RESOLVER_THREADS = 4;
+
+// Lookups are handed to a small pool of threads instead of a forked child each.
+// Finished lookups are pushed onto a lock free list that the main loop empties
+// once a pass.  Only one lookup per ip is ever in flight, however many
+// connections it opens.
+//
+// lookup() and takeResults() belong to the main thread.
+class DnsResolver {
+public:
+    struct Result {
+        std::string ip;
+        std::string hostName;   // The ip again if the lookup failed
+        bool found = false;
+    };
+
+    DnsResolver();
+    ~DnsResolver();
+    DnsResolver(const DnsResolver&) = delete;
+    DnsResolver& operator=(const DnsResolver&) = delete;
+
+    // Returns false if a lookup for this ip is already running
+    bool lookup(const sockaddr_in& addr, std::string_view ip);
+    // Everything finished since the last call, oldest first
+    std::vector<Result> takeResults();
+    [[nodiscard]] size_t getInFlight() const;
+    void stop();
+
+private:
+    struct Request {
+        sockaddr_in addr;
+        std::string ip;
+    };
+    struct Node {
+        Result result;
+        Node* next = nullptr;
+    };
+
+    void run();
+    static Result resolve(const Request& request);
+    void complete(Result&& result);
+
+    std::mutex lock;
+    std::condition_variable wake;
+    std::deque<Request> requests;
+    std::vector<std::thread> workers;
+    bool stopping = false;
+
+    std::atomic<Node*> finished{nullptr};       // Pushed by the workers, newest first
+    std::unordered_set<std::string> inFlight;   // Main thread only
+};
@@ -21,9 +21,12 @@
 #define EFFECT_MAX_DURATION 10800
 #define EFFECT_MAX_STRENGTH 5000
 
+#include <bitset>
+#include <cstdint>
 #include <iostream>
 #include <list>
 #include <memory>
+#include <string_view>
 
 #include "json.hpp"
 
@@ -35,6 +38,14 @@ typedef xmlNode *xmlNodePtr;
 class MudObject;
 class EffectBuilder;
 
+// Effect and base effect names are interned to small dense ids when the effects
+// are loaded, so checking what something is effected by is a bit test rather
+// than a string compare against every effect it has.
+typedef uint16_t EffectId;
+constexpr EffectId NO_EFFECT_ID = 0xffff;
+constexpr size_t MAX_EFFECT_IDS = 256;
+typedef std::bitset<MAX_EFFECT_IDS> EffectMask;
+
 class Effect {
 private:
     std::string name;
@@ -67,6 +78,10 @@ class Effect {
     float potionMultiplyer{}; // Multiplier of duration for potion
     int magicRoomBonus{};     // Bonus in +magic room
 
+    EffectId id = NO_EFFECT_ID;
+    EffectMask confers;       // This effect's id plus the ids of its base effects
+    bool indexed{};           // False if any of those names didn't fit in an EffectMask
+
 private:
     Effect() = default;
 
@@ -88,6 +103,9 @@ class Effect {
     [[nodiscard]] const std::string & getDisplay() const;
     [[nodiscard]] const std::string & getName() const;
     [[nodiscard]] bool hasBaseEffect(std::string_view effect) const;
+    [[nodiscard]] EffectId getId() const;
+    [[nodiscard]] const EffectMask& getConfers() const;
+    [[nodiscard]] bool isIndexed() const;
     [[nodiscard]] int getPulseDelay() const;
     [[nodiscard]] bool isPulsed() const;
     [[nodiscard]] bool isSpell() const;
@@ -97,6 +115,13 @@ class Effect {
     const std::list<std::string> &getBaseEffects();
     static bool objectCanBestowEffect(std::string_view effect);
 
+    // Gives this effect and its base effects their ids; done as it's loaded
+    void index();
+    // Ids never change once handed out, so they can be looked up once and kept
+    static EffectId intern(std::string_view name);
+    static EffectId lookupId(std::string_view name);
+    static const std::string& getIdName(EffectId effect);
+
     Effect(const Effect&) = delete;  // No Copies
     Effect(Effect&&) = default;      // Only Moves
 
@@ -209,7 +234,8 @@ class EffectInfo {
 typedef std::list<EffectInfo *> EffectList;
 
 // this class holds effect information and makes effects portable
-// across multiple objects
+// across multiple objects.  Anything that changes effectList must call
+// reindex() afterwards.
 class Effects {
 public:
     friend void to_json(nlohmann::json &j, const Effects &e);
@@ -223,6 +249,7 @@ class Effects {
     [[nodiscard]] EffectInfo *getExactEffect(std::string_view effect) const;
 
     [[nodiscard]] bool isEffected(const std::string &effect, bool exactMatch = false) const;
+    [[nodiscard]] bool isEffected(EffectId effect, bool exactMatch = false) const;
     [[nodiscard]] bool isEffected(EffectInfo *effect) const;
 
     //EffectInfo* addEffect(std::string_view effect, std::shared_ptr<MudObject> applier, bool show, std::shared_ptr<MudObject> pParent=0, const std::shared_ptr<Creature> & onwer=0, bool keepApplier=false);
@@ -246,6 +273,12 @@ class Effects {
     [[nodiscard]] std::string getEffectsList() const;
 
     void pulse(time_t t, const std::shared_ptr<MudObject>&pParent = nullptr);
+    void reindex();
 
     EffectList effectList;
+
+private:
+    EffectMask named;       // Ids of the effects in effectList
+    EffectMask conferred;   // Those plus their base effects
+    bool unindexed{};       // Something in effectList has no id; fall back to comparing names
 };
@@ -18,6 +18,8 @@
 
 #pragma once
 
+#include <cstddef>
+
 #include "enums/bits.hpp"
 
 #define MAX_DIMEN_ANCHORS   5
@@ -78,9 +80,9 @@ const int MMAX = 20000;
 const int OMAX = 20000;
 const int PMAX = 1024;
 
-const int RQMAX = 600;  // Max number of these allowed in memory
-const int MQMAX = 200;  // at any one time
-const int OQMAX = 200;
+const int MQMAX = 200;  // Max number of these allowed in memory
+const int OQMAX = 200;  // at any one time
+const size_t RQMAX_BYTES = 2UL * 1024 * 1024 * 1024; // Rooms are held to a memory budget instead
 
 
 
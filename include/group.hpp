@@ -117,6 +117,7 @@ class Group {
     void sendToAll(std::string_view msg, const std::shared_ptr<Creature>& ignore = nullptr, bool sendToInvited = false, bool gtargetChange=false);
 
     [[nodiscard]] std::string getMsdp(const std::shared_ptr<Creature>& viewer) const;
+    void publishMsdp();
 
 public:
     CreatureList members;
@@ -21,14 +21,18 @@
 #include <libxml/parser.h>  // for xmlNodePtr
 #include <map>
 #include <set>
+#include "cow.hpp"
 #include "json.hpp"
 
 class MudObject;
 class Swap;
 
+template<class Ptr> class ContainerSet;
+
 class Hooks {
 private:
-    std::map<std::string,std::string> hooks;
+    // Shared with the prototype until one of them adds a hook
+    Cow<std::map<std::string,std::string>> hooks;
     MudObject* parent{};
 
 public:
@@ -50,10 +54,10 @@ class Hooks {
 
     static bool run(const std::shared_ptr<MudObject>& trigger1, const std::string &event1, const std::shared_ptr<MudObject>& trigger2, const std::string &event2, const std::string &param1="", const std::string &param2="", const std::string &param3="");
 
-    template<class Type, class Compare>
-    inline static bool run(std::set<Type, Compare>& set, std::shared_ptr<MudObject> trigger, const std::string &event, const std::string &param1= "", const std::string &param2= "", const std::string &param3= "") {
+    template<class Ptr>
+    inline static bool run(ContainerSet<Ptr>& set, std::shared_ptr<MudObject> trigger, const std::string &event, const std::string &param1= "", const std::string &param2= "", const std::string &param3= "") {
         bool ran=false;
-        for(Type crt : set) {
+        for(Ptr crt : set) {
             if(crt != trigger) {
                 if(crt->hooks.execute(event, trigger, param1, param2, param3))
                     ran = true;
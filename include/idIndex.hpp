@@ -0,0 +1,73 @@
+/*
+ * idIndex.h
+ *   Hashed index of registered MudObject IDs
+ *   ____            _
+ *  |  _ \ ___  __ _| |_ __ ___  ___
+ *  | |_) / _ \/ _` | | '_ ` _ \/ __|
+ *  |  _ <  __/ (_| | | | | | | \__ \
+ *  |_| \_\___|\__,_|_|_| |_| |_|___/
+ *
+ * Permission to use, modify and distribute is granted via the
+ *  GNU Affero General Public License v3 or later
+ *
+ *  Copyright (C) 2007-2021 Jason Mitchell, Randi Mitchell
+ *     Contributions by Tim Callahan, Jonathan Hseu
+ *  Based on Mordor (C) Brooke Paul, Brett J. Vickers, John P. Freeman
+ *
+ */
+
+#pragma once
+
+#include <cstdint>
+#include <memory>
+#include <string>
+#include <string_view>
+#include <unordered_map>
+#include <utility>
+#include <vector>
+
+class MudObject;
+
+// A monster, object or player id ("M123") split into its kind and counter
+struct MudId {
+    char kind{};
+    uint64_t num{};
+
+    // False for anything that isn't a kind letter followed by digits, such as room ids
+    static bool parse(std::string_view id, MudId& out);
+    bool operator==(const MudId& o) const { return(kind == o.kind && num == o.num); }
+    bool operator<(const MudId& o) const { return(kind != o.kind ? kind < o.kind : num < o.num); }
+};
+
+// Maps registered ids to their objects.  Numeric ids live in an open addressing
+// table keyed by MudId so registering, unregistering and looking up an id never
+// has to compare strings; room ids ("Rmisc.1") aren't numeric and go in a plain
+// string map alongside it.
+class IdIndex {
+public:
+    IdIndex();
+
+    bool insert(std::string_view id, const std::weak_ptr<MudObject>& mo);
+    std::weak_ptr<MudObject>* find(std::string_view id);
+    bool erase(std::string_view id);
+    [[nodiscard]] size_t size() const;
+
+    // Sorted by kind, then by number (or name for rooms); only built when someone asks
+    [[nodiscard]] std::vector<std::pair<std::string, std::weak_ptr<MudObject>>> ordered() const;
+
+private:
+    enum class SlotState : uint8_t { EMPTY, USED, DELETED };
+    struct Slot {
+        MudId id;
+        SlotState state = SlotState::EMPTY;
+        std::weak_ptr<MudObject> mo;
+    };
+
+    Slot* findSlot(const MudId& id);
+    void grow();
+
+    std::vector<Slot> slots;
+    size_t used;        // Slots holding an id
+    size_t deleted;     // Tombstones; they count against the load factor until the next rehash
+    std::unordered_map<std::string, std::weak_ptr<MudObject>> named;
+};
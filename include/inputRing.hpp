@@ -0,0 +1,103 @@
+/*
+ * inputRing.h
+ *   Per socket buffer that input is read into and split into lines
+ *   ____            _
+ *  |  _ \ ___  __ _| |_ __ ___  ___
+ *  | |_) / _ \/ _` | | '_ ` _ \/ __|
+ *  |  _ <  __/ (_| | | | | | | \__ \
+ *  |_| \_\___|\__,_|_|_| |_| |_|___/
+ *
+ * Permission to use, modify and distribute is granted via the
+ *  GNU Affero General Public License v3 or later
+ *
+ *  Copyright (C) 2007-2021 Jason Mitchell, Randi Mitchell
+ *     Contributions by Tim Callahan, Jonathan Hseu
+ *  Based on Mordor (C) Brooke Paul, Brett J. Vickers, John P. Freeman
+ *
+ */
+
+#pragma once
+
+#include <algorithm>
+#include <array>
+#include <atomic>
+#include <cstdint>
+#include <memory>
+#include <string_view>
+
+// A fixed size buffer the network thread reads straight into.  Telnet
+// sequences, line endings and backspaces are squeezed out in place as the
+// bytes are scanned, and each finished line is handed to the game thread as
+// an offset and length into the buffer, so a line is never copied until the
+// game takes it.  Once the buffer or the line queue is full the network
+// thread stops reading until the game has caught up.
+//
+// Lines are never split across the end of the buffer: when there's too
+// little room left, the partial line is moved to the front and reading
+// carries on there.
+class InputRing {
+public:
+    static constexpr size_t SIZE = 16384;       // Most input a socket can have waiting
+    static constexpr size_t MAX_LINE = 4096;    // Anything past this on one line is dropped
+    static constexpr size_t MAX_LINES = 64;     // Most commands a socket can have waiting
+    static constexpr size_t MIN_READ = 1024;    // Wrap around rather than read less than this
+
+    InputRing();
+    InputRing(const InputRing&) = delete;
+    InputRing& operator=(const InputRing&) = delete;
+
+    // Network thread
+
+    // Contiguous space to read into; n is only 0 while the buffer is full of
+    // lines the game hasn't taken
+    char* readSpace(size_t& n);
+    void commitRead(size_t n);
+
+    [[nodiscard]] bool hasRaw() const { return(raw < rawEnd); }
+    unsigned char nextRaw() { return(data[raw++]); }
+
+    // Output never catches up to raw, since each byte read adds at most one byte to the line
+    bool put(char ch) {
+        if(out - lineStart >= MAX_LINE)
+            return(false);
+        data[out++] = ch;
+        return(true);
+    }
+    void backspace() {
+        if(out > lineStart)
+            out--;
+    }
+    void unput(size_t n) {
+        out -= std::min(n, out - lineStart);
+    }
+    // Check linesFull() first
+    void endLine();
+    bool linesFull();
+
+    // Game thread
+
+    [[nodiscard]] bool empty() const;
+    [[nodiscard]] std::string_view front() const;
+    void pop();
+
+private:
+    struct Line {
+        uint32_t offset;
+        uint32_t length;
+    };
+
+    size_t oldest() const;
+
+    std::unique_ptr<char[]> data;
+    std::array<Line, MAX_LINES> lines{};
+    alignas(64) std::atomic<size_t> pushed{0};
+    alignas(64) std::atomic<size_t> popped{0};
+
+    // Everything below belongs to the network thread
+    alignas(64) size_t lineStart = 0;   // Start of the line being framed
+    size_t out = 0;                     // End of the line being framed
+    size_t raw = 0;                     // Next byte to scan
+    size_t rawEnd = 0;                  // End of what's been read
+    size_t pushedCount = 0;
+    size_t poppedSeen = 0;
+};
@@ -0,0 +1,174 @@
+/*
+ * keyTxt.h
+ *   Precomputed keyword forms used to match what players type
+ *   ____            _
+ *  |  _ \ ___  __ _| |_ __ ___  ___
+ *  | |_) / _ \/ _` | | '_ ` _ \/ __|
+ *  |  _ <  __/ (_| | | | | | | \__ \
+ *  |_| \_\___|\__,_|_|_| |_| |_|___/
+ *
+ * Permission to use, modify and distribute is granted via the
+ *  GNU Affero General Public License v3 or later
+ *
+ *  Copyright (C) 2007-2021 Jason Mitchell, Randi Mitchell
+ *     Contributions by Tim Callahan, Jonathan Hseu
+ *  Based on Mordor (C) Brooke Paul, Brett J. Vickers, John P. Freeman
+ *
+ */
+
+#pragma once
+
+#include <array>
+#include <cstdint>
+#include <memory>
+#include <string>
+#include <string_view>
+#include <vector>
+
+// What the player typed, normalized once per lookup rather than once per
+// comparison
+class KeyTxtQuery {
+public:
+    explicit KeyTxtQuery(std::string_view pRaw, bool pExact = false);
+
+    std::string_view raw;   // As typed; ids and exact names are matched against this
+    std::string text;       // Colour stripped, accents folded, lower case
+    bool exact;             // Only ids and whole names match; the index can't help
+};
+
+// The normalized forms of a creature's or object's three keywords and name,
+// built the first time they're needed and thrown away by refreshKeyTxt()
+// whenever the keywords or name change.  A query matches if it's a prefix of
+// any of them, which is what running keyTxtCompare on each works out to
+// (except that colour codes trailing the query no longer spoil a match).
+class KeyTxt {
+public:
+    static constexpr int FORMS = 4;
+
+    void set(const char* key0, const char* key1, const char* key2, std::string_view name, bool pLabeled = false);
+    void invalidate() { stale = true; }
+    [[nodiscard]] bool isStale() const { return(stale); }
+
+    [[nodiscard]] std::string_view form(int i) const;
+    [[nodiscard]] bool matches(const KeyTxtQuery& query) const;
+    // Has a label some player may match on, so is always worth checking
+    [[nodiscard]] bool isLabeled() const { return(labeled); }
+
+    // Keys may hold &#NNN; entities, which are decoded; queries can't
+    static void normalizeKey(std::string_view key, std::string& out);
+    static void normalizeText(std::string_view txt, std::string& out);
+
+private:
+    std::string forms;                  // All four, back to back
+    std::array<uint32_t, FORMS> ends{};
+    bool labeled = false;
+    bool stale = true;
+};
+
+// A sorted index over the keyword forms of a set, by position in set order.
+// Looking up a query finds every position whose forms it prefixes (plus ids
+// it equals and anything labeled) with a binary search, so only those
+// elements get the full match checks.
+class KeyTxtIndex {
+public:
+    void clear();
+    void add(uint32_t pos, const KeyTxt& keyTxt, std::string_view id);
+    void finish(size_t pSize);
+
+    [[nodiscard]] bool isBuilt() const { return(valid); }
+    [[nodiscard]] bool isValid(size_t setSize) const { return(valid && setSize == size); }
+    void invalidate() { valid = false; }
+
+    // Candidate positions, in set order
+    void lookup(const KeyTxtQuery& query, std::vector<uint32_t>& positions) const;
+
+private:
+    struct Entry {
+        uint32_t offset;
+        uint32_t length;
+        uint32_t pos;
+    };
+
+    [[nodiscard]] std::string_view text(const Entry& entry) const;
+    uint32_t store(std::string_view str);
+
+    std::string arena;
+    std::vector<Entry> forms;
+    std::vector<Entry> ids;
+    std::vector<uint32_t> labeled;
+    size_t size = 0;
+    bool valid = false;
+};
+
+// The index for one of a container's sets, only built once the set is big
+// enough for it to beat a straight scan.  Containers throw it away whenever
+// they add or remove something; sets changed behind their back are caught by
+// the size changing.  Only weak pointers are kept, so it never keeps anything
+// alive, and it's never copied along with the container it belongs to.
+template<class Type>
+class KeyTxtSetIndex {
+public:
+    static constexpr size_t MIN_SIZE = 16;
+
+    KeyTxtSetIndex() = default;
+    KeyTxtSetIndex(const KeyTxtSetIndex&) {}
+    KeyTxtSetIndex& operator=(const KeyTxtSetIndex&) {
+        data.reset();
+        return(*this);
+    }
+
+    void invalidate() {
+        if(data && data->index.isBuilt()) {
+            data->index.invalidate();
+            data->elements.clear();
+        }
+    }
+
+    // Calls test on every element of the set the query could match, in set
+    // order, and returns the first one it accepts
+    template<class Set, class Test>
+    std::shared_ptr<Type> find(const Set& set, const KeyTxtQuery& query, Test&& test) {
+        if(query.exact || set.size() < MIN_SIZE) {
+            for(const auto& elem : set) {
+                if(test(elem))
+                    return(elem);
+            }
+            return(nullptr);
+        }
+
+        if(!data)
+            data = std::make_unique<Data>();
+        if(!data->index.isValid(set.size()))
+            build(set);
+
+        data->index.lookup(query, data->positions);
+        for(uint32_t pos : data->positions) {
+            // Stop if a test changed the set out from under us
+            if(pos >= data->elements.size())
+                break;
+            std::shared_ptr<Type> elem = data->elements[pos].lock();
+            if(elem && test(elem))
+                return(elem);
+        }
+        return(nullptr);
+    }
+
+private:
+    template<class Set>
+    void build(const Set& set) {
+        data->index.clear();
+        data->elements.clear();
+        for(const auto& elem : set) {
+            data->index.add((uint32_t)data->elements.size(), elem->getKeyTxt(), elem->getId());
+            data->elements.push_back(elem);
+        }
+        data->index.finish(set.size());
+    }
+
+    struct Data {
+        KeyTxtIndex index;
+        std::vector<std::weak_ptr<Type>> elements;
+        std::vector<uint32_t> positions;
+    };
+    std::unique_ptr<Data> data;
+};
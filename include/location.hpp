@@ -36,6 +36,7 @@ class Location {
     bool    operator==(const Location& l) const;
     bool    operator!=(const Location& l) const;
     std::shared_ptr<BaseRoom> loadRoom(const std::shared_ptr<Player>& player=nullptr) const;
+    [[nodiscard]] std::shared_ptr<BaseRoom> findRoom() const;
     [[nodiscard]] short getId() const;
 
     CatRef room;
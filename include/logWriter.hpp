@@ -0,0 +1,119 @@
+/*
+ * logWriter.h
+ *   Background writer for log files
+ *   ____            _
+ *  |  _ \ ___  __ _| |_ __ ___  ___
+ *  | |_) / _ \/ _` | | '_ ` _ \/ __|
+ *  |  _ <  __/ (_| | | | | | | \__ \
+ *  |_| \_\___|\__,_|_|_| |_| |_|___/
+ *
+ * Permission to use, modify and distribute is granted via the
+ *  GNU Affero General Public License v3 or later
+ *
+ *  Copyright (C) 2007-2021 Jason Mitchell, Randi Mitchell
+ *     Contributions by Tim Callahan, Jonathan Hseu
+ *  Based on Mordor (C) Brooke Paul, Brett J. Vickers, John P. Freeman
+ *
+ */
+
+#pragma once
+
+#include <sys/types.h>
+#include <atomic>
+#include <cstdint>
+#include <ctime>
+#include <filesystem>
+#include <memory>
+#include <string>
+#include <string_view>
+#include <thread>
+#include <unordered_map>
+#include <vector>
+
+namespace fs = std::filesystem;
+
+enum class LogKind : uint8_t {
+    Game,       // Staff logs: can be rotated and written as JSON
+    Record,     // Shown to players (bank statements): always plain text, never rotated
+};
+
+// Log lines are pushed onto a lock free ring by whoever is logging, and a
+// background thread writes them out, a batch at a time with writev, to files
+// it keeps open.  The timestamp is taken when the line is logged but the line
+// itself is put together on the writer thread.
+//
+// If the ring ever fills up the line is written straight away instead, so
+// nothing is lost; forked children always write straight away.
+class LogWriter {
+public:
+    static LogWriter& get();
+    ~LogWriter();
+    LogWriter(const LogWriter&) = delete;
+    LogWriter& operator=(const LogWriter&) = delete;
+
+    // name is what the line is tagged with in JSON mode
+    void append(const fs::path& file, std::string_view name, std::string text, LogKind kind = LogKind::Game);
+
+    // Blocks until everything logged so far is on disk
+    void flush();
+    // Flushes, then closes the file if the writer has it open; call before
+    // reading, renaming or removing a log
+    void release(const fs::path& file);
+    // Flushes and stops the writer thread; anything logged afterwards is written immediately
+    void stop();
+
+    // Game logs are rotated once they grow past maxBytes or have been open
+    // for maxAge seconds; 0 turns either off
+    void setRotation(off_t maxBytes, long maxAge);
+    void setJson(bool json);
+
+private:
+    LogWriter();
+
+    struct Entry {
+        std::string file;
+        std::string name;
+        std::string text;
+        time_t time = 0;
+        LogKind kind = LogKind::Game;
+        bool close = false;     // Not a line: close the file once everything before it is written
+    };
+    struct Slot {
+        std::atomic<uint64_t> sequence;
+        Entry entry;
+    };
+    struct OpenFile {
+        int fd = -1;
+        off_t size = 0;
+        time_t opened = 0;
+        time_t lastWrite = 0;
+    };
+
+    [[nodiscard]] bool isAsync() const;
+    bool push(Entry&& entry);
+    bool pop(Entry& entry);
+    void run();
+    void writeBatch(std::vector<Entry>& batch);
+    [[nodiscard]] std::string format(const Entry& entry) const;
+    OpenFile* open(const std::string& file, LogKind kind);
+    void rotate(const std::string& file, OpenFile& open);
+    void closeIdle(time_t now);
+    void writeNow(const Entry& entry);
+
+    static constexpr uint64_t RING_SIZE = 8192;
+
+    std::unique_ptr<Slot[]> ring;
+    std::atomic<uint64_t> head{0};          // Next slot a producer will claim
+    uint64_t tail = 0;                      // Next slot the writer will read; writer only
+    std::atomic<uint32_t> wake{0};          // Bumped to wake the writer
+    std::atomic<uint64_t> written{0};       // Slots the writer has finished with
+
+    std::unordered_map<std::string, OpenFile> files;   // Writer only
+    std::atomic<off_t> rotateBytes{0};
+    std::atomic<long> rotateAge{0};
+    std::atomic<bool> json{false};
+
+    std::atomic<bool> stopping{false};
+    std::thread writer;
+    pid_t owner = -1;
+};
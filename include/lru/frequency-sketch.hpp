@@ -0,0 +1,95 @@
+/*
+ * frequency-sketch.h
+ *   LRU Cache - Approximate access counts
+ *   ____            _
+ *  |  _ \ ___  __ _| |_ __ ___  ___
+ *  | |_) / _ \/ _` | | '_ ` _ \/ __|
+ *  |  _ <  __/ (_| | | | | | | \__ \
+ *  |_| \_\___|\__,_|_|_| |_| |_|___/
+ *
+ * Permission to use, modify and distribute is granted via the
+ *  GNU Affero General Public License v3 or later
+ *
+ *  Copyright (C) 2007-2021 Jason Mitchell, Randi Mitchell
+ *     Contributions by Tim Callahan, Jonathan Hseu
+ *  Based on Mordor (C) Brooke Paul, Brett J. Vickers, John P. Freeman
+ *
+ */
+/*
+ * A count-min sketch in the style of TinyLFU: a few rows of small saturating
+ * counters, each indexed by a different hash of the key.  A key's frequency is
+ * the smallest of its counters.  Every so often all counters are halved so old
+ * popularity fades out.  It remembers keys long after they've been evicted
+ * while only costing a few bytes per cached entry.
+ */
+
+#pragma once
+
+#include <algorithm>
+#include <cstddef>
+#include <cstdint>
+#include <functional>
+#include <vector>
+
+namespace LRU {
+
+template <typename key_t>
+class FrequencySketch {
+public:
+	FrequencySketch() { resize(1024); }
+
+	// Width must be a power of two; existing counts are thrown away
+	void resize(size_t width) {
+		_mask = width - 1;
+		_table.assign(width * DEPTH, 0);
+		_additions = 0;
+	}
+
+	[[nodiscard]] size_t width() const noexcept {
+		return _mask + 1;
+	}
+
+	void increment(const key_t& key) {
+		uint64_t hash = std::hash<key_t>()(key);
+		for(size_t row = 0; row < DEPTH; row++) {
+			uint8_t& counter = _table[row * width() + _index(hash, row)];
+			if(counter < MAX_COUNT)
+				counter++;
+		}
+		if(++_additions >= width() * SAMPLE_FACTOR)
+			_age();
+	}
+
+	[[nodiscard]] unsigned frequency(const key_t& key) const {
+		uint64_t hash = std::hash<key_t>()(key);
+		unsigned freq = MAX_COUNT;
+		for(size_t row = 0; row < DEPTH; row++)
+			freq = std::min<unsigned>(freq, _table[row * width() + _index(hash, row)]);
+		return freq;
+	}
+
+private:
+	static constexpr size_t DEPTH = 4;
+	static constexpr uint8_t MAX_COUNT = 15;
+	static constexpr size_t SAMPLE_FACTOR = 10;
+
+	// Remix the key's hash differently for each row
+	[[nodiscard]] size_t _index(uint64_t hash, size_t row) const {
+		hash += 0x9e3779b97f4a7c15ULL * (row + 1);
+		hash = (hash ^ (hash >> 30)) * 0xbf58476d1ce4e5b9ULL;
+		hash = (hash ^ (hash >> 27)) * 0x94d049bb133111ebULL;
+		return (hash ^ (hash >> 31)) & _mask;
+	}
+
+	void _age() {
+		for(auto& counter : _table)
+			counter >>= 1;
+		_additions /= 2;
+	}
+
+	std::vector<uint8_t> _table;
+	size_t _mask = 0;
+	size_t _additions = 0;
+};
+
+} // Namespace LRU
@@ -20,14 +20,25 @@
  *  Inspiration from:
  *    https://github.com/paudley/lru_cache
  *    https://github.com/goldsborough/lru-cache
+ *
+ *  Entries live in a slab (a deque of slots, so pointers handed out by
+ *  fetch_ptr stay put) and are evicted with a CLOCK sweep rather than by
+ *  splicing a linked list on every hit.  Each entry carries an approximate
+ *  byte cost and the cache can be bounded by entry count, by bytes, or both.
+ *  A TinyLFU style frequency sketch remembers how often keys are asked for,
+ *  so something that keeps getting evicted and reloaded comes back in hot.
  */
 
 #pragma once
 
+#include <algorithm>
+#include <cstdint>
+#include <deque>
+#include <functional>
+#include <optional>
+#include <sstream>
 #include <unordered_map>
-#include <list>
 #include <vector>
-#include <functional>
 
 //#ifdef _REENTRANT
 //#include <boost/thread/mutex.hpp>
@@ -38,6 +49,7 @@
 #define SCOPED_MUTEX
 //#endif
 
+#include "lru/frequency-sketch.hpp"
 #include "lru/statistics.hpp"
 
 const bool MONITOR_STATS = true;
@@ -54,25 +66,70 @@ struct CleanUpFn {
 		void operator()( const T &x ) { /* do nothing */ }
 };
 
-template< class key_t, class data_t, class clean_up_fn = CleanUpFn< data_t >, class can_clean_up_fn = CanCleanupFn< data_t > > class lru_cache {
+// Approximate number of bytes an entry is holding on to
+template < class T >
+struct CostFn {
+	size_t operator()( const T &x ) { return sizeof(T); }
+};
+
+template< class key_t, class data_t, class clean_up_fn = CleanUpFn< data_t >, class can_clean_up_fn = CanCleanupFn< data_t >, class cost_fn = CostFn< data_t > > class lru_cache {
 public:
-	using list_t = std::list< std::pair< key_t, data_t > >;       // Main cache storage typedef
-	using list_iter_t = typename list_t::iterator;                // Main cache iterator
-	using list_citer_t = typename list_t::const_iterator;         // Main cache iterator (const)
+	using value_t = std::pair< key_t, data_t >;                   // What's stored for each key
 	using key_list_t = std::vector< key_t >;                      // List of keys
 	using key_list_iter_t = typename key_list_t::iterator;        // Main cache iterator
 	using key_list_citer_t = typename key_list_t::const_iterator; // Main cache iterator (const)
-	using map_t = std::unordered_map< key_t, list_iter_t >;       // Index typedef
-	using pair_t = std::pair< key_t, list_iter_t >;               // Pair of map elements
-	using map_iter_t = typename map_t::iterator;			      // Index iterator
-	using map_citer_t = typename map_t::const_iterator;           // Index iterator (const)
 
 private:
-	list_t _items_list;               	// Main cache storage
-	map_t  _items_map;                	// Cache storage index
-	size_t _max_size;  				  	// Maximum abstract size of the cache
-	bool   _is_shared;				// Are we storing a reference, or a copy, of the data
-	LRU::Statistics<key_t> _stats;		// Cache hit/miss & keys
+	// Highest CLOCK count an entry can build up; it survives this many sweeps without a hit
+	static constexpr uint8_t MAX_CLOCK = 3;
+
+	struct slot_t {
+		std::optional< value_t > item;  // Empty when the slot is on the free list
+		size_t cost = 0;
+		uint8_t clock = 0;              // Evictable once the hand finds this at zero
+	};
+	using slab_t = std::deque< slot_t >;
+	using map_t = std::unordered_map< key_t, size_t >;            // Key -> slot index
+
+	// Walks the slab, skipping free slots
+	template < class slab_iter_t, class ref_t >
+	class basic_iterator {
+	public:
+		using iterator_category = std::forward_iterator_tag;
+		using value_type = value_t;
+		using difference_type = std::ptrdiff_t;
+		using pointer = std::remove_reference_t< ref_t >*;
+		using reference = ref_t;
+
+		basic_iterator(slab_iter_t it, slab_iter_t end): _it(it), _end(end) { _skip(); }
+		reference operator*() const { return *_it->item; }
+		pointer operator->() const { return &*_it->item; }
+		basic_iterator& operator++() { ++_it; _skip(); return *this; }
+		bool operator==(const basic_iterator& o) const { return _it == o._it; }
+		bool operator!=(const basic_iterator& o) const { return _it != o._it; }
+	private:
+		void _skip() { while(_it != _end && !_it->item) ++_it; }
+		slab_iter_t _it, _end;
+	};
+
+public:
+	using iterator = basic_iterator< typename slab_t::iterator, value_t& >;
+	using const_iterator = basic_iterator< typename slab_t::const_iterator, const value_t& >;
+
+private:
+	slab_t _slots;                      // Main cache storage
+	std::vector< size_t > _free;        // Slots available for reuse
+	map_t  _items_map;                  // Cache storage index
+	size_t _hand;                       // Where the CLOCK sweep picks up next
+	size_t _max_size;                   // Maximum number of entries, 0 for no limit
+	size_t _max_bytes;                  // Maximum total cost, 0 for no limit
+	size_t _bytes;                      // Current total cost
+	bool   _is_shared;                  // Are we storing a reference, or a copy, of the data
+	LRU::Statistics<key_t> _stats;      // Cache hit/miss & keys
+	FrequencySketch<key_t> _sketch;     // How often each key has been asked for
+	size_t _evictions;
+	size_t _vetoes;                     // Eviction candidates can_clean_up_fn refused
+	size_t _overruns;                   // Times everything left was vetoed and we stayed over budget
 //#ifdef _REENTRANT
 //    boost::mutex _mutex;
 //#endif
@@ -80,31 +137,36 @@ template< class key_t, class data_t, class clean_up_fn = CleanUpFn< data_t >, cl
 public:
 
 	// Constructor/Deconstructor
-	lru_cache(size_t max_size, bool is_reference): _max_size(max_size), _is_shared(is_reference), _stats(MONITOR_STATS) {}
+	lru_cache(size_t max_size, bool is_reference, size_t max_bytes = 0):
+		_hand(0), _max_size(max_size), _max_bytes(max_bytes), _bytes(0), _is_shared(is_reference),
+		_stats(MONITOR_STATS), _evictions(0), _vetoes(0), _overruns(0) {}
 	~lru_cache() { clear(); }
 
 
-	// Clear the list and index
+	// Clear the slab and index
 	void clear() {
         SCOPED_MUTEX;
-		_items_list.clear();
+		_slots.clear();
+		_free.clear();
 		_items_map.clear();
+		_hand = 0;
+		_bytes = 0;
 	};
 
 	// Does the cache contain this key?
 	//  - Records cache hit/miss
 	inline bool contains(const key_t &key) {
         SCOPED_MUTEX;
-		return find(key, true) != end();
+		return _lookup(key, true) != nullptr;
 	}
 
 	// Remove this key from the cache
 	// - Does not record cache hit/miss
 	inline void remove(const key_t &key) {
         SCOPED_MUTEX;
-		map_iter_t m_iter = _items_map.find(key);
+		auto m_iter = _items_map.find(key);
 		if(m_iter == _items_map.end()) return;
-		_remove(m_iter);
+		_remove(m_iter->second);
 	}
 
 	// How big is the cache?
@@ -116,145 +178,133 @@ template< class key_t, class data_t, class clean_up_fn = CleanUpFn< data_t >, cl
 		return _max_size;
 	}
 
-	[[nodiscard]] double utilization() const noexcept {
-		return static_cast<double>(size()) / capacity();
+	[[nodiscard]] size_t bytes() const noexcept {
+		return _bytes;
 	}
 
-	//******************************************************************
-	// Iterators
-	//******************************************************************
-
-	map_iter_t end() noexcept {
-		return _items_map.end();
-	}
-
-	map_citer_t end() const noexcept {
-		return _items_map.cend();
+	[[nodiscard]] size_t byte_capacity() const noexcept {
+		return _max_bytes;
 	}
 
-	map_iter_t begin() noexcept {
-		return _items_map.begin();
+	// How full the cache is against whichever limit it has; the byte budget wins if both are set
+	[[nodiscard]] double utilization() const noexcept {
+		if(_max_bytes)
+			return static_cast<double>(_bytes) / _max_bytes;
+		if(_max_size)
+			return static_cast<double>(size()) / _max_size;
+		return 0;
 	}
 
-	map_citer_t begin() const noexcept {
-		return _items_map.cbegin();
+	[[nodiscard]] const LRU::Statistics<key_t>& stats() const noexcept {
+		return _stats;
 	}
 
-	map_iter_t find(const key_t &key, bool touch = true) {
-		map_iter_t m_iter = _items_map.find(key);
-
-		if(m_iter != _items_map.end()) {
-			if(touch)
-				_touch(m_iter->second);
-			_register_hit(key);
-		} else {
-			_register_miss(key);
-		}
+	//******************************************************************
+	// Iterators
+	//******************************************************************
 
-		return m_iter;
+	iterator begin() noexcept {
+		return iterator(_slots.begin(), _slots.end());
 	}
 
-	map_citer_t find(const key_t &key, bool touch = true) const {
-		auto m_iter = _items_map.find(key);
+	iterator end() noexcept {
+		return iterator(_slots.end(), _slots.end());
+	}
 
-		if(m_iter != _items_map.end()) {
-			if(touch)
-				_touch(m_iter->second);
-			_register_hit(key);
-		} else {
-			_register_miss(key);
-		}
+	const_iterator begin() const noexcept {
+		return const_iterator(_slots.cbegin(), _slots.cend());
+	}
 
-		return m_iter;
+	const_iterator end() const noexcept {
+		return const_iterator(_slots.cend(), _slots.cend());
 	}
 
 	inline void touch( const key_t &key ) {
         SCOPED_MUTEX;
-		_touch(key);
+		auto m_iter = _items_map.find(key);
+		if(m_iter != _items_map.end())
+			_touch(_slots[m_iter->second]);
 	}
 
 	// Fetch a copy of the data
 	inline data_t fetch(const key_t &key, bool touch = true ) {
         SCOPED_MUTEX;
-		map_iter_t m_iter = find(key, touch);
-		if(m_iter == end())
+		value_t* item = _lookup(key, touch);
+		if(!item)
 			return data_t();
-        return m_iter->second->second;
+        return item->second;
 	}
 
     inline data_t* fetch_ptr(const key_t &key, bool touch = true ) {
         SCOPED_MUTEX;
-        map_iter_t m_iter = find(key, touch);
-        if(m_iter == end())
+        value_t* item = _lookup(key, touch);
+        if(!item)
             return nullptr;
-        return &(m_iter->second->second);
+        return &(item->second);
     }
 
 	// Fetch data and return whether it was found
 	inline bool fetch(const key_t &key, data_t &data, bool touch=true ) {
         SCOPED_MUTEX;
-		map_iter_t m_iter = find(key, touch);
-		if(m_iter == end()) {
+		value_t* item = _lookup(key, touch);
+		if(!item) {
 			return false;
 		}
 		if (_is_shared) {
-			data = m_iter->second->second;
+			data = item->second;
 		} else {
-			data = data_t(m_iter->second->second);
+			data = data_t(item->second);
 		}
 		return true;
 	}
 
-	// Insert a new (key, data) pair
+	// Insert a new (key, data) pair.  The new entry is never the one evicted to make
+	// room for it, callers expect to be able to fetch it right back out.
 	inline void insert(const key_t &key, const data_t &data) {
         SCOPED_MUTEX;
-		// Touch the key, if it exists, then replace the content.
-		map_iter_t m_iter = _touch(key);
+		// Replace the content if the key already exists
+		auto m_iter = _items_map.find(key);
 		if(m_iter != _items_map.end())
-			_remove(m_iter);
-
-		if (_is_shared) {
-            _items_list.emplace_front(key, std::ref(data));
-		} else {
-            _items_list.emplace_front(key, data);
-		}
-
-		// Ok, do the actual insert at the head of the list
-		list_iter_t l_iter = _items_list.begin();
-
-		// Store the index
-		_items_map.insert(std::make_pair(key, l_iter));
-
-		// Check to see if we need to remove an element due to exceeding max_size
-		size_t sanity_check = 0;
-		while(_items_map.size() > _max_size) {
-			// Remove the last element.
-			l_iter = _items_list.end();
-			l_iter--;
-			if (can_clean_up_fn()(l_iter->second)) {
-				_remove(l_iter->first);
-			} else {
-				sanity_check++;
-				if(sanity_check > _max_size / 2) {
-					throw std::range_error("Couldn't clean up more than half of the cache.");
-				}
-				_touch(l_iter);
-			}
-		}
+			_remove(m_iter->second);
+
+		size_t idx = _allocate();
+		slot_t& slot = _slots[idx];
+		slot.item.emplace(key, data);
+		slot.cost = cost_fn()(slot.item->second);
+		// Keys that have been popular recently start out with some credit on the clock
+		slot.clock = static_cast<uint8_t>(std::clamp(_sketch.frequency(key), 1u, (unsigned)MAX_CLOCK));
+		_bytes += slot.cost;
+		_items_map.emplace(key, idx);
+
+		// Keep the sketch wide enough that keys don't all collide
+		if(_items_map.size() * 4 > _sketch.width())
+			_sketch.resize(_sketch.width() * 2);
+
+		_evict(idx);
 	}
 
 	// Get a list of all keys - Mainly for debugging
 	inline const key_list_t get_all_keys( ) {
 		key_list_t ret;
-		for( list_citer_t l_iter : _items_list)
-			ret.push_back(l_iter->first);
+		for(const auto& it : *this)
+			ret.push_back(it.first);
 		return ret;
 	}
 
 	std::string get_stat_info(bool extended=false) {
 	    std::ostringstream oStr;
-	    oStr << "Size: " << size() << "/" << capacity() << " - " << utilization()*100.0 << "%" << std::endl;;
-	    oStr << "Hit Rate: " << _stats.hit_rate() << "%  Miss Rate: " << _stats.miss_rate() << "%" << std::endl;
+	    oStr.setf(std::ios::fixed, std::ios::floatfield);
+	    oStr.precision(2);
+	    oStr << "Size: " << size();
+	    if(_max_size)
+	    	oStr << "/" << capacity();
+	    oStr << "  Memory: " << _format_bytes(_bytes);
+	    if(_max_bytes)
+	    	oStr << "/" << _format_bytes(_max_bytes);
+	    oStr << " - " << utilization()*100.0 << "%" << std::endl;
+	    oStr << "Hit Rate: " << _stats.hit_rate()*100.0 << "%  Miss Rate: " << _stats.miss_rate()*100.0 << "%"
+	         << "  (" << _stats.total_accesses() << " lookups)" << std::endl;
+	    oStr << "Evictions: " << _evictions << "  Vetoed: " << _vetoes << "  Over budget: " << _overruns << std::endl;
 	    if(extended) {
 	    	oStr << _stats.detail_status();
 	    }
@@ -262,32 +312,99 @@ template< class key_t, class data_t, class clean_up_fn = CleanUpFn< data_t >, cl
 	}
 
 private:
-	// Touch a key (move it to the front)
-	inline map_iter_t _touch(const key_t &key) {
-		map_iter_t m_iter = _items_map.find(key);
-		if(m_iter == _items_map.end())
-			return m_iter;
-		_touch(m_iter->second);
-		return m_iter;
+	static std::string _format_bytes(size_t bytes) {
+		const char* units[] = { "b", "k", "M", "G" };
+		int unit = 0;
+		while(bytes >= 10240 && unit < 3) {
+			bytes /= 1024;
+			unit++;
+		}
+		return std::to_string(bytes) + units[unit];
 	}
 
-	// Touch a list iterator
-	void _touch(list_iter_t l_iter) {
-		// Move the found node to the head of the list.
-		_items_list.splice( _items_list.begin(), _items_list, l_iter );
+	// Find a key, recording the hit or miss
+	value_t* _lookup(const key_t &key, bool touch) {
+		_sketch.increment(key);
+		auto m_iter = _items_map.find(key);
+		if(m_iter == _items_map.end()) {
+			_register_miss(key);
+			return nullptr;
+		}
+		slot_t& slot = _slots[m_iter->second];
+		if(touch)
+			_touch(slot);
+		_register_hit(key);
+		return &*slot.item;
+	}
+
+	// A hit just bumps the clock count; nothing moves
+	void _touch(slot_t& slot) {
+		if(slot.clock < MAX_CLOCK)
+			slot.clock++;
+		_recost(slot);
 	}
 
-	// Remove a key
-	inline void _remove( const key_t &key ) {
-		map_iter_t m_iter = _items_map.find(key);
-		_remove(m_iter);
+	// Entries grow and shrink while they're cached (rooms gain monsters and objects)
+	void _recost(slot_t& slot) {
+		size_t cost = cost_fn()(slot.item->second);
+		_bytes = _bytes - slot.cost + cost;
+		slot.cost = cost;
+	}
+
+	size_t _allocate() {
+		if(!_free.empty()) {
+			size_t idx = _free.back();
+			_free.pop_back();
+			return idx;
+		}
+		_slots.emplace_back();
+		return _slots.size() - 1;
+	}
+
+	[[nodiscard]] bool _over_budget() const {
+		return (_max_size && _items_map.size() > _max_size) || (_max_bytes && _bytes > _max_bytes);
+	}
+
+	// Sweep the clock hand until we're back under budget.  Anything can_clean_up_fn
+	// refuses is passed over; if a full set of sweeps turns up nothing we can evict,
+	// stay over budget until the next insert rather than give up on the cache.
+	void _evict(size_t protect) {
+		size_t limit = _slots.size() * (MAX_CLOCK + 2);
+		for(size_t scanned = 0; _over_budget(); scanned++) {
+			if(scanned >= limit) {
+				_overruns++;
+				return;
+			}
+			if(_hand >= _slots.size())
+				_hand = 0;
+			size_t idx = _hand++;
+			slot_t& slot = _slots[idx];
+			if(!slot.item || idx == protect)
+				continue;
+			_recost(slot);
+			if(slot.clock) {
+				slot.clock--;
+				continue;
+			}
+			if(!can_clean_up_fn()(slot.item->second)) {
+				_vetoes++;
+				continue;
+			}
+			_remove(idx);
+			_evictions++;
+		}
 	}
 
-	// Remove an items map iterator and associated items
-	inline void _remove( const map_iter_t &m_iter ) {
-		const auto data = m_iter->second->second;
-		_items_list.erase(m_iter->second);
-		_items_map.erase(m_iter);
+	// Remove a slot and hand its data to clean_up_fn
+	inline void _remove( size_t idx ) {
+		slot_t& slot = _slots[idx];
+		const auto data = std::move(slot.item->second);
+		_items_map.erase(slot.item->first);
+		_bytes -= slot.cost;
+		slot.item.reset();
+		slot.cost = 0;
+		slot.clock = 0;
+		_free.push_back(idx);
 		clean_up_fn()(data);
 	}
 
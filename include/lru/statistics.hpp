@@ -69,10 +69,14 @@ class Statistics {
 	}
 
 	double hit_rate() const noexcept {
+		if(!total_accesses())
+			return 0;
 		return static_cast<double>(total_hits()) / total_accesses();
 	}
 
 	double miss_rate() const noexcept {
+		if(!total_accesses())
+			return 0;
 		return 1 - hit_rate();
 	}
 
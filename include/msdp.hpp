@@ -18,15 +18,34 @@
 
 #pragma once
 
+#include <cstdint>
 #include <functional>
 #include <ctime>
 
-#include "timer.hpp"
-
 class Socket;
 class Player;
 class MsdpBuilder;
 
+// Game state changes that reported variables can listen for.  Whatever changes
+// the state publishes the event (see Creature::publishMsdp); only sockets
+// reporting a variable that listens for it are woken up.
+enum class MsdpEvent : uint8_t {
+    Health,         // hp current/max
+    Mana,           // mp current/max
+    Experience,     // experience or level
+    Stats,          // strength, dexterity and the rest
+    Target,         // who we're targeting
+    TargetHealth,   // our target's hp current/max
+    TargetStats,    // our target's stats
+    Room,           // moved to another room
+    Group,          // group membership, or a member's hp/mp/room/effects
+    Affects,        // effects added or removed
+};
+
+constexpr uint32_t msdpEventBit(MsdpEvent event) {
+    return(1u << static_cast<uint8_t>(event));
+}
+
 
 class MsdpVariable {
     friend class ReportedMsdpVariable;
@@ -43,6 +62,7 @@ class MsdpVariable {
     int updateInterval{};      // Update interval (in 10ths of a second)
     bool updateable{};         // Does this have an update function?
     bool isGroup{};            // Is this a group of related variables?
+    uint32_t events{};         // MsdpEvents that change this variable; none means it's polled every updateInterval
 
     std::function<std::string(Socket&, std::shared_ptr<Player>)> valueFn{nullptr}; // Function to send the variable
 
@@ -60,6 +80,8 @@ class MsdpVariable {
     [[nodiscard]] bool isWriteOnce() const;
     [[nodiscard]] bool getRequiresPlayer() const;
     [[nodiscard]] int getUpdateInterval() const;
+    [[nodiscard]] uint32_t getEvents() const;
+    [[nodiscard]] bool isPolled() const;
 
     bool send(Socket &sock) const;
 
@@ -69,9 +91,10 @@ class ReportedMsdpVariable : public MsdpVariable {
 protected:
     std::string value;
     bool dirty;
+    bool stale;             // Value needs to be recalculated before it's next sent
     std::weak_ptr<Socket> parentSock; // Parent Socket
 
-    Timer timer;
+    long nextUpdate;        // When a polled variable is next due, from msdp::now()
 
 public:
     ReportedMsdpVariable(const ReportedMsdpVariable&) = default;
@@ -81,7 +104,10 @@ class ReportedMsdpVariable : public MsdpVariable {
     void setValue(std::string_view newValue);
     void setValue(int newValue);
     void setValue(long newValue);
-    bool checkTimer();       // True = ok to send, False = timer hasn't expired yet
+    bool checkTimer(long now);  // True = ok to send, False = timer hasn't expired yet
+    [[nodiscard]] long getNextUpdate() const;
+    [[nodiscard]] bool isStale() const;
+    void setStale();
 
     [[nodiscard]] bool isDirty() const;
     void update();
@@ -90,6 +116,9 @@ class ReportedMsdpVariable : public MsdpVariable {
 
 namespace msdp {
 
+    // Milliseconds on a monotonic clock, read once per pulse
+    long now();
+
     // Reporting Functions
     std::string getServerId(Socket &sock, const std::shared_ptr<Player>& player);
     std::string getServerTime(Socket &sock, const std::shared_ptr<Player>& player);
@@ -0,0 +1,79 @@
+/*
+ * mudFormat.h
+ *   fmt formatters for creatures and objects, and the printf style shim
+ *   ____            _
+ *  |  _ \ ___  __ _| |_ __ ___  ___
+ *  | |_) / _ \/ _` | | '_ ` _ \/ __|
+ *  |  _ <  __/ (_| | | | | | | \__ \
+ *  |_| \_\___|\__,_|_|_| |_| |_|___/
+ *
+ * Permission to use, modify and distribute is granted via the
+ *  GNU Affero General Public License v3 or later
+ *
+ *  Copyright (C) 2007-2021 Jason Mitchell, Randi Mitchell
+ *     Contributions by Tim Callahan, Jonathan Hseu
+ *  Based on Mordor (C) Brooke Paul, Brett J. Vickers, John P. Freeman
+ *
+ */
+
+#pragma once
+
+#include <cstdarg>
+#include <string>
+#include <string_view>
+#include <fmt/format.h>
+
+class Creature;
+class Object;
+
+// A creature's name the way a viewer with the given display flags sees it; this is
+// what %M (flags | CAP) and %N print.  Num picks the article/count form, like the
+// old printf width did (%1M).
+struct CrtName {
+    CrtName(const Creature* pCrt, int pFlags = 0, int pNum = 0) : crt(pCrt), flags(pFlags), num(pNum) {}
+    const Creature* crt;
+    int flags;
+    int num;
+};
+
+// Same as CrtName, for %O and %P
+struct ObjName {
+    ObjName(const Object* pObj, int pFlags = 0, int pNum = 0) : obj(pObj), flags(pFlags), num(pNum) {}
+    const Object* obj;
+    int flags;
+    int num;
+};
+
+// Both take the usual string specs, so "{:<20}" pads a name to 20 columns
+template <>
+struct fmt::formatter<CrtName> : fmt::formatter<std::string_view> {
+    fmt::format_context::iterator format(const CrtName& name, fmt::format_context& ctx) const;
+};
+
+template <>
+struct fmt::formatter<ObjName> : fmt::formatter<std::string_view> {
+    fmt::format_context::iterator format(const ObjName& name, fmt::format_context& ctx) const;
+};
+
+// Adds a viewer's display flags to CrtName and ObjName arguments; everything else passes through
+template <typename T>
+const T& forViewer(const T& arg, int) { return(arg); }
+inline CrtName forViewer(const CrtName& name, int flags) { return(CrtName(name.crt, name.flags | flags, name.num)); }
+inline ObjName forViewer(const ObjName& name, int flags) { return(ObjName(name.obj, name.flags | flags, name.num)); }
+
+template <typename... Args>
+std::string formatArgs(fmt::string_view format, const Args&... args) {
+    return(fmt::vformat(format, fmt::make_format_args(args...)));
+}
+
+// fmt::format for a viewer with the given display flags.  The format isn't checked
+// here; the print and broadcast entry points that call this check it at compile time.
+template <typename... Args>
+std::string formatFor(int flags, fmt::string_view format, const Args&... args) {
+    return(formatArgs(format, forViewer(args, flags)...));
+}
+
+// Formats a printf style string, including the mud's own %M %N %O %P %R %T and %b
+// conversions, for a viewer with the given display flags.  This is what the varargs
+// print functions go through until they've all been moved over to fmt.
+std::string formatLegacy(int flags, const char *fmt, va_list ap);
@@ -19,6 +19,8 @@
 #ifndef CONTAINER_H_
 #define CONTAINER_H_
 
+#include "containerSet.hpp"
+#include "keyTxt.hpp"
 #include "mudObject.hpp"
 
 #include <set>
@@ -37,21 +39,9 @@ class UniqueRoom;
 
 class cmd;
 
-struct PlayerPtrLess {
-    bool operator()(const std::weak_ptr<Player>& lhs, const std::weak_ptr<Player>& rhs) const;
-};
-
-struct MonsterPtrLess {
-    bool operator()(const std::shared_ptr<Monster>&  lhs, const std::shared_ptr<Monster>&  rhs) const;
-};
-
-struct ObjectPtrLess  {
-    bool operator()(const std::shared_ptr<Object>&  lhs, const std::shared_ptr<Object>&  rhs) const;
-};
-
-typedef std::set<std::weak_ptr<Player>, PlayerPtrLess> PlayerSet;
-typedef std::set<std::shared_ptr<Monster> , MonsterPtrLess> MonsterSet;
-typedef std::set<std::shared_ptr<Object> , ObjectPtrLess> ObjectSet;
+typedef ContainerSet<std::weak_ptr<Player>> PlayerSet;
+typedef ContainerSet<std::shared_ptr<Monster>> MonsterSet;
+typedef ContainerSet<std::shared_ptr<Object>> ObjectSet;
 
 // Any container or containable item is a MudObject.  Since an object can be both a container and containable...
 // make sure we use virtual MudObject as the parent to avoid the "dreaded" diamond
@@ -79,6 +69,9 @@ class Container : public virtual MudObject, public inheritable_enable_shared_fro
     void registerContainedItems() override;
     void unRegisterContainedItems() override;
 
+    // Something we hold changed its keywords
+    void keyTxtChanged();
+
 
     bool checkAntiMagic(const std::shared_ptr<Monster>&  ignore = nullptr);
 
@@ -117,6 +110,13 @@ class Container : public virtual MudObject, public inheritable_enable_shared_fro
     std::shared_ptr<MudObject> findTarget(const std::shared_ptr<const Creature>& searcher,  const std::string& name, int num, bool monFirst= true, bool firstAggro = false, bool exactMatch = false) const;
     std::shared_ptr<MudObject> findTarget(const std::shared_ptr<const Creature>& searcher,  const std::string& name, int num, bool monFirst, bool firstAggro, bool exactMatch, int& match) const;
 
+    // The num'th monster/object the query matches, counting on from match
+    std::shared_ptr<Monster>  findMonster(const std::shared_ptr<const Creature>& searcher, const KeyTxtQuery& query, int num, int& match, bool checkVisibility) const;
+    std::shared_ptr<Object>  findObject(const std::shared_ptr<const Creature>& searcher, const KeyTxtQuery& query, int num, int& match, bool checkVisibility) const;
+
+private:
+    mutable KeyTxtSetIndex<Monster> monsterIndex;
+    mutable KeyTxtSetIndex<Object> objectIndex;
 };
 
 class Containable : public virtual MudObject,  public inheritable_enable_shared_from_this<Containable> {
@@ -158,6 +158,11 @@ class Containable : public virtual MudObject,  public inheritable_enable_shared_
     [[nodiscard]] std::shared_ptr<const Monster>  getConstMonsterParent() const;
     [[nodiscard]] std::shared_ptr<const Creature> getConstCreatureParent() const;
 
+    // Sets of us are kept sorted by this, rebuilt each time we're added to one
+    // so no comparison has to build it
+    virtual const std::string* refreshSortKey();
+    [[nodiscard]] virtual const std::string* getSortKey() const;
+
 protected:
     std::weak_ptr<Container> parent;   // Parent Container
 
@@ -166,6 +171,7 @@ class Containable : public virtual MudObject,  public inheritable_enable_shared_
     void removeFromSet() override;
     void addToSet() override;
 
+    std::string sortKey;
 };
 
 #endif /* CONTAINER_H_ */
@@ -26,16 +26,19 @@
 #include "mudObjects/container.hpp"
 #include "mudObjects/mudObject.hpp"
 #include "carry.hpp"
+#include "cow.hpp"
 #include "creatureStreams.hpp"
 #include "damage.hpp"
 #include "enums/loadType.hpp"
 #include "fighters.hpp"
 #include "global.hpp"
 #include "group.hpp"
+#include "keyTxt.hpp"
 #include "lasttime.hpp"
 #include "location.hpp"
 #include "magic.hpp"
 #include "monType.hpp"
+#include "mudFormat.hpp"
 #include "quests.hpp"
 #include "range.hpp"
 #include "realm.hpp"
@@ -50,6 +53,8 @@ class Object;
 class Skill;
 class Socket;
 class Song;
+class Stat;
+enum class MsdpEvent : uint8_t;
 
 
 enum AttackType {
@@ -198,7 +203,7 @@ class Creature: public virtual MudObject, public Streamable, public Container, p
     unsigned short clan{};
     unsigned short poison_dur{};
     unsigned short poison_dmg{};
-    std::string description;
+    Cow<std::string> description; // Shared with the prototype until changed
     std::string version; // Version of the mud this creature was saved under
     boost::dynamic_bitset<> flags{256};
     unsigned long realm[MAX_REALM-1]{}; // Magic Spell realms
@@ -213,6 +218,8 @@ class Creature: public virtual MudObject, public Streamable, public Container, p
     Group* group{};
     GroupStatus groupStatus;
 
+    mutable KeyTxt keyTxt; // Built from key and the name when first needed
+
 public:
 // Constructors, Deconstructors, etc
     Creature();
@@ -275,6 +282,9 @@ class Creature: public virtual MudObject, public Streamable, public Container, p
     void clearTarget(bool clearTargetsList = true);
     void clearTargetingThis(Creature *targeter);
 
+    void publishMsdp(MsdpEvent event);
+    void statChanged(const Stat& stat);
+
     long getLTLeft(int myLT, long t = -1); // gets the time left on a LT
     void setLastTime(int myLT, long t, long interval); // Sets a LT
 
@@ -396,6 +406,8 @@ class Creature: public virtual MudObject, public Streamable, public Container, p
 
 // Formatting
     virtual void escapeText() {};
+    [[nodiscard]] const KeyTxt& getKeyTxt() const;
+    void refreshKeyTxt() override;
     std::string getCrtStr(const std::shared_ptr<const Creature> & viewer = nullptr, int ioFlags = 0, int num = 0) const;
     std::string statCrt(int statFlags);
     int displayFlags() const;
@@ -415,11 +427,29 @@ class Creature: public virtual MudObject, public Streamable, public Container, p
 
     void printPaged(std::string_view toPrint) const;
     void bPrint(std::string_view toPrint) const;
+    template <typename... Args>
+    void bPrint(fmt::format_string<Args...> toPrint, Args &&... args) const {
+        bPrint(std::string_view(fmt::format(toPrint, std::forward<Args>(args)...)));
+    }
     void bPrintPython(const std::string& toPrint) const;
 
     void print(const char *fmt, ...) const;
     void printColor(const char *fmt, ...) const;
 
+    // Type checked print and printColor: CrtName and ObjName arguments are shown
+    // the way whoever reads this sees them, as %M and %O are
+    template <typename... Args>
+    void printFmt(fmt::format_string<Args...> format, Args &&... args) const {
+        printFormatted(formatFor(getPrintFlags(), format, args...));
+    }
+    template <typename... Args>
+    void printColorFmt(fmt::format_string<Args...> format, Args &&... args) const {
+        printFormatted(formatFor(getPrintFlags(), format, args...));
+    }
+    [[nodiscard]] std::shared_ptr<Socket> getPrintSock() const;
+    [[nodiscard]] int getPrintFlags() const;
+    void printFormatted(std::string msg) const;
+
     virtual void vprint(const char *fmt, va_list ap) const {};
 
 // Combat & Death
@@ -757,7 +787,7 @@ class Creature: public virtual MudObject, public Streamable, public Container, p
     virtual void pulseTick(long t) = 0;
 
     std::shared_ptr<MudObject> findTarget(int findWhere, int findFlags, const std::string& str, int val);
-    std::shared_ptr<MudObject> findObjTarget(ObjectSet &set, int findFlags, const std::string& str, int val, int* match);
+    std::shared_ptr<MudObject> findObjTarget(const Container& container, int findFlags, const KeyTxtQuery& query, int val, int* match);
     //std::shared_ptr<MudObject> findTarget(cmd* cmnd, TargetType targetType, bool offensive);
 
     // New songs
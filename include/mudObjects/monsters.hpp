@@ -45,6 +45,7 @@ class Monster : public Creature {
     Monster& operator=(const Monster& cr);
     bool operator< (const Monster& t) const;
     ~Monster();
+    const std::string* refreshSortKey() override;
     void readXml(xmlNodePtr curNode, bool offline=false);
     void saveXml(xmlNodePtr curNode) const;
     int saveToFile();
@@ -74,13 +75,16 @@ class Monster : public Creature {
 
     std::list<QuestInfo*> quests;
 
+    long dormantSince{};    // When the monster went dormant, 0 if it isn't
+    long lastSimulated{};   // Last time updateActive ran for this monster
+
 public:
 // Data
     char last_mod[25]{}; // last staff member to modify creature.
     char ttalk[72]{};
     char aggroString[80]{};
     char attack[3][CRT_ATTACK_LENGTH]{};
-    std::list<TalkResponse*> responses;
+    Cow<std::list<std::shared_ptr<TalkResponse>>> responses; // Shared with the prototype until changed
     boost::dynamic_bitset<> cClassAggro{32};
     boost::dynamic_bitset<> raceAggro{64};
     boost::dynamic_bitset<> deityAggro{32};
@@ -225,6 +229,14 @@ class Monster : public Creature {
     bool doTalkAction(const std::shared_ptr<Player>& target, std::string action, QuestInfo* quest = nullptr);
     void sayTo(const std::shared_ptr<Player>& player, const std::string& message);
     void pulseTick(long t);
+// Active list tiers
+    [[nodiscard]] bool staysActive() const;
+    [[nodiscard]] bool isDormant() const;
+    void goDormant(long t);
+    void fastForward(long t);
+    [[nodiscard]] long getLastSimulated() const;
+    void setLastSimulated(long t);
+
     void beneficialCaster();
     int initMonster(bool loadOriginal = false, bool prototype = false);
     void setRandomSex();
@@ -51,7 +51,7 @@ class MudObject: public std::enable_shared_from_this<MudObject> {
 
 protected:
     bool registered{};
-    std::list<DelayedAction*> delayedActionQueue;
+    std::list<DelayedActionRef> delayedActionQueue;
 
 public:
     friend void to_json(nlohmann::json &j, const MudObject &mo);
@@ -68,6 +68,8 @@ class MudObject: public std::enable_shared_from_this<MudObject> {
     void setName(std::string_view newName);
     [[nodiscard]] const std::string & getName() const;
     [[nodiscard]] const char* getCName() const;
+    // Call after changing keywords, so matching sees the new ones
+    virtual void refreshKeyTxt();
 
     void moCopy(const MudObject& mo);
 
@@ -118,6 +120,7 @@ class MudObject: public std::enable_shared_from_this<MudObject> {
 
 // Effects
     [[nodiscard]] bool isEffected(const std::string &effect, bool exactMatch = false) const;
+    [[nodiscard]] bool isEffected(EffectId effect, bool exactMatch = false) const;
     [[nodiscard]] bool isEffected(EffectInfo* effect) const;
     [[nodiscard]] bool hasPermEffect(std::string_view effect) const;
     [[nodiscard]] EffectInfo* getEffect(std::string_view effect) const;
@@ -137,9 +140,10 @@ class MudObject: public std::enable_shared_from_this<MudObject> {
 
 // Delayed Actions
     void interruptDelayedActions();
-    void removeDelayedAction(DelayedAction* action);
-    void addDelayedAction(DelayedAction* action);
+    void removeDelayedAction(DelayedActionRef action);
+    void addDelayedAction(DelayedActionRef action);
     void clearDelayedActions();
+    [[nodiscard]] const std::list<DelayedActionRef>& getDelayedActions() const;
 
 protected:
     virtual void removeFromSet();
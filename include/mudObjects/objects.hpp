@@ -26,10 +26,12 @@
 #include "alchemy.hpp"
 #include "catRef.hpp"
 #include "container.hpp"
+#include "cow.hpp"
 #include "dice.hpp"
 #include "global.hpp"
 #include "lasttime.hpp"
 #include "json.hpp"
+#include "keyTxt.hpp"
 #include "enums/loadType.hpp"
 #include "money.hpp"
 #include "range.hpp"
@@ -174,6 +176,7 @@ class Object: public Container, public Containable {
     bool operator==(const Object& o) const;
     bool operator!=(const Object& o) const;
     bool operator< (const Object& t) const;
+    const std::string* refreshSortKey() override;
     void validateId() override;
 
 protected:
@@ -218,6 +221,8 @@ class Object: public Container, public Containable {
     short extra;
     std::string questOwner;
 
+    mutable KeyTxt keyTxt;  // Built from key, the name and label when first needed
+
 protected:
     void objCopy(const Object& o);
     void selectRandom();  // become a random object
@@ -228,7 +233,7 @@ class Object: public Container, public Containable {
     ObjIncrease* increase = nullptr;
 
     // Strings
-    std::string description;
+    Cow<std::string> description; // Shared with the prototype until changed
     std::string version;    // What version of the mud this object was saved under
     std::string lastMod;    // Last staff member to modify object.
 
@@ -296,6 +301,8 @@ class Object: public Container, public Containable {
 
 //    char* cmpName();
     void escapeText();
+    [[nodiscard]] const KeyTxt& getKeyTxt() const;
+    void refreshKeyTxt() override;
     [[nodiscard]] bool isBroken() const;
 
     [[nodiscard]] std::string getFlagList(std::string_view sep=", ") const override;
@@ -18,7 +18,9 @@
 
 #pragma once
 
+#include <memory>
 #include <string>
+#include <vector>
 
 #include "mudObjects/creatures.hpp"
 
@@ -39,6 +41,8 @@ class Player : public Creature {
     void delList(std::list<std::string> &list, const std::string &name);
     int doDeleteFromRoom(std::shared_ptr<BaseRoom> room, bool delPortal) override;
     void finishAddPlayer(const std::shared_ptr<BaseRoom>& room);
+    void markNearbyRooms(const std::shared_ptr<BaseRoom>& room);
+    void clearNearbyRooms();
     long getInterest(long principal, double annualRate, long seconds);
 
 public:
@@ -48,6 +52,8 @@ class Player : public Creature {
     Player(const Player& cr);
     Player& operator=(const Player& cr);
     bool operator< (const Player& t) const;
+    const std::string* refreshSortKey() override;
+    [[nodiscard]] const std::string* getSortKey() const override;
     ~Player() override;
     int save(bool updateTime=false, LoadType saveType=LoadType::LS_NORMAL);
     int saveToFile(LoadType saveType=LoadType::LS_NORMAL);
@@ -63,6 +69,7 @@ class Player : public Creature {
 
     std::string proxyName;
     std::string proxyId;
+    std::vector<std::weak_ptr<BaseRoom>> nearbyRooms; // Rooms whose nearby player count includes us
 
     char customColors[CUSTOM_COLOR_SIZE]{};
     unsigned short warnings{};
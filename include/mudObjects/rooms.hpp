@@ -44,6 +44,7 @@ class BaseRoom: public Container {
     void BaseDestroy();
     std::string version;    // What version of the mud this object was saved under
     bool tempNoKillDarkmetal;
+    int nearbyPlayers{};    // Players within a few exits of this room, including any in it
 
 public:
     //xtag  *first_ext;     // Exits
@@ -101,6 +102,9 @@ class BaseRoom: public Container {
     [[nodiscard]] bool isOutlawSafe() const;
     [[nodiscard]] bool isPkSafe() const;
     [[nodiscard]] bool isFastTick() const;
+    [[nodiscard]] int getNearbyPlayers() const;
+    bool addNearbyPlayer();
+    void removeNearbyPlayer();
 
 
     [[nodiscard]] virtual bool flagIsSet(int flag) const = 0;
@@ -71,6 +71,7 @@ class UniqueRoom: public BaseRoom {
     [[nodiscard]] bool swapIsInteresting(const Swap& s) const;
 
     std::string getMsdp(bool showExits = true) const override;
+    [[nodiscard]] size_t getCacheCost() const;
 protected:
     boost::dynamic_bitset<> flags{128};
     std::string fishing;
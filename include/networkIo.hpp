@@ -0,0 +1,94 @@
+/*
+ * networkIo.h
+ *   Threads that read from and write to the players' sockets
+ *   ____            _
+ *  |  _ \ ___  __ _| |_ __ ___  ___
+ *  | |_) / _ \/ _` | | '_ ` _ \/ __|
+ *  |  _ <  __/ (_| | | | | | | \__ \
+ *  |_| \_\___|\__,_|_|_| |_| |_|___/
+ *
+ * Permission to use, modify and distribute is granted via the
+ *  GNU Affero General Public License v3 or later
+ *
+ *  Copyright (C) 2007-2021 Jason Mitchell, Randi Mitchell
+ *     Contributions by Tim Callahan, Jonathan Hseu
+ *  Based on Mordor (C) Brooke Paul, Brett J. Vickers, John P. Freeman
+ *
+ */
+
+#pragma once
+
+#include <atomic>
+#include <chrono>
+#include <memory>
+#include <thread>
+#include <unordered_map>
+#include <vector>
+
+#include "reactor.hpp"                              // for Reactor
+#include "spscQueue.hpp"                            // for SpscQueue
+
+class SocketIo;
+
+// Number of network threads; each socket is given to one of them for good
+const int NETWORK_IO_THREADS = 2;
+// How long a closed socket's last output gets to go out before the descriptor is closed anyway
+const std::chrono::seconds NETWORK_IO_LINGER{10};
+
+// A small pool of threads, each with its own reactor, that do all the socket
+// reads and writes, telnet parsing and MCCP compression, so a slow client or
+// a lot of output never holds up the game loop.
+//
+// Input comes back through each SocketIo's queue for the game loop to pick up
+// once a pass.  Output is queued on the SocketIo and the socket put on its
+// thread's list; kick() then wakes every thread with something on its list,
+// once a pass rather than once a write.
+//
+// Everything public belongs to the game thread.
+class NetworkIo {
+public:
+    NetworkIo();
+    ~NetworkIo();
+    NetworkIo(const NetworkIo&) = delete;
+    NetworkIo& operator=(const NetworkIo&) = delete;
+
+    void add(const std::shared_ptr<SocketIo>& sock);
+    void queue(const std::shared_ptr<SocketIo>& sock);
+    void kick();
+
+    // Traffic since the last call is added on
+    void collectStats(long& inBytes, long& outBytes);
+    void countIn(long n);
+    void countOut(long n);
+
+    // Everything already queued is written out (as far as the clients will
+    // take it) before the threads exit.  Sockets that weren't closed are left
+    // open, so they survive a reboot.
+    void stop();
+
+private:
+    struct Worker {
+        Reactor reactor;
+        int wakeFd = -1;
+        std::thread thread;
+        SpscQueue<std::shared_ptr<SocketIo>> pending;   // Sockets with output or a close to handle
+        std::atomic<bool> dirty{false};                 // Something was added to pending since the last kick
+        std::unordered_map<int, std::shared_ptr<SocketIo>> sockets;    // By fd; thread only
+        std::vector<std::shared_ptr<SocketIo>> lingering;              // Closed, still sending; thread only
+    };
+
+    void start();
+    void run(Worker& worker);
+    void service(Worker& worker, const std::shared_ptr<SocketIo>& sock);
+    void drain(Worker& worker);
+    void linger(Worker& worker, const std::shared_ptr<SocketIo>& sock);
+    void finishClose(Worker& worker, const std::shared_ptr<SocketIo>& sock);
+    void expireLingering(Worker& worker, bool all);
+
+    std::vector<std::unique_ptr<Worker>> workers;
+    int nextWorker = 0;
+    std::atomic<bool> stopping{false};
+    bool stopped = false;
+    std::atomic<long> bytesIn{0};
+    std::atomic<long> bytesOut{0};
+};
@@ -0,0 +1,70 @@
+/*
+ * outputQueue.h
+ *   Per socket queue of processed output waiting to be written
+ *   ____            _
+ *  |  _ \ ___  __ _| |_ __ ___  ___
+ *  | |_) / _ \/ _` | | '_ ` _ \/ __|
+ *  |  _ <  __/ (_| | | | | | | \__ \
+ *  |_| \_\___|\__,_|_|_| |_| |_|___/
+ *
+ * Permission to use, modify and distribute is granted via the
+ *  GNU Affero General Public License v3 or later
+ *
+ *  Copyright (C) 2007-2021 Jason Mitchell, Randi Mitchell
+ *     Contributions by Tim Callahan, Jonathan Hseu
+ *  Based on Mordor (C) Brooke Paul, Brett J. Vickers, John P. Freeman
+ *
+ */
+
+#pragma once
+
+#include <sys/types.h>  // for ssize_t
+#include <deque>
+#include <memory>
+#include <string>
+#include <string_view>
+#include <vector>
+
+// A chain of fixed size chunks.  Data is appended to the tail chunk and
+// the whole chain is handed to writev() in one call; fully written chunks are
+// recycled instead of freed.  Buffers shared with other sockets (broadcasts)
+// go into the chain as they are, and are written straight from the buffer.
+class OutputQueue {
+public:
+    static constexpr size_t CHUNK_SIZE = 4096;
+
+    OutputQueue() = default;
+    OutputQueue(const OutputQueue&) = delete;
+    OutputQueue& operator=(const OutputQueue&) = delete;
+
+    void append(std::string_view data);
+    void append(std::shared_ptr<const std::string> data);
+
+    // Write as much as the descriptor will take.  Returns the number of bytes
+    // written, or -1 on an error other than EWOULDBLOCK.
+    ssize_t writeTo(int fd);
+
+    void clear();
+    [[nodiscard]] bool empty() const;
+    [[nodiscard]] size_t size() const;
+
+private:
+    struct Chunk {
+        char data[CHUNK_SIZE];
+    };
+
+    struct Segment {
+        std::unique_ptr<Chunk> chunk{};                 // Either our own chunk...
+        std::shared_ptr<const std::string> shared{};    // ...or a buffer other sockets are sending too
+        size_t start = 0;                               // First unwritten byte
+        size_t end = 0;                                 // One past the last byte appended
+        [[nodiscard]] const char* data() const { return(chunk ? chunk->data : shared->data()); }
+    };
+
+    std::unique_ptr<Chunk> newChunk();
+    void consume(size_t n);
+
+    std::deque<Segment> chunks;
+    std::vector<std::unique_ptr<Chunk>> spare;
+    size_t bytes = 0;
+};
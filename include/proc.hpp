@@ -7,7 +7,6 @@
 #include <string>
 
 enum class ChildType {
-    DNS_RESOLVER,
     LISTER,
     DEMOGRAPHICS,
     SWAP_FIND,
@@ -23,16 +22,20 @@ struct childProcess {
     ChildType type;
     int fd; // Fd if any we should watch
     std::string extra;
+    bool readable; // Output is waiting on fd
+    bool hungUp;   // The child closed its end of the pipe
     childProcess() {
         pid = 0;
         fd = -1;
         extra = "";
         type = ChildType::UNKNOWN;
+        readable = hungUp = false;
     }
     childProcess(int p, ChildType t, int f = -1, std::string_view e = "") {
         pid = p;
         type = t;
         fd = f;
         extra = e;
+        readable = hungUp = false;
     }
 };
@@ -34,6 +34,7 @@ class CatRefInfo;
 class Creature;
 class Container;
 class GuildCreation;
+class KeyTxtQuery;
 class Location;
 class MapMarker;
 class MudObject;
@@ -52,6 +53,7 @@ float getPercentRemaining(int current, int maximum);
 
 // Container
 bool isMatch(const std::shared_ptr<const Creature>& searcher, const std::shared_ptr<MudObject>& target, const std::string& name, bool exactMatch, bool checkVisibility = false);
+bool isMatch(const std::shared_ptr<const Creature>& searcher, const std::shared_ptr<MudObject>& target, const KeyTxtQuery& query, bool checkVisibility = false);
 
 
 // Socials
@@ -101,6 +103,8 @@ namespace Pueblo {
 char keyTxtConvert(unsigned char c);
 std::string keyTxtConvert(std::string_view txt);
 bool keyTxtCompare(const char* key, const char* txt, int tLen);
+bool keyTxtEqual(const std::shared_ptr<Creature> & target, const KeyTxtQuery& query);
+bool keyTxtEqual(const std::shared_ptr<Object>& target, const KeyTxtQuery& query);
 bool keyTxtEqual(const std::shared_ptr<Creature> & target, const char* txt);
 bool keyTxtEqual(const std::shared_ptr<Object>  target, const char* txt);
 bool isPrintable(char c);
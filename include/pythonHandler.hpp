@@ -24,15 +24,47 @@
 #include <pybind11/pytypes.h>
 #include <pybind11/embed.h>
 
+#include <ctime>
+#include <memory>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
 namespace py = pybind11;
 using namespace py::literals;
 
+class MudObject;
+class Socket;
+
+// A script's source compiled once into a code object, along with how often and
+// how long it has run
+struct CompiledScript {
+    std::string source;
+    py::object code;
+    bool expression{};
+    int running{};
+    long calls{};
+    long errors{};
+    double totalTime{};     // Microseconds
+    time_t lastUsed{};
+};
+
 class PythonHandler {
     friend class Server;
 private:
     // Our main namespace for python
     py::object mainNamespace;
 
+    // Keyed on a hash of the source; an edited hook hashes differently, so it is
+    // compiled fresh and the old code object ages out
+    std::unordered_map<size_t, CompiledScript> scripts;
+    // Cleared locals dictionaries waiting to be reused
+    std::vector<py::dict> localsPool;
+
+    CompiledScript* getScript(const std::string& pyScript, bool expression);
+    void pruneScripts(time_t t);
+    py::object runCompiled(const std::string& pyScript, py::object& locals, bool expression);
+
 public:
     // Python
     static bool initPython();
@@ -46,6 +78,19 @@ class PythonHandler {
 
     static bool addMudObjectToDictionary(py::object& dictionary, const std::string& key, std::shared_ptr<MudObject> myObject);
 
+    py::dict acquireLocals();
+    void releaseLocals(py::dict& locals);
+    void clearScripts();
+    void showScriptStats(const std::shared_ptr<Socket>& sock, bool all) const;
 
 };
 
+// A locals dictionary borrowed from the handler's pool for the length of one
+// script run; it's cleared and handed back when this goes out of scope
+class PooledLocals : public py::dict {
+public:
+    PooledLocals();
+    ~PooledLocals();
+    PooledLocals(const PooledLocals&) = delete;
+    PooledLocals& operator=(const PooledLocals&) = delete;
+};
@@ -0,0 +1,72 @@
+/*
+ * reactor.h
+ *   Edge triggered epoll event loop for the server's descriptors
+ *   ____            _
+ *  |  _ \ ___  __ _| |_ __ ___  ___
+ *  | |_) / _ \/ _` | | '_ ` _ \/ __|
+ *  |  _ <  __/ (_| | | | | | | \__ \
+ *  |_| \_\___|\__,_|_|_| |_| |_|___/
+ *
+ * Permission to use, modify and distribute is granted via the
+ *  GNU Affero General Public License v3 or later
+ *
+ *  Copyright (C) 2007-2021 Jason Mitchell, Randi Mitchell
+ *     Contributions by Tim Callahan, Jonathan Hseu
+ *  Based on Mordor (C) Brooke Paul, Brett J. Vickers, John P. Freeman
+ *
+ */
+
+#pragma once
+
+#include <cstdint>
+#include <memory>
+#include <vector>
+
+class Socket;
+
+enum class WatchType {
+    NONE,
+    LISTENER,   // One of the server's control sockets
+    SOCKET,     // A connected player socket
+    CHILD,      // The read end of a child process's pipe
+    WAKEUP,     // An eventfd used to wake a network thread
+};
+
+class Reactor {
+public:
+    struct Event {
+        int fd;
+        uint32_t events;
+        WatchType type;
+    };
+
+    Reactor();
+    ~Reactor();
+    Reactor(const Reactor&) = delete;
+    Reactor& operator=(const Reactor&) = delete;
+
+    bool watch(int fd, WatchType type, const std::shared_ptr<Socket>& sock = nullptr);
+    void unwatch(int fd);
+    // Sockets only ask for EPOLLOUT while they have output they couldn't write
+    void setWriteInterest(int fd, bool wantWrite);
+
+    // Wait up to timeout milliseconds for any descriptor to become ready
+    int wait(int timeout);
+    [[nodiscard]] const std::vector<Event>& getEvents() const;
+    [[nodiscard]] std::shared_ptr<Socket> getSocket(int fd) const;
+
+    [[nodiscard]] bool isValid() const;
+    [[nodiscard]] size_t getNumWatched() const;
+
+private:
+    struct Watch {
+        WatchType type = WatchType::NONE;
+        bool wantWrite = false;
+        std::weak_ptr<Socket> sock;
+    };
+
+    int epollFd;
+    size_t numWatched;
+    std::vector<Watch> watches;    // Indexed by file descriptor
+    std::vector<Event> events;     // Results from the last call to wait()
+};
@@ -0,0 +1,80 @@
+/*
+ * saveQueue.h
+ *   Background writer for player files
+ *   ____            _
+ *  |  _ \ ___  __ _| |_ __ ___  ___
+ *  | |_) / _ \/ _` | | '_ ` _ \/ __|
+ *  |  _ <  __/ (_| | | | | | | \__ \
+ *  |_| \_\___|\__,_|_|_| |_| |_|___/
+ *
+ * Permission to use, modify and distribute is granted via the
+ *  GNU Affero General Public License v3 or later
+ *
+ *  Copyright (C) 2007-2021 Jason Mitchell, Randi Mitchell
+ *     Contributions by Tim Callahan, Jonathan Hseu
+ *  Based on Mordor (C) Brooke Paul, Brett J. Vickers, John P. Freeman
+ *
+ */
+
+#pragma once
+
+#include <sys/types.h>
+#include <condition_variable>
+#include <deque>
+#include <filesystem>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <unordered_map>
+
+namespace fs = std::filesystem;
+
+// Number of older copies kept when a backup file is overwritten: name.bak.1.xml, name.bak.2.xml, ...
+const int PLAYER_BACKUPS = 3;
+
+// Files handed to the queue are written by a background thread: to a temp file
+// first, which is fsync'd and then renamed over the real one, so a crash leaves
+// either the old file or the new one and never half of each.  If a file is
+// queued again before the writer gets to it, only the newest contents are written.
+class SaveQueue {
+public:
+    SaveQueue();
+    ~SaveQueue();
+
+    void push(const fs::path& filename, std::string contents, int backups=0);
+
+    // Blocks until everything queued so far is on disk
+    void flush();
+    // Blocks until the given file has no write pending; call before reading or removing it
+    void wait(const fs::path& filename);
+    // Flushes and stops the writer thread; anything pushed afterwards is written immediately
+    void stop();
+
+    [[nodiscard]] size_t getPending();
+    [[nodiscard]] unsigned long getWritten();
+    [[nodiscard]] unsigned long getCoalesced();
+
+private:
+    struct Job {
+        std::string contents;
+        int backups = 0;
+    };
+
+    void run();
+    [[nodiscard]] bool isAsync() const;
+    static bool writeFile(const fs::path& filename, const Job& job);
+    static void rotateBackups(const fs::path& filename, int backups);
+
+    std::mutex lock;
+    std::condition_variable wake;   // Writer: there's work to do
+    std::condition_variable done;   // Waiters: a file has been written
+
+    std::deque<std::string> order;                  // Oldest first
+    std::unordered_map<std::string, Job> pending;   // Newest contents for each queued file
+    std::string writing;                            // File the writer currently has in hand
+    unsigned long written = 0;
+    unsigned long coalesced = 0;
+    bool stopping = false;
+    std::thread writer;
+    pid_t owner = -1;   // Forked children don't get the writer thread, they write directly
+};
@@ -28,6 +28,7 @@ namespace odbc {
 
 #include <list>
 #include <map>
+#include <unordered_map>
 #include <vector>
 
 // C Includes
@@ -35,9 +36,16 @@ namespace odbc {
 
 #include "catRef.hpp"
 #include "delayedAction.hpp"
+#include "dnsResolver.hpp"
+#include "idIndex.hpp"
 #include "money.hpp"
+#include "networkIo.hpp"
 #include "proc.hpp"
+#include "reactor.hpp"
+#include "saveQueue.hpp"
+#include "socketTable.hpp"
 #include "swap.hpp"
+#include "timerWheel.hpp"
 #include "weather.hpp"
 #include "lru/lru.hpp"
 
@@ -76,47 +84,24 @@ struct CleanupRoomFn {
     void operator()(const std::shared_ptr<UniqueRoom>& r );
 };
 
+struct RoomCostFn {
+    size_t operator()(const std::shared_ptr<UniqueRoom>& r );
+};
+
 enum GoldLog {
     GOLD_IN,
     GOLD_OUT
 };
 
-// Custom comparison operator to sort by the numeric id instead of standard string comparison
-auto idComp = [](const std::string& lhs, const std::string& rhs) {
-    std::stringstream strL(lhs);
-    std::stringstream strR(rhs);
-
-    char charL, charR;
-    long longL, longR;
-
-    strL >> charL >> longL;
-    strR >> charR >> longR;
-
-    if(charL == charR) {
-        if(charL == 'R') {
-            // Rooms work a bit differently
-            return(lhs < rhs);
-        }
-        else {
-            return (longL < longR);
-        }
-    } else {
-        return(charL < charR);
-    }
-    return(true);
-};
-
 #include "async.hpp"
 
-typedef std::map<std::string, std::weak_ptr<MudObject>, decltype(idComp)> IdMap;
 using WeakMonsterList = std::list<std::weak_ptr<Monster> >;
 using MonsterList = std::list<std::shared_ptr<Monster> >;
 using GroupList = std::list<Group*>;
-using SocketList = std::list<std::shared_ptr<Socket>>;
 using SocketVector= std::vector<std::weak_ptr<Socket>>;
 using PlayerMap = std::map<std::string, std::shared_ptr<Player>>;
 
-using RoomCache = LRU::lru_cache<CatRef, std::shared_ptr<UniqueRoom>, CleanupRoomFn, CanCleanupRoomFn>;
+using RoomCache = LRU::lru_cache<CatRef, std::shared_ptr<UniqueRoom>, CleanupRoomFn, CanCleanupRoomFn, RoomCostFn>;
 using MonsterCache = LRU::lru_cache<CatRef, Monster >;
 using ObjectCache = LRU::lru_cache<CatRef, Object >;
 
@@ -143,9 +128,11 @@ class Server {
     struct controlSock {
         int port;
         int control;
+        bool pending; // Connections are waiting to be accepted
         controlSock(int port, int control) {
             this->port = port;
             this->control = control;
+            this->pending = false;
         }
     };
 
@@ -153,11 +140,14 @@ class Server {
         std::string ip;
         std::string hostName;
         time_t time;
-        dnsCache(std::string_view pIp, std::string_view pHostName, time_t pTime) {
+        bool found;     // False if the lookup failed and hostName is just the ip
+        dnsCache(std::string_view pIp, std::string_view pHostName, time_t pTime, bool pFound = true) {
             ip = pIp;
             hostName = pHostName;
             time = pTime;
+            found = pFound;
         }
+        [[nodiscard]] bool isExpired(time_t t) const;
         bool operator==(const dnsCache& o) const {
             return(ip == o.ip && hostName == o.hostName);
         }
@@ -165,27 +155,29 @@ class Server {
 
 public:
     PlayerMap players; // Map of all players
-    SocketList sockets; // List of all connected sockets
-    SocketVector* vSockets = nullptr;
+    SocketTable sockets; // All connected sockets
 
     RoomCache roomCache;
     MonsterCache monsterCache;
     ObjectCache objectCache;
 
+    SaveQueue playerSaves; // Player files are written out in the background
+    TimerWheel timers; // Delayed actions and periodic game updates
+
 // ******************
 // Internal Variables
 private:
 
-    std::list<DelayedAction> delayedActionQueue;
+    DelayedActionQueue delayedActionQueue;
 
     PythonHandler* pythonHandler;
     HttpServer* httpServer;
 
     std::list<std::weak_ptr<BaseRoom>> effectsIndex;
 
-    fd_set inSet{};
-    fd_set outSet{};
-    fd_set excSet{};
+    Reactor reactor; // Watches the control sockets and child pipes
+    NetworkIo network; // Reads and writes the player sockets on their own threads
+    SocketVector msdpQueue; // Sockets with MSDP variables to send this pulse
 
     bool running; // True while the game is up and bound to a port
     long pulse; // Current pulse
@@ -195,7 +187,7 @@ class Server {
     bool valgrind;
 
     // List of Ids
-    IdMap registeredIds;
+    IdIndex registeredIds;
     // List of groups
     GroupList groups;
 
@@ -207,7 +199,8 @@ class Server {
 
     std::list<childProcess> children; // List of child processes
     std::list<controlSock> controlSocks; // List of control fds
-    std::list<dnsCache> cachedDns; // Cache of DNS lookups
+    std::unordered_map<std::string, dnsCache> cachedDns; // Cache of DNS lookups, by ip
+    DnsResolver resolver;
     WebInterface* webInterface;
     dpp::cluster *discordBot{};
     dpp::commandhandler *commandHandler{};
@@ -220,6 +213,8 @@ class Server {
     long lastRoomPulseUpdate;
     long lastRandomUpdate;
     long lastActiveUpdate;
+    TimerHandle randomTimer;
+    TimerHandle actionTimer;
 
 public:
     std::list<std::shared_ptr<Area> > areas;
@@ -237,7 +232,8 @@ class Server {
 
     // Game & Socket methods
     int handleNewConnection(controlSock& control);
-    int poll(); // Poll all descriptors for input
+    int poll(int timeout); // Wait up to timeout ms for any descriptors to become ready
+    void dispatchEvent(const Reactor::Event& event);
     int checkNew(); // Accept new connections
     int processInput(); // Process input from users
     int processCommands(); // Process commands from users
@@ -252,6 +248,7 @@ class Server {
     bool saveRebootFile(bool resetShips = false);
 
     // Updates
+    void scheduleUpdates();
     void updateGame();
     void processMsdp();
     void pulseTicks(long t);
@@ -267,7 +264,8 @@ class Server {
     void updateAction(long t);
 
     // DNS
-    void addCache(std::string_view ip, std::string_view hostName, time_t t = -1);
+    void addCache(std::string_view ip, std::string_view hostName, time_t t = -1, bool found = true);
+    void finishDnsLookups();
     void saveDnsCache();
     void loadDnsCache();
     void pruneDns();
@@ -275,11 +273,9 @@ class Server {
     int installPrintfHandlers();
     static void installSignalHandlers();
 
-    void populateVSockets();
-
     // Delayed Actions
 protected:
-    void parseDelayedActions(long t);
+    void runDelayedAction(DelayedActionRef action);
 
 #ifdef SQL_LOGGER
 
@@ -363,10 +359,17 @@ class Server {
 // Public methods for server class
 public:
     void showMemory(std::shared_ptr<Socket> sock, bool extended=false);
+    void showCacheStats(std::shared_ptr<Socket> sock, bool extended=false);
+
+    // MSDP
+    void queueMsdp(const std::shared_ptr<Socket>& sock);
 
     // Child processes
     void addChild(int pid, ChildType pType, int pFd = -1, std::string_view pExtra = "");
 
+    // Stop watching a descriptor; must be called before it's closed
+    void unwatch(int fd);
+
 
     // Setup
     bool init();    // Setup the server
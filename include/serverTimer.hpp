@@ -30,5 +30,5 @@ class ServerTimer {
 public:
     void start();
     void end();
-    void sleep();
+    [[nodiscard]] int getTimeLeft() const; // Milliseconds left in this pulse
 };
@@ -25,12 +25,15 @@
 // C++ Includes
 #include <list>
 #include <map>
-#include <queue>
+#include <memory>
+#include <utility>
 #include <vector>
 #include <string>
 #include <fmt/format.h>
 
 #include "msdp.hpp"                                 // for ReportedMsdpVariable
+#include "socketIo.hpp"                             // for SocketIo, InputEvent
+#include "socketTable.hpp"                          // for SocketHandle, SocketTable
 
 // Defines needed
 
@@ -44,6 +47,7 @@ extern long UnCompressedBytes;
 extern long OutBytes;
 
 class Player;
+class SharedOutput;
 
 typedef struct _xmlNode xmlNode;
 typedef xmlNode *xmlNodePtr;
@@ -131,6 +135,7 @@ namespace telnet {
 
 class Socket : public std::enable_shared_from_this<Socket> {
     friend class Server;
+    friend class SocketTable;
     struct Host {
         std::string hostName;
         std::string ip;
@@ -192,12 +197,17 @@ class Socket : public std::enable_shared_from_this<Socket> {
     void askFor(const char *str);
 
     void vprint(const char *fmt, va_list ap);
+    static std::string renderPrint(int flags, int wrap, const char *fmt, va_list ap);
+    static std::string wrapPrint(int wrap, std::string msg);
 
     void bprint(std::string_view toPrint);
+    // A broadcast other sockets are getting too; only transcoded once per kind of client
+    void bprint(const std::shared_ptr<const SharedOutput>& toPrint);
     void bprintPython(const std::string& toPrint);
 
+    // Type checked at compile time; use CrtName/ObjName (mudFormat.hpp) in place of %M/%O
     template <typename... Args>
-    void bprint(std::string_view toPrint, Args &&... args) const {
+    void bprint(fmt::format_string<Args...> toPrint, Args &&... args) {
         return bprint(fmt::format(toPrint, std::forward<Args>(args)...));
     }
 
@@ -205,7 +215,7 @@ class Socket : public std::enable_shared_from_this<Socket> {
     void appendPaged(std::string_view toPrint);
 
     template <typename... Args>
-    void printPaged(std::string_view toPrint, Args &&... args) const {
+    void printPaged(fmt::format_string<Args...> toPrint, Args &&... args) {
         return printPaged(fmt::format(toPrint, std::forward<Args>(args)...));
     }
     void println(std::string_view toPrint = "");
@@ -213,9 +223,8 @@ class Socket : public std::enable_shared_from_this<Socket> {
     void printColor(const char* format, ...);
 
     std::string parseForOutput(std::string_view outBuf);
-    std::string getColorCode(unsigned char ch);
 
-    int processInput();
+    int processInput(); // Take whatever the network thread has read
     int processOneCommand();
 
     void reconnect(bool pauseScreen=false);
@@ -224,6 +233,11 @@ class Socket : public std::enable_shared_from_this<Socket> {
 
     void flush(); // Flush any pending output
 
+    // Once this much output is pending, further output is discarded until the client catches up
+    void setOutputHighWater(size_t bytes);
+    [[nodiscard]] bool isOutputThrottled() const;
+    [[nodiscard]] size_t getPendingOutput() const;
+
 
     int startCompress(bool silent = false);
     int endCompress();
@@ -236,6 +250,7 @@ class Socket : public std::enable_shared_from_this<Socket> {
 // End Telopt related
 
     [[nodiscard]] int getFd() const;
+    [[nodiscard]] SocketHandle getHandle() const;
     [[nodiscard]] bool isConnected() const;
     [[nodiscard]] int getState() const;
     [[nodiscard]] std::string_view getIp() const;
@@ -266,6 +281,7 @@ class Socket : public std::enable_shared_from_this<Socket> {
     [[nodiscard]] int getColorOpt() const;
     [[nodiscard]] int getTermCols() const;
     [[nodiscard]] int getTermRows() const;
+    [[nodiscard]] int getWrapWidth() const;
 
     void setColorOpt(int opt);
 
@@ -291,24 +307,31 @@ class Socket : public std::enable_shared_from_this<Socket> {
     void msdpSendList(std::string_view variable, const std::vector<std::string>& values);
     void msdpClearReporting();
     std::string getMsdpReporting();
+    void msdpNotify(MsdpEvent event);
+    void msdpFlush(long now);
+    [[nodiscard]] bool msdpPollDue(long now) const;
 
 protected:
+    bool discardOutput();
+    ssize_t write(const SharedOutput& toWrite);
+    void writeToSpies(std::string_view toWrite);
+
     // Telopt related
-    bool negotiate(unsigned char ch);
-    //bool subNegotiate(unsigned char ch);
-    bool handleNaws(int& colRow, unsigned char& chr, bool high);
-    size_t processCompressed(); // Mccp
+    void handleEvent(const InputEvent& event);
+    bool negotiate(unsigned char verb, unsigned char option);
+    void setTermType(const std::string& type);
 
-    bool parseMXPSecure();
+    bool parseMXPSecure(const std::string& toParse);
 
     // MSDP Support Functions
-    bool parseMsdp();
+    bool parseMsdp(std::string_view sub);
     bool processMsdpVarVal(const std::string &variable, const std::string &value);
     bool msdpSend(const std::string &variable);
     bool msdpList(const std::string &value);
     ReportedMsdpVariable* msdpReport(const std::string &value);
     bool msdpReset(std::string& value);
     bool msdpUnReport(const std::string &value);
+    void msdpResubscribe();
 
 // TODO - Retool so they can be moved to protected
 public:
@@ -320,6 +343,9 @@ class Socket : public std::enable_shared_from_this<Socket> {
 
 protected:
     int         fd;                 // File Descriptor of this socket
+    std::shared_ptr<SocketIo> io;   // The half that lives on a network thread
+    SocketTable* table{};           // Mirrors our state, fd and whether there's output while we're in it
+    SocketHandle handle;
     Host        host;
     bool        dnsDone{};
     Term        term;
@@ -328,28 +354,18 @@ class Socket : public std::enable_shared_from_this<Socket> {
     int         lastState{};
     int         connState{};
 
-    int         tState{};
-    bool        oneIAC{};
-    bool        watchBrokenClient{};
-
-    std::stringstream output;
-    std::string       processedOutput;   // Output that has been processed but not fully sent (in the case of EWOULDBLOCK for example)
+    std::string output;                 // Output that hasn't been processed yet
+    std::vector<std::pair<size_t, std::shared_ptr<const SharedOutput>>> sharedOutput;  // Broadcasts waiting with it, and where in output they go
+    std::string transcoded;             // Scratch space for write(), reused so it doesn't reallocate every time
+    size_t      outputHighWater{};
+    bool        outputThrottled{};
 
-    std::queue<std::string> input;      // Processed Input buffer
-
-    // IAC buffer, we make it a vector so that it will handle NUL bytes and other characters and still report the correct size()/length()
-    std::vector<unsigned char>  cmdInBuf;
-    std::string     inBuf;              // Input Buffer
     std::string     inLast;             // Last command
 
     bool registered{};
     std::shared_ptr<Player>     myPlayer{};
 
 
-// For MCCP
-    char        *outCompressBuf{};
-    z_stream    *outCompress{};
-
 // Old items from IOBUF that we might keep
     void        (*fn)(std::shared_ptr<Socket>, const std::string&){};
     char        fnparam{};
@@ -357,6 +373,10 @@ class Socket : public std::enable_shared_from_this<Socket> {
     std::weak_ptr<Socket> spyingOn{};      // Socket we are spying on
     std::list<std::weak_ptr<Socket>> spying;    // Sockets spying on us
     std::map<std::string, ReportedMsdpVariable> msdpReporting;
+    uint32_t msdpSubscribed{};  // Events any reported variable listens for
+    uint32_t msdpPending{};     // Events published since the last flush
+    long msdpNextPoll{};        // When the next polled variable is due, 0 if none
+    bool msdpQueued{};          // Already waiting in Server::msdpQueue
 // TEMP
 public:
     long        ltime{};
@@ -366,7 +386,7 @@ class Socket : public std::enable_shared_from_this<Socket> {
     std::deque<std::string> pagerOutput;
 
 public:
-    static const int COMPRESSED_OUTBUF_SIZE;
+    static const size_t OUTPUT_HIGH_WATER;
 
 public:
     static int getNumSockets();
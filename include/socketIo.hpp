@@ -0,0 +1,163 @@
+/*
+ * socketIo.h
+ *   The half of a socket that lives on a network thread
+ *   ____            _
+ *  |  _ \ ___  __ _| |_ __ ___  ___
+ *  | |_) / _ \/ _` | | '_ ` _ \/ __|
+ *  |  _ <  __/ (_| | | | | | | \__ \
+ *  |_| \_\___|\__,_|_|_| |_| |_|___/
+ *
+ * Permission to use, modify and distribute is granted via the
+ *  GNU Affero General Public License v3 or later
+ *
+ *  Copyright (C) 2007-2021 Jason Mitchell, Randi Mitchell
+ *     Contributions by Tim Callahan, Jonathan Hseu
+ *  Based on Mordor (C) Brooke Paul, Brett J. Vickers, John P. Freeman
+ *
+ */
+
+#pragma once
+
+#include <zlib.h>
+#include <atomic>
+#include <chrono>
+#include <cstdint>
+#include <memory>
+#include <string>
+#include <string_view>
+
+#include "inputRing.hpp"                            // for InputRing
+#include "outputQueue.hpp"                          // for OutputQueue
+#include "spscQueue.hpp"                            // for SpscQueue
+
+class NetworkIo;
+
+// Telnet the network thread read from the client, in the order it arrived;
+// lines of input go through the socket's InputRing instead
+struct InputEvent {
+    enum Kind : uint8_t {
+        Negotiate,      // IAC verb option
+        Naws,           // New window size
+        TermType,       // TTYPE IS; data is the terminal type
+        Charset,        // CHARSET reply; value is ACCEPTED or REJECTED
+        Msdp,           // data is the MSDP subnegotiation
+        MxpSecure,      // data is the line sent in MXP secure mode
+    };
+
+    Kind kind = Negotiate;
+    unsigned char verb = 0;
+    unsigned char value = 0;
+    int cols = 0;
+    int rows = 0;
+    std::string data{};
+};
+
+// Something the game wants done with the client, in the order it asked
+struct OutputEvent {
+    enum Kind : uint8_t {
+        Data,           // Already rendered; send as is
+        StartCompress,  // Everything after this is MCCP compressed
+        EndCompress,
+        Close,          // Send what's left and close the descriptor
+    };
+
+    Kind kind = Data;
+    std::string data{};
+    std::shared_ptr<const std::string> shared{};    // Sent instead of data when set, without a copy
+};
+
+// Socket is split in two: the game thread keeps everything the game looks at
+// (options, terminal, player, paging), and a network thread owns this half,
+// which does the reading, telnet parsing, compression and writing.  The two
+// halves only talk through a pair of single producer/consumer queues and a
+// few atomics.
+//
+// The public methods belong to the game thread; the rest to whichever network
+// thread the socket was given to (or to the game thread once the network
+// threads have stopped).
+class SocketIo : public std::enable_shared_from_this<SocketIo> {
+    friend class NetworkIo;
+public:
+    explicit SocketIo(int pFd);
+    ~SocketIo();
+    SocketIo(const SocketIo&) = delete;
+    SocketIo& operator=(const SocketIo&) = delete;
+
+    void send(std::string_view data);
+    // For output that's going to several sockets; the buffer must not change once it's sent
+    void send(std::shared_ptr<const std::string> data);
+    void startCompress();
+    void endCompress();
+    // The descriptor is closed once everything queued before this has been sent
+    void close();
+
+    // True (once) when there's input to take or the client has gone away
+    bool takeReady();
+    bool takeInput(InputEvent& event);
+    // Lines of input, oldest first.  The view is good until popLine().
+    [[nodiscard]] bool hasLine() const;
+    [[nodiscard]] std::string_view frontLine() const;
+    void popLine();
+    [[nodiscard]] bool isHungUp() const;
+    // Bytes handed over that haven't been written to the client yet
+    [[nodiscard]] size_t getPending() const;
+
+    static const int COMPRESSED_OUTBUF_SIZE;
+
+private:
+    void queue(OutputEvent&& event);
+    void wake();
+
+    // Network thread
+    void readInput();
+    void parse();
+    void parseByte(unsigned char ch);
+    void parseText(unsigned char ch);
+    bool handleNaws(int& colRow, unsigned char chr, bool high);
+    void emit(InputEvent&& event);
+    bool serviceOutput();       // True once the game has asked for the socket to be closed
+    void beginCompress();
+    void compress(std::string_view data);
+    void finishCompress();
+    void processCompressed();
+    void writeOutput();
+
+    const int fd;
+    NetworkIo* network = nullptr;   // Set once the socket has been given to a thread
+    int worker = -1;
+    bool closed = false;            // Game thread: close() has been called
+
+    SpscQueue<InputEvent> input;
+    SpscQueue<OutputEvent> output;
+    std::atomic<bool> ready{false};
+    std::atomic<bool> hungUp{false};
+    std::atomic<bool> queued{false};        // Waiting on its thread's list of sockets to service
+    std::atomic<size_t> unsent{0};          // Handed over but not yet taken off the queue
+    std::atomic<size_t> buffered{0};        // In outQueue
+    std::atomic<bool> throttled{false};     // Reading has stopped until the game takes a line
+
+    // Everything below belongs to the network thread
+
+    // Telnet parser
+    int         tState = 0;
+    bool        oneIAC = false;
+    bool        watchBrokenClient = false;
+    int         mxpHeld = 0;        // Bytes of a possible MXP secure sequence put on the line so far
+    int         cols = 0;
+    int         rows = 0;
+    std::string sub;                // Subnegotiation or MXP secure line being collected
+
+    InputRing   inRing;
+    char        lastEol = 0;        // The line ending just seen, so \r\n and \n\r count once
+    bool        framed = false;     // A line has been finished since the game was last told
+    bool        paused = false;     // Stopped reading because inRing was full
+
+    OutputQueue outQueue;           // Processed (and possibly compressed) output waiting for the socket to be writable
+    bool        writeReady = true;  // False after EWOULDBLOCK until the reactor says we can write again
+    bool        watched = false;
+    bool        closing = false;    // The game has closed it; the last output is going out
+    bool        fdClosed = false;
+    std::chrono::steady_clock::time_point closeBy;
+    z_stream    *outCompress = nullptr;
+    char        *outCompressBuf = nullptr;
+};
@@ -0,0 +1,118 @@
+/*
+ * socketTable.h
+ *   The server's table of connected sockets
+ *   ____            _
+ *  |  _ \ ___  __ _| |_ __ ___  ___
+ *  | |_) / _ \/ _` | | '_ ` _ \/ __|
+ *  |  _ <  __/ (_| | | | | | | \__ \
+ *  |_| \_\___|\__,_|_|_| |_| |_|___/
+ *
+ * Permission to use, modify and distribute is granted via the
+ *  GNU Affero General Public License v3 or later
+ *
+ *  Copyright (C) 2007-2021 Jason Mitchell, Randi Mitchell
+ *     Contributions by Tim Callahan, Jonathan Hseu
+ *  Based on Mordor (C) Brooke Paul, Brett J. Vickers, John P. Freeman
+ *
+ */
+
+#pragma once
+
+#include <cstdint>
+#include <memory>
+#include <vector>
+
+class Socket;
+class SocketIo;
+
+// Refers to a socket for as long as it's in the table; once it's been
+// removed, the handle stops working even if the slot is reused
+struct SocketHandle {
+    static constexpr uint32_t NONE = UINT32_MAX;
+
+    uint32_t index = NONE;
+    uint32_t generation = 0;
+
+    [[nodiscard]] bool valid() const { return(index != NONE); }
+    bool operator==(const SocketHandle&) const = default;
+};
+
+// Sockets live at a position in a set of parallel arrays holding the fields
+// the game loop checks every pass (state, descriptor, whether there's output
+// to flush), so each phase walks contiguous memory instead of chasing and
+// locking pointers.
+//
+// Removing a socket only leaves a tombstone at its position; positions don't
+// move until compact() runs at the top of the next pass.  That makes it safe
+// to disconnect sockets (even all of them) from inside any loop over the
+// table.  Loops by position must skip tombstones: at() returns null.
+class SocketTable {
+public:
+    class iterator {
+    public:
+        iterator(const SocketTable* pTable, size_t pPos);
+        const std::shared_ptr<Socket>& operator*() const;
+        iterator& operator++();
+        bool operator!=(const iterator& other) const { return(pos != other.pos); }
+    private:
+        void skip();
+        const SocketTable* table;
+        size_t pos;
+    };
+
+    SocketTable() = default;
+    SocketTable(const SocketTable&) = delete;
+    SocketTable& operator=(const SocketTable&) = delete;
+
+    const std::shared_ptr<Socket>& add(std::shared_ptr<Socket> sock);
+    [[nodiscard]] std::shared_ptr<Socket> get(SocketHandle handle) const;
+    void remove(SocketHandle handle);
+    void removeAt(size_t pos);
+    void clear();
+
+    // Squeeze out the tombstones; nothing may be looping over the table
+    void compact();
+    // A fresh random order of positions, so no socket always goes first
+    void shuffle();
+    [[nodiscard]] const std::vector<uint32_t>& passOrder() const { return(order); }
+
+    [[nodiscard]] size_t size() const { return(live); }
+    [[nodiscard]] bool empty() const { return(live == 0); }
+    [[nodiscard]] iterator begin() const { return(iterator(this, 0)); }
+    [[nodiscard]] iterator end() const { return(iterator(this, socks.size())); }
+
+    // By position, tombstones included
+    [[nodiscard]] size_t extent() const { return(socks.size()); }
+    [[nodiscard]] const std::shared_ptr<Socket>& at(size_t pos) const { return(socks[pos]); }
+    [[nodiscard]] SocketIo* ioAt(size_t pos) const { return(ios[pos]); }
+    [[nodiscard]] int stateAt(size_t pos) const { return(states[pos]); }
+    [[nodiscard]] int fdAt(size_t pos) const { return(fds[pos]); }
+    [[nodiscard]] bool hasOutputAt(size_t pos) const { return(outputs[pos]); }
+
+    // Kept up to date by Socket
+    void setState(SocketHandle handle, int state);
+    void setFd(SocketHandle handle, int fd);
+    void setHasOutput(SocketHandle handle, bool hasOutput);
+
+private:
+    struct Slot {
+        uint32_t generation = 0;
+        uint32_t pos = SocketHandle::NONE;
+    };
+
+    [[nodiscard]] const Slot* find(SocketHandle handle) const;
+
+    std::vector<Slot> slots;
+    std::vector<uint32_t> freeSlots;
+
+    // By position
+    std::vector<std::shared_ptr<Socket>> socks;     // Null once removed
+    std::vector<uint32_t> slotOf;
+    std::vector<SocketIo*> ios;
+    std::vector<int> states;
+    std::vector<int> fds;
+    std::vector<uint8_t> outputs;
+
+    std::vector<uint32_t> order;
+    size_t live = 0;
+};
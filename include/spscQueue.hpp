@@ -0,0 +1,74 @@
+/*
+ * spscQueue.h
+ *   Unbounded single producer, single consumer queue
+ *   ____            _
+ *  |  _ \ ___  __ _| |_ __ ___  ___
+ *  | |_) / _ \/ _` | | '_ ` _ \/ __|
+ *  |  _ <  __/ (_| | | | | | | \__ \
+ *  |_| \_\___|\__,_|_|_| |_| |_|___/
+ *
+ * Permission to use, modify and distribute is granted via the
+ *  GNU Affero General Public License v3 or later
+ *
+ *  Copyright (C) 2007-2021 Jason Mitchell, Randi Mitchell
+ *     Contributions by Tim Callahan, Jonathan Hseu
+ *  Based on Mordor (C) Brooke Paul, Brett J. Vickers, John P. Freeman
+ *
+ */
+
+#pragma once
+
+#include <atomic>
+#include <utility>
+
+// A linked list with a dummy head node: the producer only ever touches the
+// tail and the consumer only the head, so neither side needs a lock.  One
+// thread may push and one (other) thread may pop; nothing else is safe.
+template<class T>
+class SpscQueue {
+public:
+    SpscQueue() {
+        head = tail = new Node;
+    }
+    ~SpscQueue() {
+        while(head) {
+            Node* next = head->next.load(std::memory_order_relaxed);
+            delete head;
+            head = next;
+        }
+    }
+    SpscQueue(const SpscQueue&) = delete;
+    SpscQueue& operator=(const SpscQueue&) = delete;
+
+    // Producer
+    void push(T value) {
+        auto* node = new Node;
+        node->value = std::move(value);
+        tail->next.store(node, std::memory_order_release);
+        tail = node;
+    }
+
+    // Consumer
+    bool pop(T& value) {
+        Node* next = head->next.load(std::memory_order_acquire);
+        if(!next)
+            return(false);
+        value = std::move(next->value);
+        next->value = T();
+        delete head;
+        head = next;
+        return(true);
+    }
+    [[nodiscard]] bool empty() const {
+        return(head->next.load(std::memory_order_acquire) == nullptr);
+    }
+
+private:
+    struct Node {
+        T value{};
+        std::atomic<Node*> next{nullptr};
+    };
+
+    alignas(64) Node* head;     // Consumer only; the node before the oldest value
+    alignas(64) Node* tail;     // Producer only
+};
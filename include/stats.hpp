@@ -18,11 +18,16 @@
 
 #pragma once
 
-#include <map>
+#include <cstdint>
+#include <string>
+#include <string_view>
+#include <vector>
 #include <libxml/parser.h>  // for xmlNodePtr
 
 #include "alphanum.hpp"
 
+class Creature;
+
 enum ModifierType {
     MOD_NONE = 0,
     MOD_CUR = 1,
@@ -30,31 +35,50 @@ enum ModifierType {
     MOD_CUR_MAX = 3,
     MOD_ALL = MOD_CUR_MAX
 };
+
+// Modifiers the stat code itself keeps touching get a fixed slot instead of
+// being looked up by name.  Their names are interned first, so a modifier's
+// key is its slot when it has one.
+enum StatSlot : uint8_t {
+    SLOT_CUR,           // CurModifier
+    SLOT_CON_BONUS,     // ConBonus
+    SLOT_INT_BONUS,     // IntBonus
+    SLOT_ROUNDING,      // Rounding
+    SLOT_DM_SET,        // DmSet
+
+    NUM_STAT_SLOTS
+};
+
 class StatModifier {
 public:
     StatModifier();
     StatModifier(std::string_view pName, int pModAmt, ModifierType pModType);
+    StatModifier(uint16_t pKey, int pModAmt, ModifierType pModType);
     StatModifier(xmlNodePtr curNode);
-    StatModifier(StatModifier &sm);
-    void save(xmlNodePtr parentNode);
+    StatModifier(const StatModifier &sm) = default;
+    void save(xmlNodePtr parentNode) const;
 
     void adjust(int adjAmount);
     void set(int newAmt);
     void setType(ModifierType newType);
-    std::string getName();
-    int getModAmt();
-    ModifierType getModType();
+    [[nodiscard]] const std::string& getName() const;
+    [[nodiscard]] uint16_t getKey() const;
+    [[nodiscard]] int getModAmt() const;
+    [[nodiscard]] ModifierType getModType() const;
+    [[nodiscard]] int curAmt() const;
+    [[nodiscard]] int maxAmt() const;
 
     std::string toString();
+
+    // Modifier names are never removed, so keys stay valid for the life of the process
+    static uint16_t intern(std::string_view name);
 private:
-    std::string         name;
+    uint16_t        key{};
     int             modAmt{};
     ModifierType    modType;
 
 };
 
-typedef std::map<std::string, std::shared_ptr<StatModifier>, alphanum_less<std::string> > ModifierMap;
-
 class Stat
 {
 public:
@@ -89,6 +113,7 @@ class Stat
 
     void setInfluences(Stat* pInfluences);
     void setInfluencedBy(Stat* pInfluencedBy);
+    void setParent(Creature* pParent);
     int restore(); // Set a stat to it's maximum value
 
     void reCalc();
@@ -102,15 +127,26 @@ class Stat
 
     void clearModifiers();
 
-    std::shared_ptr<StatModifier>& getModifier(const std::string &pName);
+    StatModifier* getModifier(const std::string &pName);
     bool hasModifier(const std::string &pName);
     int getModifierAmt(const std::string &pName);
 
     void upgradeSetCur(int newCur);  // Used only in upgrading to new stats
 protected:
+    StatModifier* findModifier(uint16_t key);
+    bool insertModifier(const StatModifier& mod);
+    bool eraseModifier(uint16_t key);
+    bool adjustByKey(uint16_t key, int modAmt, ModifierType modType);
+    bool setByKey(uint16_t key, int newAmt, ModifierType modType);
+    void adjustCur(int amt);
+    [[nodiscard]] std::vector<const StatModifier*> sortedModifiers() const;
 
     std::string name;
-    ModifierMap modifiers;
+    StatModifier slots[NUM_STAT_SLOTS];
+    uint8_t slotsUsed;                  // Bit per StatSlot
+    std::vector<StatModifier> named;    // Everything else: levels, effects, equipment
+    int curTotal;                       // What all the modifiers add to cur
+    int maxTotal;                       // and to max
     bool dirty;
 
 
@@ -120,5 +156,5 @@ class Stat
 
     Stat* influences;
     Stat* influencedBy;
+    Creature* parent;       // Told whenever this stat changes
 };
-
@@ -0,0 +1,100 @@
+/*
+ * timerWheel.h
+ *   Hierarchical timing wheel for delayed actions and periodic game updates
+ *   ____            _
+ *  |  _ \ ___  __ _| |_ __ ___  ___
+ *  | |_) / _ \/ _` | | '_ ` _ \/ __|
+ *  |  _ <  __/ (_| | | | | | | \__ \
+ *  |_| \_\___|\__,_|_|_| |_| |_|___/
+ *
+ * Permission to use, modify and distribute is granted via the
+ *  GNU Affero General Public License v3 or later
+ *
+ *  Copyright (C) 2007-2021 Jason Mitchell, Randi Mitchell
+ *     Contributions by Tim Callahan, Jonathan Hseu
+ *  Based on Mordor (C) Brooke Paul, Brett J. Vickers, John P. Freeman
+ *
+ */
+
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <deque>
+#include <functional>
+#include <vector>
+
+// Refers to a scheduled timer.  Once the timer has fired or been cancelled the
+// handle goes stale and everything done with it is a harmless no-op.
+class TimerHandle {
+public:
+    [[nodiscard]] bool isSet() const { return(generation != 0); }
+    void reset() { index = generation = 0; }
+
+private:
+    friend class TimerWheel;
+    uint32_t index = 0;
+    uint32_t generation = 0;
+};
+
+class TimerWheel {
+public:
+    typedef std::function<void()> Callback;
+
+    TimerWheel();
+    TimerWheel(const TimerWheel&) = delete;
+    TimerWheel& operator=(const TimerWheel&) = delete;
+
+    // Run the callback once, delay milliseconds from now
+    TimerHandle schedule(uint64_t delay, Callback callback);
+    // Run the callback every interval milliseconds, the first time after firstDelay
+    TimerHandle repeat(uint64_t interval, Callback callback, uint64_t firstDelay);
+    TimerHandle repeat(uint64_t interval, Callback callback);
+    // Change how often a repeating timer runs, starting with the next interval
+    bool setInterval(const TimerHandle& handle, uint64_t interval);
+    bool cancel(TimerHandle& handle);
+
+    [[nodiscard]] bool isPending(const TimerHandle& handle) const;
+    // Milliseconds until the timer fires, 0 if it isn't pending
+    [[nodiscard]] uint64_t timeLeft(const TimerHandle& handle) const;
+    [[nodiscard]] size_t size() const;
+
+    // Fire everything that has come due; returns how many timers ran
+    size_t advance();
+    size_t advance(uint64_t now);
+
+    // Milliseconds on the wheel's monotonic clock
+    [[nodiscard]] static uint64_t clock();
+
+private:
+    static constexpr int LEVELS = 5;
+    static constexpr int SLOT_BITS = 6;
+    static constexpr int SLOTS = 1 << SLOT_BITS;
+    static constexpr uint32_t NIL = UINT32_MAX;
+
+    struct Timer {
+        uint64_t expires = 0;
+        uint64_t interval = 0;      // 0 for one shot timers
+        Callback callback;
+        uint32_t generation = 1;
+        uint32_t prev = NIL;
+        uint32_t next = NIL;
+        uint32_t* bucket = nullptr; // Head of the list this timer is linked into
+        bool firing = false;
+    };
+
+    // Index of the timer the handle refers to, NIL if it's stale
+    [[nodiscard]] uint32_t find(const TimerHandle& handle) const;
+    TimerHandle add(uint64_t expires, uint64_t interval, Callback callback);
+    void link(uint32_t index);
+    void unlink(uint32_t index);
+    void release(uint32_t index);
+    void cascade(int level);
+    size_t fire(uint32_t* bucket);
+
+    std::deque<Timer> timers;       // A deque so a running callback never moves
+    std::vector<uint32_t> freeTimers;
+    uint32_t buckets[LEVELS][SLOTS];
+    uint64_t current;               // Last millisecond the wheel has processed
+    size_t pending;
+};
@@ -0,0 +1,35 @@
+/*
+ * transcoder.h
+ *   Translates color codes, MXP tags and newlines on their way out to a socket
+ *   ____            _
+ *  |  _ \ ___  __ _| |_ __ ___  ___
+ *  | |_) / _ \/ _` | | '_ ` _ \/ __|
+ *  |  _ <  __/ (_| | | | | | | \__ \
+ *  |_| \_\___|\__,_|_|_| |_| |_|___/
+ *
+ * Permission to use, modify and distribute is granted via the
+ *  GNU Affero General Public License v3 or later
+ *
+ *  Copyright (C) 2007-2021 Jason Mitchell, Randi Mitchell
+ *     Contributions by Tim Callahan, Jonathan Hseu
+ *  Based on Mordor (C) Brooke Paul, Brett J. Vickers, John P. Freeman
+ *
+ */
+
+#pragma once
+
+#include <string>
+#include <string_view>
+
+// What to send for each ^ color code, indexed by the character after the caret
+struct ColorTable {
+    std::string_view codes[256];
+    bool colored; // Don't repeat a color that's already active
+};
+
+const ColorTable& getColorTable(int colorOpt);
+
+// Appends the client-ready form of in to out: ^ codes are replaced from the color
+// table, \n becomes \r\n and MXP tags are either wrapped in secure/locked mode or
+// dropped.  lastColor carries the active color between calls.
+void transcodeOutput(std::string_view in, std::string& out, const ColorTable& colors, bool mxp, unsigned char& lastColor);
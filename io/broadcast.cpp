@@ -0,0 +1,133 @@
+/*
+ * broadcast.cpp
+ *   Renders a broadcast once per distinct viewer instead of once per socket
+ *   ____            _
+ *  |  _ \ ___  __ _| |_ __ ___  ___
+ *  | |_) / _ \/ _` | | '_ ` _ \/ __|
+ *  |  _ <  __/ (_| | | | | | | \__ \
+ *  |_| \_\___|\__,_|_|_| |_| |_|___/
+ *
+ * Permission to use, modify and distribute is granted via the
+ *  GNU Affero General Public License v3 or later
+ *
+ *  Copyright (C) 2007-2021 Jason Mitchell, Randi Mitchell
+ *     Contributions by Tim Callahan, Jonathan Hseu
+ *  Based on Mordor (C) Brooke Paul, Brett J. Vickers, John P. Freeman
+ *
+ */
+
+#include <cstdarg>                      // for va_copy, va_end, va_list
+#include <memory>                       // for shared_ptr, make_shared
+#include <string>                       // for string
+#include <utility>                      // for move
+
+#include "broadcast.hpp"                // for BroadcastRenderer, SharedOutput
+#include "mudFormat.hpp"                // for formatLegacy
+#include "mudObjects/players.hpp"       // for Player
+#include "socket.hpp"                   // for Socket
+#include "transcoder.hpp"               // for ColorTable, transcodeOutput
+
+//*********************************************************************
+//                      SharedOutput
+//*********************************************************************
+
+SharedOutput::SharedOutput(std::string pText) : text(std::move(pText)) {
+}
+
+const std::string& SharedOutput::getText() const {
+    return(text);
+}
+
+//*********************************************************************
+//                      transcode
+//*********************************************************************
+// Returns the bytes a client with these settings gets for the text, and moves
+// lastColor on the same way transcodeOutput would.
+
+std::shared_ptr<const std::string> SharedOutput::transcode(const ColorTable& colors, bool mxp, unsigned char& lastColor) const {
+    for(const auto& encoding : encodings) {
+        if(encoding.colors == &colors && encoding.mxp == mxp && encoding.lastIn == lastColor) {
+            lastColor = encoding.lastOut;
+            return(encoding.bytes);
+        }
+    }
+
+    unsigned char lastIn = lastColor;
+    std::string bytes;
+    transcodeOutput(text, bytes, colors, mxp, lastColor);
+
+    auto shared = std::make_shared<const std::string>(std::move(bytes));
+    encodings.push_back({&colors, mxp, lastIn, lastColor, shared});
+    return(shared);
+}
+
+//*********************************************************************
+//                      BroadcastRenderer
+//*********************************************************************
+// The format and arguments must outlive the renderer; it only holds on to them
+// for the length of a single broadcast.
+
+BroadcastRenderer::BroadcastRenderer(const char *pFmt, va_list pAp, const char *pSuffix) {
+    fmt = pFmt ? pFmt : "";
+    suffix = pSuffix;
+    va_copy(ap, pAp);
+}
+
+BroadcastRenderer::BroadcastRenderer(std::string_view pFmt, Formatter pFormatter, const char *pSuffix) {
+    fmt = pFmt;
+    suffix = pSuffix;
+    formatter = std::move(pFormatter);
+}
+
+BroadcastRenderer::~BroadcastRenderer() {
+    if(!formatter)
+        va_end(ap);
+}
+
+size_t BroadcastRenderer::getNumVariants() const {
+    return(variants.size());
+}
+
+//*********************************************************************
+//                      render
+//*********************************************************************
+// Returns the text this viewer would get from vprint, rendering it only if no
+// earlier viewer saw it the same way.  There are only ever a handful of
+// variants (staff, players with detect-invisible, odd wrap widths), so a linear
+// search beats hashing the format.
+
+std::shared_ptr<const SharedOutput> BroadcastRenderer::render(const std::shared_ptr<const Player>& viewer, const Socket& sock) {
+    std::string colorized = viewer->customColorize(std::string(fmt));
+    int flags = viewer->displayFlags();
+    int wrap = sock.getWrapWidth();
+
+    for(const auto& variant : variants) {
+        if(variant.flags == flags && variant.wrap == wrap && variant.fmt == colorized)
+            return(variant.text);
+    }
+
+    std::string text = Socket::wrapPrint(wrap, format(colorized, flags));
+    if(suffix)
+        text += Socket::wrapPrint(wrap, format(suffix, flags));
+
+    auto shared = std::make_shared<const SharedOutput>(std::move(text));
+    variants.push_back({std::move(colorized), flags, wrap, shared});
+    return(shared);
+}
+
+std::string BroadcastRenderer::format(const std::string& toFormat, int flags) {
+    if(formatter)
+        return(formatter(toFormat, flags));
+    return(formatLegacy(flags, toFormat.c_str(), ap));
+}
+
+//*********************************************************************
+//                      send
+//*********************************************************************
+
+void BroadcastRenderer::send(const std::shared_ptr<const Player>& viewer) {
+    std::shared_ptr<Socket> sock = viewer->getSock();
+    if(!sock)
+        return;
+    sock->bprint(render(viewer, *sock));
+}
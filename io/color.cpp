@@ -384,32 +384,6 @@ void Player::setSockColors() {
     }
 }
 
-//***********************************************************************
-//                      getColorCode
-//***********************************************************************
-// Get the color code we need to print
-// Currently handles MXP & ANSI Color
-// TODO: Handle xterm256 color
-
-std::string Socket::getColorCode(const unsigned char ch) {
-    std::ostringstream oStr;
-    if(!opts.color) {
-        // Color is not active, only replace a caret
-        if(ch == '^')
-            oStr << "^";
-        return(oStr.str());
-    } else {
-        // Color is active, do replacement
-
-        // Only return a color if the last color is not equal to the current color
-        if(opts.lastColor != ch || opts.lastColor == '^') {
-            opts.lastColor = ch;
-            oStr << getAnsiColorCode(ch);
-        }
-        return(oStr.str());
-    }
-}
-
 //***********************************************************************
 //                      stripColor
 //***********************************************************************
@@ -0,0 +1,114 @@
+/*
+ * inputRing.cpp
+ *   Per socket buffer that input is read into and split into lines
+ *   ____            _
+ *  |  _ \ ___  __ _| |_ __ ___  ___
+ *  | |_) / _ \/ _` | | '_ ` _ \/ __|
+ *  |  _ <  __/ (_| | | | | | | \__ \
+ *  |_| \_\___|\__,_|_|_| |_| |_|___/
+ *
+ * Permission to use, modify and distribute is granted via the
+ *  GNU Affero General Public License v3 or later
+ *
+ *  Copyright (C) 2007-2021 Jason Mitchell, Randi Mitchell
+ *     Contributions by Tim Callahan, Jonathan Hseu
+ *  Based on Mordor (C) Brooke Paul, Brett J. Vickers, John P. Freeman
+ *
+ */
+
+#include <cstring>              // for memmove
+
+#include "inputRing.hpp"        // for InputRing
+
+InputRing::InputRing(): data(std::make_unique<char[]>(SIZE)) {
+}
+
+//********************************************************************
+//                      oldest
+//********************************************************************
+// Start of the oldest line the game hasn't taken yet.  Everything from
+// here up to lineStart (going around the end if need be) is the game's.
+
+size_t InputRing::oldest() const {
+    size_t first = popped.load();
+    if(first == pushedCount)
+        return(lineStart);
+    return(lines[first % MAX_LINES].offset);
+}
+
+//********************************************************************
+//                      readSpace
+//********************************************************************
+
+char* InputRing::readSpace(size_t& n) {
+    size_t first = oldest();
+
+    // We've already wrapped around and are catching up on the game's lines
+    if(first > lineStart) {
+        n = first - rawEnd;
+        return(data.get() + rawEnd);
+    }
+
+    // Running out of room at the end; if there's enough free at the front,
+    // move the partial line and anything still to be scanned there.  With no
+    // lines waiting on the game the whole buffer is free, which also throws
+    // away telnet codes and overflow that were scanned but never kept, so a
+    // socket that never finishes a line can't wedge the buffer.
+    if(SIZE - rawEnd < MIN_READ) {
+        size_t partial = out - lineStart;
+        size_t pending = rawEnd - raw;
+        size_t free = popped.load() == pushedCount ? SIZE : first;
+        if(free >= partial + pending + MIN_READ) {
+            memmove(data.get(), data.get() + lineStart, partial);
+            memmove(data.get() + partial, data.get() + raw, pending);
+            lineStart = 0;
+            out = partial;
+            raw = partial;
+            rawEnd = partial + pending;
+            return(readSpace(n));
+        }
+    }
+
+    n = SIZE - rawEnd;
+    return(data.get() + rawEnd);
+}
+
+void InputRing::commitRead(size_t n) {
+    rawEnd += n;
+}
+
+//********************************************************************
+//                      endLine
+//********************************************************************
+
+void InputRing::endLine() {
+    lines[pushedCount % MAX_LINES] = Line{(uint32_t)lineStart, (uint32_t)(out - lineStart)};
+    pushed.store(++pushedCount, std::memory_order_release);
+    lineStart = out;
+}
+
+bool InputRing::linesFull() {
+    if(pushedCount - poppedSeen < MAX_LINES)
+        return(false);
+    poppedSeen = popped.load();
+    return(pushedCount - poppedSeen >= MAX_LINES);
+}
+
+//********************************************************************
+//                      Game thread
+//********************************************************************
+
+bool InputRing::empty() const {
+    return(popped.load(std::memory_order_relaxed) == pushed.load(std::memory_order_acquire));
+}
+
+std::string_view InputRing::front() const {
+    const Line& line = lines[popped.load(std::memory_order_relaxed) % MAX_LINES];
+    return(std::string_view(data.get() + line.offset, line.length));
+}
+
+// Sequentially consistent, so the network thread either sees the space or
+// SocketIo sees that it stopped reading
+void InputRing::pop() {
+    popped.store(popped.load(std::memory_order_relaxed) + 1);
+}
@@ -32,6 +32,7 @@
 #include <utility>                               // for pair
 
 #include "area.hpp"                              // for MapMarker
+#include "broadcast.hpp"                         // for BroadcastRenderer
 #include "catRef.hpp"                            // for CatRef
 #include "clans.hpp"                             // for Clan
 #include "config.hpp"                            // for Config, gConfig
@@ -40,7 +41,9 @@
 #include "flags.hpp"                             // for P_DM_INVIS, P_NO_BRO...
 #include "global.hpp"                            // for CreatureClass, Creat...
 #include "group.hpp"                             // for CreatureList, Group
+#include "keyTxt.hpp"                            // for KeyTxtQuery, KeyTxt
 #include "location.hpp"                          // for Location
+#include "logWriter.hpp"                         // for LogWriter
 #include "mud.hpp"                               // for GUILD_PEON
 #include "mudObjects/areaRooms.hpp"              // for AreaRoom
 #include "mudObjects/container.hpp"              // for Container, PlayerSet
@@ -99,6 +102,11 @@ bool hearBroadcast(std::shared_ptr<Creature> target, const std::shared_ptr<Socke
 
 // global broadcast
 void doBroadCast(bool showTo(std::shared_ptr<Socket>), bool showAlso(std::shared_ptr<Socket>), const char *fmt, va_list ap, const std::shared_ptr<Creature>& player) {
+    BroadcastRenderer renderer(fmt, ap, "^x\n");
+    doBroadCast(showTo, showAlso, renderer, player);
+}
+
+void doBroadCast(bool showTo(std::shared_ptr<Socket>), bool showAlso(std::shared_ptr<Socket>), BroadcastRenderer& renderer, const std::shared_ptr<Creature>& player) {
     for(const auto& sock : gServer->sockets) {
         const std::shared_ptr<Player> ply = sock->getPlayer();
 
@@ -114,14 +122,18 @@ void doBroadCast(bool showTo(std::shared_ptr<Socket>), bool showAlso(std::shared
         if(player && ply->isGagging(player->getName()) && !player->isCt())
             continue;
 
-        ply->vprint(ply->customColorize(fmt).c_str(), ap);
-        ply->printColor("^x\n");
+        renderer.send(ply);
     }
 }
 
 
 // room broadcast
 void doBroadcast(bool showTo(std::shared_ptr<Socket>), std::shared_ptr<Socket> ignore1, const std::shared_ptr<Socket> ignore2, const std::shared_ptr<const Container>& container, const char *fmt, va_list ap) {
+    BroadcastRenderer renderer(fmt, ap, "^x\n");
+    doBroadcast(showTo, ignore1, ignore2, container, renderer);
+}
+
+void doBroadcast(bool showTo(std::shared_ptr<Socket>), std::shared_ptr<Socket> ignore1, std::shared_ptr<Socket> ignore2, const std::shared_ptr<const Container>& container, BroadcastRenderer& renderer) {
     if(!container)
         return;
 
@@ -132,8 +144,7 @@ void doBroadcast(bool showTo(std::shared_ptr<Socket>), std::shared_ptr<Socket> i
             if (ply->flagIsSet(P_UNCONSCIOUS))
                 continue;
 
-            ply->vprint(ply->customColorize(fmt).c_str(), ap);
-            ply->printColor("^x\n");
+            renderer.send(ply);
         }
 
     }
@@ -345,7 +356,7 @@ void broadcast_rom_LangWc(int lang, std::shared_ptr<Socket> ignore, const Locati
 // this function broadcasts a message to all players in a group except
 // the source player
 
-void broadcastGroupMember(bool dropLoot, const std::shared_ptr<const Creature>& player, const std::shared_ptr<const Player>& listen, const char *fmt, va_list ap) {
+void broadcastGroupMember(bool dropLoot, const std::shared_ptr<const Creature>& player, const std::shared_ptr<const Player>& listen, BroadcastRenderer& renderer) {
 
     if(!listen)
         return;
@@ -373,7 +384,7 @@ void broadcastGroupMember(bool dropLoot, const std::shared_ptr<const Creature>&
             return;
     }
 
-    listen->vprint(listen->customColorize(fmt).c_str(), ap);
+    renderer.send(listen);
 }
 
 void broadcastGroup(bool dropLoot, const std::shared_ptr<Creature>& player, const char *fmt,...) {
@@ -382,8 +393,9 @@ void broadcastGroup(bool dropLoot, const std::shared_ptr<Creature>& player, cons
         return;
     va_list ap;
     va_start(ap, fmt);
+    BroadcastRenderer renderer(fmt, ap);
 
-//  broadcastGroupMember(dropLoot, player, leader, fmt, ap);
+//  broadcastGroupMember(dropLoot, player, leader, renderer);
     auto it = group->members.begin();
     while (it != group->members.end()) {
         auto crt = it->lock();
@@ -392,8 +404,9 @@ void broadcastGroup(bool dropLoot, const std::shared_ptr<Creature>& player, cons
             continue;
         }
         it++;
-        broadcastGroupMember(dropLoot, player, crt->getAsConstPlayer(), fmt, ap);
+        broadcastGroupMember(dropLoot, player, crt->getAsConstPlayer(), renderer);
     }
+    va_end(ap);
 }
 
 //**********************************************************************
@@ -473,7 +486,10 @@ void shutdown_now(int sig) {
     loge("--- Game shutdown via signal\n");
     gServer->resaveAllRooms(1);
     gServer->saveAllPly();
+    // The saves are only queued; nothing else writes them out before exit
+    gServer->playerSaves.stop();
     gServer->stop();
+    LogWriter::get().stop();
 
     std::clog << "Goodbye." << std::endl;
     exit(0);
@@ -514,11 +530,13 @@ void Monster::escapeText() {
     if(Pueblo::is(getName()))
         setName("clay form");
     description = Pueblo::multiline(description);
+    refreshKeyTxt();
 }
 
 void Player::escapeText() {
     if(Pueblo::is(description))
         description = "";
+    refreshKeyTxt();
 }
 
 void Object::escapeText() {
@@ -527,6 +545,7 @@ void Object::escapeText() {
     if(Pueblo::is(use_output))
         zero(use_output, sizeof(use_output));
     description = Pueblo::multiline(description);
+    refreshKeyTxt();
 }
 
 void UniqueRoom::escapeText() {
@@ -728,15 +747,16 @@ bool keyTxtCompare(const char* key, const char* txt, int tLen) {
         }
 
         if(key[kI] == '&' && key[kI+1] == '#') {
-            // get the number from the string
-            convert = toNum<int>(&key[kI+2]);
             // advance kI appropriately
             kI += 2;
+            int start = kI;
             while(key[kI] != ';') {
                 kI++;
                 if(kI >= kLen)
                     return(false);
             }
+            // get the number from the string
+            convert = toNumSV<int>(std::string_view(&key[start], kI - start));
             // turn it into a character we can compare
             kC = keyTxtConvert(convert);
         } else
@@ -755,22 +775,20 @@ bool keyTxtCompare(const char* key, const char* txt, int tLen) {
 //                      keyTxtEqual
 //*********************************************************************
 
+bool keyTxtEqual(const std::shared_ptr<Creature> & target, const KeyTxtQuery& query) {
+    return(target->getKeyTxt().matches(query) || target->getId() == query.raw);
+}
+
+bool keyTxtEqual(const std::shared_ptr<Object>& target, const KeyTxtQuery& query) {
+    return(target->getKeyTxt().matches(query) || target->getId() == query.raw);
+}
+
 bool keyTxtEqual(const std::shared_ptr<Creature> & target, const char* txt) {
-    int len = strlen(txt);
-    return keyTxtCompare(target->key[0], txt, len) ||
-           keyTxtCompare(target->key[1], txt, len) ||
-           keyTxtCompare(target->key[2], txt, len) ||
-           keyTxtCompare(target->getCName(), txt, len) ||
-           target->getId() == txt;
+    return(keyTxtEqual(target, KeyTxtQuery(txt)));
 }
 
 bool keyTxtEqual(const std::shared_ptr<Object>  target, const char* txt) {
-    int len = strlen(txt);
-    return keyTxtCompare(target->key[0], txt, len) ||
-           keyTxtCompare(target->key[1], txt, len) ||
-           keyTxtCompare(target->key[2], txt, len) ||
-           keyTxtCompare(target->getCName(), txt, len) ||
-           target->getId() == txt;
+    return(keyTxtEqual(target, KeyTxtQuery(txt)));
 }
 
 //*********************************************************************
@@ -0,0 +1,184 @@
+/*
+ * keyTxt.cpp
+ *   Precomputed keyword forms used to match what players type
+ *   ____            _
+ *  |  _ \ ___  __ _| |_ __ ___  ___
+ *  | |_) / _ \/ _` | | '_ ` _ \/ __|
+ *  |  _ <  __/ (_| | | | | | | \__ \
+ *  |_| \_\___|\__,_|_|_| |_| |_|___/
+ *
+ * Permission to use, modify and distribute is granted via the
+ *  GNU Affero General Public License v3 or later
+ *
+ *  Copyright (C) 2007-2021 Jason Mitchell, Randi Mitchell
+ *     Contributions by Tim Callahan, Jonathan Hseu
+ *  Based on Mordor (C) Brooke Paul, Brett J. Vickers, John P. Freeman
+ *
+ */
+
+#include <algorithm>            // for sort, unique, lower_bound
+
+#include "keyTxt.hpp"           // for KeyTxt, KeyTxtIndex, KeyTxtQuery
+#include "proto.hpp"            // for keyTxtConvert
+#include "toNum.hpp"            // for toNumSV
+
+//********************************************************************
+//                      KeyTxtQuery
+//********************************************************************
+
+KeyTxtQuery::KeyTxtQuery(std::string_view pRaw, bool pExact): raw(pRaw), exact(pExact) {
+    if(!exact)
+        KeyTxt::normalizeText(raw, text);
+}
+
+//********************************************************************
+//                      normalizeKey
+//********************************************************************
+// The same rules keyTxtCompare applies to the key as it goes: colour codes
+// are dropped, entities are turned into the character they stand for, and
+// everything goes through keyTxtConvert.  keyTxtCompare fails on an entity
+// with no closing ';', so the form stops there.
+
+void KeyTxt::normalizeKey(std::string_view key, std::string& out) {
+    size_t i = 0;
+    while(i < key.size()) {
+        if(key[i] == '^') {
+            i += 2;
+            continue;
+        }
+        if(key[i] == '&' && i + 1 < key.size() && key[i+1] == '#') {
+            size_t end = key.find(';', i + 2);
+            if(end == std::string_view::npos)
+                return;
+            out += keyTxtConvert(toNumSV<int>(key.substr(i + 2, end - i - 2)));
+            i = end + 1;
+            continue;
+        }
+        out += keyTxtConvert(key[i]);
+        i++;
+    }
+}
+
+//********************************************************************
+//                      normalizeText
+//********************************************************************
+
+void KeyTxt::normalizeText(std::string_view txt, std::string& out) {
+    size_t i = 0;
+    while(i < txt.size()) {
+        if(txt[i] == '^') {
+            i += 2;
+            continue;
+        }
+        out += keyTxtConvert(txt[i]);
+        i++;
+    }
+}
+
+//********************************************************************
+//                      set
+//********************************************************************
+
+void KeyTxt::set(const char* key0, const char* key1, const char* key2, std::string_view name, bool pLabeled) {
+    forms.clear();
+    normalizeKey(key0, forms);
+    ends[0] = forms.size();
+    normalizeKey(key1, forms);
+    ends[1] = forms.size();
+    normalizeKey(key2, forms);
+    ends[2] = forms.size();
+    normalizeKey(name, forms);
+    ends[3] = forms.size();
+    labeled = pLabeled;
+    stale = false;
+}
+
+std::string_view KeyTxt::form(int i) const {
+    uint32_t start = i ? ends[i-1] : 0;
+    return(std::string_view(forms).substr(start, ends[i] - start));
+}
+
+//********************************************************************
+//                      matches
+//********************************************************************
+// Like keyTxtCompare, nothing matches an empty key or an empty query
+
+bool KeyTxt::matches(const KeyTxtQuery& query) const {
+    if(query.text.empty())
+        return(false);
+    for(int i = 0; i < FORMS; i++) {
+        std::string_view f = form(i);
+        if(!f.empty() && f.starts_with(query.text))
+            return(true);
+    }
+    return(false);
+}
+
+//********************************************************************
+//                      KeyTxtIndex
+//********************************************************************
+
+std::string_view KeyTxtIndex::text(const Entry& entry) const {
+    return(std::string_view(arena).substr(entry.offset, entry.length));
+}
+
+uint32_t KeyTxtIndex::store(std::string_view str) {
+    auto offset = (uint32_t)arena.size();
+    arena.append(str);
+    return(offset);
+}
+
+void KeyTxtIndex::clear() {
+    arena.clear();
+    forms.clear();
+    ids.clear();
+    labeled.clear();
+    size = 0;
+    valid = false;
+}
+
+void KeyTxtIndex::add(uint32_t pos, const KeyTxt& keyTxt, std::string_view id) {
+    for(int i = 0; i < KeyTxt::FORMS; i++) {
+        std::string_view f = keyTxt.form(i);
+        if(!f.empty())
+            forms.push_back(Entry{store(f), (uint32_t)f.size(), pos});
+    }
+    if(!id.empty())
+        ids.push_back(Entry{store(id), (uint32_t)id.size(), pos});
+    if(keyTxt.isLabeled())
+        labeled.push_back(pos);
+}
+
+void KeyTxtIndex::finish(size_t pSize) {
+    auto byText = [this](const Entry& a, const Entry& b) {
+        return(text(a) < text(b));
+    };
+    std::sort(forms.begin(), forms.end(), byText);
+    std::sort(ids.begin(), ids.end(), byText);
+    size = pSize;
+    valid = true;
+}
+
+//********************************************************************
+//                      lookup
+//********************************************************************
+
+void KeyTxtIndex::lookup(const KeyTxtQuery& query, std::vector<uint32_t>& positions) const {
+    auto before = [this](const Entry& entry, std::string_view str) {
+        return(text(entry) < str);
+    };
+    positions = labeled;
+
+    if(!query.text.empty()) {
+        auto it = std::lower_bound(forms.begin(), forms.end(), query.text, before);
+        for(; it != forms.end() && text(*it).starts_with(query.text); it++)
+            positions.push_back(it->pos);
+    }
+
+    auto it = std::lower_bound(ids.begin(), ids.end(), query.raw, before);
+    for(; it != ids.end() && text(*it) == query.raw; it++)
+        positions.push_back(it->pos);
+
+    std::sort(positions.begin(), positions.end());
+    positions.erase(std::unique(positions.begin(), positions.end()), positions.end());
+}
@@ -0,0 +1,292 @@
+/*
+ * mudFormat.cpp
+ *   fmt formatters for creatures and objects, and the printf style shim
+ *   ____            _
+ *  |  _ \ ___  __ _| |_ __ ___  ___
+ *  | |_) / _ \/ _` | | '_ ` _ \/ __|
+ *  |  _ <  __/ (_| | | | | | | \__ \
+ *  |_| \_\___|\__,_|_|_| |_| |_|___/
+ *
+ * Permission to use, modify and distribute is granted via the
+ *  GNU Affero General Public License v3 or later
+ *
+ *  Copyright (C) 2007-2021 Jason Mitchell, Randi Mitchell
+ *     Contributions by Tim Callahan, Jonathan Hseu
+ *  Based on Mordor (C) Brooke Paul, Brett J. Vickers, John P. Freeman
+ *
+ */
+
+#include <cctype>                    // for isdigit
+#include <cstdarg>                   // for va_arg, va_copy, va_end, va_list
+#include <cstddef>                   // for ptrdiff_t, size_t
+#include <cstdint>                   // for intmax_t, uintmax_t
+#include <cstdio>                    // for snprintf
+#include <cstring>                   // for strchr, strlen
+#include <sstream>                   // for ostringstream
+#include <string>                    // for string
+#include <string_view>               // for string_view
+#include <fmt/format.h>              // for format_to, memory_buffer
+
+#include "global.hpp"                // for CAP
+#include "mudFormat.hpp"             // for CrtName, ObjName, formatLegacy
+#include "mudObjects/creatures.hpp"  // for Creature
+#include "mudObjects/objects.hpp"    // for Object
+
+//*********************************************************************
+//                      formatters
+//*********************************************************************
+
+fmt::format_context::iterator fmt::formatter<CrtName>::format(const CrtName& name, fmt::format_context& ctx) const {
+    if(!name.crt)
+        return(fmt::formatter<std::string_view>::format("", ctx));
+    return(fmt::formatter<std::string_view>::format(name.crt->getCrtStr(nullptr, name.flags, name.num), ctx));
+}
+
+fmt::format_context::iterator fmt::formatter<ObjName>::format(const ObjName& name, fmt::format_context& ctx) const {
+    if(!name.obj)
+        return(fmt::formatter<std::string_view>::format("", ctx));
+    return(fmt::formatter<std::string_view>::format(name.obj->getObjStr(nullptr, name.flags, name.num), ctx));
+}
+
+//*********************************************************************
+//                      formatLegacy
+//*********************************************************************
+
+enum class ArgLength { NONE, CHAR, SHORT, LONG, LONG_LONG, LONG_DOUBLE, SIZE, INTMAX, PTRDIFF };
+
+// Hand a single standard conversion to snprintf; the spec already has its
+// width and precision filled in
+template <typename T>
+static void appendPrintf(fmt::memory_buffer& out, const std::string& spec, T value) {
+    char buf[256];
+    int n = snprintf(buf, sizeof(buf), spec.c_str(), value);
+    if(n < 0)
+        return;
+    if((size_t)n < sizeof(buf)) {
+        out.append(buf, buf + n);
+        return;
+    }
+    size_t start = out.size();
+    out.resize(start + n + 1);
+    snprintf(out.data() + start, n + 1, spec.c_str(), value);
+    out.resize(start + n);
+}
+
+// Unlike glibc's register_printf_specifier hooks, the viewer's flags are passed
+// in rather than left in a global, so this is safe to call from anywhere.  Plain
+// %s and %d (by far the most common) skip snprintf entirely.
+
+std::string formatLegacy(int flags, const char *fmt, va_list ap) {
+    fmt::memory_buffer out;
+    va_list aq;
+
+    if(!fmt)
+        return("");
+
+    va_copy(aq, ap);
+    const char *p = fmt;
+    while(*p) {
+        const char *pct = strchr(p, '%');
+        if(!pct) {
+            out.append(p, p + strlen(p));
+            break;
+        }
+        out.append(p, pct);
+
+        const char *s = pct + 1;
+        std::string spec = "%";
+        int width = 0;
+
+        while(*s && strchr("-+ #0'", *s))
+            spec += *s++;
+
+        if(*s == '*') {
+            width = va_arg(aq, int);
+            spec += std::to_string(width);
+            s++;
+        } else {
+            while(isdigit((unsigned char)*s)) {
+                width = width * 10 + (*s - '0');
+                spec += *s++;
+            }
+        }
+
+        if(*s == '.') {
+            spec += *s++;
+            if(*s == '*') {
+                spec += std::to_string(va_arg(aq, int));
+                s++;
+            } else {
+                while(isdigit((unsigned char)*s))
+                    spec += *s++;
+            }
+        }
+        bool plain = (spec.size() == 1);
+
+        ArgLength length = ArgLength::NONE;
+        switch(*s) {
+            case 'h':
+                length = (s[1] == 'h' ? ArgLength::CHAR : ArgLength::SHORT);
+                s += (s[1] == 'h' ? 2 : 1);
+                break;
+            case 'l':
+                length = (s[1] == 'l' ? ArgLength::LONG_LONG : ArgLength::LONG);
+                s += (s[1] == 'l' ? 2 : 1);
+                break;
+            case 'q':
+                length = ArgLength::LONG_LONG;
+                s++;
+                break;
+            case 'L':
+                length = ArgLength::LONG_DOUBLE;
+                s++;
+                break;
+            case 'z':
+                length = ArgLength::SIZE;
+                s++;
+                break;
+            case 'j':
+                length = ArgLength::INTMAX;
+                s++;
+                break;
+            case 't':
+                length = ArgLength::PTRDIFF;
+                s++;
+                break;
+            default:
+                break;
+        }
+
+        char conv = *s;
+        if(!conv) {
+            // Dangling %, print it as is
+            out.append(pct, s);
+            break;
+        }
+        s++;
+
+        switch(conv) {
+            case '%':
+                out.push_back('%');
+                break;
+            case 'M':
+            case 'N': {
+                auto crt = va_arg(aq, const Creature*);
+                if(crt)
+                    fmt::format_to(std::back_inserter(out), "{}", CrtName(crt, conv == 'M' ? flags | CAP : flags, width));
+                break;
+            }
+            case 'O':
+            case 'P': {
+                auto obj = va_arg(aq, const Object*);
+                if(obj)
+                    fmt::format_to(std::back_inserter(out), "{}", ObjName(obj, conv == 'O' ? flags | CAP : flags, width));
+                break;
+            }
+            case 'R': {
+                auto crt = va_arg(aq, const Creature*);
+                if(crt)
+                    out.append(std::string_view(crt->getCName()));
+                break;
+            }
+            case 'b': {
+                auto str = va_arg(aq, const std::string*);
+                if(str)
+                    out.append(std::string_view(*str));
+                break;
+            }
+            case 'T': {
+                auto oStr = va_arg(aq, const std::ostringstream*);
+                if(oStr)
+                    out.append(std::string_view(oStr->str()));
+                break;
+            }
+            case 'd':
+            case 'i': {
+                long long value;
+                switch(length) {
+                    case ArgLength::CHAR:       value = (signed char)va_arg(aq, int); break;
+                    case ArgLength::SHORT:      value = (short)va_arg(aq, int); break;
+                    case ArgLength::LONG:       value = va_arg(aq, long); break;
+                    case ArgLength::LONG_LONG:  value = va_arg(aq, long long); break;
+                    case ArgLength::SIZE:       value = va_arg(aq, ssize_t); break;
+                    case ArgLength::INTMAX:     value = va_arg(aq, intmax_t); break;
+                    case ArgLength::PTRDIFF:    value = va_arg(aq, ptrdiff_t); break;
+                    default:                    value = va_arg(aq, int); break;
+                }
+                if(plain)
+                    fmt::format_to(std::back_inserter(out), "{}", value);
+                else
+                    appendPrintf(out, spec + "ll" + conv, value);
+                break;
+            }
+            case 'u':
+            case 'o':
+            case 'x':
+            case 'X': {
+                unsigned long long value;
+                switch(length) {
+                    case ArgLength::CHAR:       value = (unsigned char)va_arg(aq, unsigned int); break;
+                    case ArgLength::SHORT:      value = (unsigned short)va_arg(aq, unsigned int); break;
+                    case ArgLength::LONG:       value = va_arg(aq, unsigned long); break;
+                    case ArgLength::LONG_LONG:  value = va_arg(aq, unsigned long long); break;
+                    case ArgLength::SIZE:       value = va_arg(aq, size_t); break;
+                    case ArgLength::INTMAX:     value = va_arg(aq, uintmax_t); break;
+                    case ArgLength::PTRDIFF:    value = va_arg(aq, ptrdiff_t); break;
+                    default:                    value = va_arg(aq, unsigned int); break;
+                }
+                if(plain && conv == 'u')
+                    fmt::format_to(std::back_inserter(out), "{}", value);
+                else
+                    appendPrintf(out, spec + "ll" + conv, value);
+                break;
+            }
+            case 'c': {
+                int value = va_arg(aq, int);
+                if(plain)
+                    out.push_back((char)value);
+                else
+                    appendPrintf(out, spec + conv, value);
+                break;
+            }
+            case 'e':
+            case 'E':
+            case 'f':
+            case 'F':
+            case 'g':
+            case 'G':
+            case 'a':
+            case 'A':
+                if(length == ArgLength::LONG_DOUBLE)
+                    appendPrintf(out, spec + "L" + conv, va_arg(aq, long double));
+                else
+                    appendPrintf(out, spec + conv, va_arg(aq, double));
+                break;
+            case 's': {
+                if(length == ArgLength::LONG) {
+                    appendPrintf(out, spec + "ls", va_arg(aq, const wchar_t*));
+                    break;
+                }
+                const char *str = va_arg(aq, const char*);
+                if(plain)
+                    out.append(std::string_view(str ? str : "(null)"));
+                else
+                    appendPrintf(out, spec + conv, str);
+                break;
+            }
+            case 'p':
+                appendPrintf(out, spec + conv, va_arg(aq, void*));
+                break;
+            case 'n':
+                *va_arg(aq, int*) = (int)out.size();
+                break;
+            default:
+                // Not a conversion we know about; show it rather than guess at the argument
+                out.append(pct, s);
+                break;
+        }
+        p = s;
+    }
+    va_end(aq);
+    return(fmt::to_string(out));
+}
@@ -0,0 +1,133 @@
+/*
+ * outputQueue.cpp
+ *   Per socket queue of processed output waiting to be written
+ *   ____            _
+ *  |  _ \ ___  __ _| |_ __ ___  ___
+ *  | |_) / _ \/ _` | | '_ ` _ \/ __|
+ *  |  _ <  __/ (_| | | | | | | \__ \
+ *  |_| \_\___|\__,_|_|_| |_| |_|___/
+ *
+ * Permission to use, modify and distribute is granted via the
+ *  GNU Affero General Public License v3 or later
+ *
+ *  Copyright (C) 2007-2021 Jason Mitchell, Randi Mitchell
+ *     Contributions by Tim Callahan, Jonathan Hseu
+ *  Based on Mordor (C) Brooke Paul, Brett J. Vickers, John P. Freeman
+ *
+ */
+
+#include <sys/uio.h>            // for iovec, writev
+#include <algorithm>            // for min
+#include <cerrno>               // for errno, EWOULDBLOCK, EINTR
+#include <cstring>              // for memcpy
+
+#include "outputQueue.hpp"      // for OutputQueue
+
+// Most iovecs handed to a single writev; more than enough to fill a socket's send buffer
+static constexpr int MAX_IOV = 64;
+// Chunks kept around for reuse once they've been written out
+static constexpr size_t MAX_SPARE = 4;
+
+//********************************************************************
+//                      newChunk
+//********************************************************************
+
+std::unique_ptr<OutputQueue::Chunk> OutputQueue::newChunk() {
+    if(spare.empty())
+        return(std::make_unique<Chunk>());
+
+    std::unique_ptr<Chunk> chunk = std::move(spare.back());
+    spare.pop_back();
+    return(chunk);
+}
+
+//********************************************************************
+//                      append
+//********************************************************************
+
+void OutputQueue::append(std::string_view data) {
+    bytes += data.size();
+    while(!data.empty()) {
+        if(chunks.empty() || !chunks.back().chunk || chunks.back().end == CHUNK_SIZE)
+            chunks.push_back(Segment{.chunk = newChunk()});
+
+        Segment& tail = chunks.back();
+        size_t n = std::min(data.size(), CHUNK_SIZE - tail.end);
+        memcpy(tail.chunk->data + tail.end, data.data(), n);
+        tail.end += n;
+        data.remove_prefix(n);
+    }
+}
+
+// No copy; the buffer is kept alive until it has all been written
+void OutputQueue::append(std::shared_ptr<const std::string> data) {
+    if(!data || data->empty())
+        return;
+    bytes += data->size();
+    size_t end = data->size();
+    chunks.push_back(Segment{.shared = std::move(data), .end = end});
+}
+
+//********************************************************************
+//                      consume
+//********************************************************************
+
+void OutputQueue::consume(size_t n) {
+    bytes -= n;
+    while(n && !chunks.empty()) {
+        Segment& head = chunks.front();
+        size_t len = std::min(n, head.end - head.start);
+        head.start += len;
+        n -= len;
+        if(head.start == head.end) {
+            if(head.chunk && spare.size() < MAX_SPARE)
+                spare.push_back(std::move(head.chunk));
+            chunks.pop_front();
+        }
+    }
+}
+
+//********************************************************************
+//                      writeTo
+//********************************************************************
+
+ssize_t OutputQueue::writeTo(int fd) {
+    ssize_t written = 0;
+    struct iovec iov[MAX_IOV];
+
+    while(!empty()) {
+        int count = 0;
+        for(auto it = chunks.begin(); it != chunks.end() && count < MAX_IOV; it++, count++) {
+            iov[count].iov_base = const_cast<char*>(it->data() + it->start);
+            iov[count].iov_len = it->end - it->start;
+        }
+
+        ssize_t n = ::writev(fd, iov, count);
+        if(n < 0) {
+            if(errno == EINTR)
+                continue;
+            if(errno == EWOULDBLOCK || errno == EAGAIN)
+                break;
+            return(-1);
+        }
+        consume(n);
+        written += n;
+    }
+    return(written);
+}
+
+//********************************************************************
+//                      clear
+//********************************************************************
+
+void OutputQueue::clear() {
+    consume(bytes);
+}
+
+bool OutputQueue::empty() const {
+    return(bytes == 0);
+}
+
+size_t OutputQueue::size() const {
+    return(bytes);
+}
@@ -48,12 +48,12 @@
 #include <list>                                     // for list, operator==
 #include <map>                                      // for map
 #include <memory>                                   // for allocator, alloca...
-#include <queue>                                    // for queue
 #include <sstream>                                  // for basic_ostringstre...
 #include <string>                                   // for string, basic_string
 #include <string_view>                              // for string_view, basi...
 #include <vector>                                   // for vector
 
+#include "broadcast.hpp"                            // for SharedOutput
 #include "color.hpp"                                // for stripColor
 #include "commands.hpp"                             // for command, changing...
 #include "config.hpp"                               // for Config, gConfig
@@ -70,6 +70,7 @@
 #include "security.hpp"                             // for changePassword
 #include "server.hpp"                               // for Server, gServer
 #include "socket.hpp"                               // for Socket, Socket::S...
+#include "transcoder.hpp"                           // for transcodeOutput, getColorTable
 #include "version.hpp"                              // for VERSION
 #include "xml.hpp"                                  // for copyToBool, newBo...
 #include "blackjack.hpp"                            // for interactive gambling
@@ -77,47 +78,9 @@
 const int MIN_PAGES = 10;
 
 // Static initialization
-const int Socket::COMPRESSED_OUTBUF_SIZE = 8192;
+const size_t Socket::OUTPUT_HIGH_WATER = 512 * 1024;
 int Socket::numSockets = 0;
 
-enum telnetNegotiation {
-    NEG_NONE,
-    NEG_IAC,
-    NEG_WILL,
-    NEG_WONT,
-    NEG_DO,
-    NEG_DONT,
-
-    NEG_SB,
-    NEG_START_NAWS,
-    NEG_SB_NAWS_COL_HIGH,
-    NEG_SB_NAWS_COL_LOW,
-    NEG_SB_NAWS_ROW_HIGH,
-    NEG_SB_NAWS_ROW_LOW,
-    NEG_END_NAWS,
-
-    NEG_SB_TTYPE,
-    NEG_SB_TTYPE_END,
-
-    NEG_SB_MSDP,
-    NEG_SB_MSDP_END,
-
-    NEG_SB_GMCP,
-    NEG_SB_GMCP_END,
-
-    NEG_SB_CHARSET,
-    NEG_SB_CHARSET_LOOK_FOR_IAC,
-    NEG_SB_CHARSET_END,
-
-    NEG_MXP_SECURE,
-    NEG_MXP_SECURE_TWO,
-    NEG_MXP_SECURE_THREE,
-    NEG_MXP_SECURE_FINISH,
-    NEG_MXP_SECURE_CONSUME,
-
-    NEG_UNUSED
-};
-
 //********************************************************************
 //                      telnet namespace
 //********************************************************************
@@ -214,12 +177,10 @@ void Socket::reset() {
 
     opts.compressing = false;
 
-    outCompressBuf = nullptr;
-    outCompress = nullptr;
-    myPlayer = nullptr;
+    outputHighWater = OUTPUT_HIGH_WATER;
+    outputThrottled = false;
 
-    tState = NEG_NONE;
-    oneIAC = watchBrokenClient = false;
+    myPlayer = nullptr;
 
     term.type = "dumb";
     term.firstType.clear();
@@ -230,12 +191,10 @@ void Socket::reset() {
     intrpt = 0;
 
     fn = nullptr;
-    tState = NEG_NONE;
     connState = LOGIN_START;
     lastState = LOGIN_START;
 
     zero(tempstr, sizeof(tempstr));
-    inBuf.clear();
     spyingOn.reset();
 }
 
@@ -246,6 +205,7 @@ void Socket::reset() {
 Socket::Socket(int pFd) {
     reset();
     fd = pFd;
+    io = std::make_shared<SocketIo>(fd);
     numSockets++;
 }
 
@@ -254,6 +214,7 @@ Socket::Socket(int pFd, sockaddr_in pAddr) {
 
     struct linger ling{};
     fd = pFd;
+    io = std::make_shared<SocketIo>(fd);
 
     resolveIp(pAddr, host.ip);
     resolveIp(pAddr, host.hostName); // Start off with the hostname as the ip, then do an asyncronous lookup
@@ -302,8 +263,11 @@ void Socket::cleanUp() {
     }
     endCompress();
     if(fd > -1) {
-        close(fd);
+        // The network thread closes it once everything before it has gone out
+        io->close();
         fd = -1;
+        if (table)
+            table->setFd(handle, -1);
     }
 
 }
@@ -407,43 +371,9 @@ void Socket::resolveIp(const sockaddr_in &addr, std::string& ip) {
 }
 
 std::string Socket::parseForOutput(std::string_view outBuf) {
-    int i = 0;
-    auto n = outBuf.size();
-    std::ostringstream oStr;
-    bool inTag = false;
-    unsigned char ch = 0;
-    while(i < n) {
-        ch = outBuf[i++];
-        if(inTag) {
-            if(ch == CH_MXP_END) {
-                inTag = false;
-                if(opts.mxp)
-                    oStr << ">" << MXP_LOCK_CLOSE;
-            } else if(opts.mxp)
-                oStr << ch;
-
-            continue;
-        } else {
-            if(ch == CH_MXP_BEG) {
-                inTag = true;
-                if(opts.mxp)
-                    oStr << MXP_SECURE_OPEN << "<";
-                continue;
-            } else {
-                if(ch == '^') {
-                    ch = outBuf[i++];
-                    oStr << getColorCode(ch);
-                } else if(ch == '\n') {
-                    oStr << "\r\n";
-                } else {
-                    oStr << ch;
-                }
-                continue;
-            }
-        }
-    }
-    return(oStr.str());
-
+    std::string toOutput;
+    transcodeOutput(outBuf, toOutput, getColorTable(opts.color), opts.mxp, opts.lastColor);
+    return(toOutput);
 }
 
 bool Socket::needsPrompt(std::string_view inStr) {
@@ -571,385 +501,106 @@ void Socket::continueTelnetNeg(bool queryTType) {
 //********************************************************************
 //                      processInput
 //********************************************************************
+// The network thread has already split the input into lines and pulled out
+// any telnet sequences; apply those in the order they arrived.  The lines
+// wait in io until processOneCommand takes them.  Returns -1 once the client
+// has gone away.
 
 int Socket::processInput() {
-    unsigned char tmpBuf[1024];
-    ssize_t n;
-    ssize_t i = 0;
-    std::string tmp = "";
-
-    // Attempt to read from the socket
-    n = read(getFd(), tmpBuf, 1023);
-    if (n <= 0) {
-        if (errno != EWOULDBLOCK)
-            return (-1);
-        else
-            return (0);
-    }
-
-    tmp.reserve(n);
-
-    InBytes += n;
-
-    tmpBuf[n] = '\0';
-    // If we have any full strings, copy it over to the queue to be interpreted
-
-    // Look for any IAC commands using a finite state machine
-    for (i = 0; i < n; i++) {
-        // For debugging
-//        std::clog << "DEBUG:" << (unsigned int)tmpBuf[i] << "'" << (unsigned char)tmpBuf[i] << "'" << "\n";
+    InputEvent event;
+    while(io->takeInput(event))
+        handleEvent(event);
+    ltime = time(nullptr);
+    return(io->isHungUp() ? -1 : 0);
+}
 
-        // Try to handle zMud, cMud & tintin++ which don't seem to double the IAC for NAWS
-        // during my limited testing -JM
-        if (oneIAC && tState > NEG_START_NAWS && tState < NEG_END_NAWS && tmpBuf[i] != IAC) {
-            // Broken Client
-            std::clog << "NAWS: BUG - Broken Client: Non-doubled IAC\n";
-            i--;
-        }
-        if (watchBrokenClient) {
-            // If we just finished NAWS with a 255 height...keep an eye out for the next
-            // character to be a stray SE
-            if (tState == NEG_NONE && (unsigned char) tmpBuf[i] == SE) {
-                std::clog << "NAWS: BUG - Stray SE\n";
-                // Set the tState to NEG_IAC as it should have been, and carry gracefully on
-                tState = NEG_IAC;
-            }
-            // It should only be the next character, so if we don't find it...don't keep looking for it
-            watchBrokenClient = false;
-        }
+//********************************************************************
+//                      handleEvent
+//********************************************************************
 
-        switch (tState) {
-            case NEG_NONE:
-                // Expecting an IAC here
-                if ((unsigned char) tmpBuf[i] == IAC) {
-                    tState = NEG_IAC;
-                    break;
-                } else if((unsigned char)tmpBuf[i] == '\033') {
-                    tState = NEG_MXP_SECURE;
-                    break;
-                } else {
-                    tmp += tmpBuf[i];
-                    break;
-                }
-                break;
-            case NEG_MXP_SECURE:
-                if(tmpBuf[i] == '[') {
-                    tState = NEG_MXP_SECURE_TWO;
-                    break;
-                } else {
-                    tmp += fmt::format("\033{}", tmpBuf[i]);
-                }
-                tState = NEG_NONE;
-                break;
-            case NEG_MXP_SECURE_TWO:
-                if(tmpBuf[i] == '1') {
-                    tState = NEG_MXP_SECURE_FINISH;
-                    break;
-                } else {
-                    tmp += fmt::format("\033[{}", tmpBuf[i]);
-                }
-                tState = NEG_NONE;
-                break;
-            case NEG_MXP_SECURE_FINISH:
-                if(tmpBuf[i] == 'z') {
-                    opts.mxpClientSecure = true;
-                    tState = NEG_MXP_SECURE_CONSUME;
-                    std::clog << "Client secure MXP mode enabled" << std::endl;
-                    break;
-                } else {
-                    tmp += fmt::format("\033[1{}",tmpBuf[i]);
-                }
-                tState = NEG_NONE;
-                break;
-            case NEG_MXP_SECURE_CONSUME:
-                if(tmpBuf[i] == '\n') {
-                    tState = NEG_NONE;
-                    parseMXPSecure();
-                } else {
-                    cmdInBuf.push_back(tmpBuf[i]);
-                }
-                break;
-            case NEG_IAC:
-                switch ((unsigned char) tmpBuf[i]) {
-                    case NOP:
-                    case IP:
-                    case GA:
-                        tState = NEG_NONE;
-                        break;
-                    case WILL:
-                        tState = NEG_WILL;
-                        break;
-                    case WONT:
-                        tState = NEG_WONT;
-                        break;
-                    case DO:
-                        tState = NEG_DO;
-                        break;
-                    case DONT:
-                        tState = NEG_DONT;
-                        break;
-                    case SE:
-                        tState = NEG_NONE;
-                        break;
-                    case SB:
-                        tState = NEG_SB;
-                        break;
-                    case IAC:
-                        // Doubled IAC, send along to parser
-                        tmp += tmpBuf[i];
-                        tState = NEG_NONE;
-                        break;
-                    default:
-                        tState = NEG_NONE;
-                        break;
-                }
-                break;
-                // Handle Do and Will
-            case NEG_DO:
-            case NEG_WILL:
-            case NEG_DONT:
-            case NEG_WONT:
-                negotiate((unsigned char) tmpBuf[i]);
-                break;
-            case NEG_SB:
-                switch ((unsigned char) tmpBuf[i]) {
-                    case NAWS:
-                        tState = NEG_SB_NAWS_COL_HIGH;
-                        break;
-                    case TTYPE:
-                        tState = NEG_SB_TTYPE;
-                        break;
-                    case CHARSET:
-                        if (charsetEnabled())
-                            tState = NEG_SB_CHARSET;
-                        else
-                            tState = NEG_NONE;
-                        break;
-                    case MSDP:
-                        tState = NEG_SB_MSDP;
-                        break;
-                    case TELOPT_GMCP:
-                        tState = NEG_SB_GMCP;
-                        break;
-                    default:
-                        std::clog << "Unknown Sub Negotiation: " << (int)tmpBuf[i] << std::endl;
-                        tState = NEG_NONE;
-                        break;
-                }
-                break;
-            case NEG_SB_MSDP:
-                cmdInBuf.push_back(tmpBuf[i]);
-                if (tmpBuf[i] == IAC) {
-                    tState = NEG_SB_MSDP_END;
-                    break;
-                }
-                break;
-            case NEG_SB_MSDP_END:
-                if (tmpBuf[i] == SE) {
-                    // We should have a full MDSP command now, let's parse it now
-                    parseMsdp();
-                    tState = NEG_NONE;
-                    break;
-                } else {
-                    // Not an SE: The last input was an IAC, so push the new input
-                    // onto the inbuf and keep going
-                    cmdInBuf.push_back(tmpBuf[i]);
-                    tState = NEG_SB_MSDP;
-                    break;
-                }
-                break;
-            case NEG_SB_GMCP:
-                // We don't handle this right now, but ignoring it because Mudlet likes to send it anyway
-                if(tmpBuf[i] == IAC) {
-                    tState = NEG_SB_GMCP_END;
-                    break;
-                }
-                break;
-            case NEG_SB_GMCP_END:
-                if (tmpBuf[i] == SE) {
-                    // We should have a full GMCP command now, let's ignore it
-                    tState = NEG_NONE;
-                    break;
-                } else {
-                    // Not an SE: The last input was an IAC, so keep going
-                    cmdInBuf.push_back(tmpBuf[i]);
-                    tState = NEG_SB_GMCP;
-                    break;
-                }
-                break;
-            case NEG_SB_CHARSET:
-                // We've only asked for UTF-8, so assume if they respond it's for that and just eat the rest of the input
-                //
-                // Any other sub-negotiations (such as TTABLE-*) are not handled
-                if (tmpBuf[i] == ACCEPTED) {
-                    std::clog << "Enabled UTF8" << std::endl;
-                    opts.utf8 = true;
-                    tState = NEG_SB_CHARSET_LOOK_FOR_IAC;
-                } else if (tmpBuf[i] == REJECTED) {
-                    opts.utf8 = false;
-                    tState = NEG_SB_CHARSET_LOOK_FOR_IAC;
-                } else {
-                    tState = NEG_SB_CHARSET_LOOK_FOR_IAC;
-                }
-                break;
-            case NEG_SB_CHARSET_LOOK_FOR_IAC:
-                // Do nothing while we wait for an IAC
-                if (tmpBuf[i] == IAC)
-                    tState = NEG_SB_CHARSET_END;
-                break;
-            case NEG_SB_CHARSET_END:
-                if (tmpBuf[i] == IAC) {
-                    // Double IAC, part of the data
-                    tState = NEG_SB_CHARSET_LOOK_FOR_IAC;
-                    break;
-                } else if (tmpBuf[i] == SE) {
-                    // Found what we were looking for
-                } else {
-                    std::clog << "NEG_SB_CHARSET_END Error: Expected SE, got '" << (int) tmpBuf[i] << "'" << std::endl;
-                }
-                tState = NEG_NONE;
-                break;
-            case NEG_SB_TTYPE:
-                // Grab the terminal type
-                if (tmpBuf[i] == TELQUAL_IS) {
-                    term.lastType = term.type;
-                    term.type.erase();
-                    term.type = "";
-                } else if (tmpBuf[i] == IAC) {
-                    // Expect a SE next
-                    tState = NEG_SB_TTYPE_END;
-                    break;
-                } else {
-                    term.type += tmpBuf[i];
-                }
+void Socket::handleEvent(const InputEvent& event) {
+    switch(event.kind) {
+        case InputEvent::Negotiate:
+            negotiate(event.verb, event.value);
+            break;
+        case InputEvent::Naws:
+            term.cols = event.cols;
+            term.rows = event.rows;
+            std::clog << "New term size: " << term.cols << " x " << term.rows << std::endl;
+            break;
+        case InputEvent::TermType:
+            setTermType(event.data);
+            break;
+        case InputEvent::Charset:
+            // We've only asked for UTF-8, so assume if they respond it's for that
+            if(!charsetEnabled())
                 break;
-            case NEG_SB_TTYPE_END:
-                if (tmpBuf[i] == SE) {
-                    std::clog << "Found term type: " << term.type << std::endl;
-                    // We haven't cycled back around to the first term type, and
-                    // No previous term type or the current term type isn't the same as the last
-                    if ((term.firstType != term.type) && (term.lastType.empty() ||  (term.type != term.lastType))) {
-                        term.lastType = "";
-                        // Look for 256 color support
-                        if (term.type.find("-256color") != std::string::npos) {
-                            // Works for tintin++, wintin++ and blowtorch
-                            opts.xterm256 = true;
-                        }
-
-                        // Request another!
-                        write(reinterpret_cast<const char *>(telnet::query_ttype), false);
-                    }
-                    if (term.firstType.empty()) {
-                        term.firstType = term.type;
-                    }
+            opts.utf8 = (event.value == ACCEPTED);
+            if(opts.utf8)
+                std::clog << "Enabled UTF8" << std::endl;
+            break;
+        case InputEvent::Msdp:
+            parseMsdp(event.data);
+            break;
+        case InputEvent::MxpSecure:
+            opts.mxpClientSecure = true;
+            parseMXPSecure(event.data);
+            break;
+        default:
+            break;
+    }
+}
 
-                    if (term.type.find("Mudlet") != std::string::npos and term.type > "Mudlet 1.1") {
-                        opts.xterm256 = true;
-                    } else if(boost::iequals(term.type, "EMACS-RINZAI") || term.type.find("DecafMUD") != std::string::npos) {
-                        opts.xterm256 = true;
-                    }
+//********************************************************************
+//                      setTermType
+//********************************************************************
 
-                } else if (tmpBuf[i] == IAC) {
-                    // I doubt this will happen
-                    std::clog << "NEG_SB_TTYPE: Found double IAC" << std::endl;
-                    term.type += tmpBuf[i];
-                    tState = NEG_SB_TTYPE;
-                    break;
-                } else {
-                    std::clog << "NEG_SB_TTYPE_END Error: Expected SE, got '" << (int) tmpBuf[i] << "'" << std::endl;
-                }
+void Socket::setTermType(const std::string& type) {
+    term.lastType = term.type;
+    term.type = type;
+    std::clog << "Found term type: " << term.type << std::endl;
 
-                tState = NEG_NONE;
-                break;
-            case NEG_SB_NAWS_COL_HIGH:
-                if (handleNaws(term.cols, tmpBuf[i], true))
-                    tState = NEG_SB_NAWS_COL_LOW;
-                break;
-            case NEG_SB_NAWS_COL_LOW:
-                if (handleNaws(term.cols, tmpBuf[i], false))
-                    tState = NEG_SB_NAWS_ROW_HIGH;
-                break;
-            case NEG_SB_NAWS_ROW_HIGH:
-                if (handleNaws(term.rows, tmpBuf[i], true))
-                    tState = NEG_SB_NAWS_ROW_LOW;
-                break;
-            case NEG_SB_NAWS_ROW_LOW:
-                if (handleNaws(term.rows, tmpBuf[i], false)) {
-                    std::clog << "New term size: " << term.cols << " x " << term.rows << std::endl;
-                    // Some clients (tintin++, cmud, possibly zmud) don't seem to double an IAC(255) when it's
-                    // sent as data, if this happens in the cols...we should be able to gracefully catch it
-                    // but if it happens in the rows...it'll eat the IAC from IAC SE and cause problems,
-                    // so we set the state machine to keep an eye out for a stray SE if the rows were set to 255
-                    if (term.rows == 255)
-                        watchBrokenClient = true;
-                    tState = NEG_NONE;
-                }
-                break;
-            default:
-                std::clog << "Unhandled state" << std::endl;
-                tState = NEG_NONE;
-                break;
+    // We haven't cycled back around to the first term type, and
+    // No previous term type or the current term type isn't the same as the last
+    if ((term.firstType != term.type) && (term.lastType.empty() ||  (term.type != term.lastType))) {
+        term.lastType = "";
+        // Look for 256 color support
+        if (term.type.find("-256color") != std::string::npos) {
+            // Works for tintin++, wintin++ and blowtorch
+            opts.xterm256 = true;
         }
-    }
 
-    // Handles the screwy windows telnet, and its not that hard for
-    // other clients that send \n\r too
-    std::replace(tmp.begin(), tmp.end(), '\r', '\n');
-    inBuf += tmp;
-
-    // handle backspaces
-    n = inBuf.length();
-
-    for (i = std::max<int>(n - tmp.length(), 0); i < (unsigned) n; i++) {
-        if (inBuf.at(i) == '\b' || inBuf.at(i) == 127) {
-            if (n < 2) {
-                inBuf = "";
-                n = 0;
-            } else if (i == 0) {
-                inBuf.erase(i, 1);
-                i--;
-            } else {
-                inBuf.erase(i - 1, 2);
-                n -= 2;
-                i--;
-            }
-        }
+        // Request another!
+        write(reinterpret_cast<const char *>(telnet::query_ttype), false);
+    }
+    if (term.firstType.empty()) {
+        term.firstType = term.type;
     }
 
-    std::string::size_type idx = 0;
-    while ((idx = inBuf.find("\n", 0)) != std::string::npos) {
-        std::string tmpr = inBuf.substr(0, idx); // Don't copy the \n
-        idx += 1; // Consume the \n
-        if (inBuf[idx] == '\n')
-            idx += 1; // Consume the extra \n if applicable
-
-        inBuf.erase(0, idx);
-        if(opts.mxpClientSecure) {
-            if(boost::istarts_with(inBuf, "<version")) {
-                std::clog << "Got msxp version\n";
-            } else if(boost::istarts_with(inBuf, "<supports")) {
-                std::clog << "Got msxp supports\n";
-            }
-        }
-        input.push(tmpr);
+    if (term.type.find("Mudlet") != std::string::npos and term.type > "Mudlet 1.1") {
+        opts.xterm256 = true;
+    } else if(boost::iequals(term.type, "EMACS-RINZAI") || term.type.find("DecafMUD") != std::string::npos) {
+        opts.xterm256 = true;
     }
-    ltime = time(nullptr);
-    return (0);
 }
 
-bool Socket::negotiate(unsigned char ch) {
+//********************************************************************
+//                      negotiate
+//********************************************************************
+
+bool Socket::negotiate(unsigned char verb, unsigned char option) {
+    bool on = (verb == WILL || verb == DO);
 
-    switch (ch) {
+    switch (option) {
         case TELOPT_CHARSET:
-            if (tState == NEG_WILL) {
+            if (verb == WILL) {
                 opts.charset = true;
                 write(reinterpret_cast<const char *>(telnet::charset_utf8), false);
                 std::clog << "Charset On" << std::endl;
-            } else if (tState == NEG_WONT) {
+            } else if (verb == WONT) {
                 opts.charset = false;
                 std::clog << "Charset Off" << std::endl;
             }
-            tState = NEG_NONE;
             break;
         case TELOPT_TTYPE:
             // If we've gotten this far, we're fairly confident they support ANSI color
@@ -959,11 +610,11 @@ bool Socket::negotiate(unsigned char ch) {
             // If we get here it's clearly not a dumb terminal, however if
             // dumb is still set, it means we haven't negotiated, so let's negotiate now
             if (opts.dumb) {
-                if (tState == NEG_WILL) {
+                if (verb == WILL) {
                     // Continue and query the rest of the options, including term type
                     std::clog << "Continuing telnet negotiation\n";
                     continueTelnetNeg(true);
-                } else if (tState == NEG_WONT) {
+                } else if (verb == WONT) {
                     // If they respond to something here they know how to negotiate,
                     // so continue and ask for the rest of the options, except term type
                     // which they have just indicated they won't do
@@ -972,82 +623,59 @@ bool Socket::negotiate(unsigned char ch) {
 
                 }
             }
-            tState = NEG_NONE;
             break;
         case TELOPT_MXP:
-            if (tState == NEG_WILL || tState == NEG_DO) {
+            if (on) {
                 write(reinterpret_cast<const char *>(telnet::start_mxp));
                 // Start off in MXP LOCKED CLOSED
                 //TODO: send elements we're using for mxp
                 opts.mxp = true;
                 std::clog << "Enabled MXP" << std::endl;
                 defineMxp();
-            } else if (tState == NEG_WONT || tState == NEG_DONT) {
+            } else {
                 opts.mxp = false;
                 std::clog << "Disabled MXP" << std::endl;
             }
-            tState = NEG_NONE;
             break;
         case TELOPT_COMPRESS2:
-            if (tState == NEG_WILL || tState == NEG_DO) {
+            if (on) {
                 opts.mccp = 2;
                 startCompress();
-            } else if (tState == NEG_WONT || tState == NEG_DONT) {
-                if (opts.mccp == 2) {
-                    opts.mccp = 0;
-                    endCompress();
-                }
+            } else if (opts.mccp == 2) {
+                endCompress();
+                opts.mccp = 0;
             }
-            tState = NEG_NONE;
             break;
         case TELOPT_COMPRESS:
-            if (tState == NEG_WILL || tState == NEG_DO) {
+            if (on) {
                 opts.mccp = 1;
                 startCompress();
-            } else if (tState == NEG_WONT || tState == NEG_DONT) {
-                if (opts.mccp == 1) {
-                    opts.mccp = 0;
-                    endCompress();
-                }
+            } else if (opts.mccp == 1) {
+                endCompress();
+                opts.mccp = 0;
             }
-            tState = NEG_NONE;
             break;
         case TELOPT_EOR:
-            if (tState == NEG_WILL || tState == NEG_DO) {
-                opts.eor = true;
-                std::clog << "Activating EOR\n";
-            } else if (tState == NEG_WONT || tState == NEG_DONT) {
-                opts.eor = false;
-                std::clog << "Deactivating EOR\n";
-            }
-            tState = NEG_NONE;
+            opts.eor = on;
+            std::clog << (on ? "Activating EOR\n" : "Deactivating EOR\n");
             break;
         case TELOPT_NAWS:
-            opts.naws = (tState == NEG_WILL);
-            tState = NEG_NONE;
+            opts.naws = (verb == WILL);
             break;
         case TELOPT_ECHO:
         case TELOPT_NEW_ENVIRON:
             // TODO: Echo/New Environ
-            tState = NEG_NONE;
             break;
         case TELOPT_MSSP:
-            if (tState == NEG_DO) {
+            if (verb == DO) {
                 sendMSSP();
             }
-            tState = NEG_NONE;
             break;
         case TELOPT_MSP:
-            if (tState == NEG_WILL || tState == NEG_DO) {
-                opts.msp = true;
-            } else if (tState == NEG_WONT || tState == NEG_DONT) {
-                opts.msp = false;
-            }
-
-            tState = NEG_NONE;
+            opts.msp = on;
             break;
         case TELOPT_MSDP:
-            if (tState == NEG_DO) {
+            if (verb == DO) {
                 opts.msdp = true;
                 msdpSend("SERVER_ID");
 
@@ -1056,51 +684,21 @@ bool Socket::negotiate(unsigned char ch) {
                 std::clog << "Disabled MSDP" << std::endl;
                 opts.msdp = false;
             }
-            tState = NEG_NONE;
             break;
         default:
-            tState = NEG_NONE;
             break;
     }
     return (true);
 }
 
-//********************************************************************
-//                      handleNaws
-//********************************************************************
-// Return true if a state should be changed
-
-bool Socket::handleNaws(int& colRow, unsigned char& chr, bool high) {
-    // If we get an IAC here, we need a double IAC
-    if (chr == IAC) {
-        if (!oneIAC) {
-            oneIAC = true;
-            return (false);
-        } else {
-            oneIAC = false;
-        }
-    } else if (oneIAC && chr != IAC) {
-        // Error!
-        std::clog << "NAWS: BUG - Expecting a doubled IAC, got " << (unsigned int) chr << "\n";
-        oneIAC = false;
-    }
-
-    if (high)
-        colRow = chr << 8;
-    else
-        colRow += chr;
-
-    return (true);
-}
-
 //********************************************************************
 //                      processOneCommand
 //********************************************************************
 // Aka interpreter
 
 int Socket::processOneCommand() {
-    std::string cmd = input.front();
-    input.pop();
+    std::string cmd(io->frontLine());
+    io->popLine();
 
     // Send the command to the people we're spying on
     if (!spying.empty()) {
@@ -1205,6 +803,8 @@ void Socket::setState(int pState, char pFnParam) {
     if (pState != connState)
         lastState = connState;
     connState = pState;
+    if (table)
+        table->setState(handle, pState);
 
     if (pState == LOGIN_PAUSE_SCREEN)
         fn = pauseScreen;
@@ -1266,9 +866,8 @@ std::string getMxpTag( std::string_view tag, std::string text ) {
     return("");
 }
 
-bool Socket::parseMXPSecure() {
+bool Socket::parseMXPSecure(const std::string& toParse) {
     if(mxpEnabled()) {
-        std::string toParse(reinterpret_cast<char*>(&cmdInBuf[0]), cmdInBuf.size());
         std::clog << toParse << std::endl;
 
         std::string client = getMxpTag("CLIENT=", toParse);
@@ -1297,40 +896,40 @@ bool Socket::parseMXPSecure() {
 
     }
     clearMxpClientSecure();
-    cmdInBuf.clear();
     return(true);
 }
 
-bool Socket::parseMsdp() {
+bool Socket::parseMsdp(std::string_view sub) {
     if(msdpEnabled()) {
         std::string var, val;
         int nest = 0;
 
         var.reserve(15);
         val.reserve(30);
-        ssize_t i = 0, n = cmdInBuf.size();
-        while (i < n && cmdInBuf[i] != SE) {
-            switch (cmdInBuf[i]) {
+        auto data = reinterpret_cast<const unsigned char*>(sub.data());
+        ssize_t i = 0, n = sub.size();
+        while (i < n && data[i] != SE) {
+            switch (data[i]) {
             case MSDP_VAR:
                 i++;
-                while (i < n && cmdInBuf[i] != MSDP_VAL) {
-                    var += cmdInBuf[i++];
+                while (i < n && data[i] != MSDP_VAL) {
+                    var += data[i++];
                 }
                 break;
             case MSDP_VAL:
                 i++;
                 val.erase();
-                while (i < n && cmdInBuf[i] != IAC) {
-                    if (cmdInBuf[i] == MSDP_TABLE_OPEN
-                            || cmdInBuf[i] == MSDP_ARRAY_OPEN)
+                while (i < n && data[i] != IAC) {
+                    if (data[i] == MSDP_TABLE_OPEN
+                            || data[i] == MSDP_ARRAY_OPEN)
                         nest++;
-                    else if (cmdInBuf[i] == MSDP_TABLE_CLOSE
-                            || cmdInBuf[i] == MSDP_ARRAY_CLOSE)
+                    else if (data[i] == MSDP_TABLE_CLOSE
+                            || data[i] == MSDP_ARRAY_CLOSE)
                         nest--;
                     else if (nest == 0
-                            && (cmdInBuf[i] == MSDP_VAR || cmdInBuf[i] == MSDP_VAL))
+                            && (data[i] == MSDP_VAR || data[i] == MSDP_VAL))
                         break;
-                    val += cmdInBuf[i++];
+                    val += data[i++];
                 }
                 if (nest == 0)
                     processMsdpVarVal(var, val);
@@ -1342,7 +941,6 @@ bool Socket::parseMsdp() {
             }
         }
     }
-    cmdInBuf.clear();
 
     return (true);
 }
@@ -1406,13 +1004,40 @@ void Socket::appendPaged(std::string_view toAppend) {
 // Append a string to the socket's output queue
 
 void Socket::bprint(std::string_view toPrint) {
-    if (!toPrint.empty())
-        output << toPrint;
+    if (toPrint.empty() || discardOutput())
+        return;
+
+    output += toPrint;
+    if (table)
+        table->setHasOutput(handle, true);
+}
+
+void Socket::bprint(const std::shared_ptr<const SharedOutput>& toPrint) {
+    if (!toPrint || toPrint->getText().empty() || discardOutput())
+        return;
+
+    sharedOutput.emplace_back(output.size(), toPrint);
+    if (table)
+        table->setHasOutput(handle, true);
+}
+
+// The client isn't keeping up (or something is spamming them); drop it, but let them know once
+bool Socket::discardOutput() {
+    if (!isOutputThrottled()) {
+        outputThrottled = false;
+        return (false);
+    }
+    if (!outputThrottled) {
+        outputThrottled = true;
+        output += "\n^R*** Output overflow, discarding output until your client catches up ***^x\n";
+        if (table)
+            table->setHasOutput(handle, true);
+    }
+    return (true);
 }
 
 void Socket::bprintPython(const std::string& toPrint) {
-    if (!toPrint.empty())
-        output << toPrint;
+    bprint(toPrint);
 }
 
 //********************************************************************
@@ -1453,109 +1078,110 @@ void Socket::printColor(const char* fmt, ...) {
 // Flush pending output and send a prompt
 
 void Socket::flush() {
-    if (fd == -1) return;
-
-    ssize_t n;
-    if(!processedOutput.empty()) {
-        n = write(processedOutput, false, false);
-    } else {
-        if ((n = write(output.str())) == 0)
-            return;
-        output = std::stringstream();
+    // Anything left over from last time is the network thread's problem, and its prompt is already queued
+    if (fd == -1 || (output.empty() && sharedOutput.empty())) return;
+
+    std::string toWrite;
+    toWrite.swap(output);
+    if (table)
+        table->setHasOutput(handle, false);
+    // If we only wrote OOB data then write returns -2, don't send a prompt in that case.  The prompt is queued
+    // behind the output even if the socket would block, so it still goes out in order.
+    std::string_view rest = toWrite;
+    size_t pos = 0;
+    bool prompt = false;
+    for (const auto& [at, shared] : sharedOutput) {
+        if (at > pos)
+            prompt |= (write(rest.substr(0, at - pos)) != -2);
+        rest.remove_prefix(at - pos);
+        pos = at;
+        prompt |= (write(*shared) != -2);
     }
-    // If we only wrote OOB data or partial data was written because of EWOULDBLOCK,
-    // then n is -2, don't send a prompt in that case
-    if (n != -2 && myPlayer && connState != CON_CHOSING_WEAPONS && pagerOutput.empty())
+    sharedOutput.clear();
+    if (!rest.empty())
+        prompt |= (write(rest) != -2);
+
+    if (prompt && myPlayer && connState != CON_CHOSING_WEAPONS && pagerOutput.empty())
         myPlayer->sendPrompt();
 }
 
 //********************************************************************
 //                      write
 //********************************************************************
-// Write a string of data to the socket's file descriptor
+// Process a string of data and hand it to the network thread, which compresses
+// it if need be and sends it once the game loop is done with this pass.
 
 ssize_t Socket::write(std::string_view toWrite, bool pSpy, bool process) {
-    ssize_t written = 0;
-    ssize_t n = 0;
-    size_t total = 0;
-
     // Parse any color, unicode, etc here
-    std::string toOutput;
-    if(process)
-        toOutput = parseForOutput(toWrite);
-    else {
-        toOutput = toWrite;
+    std::string_view processed = toWrite;
+    if(process) {
+        transcoded.clear();
+        transcodeOutput(toWrite, transcoded, getColorTable(opts.color), opts.mxp, opts.lastColor);
+        processed = transcoded;
     }
 
-    total = toOutput.length();
-
-    const char *str = toOutput.c_str();
-    // Write directly to the socket, otherwise compress it and send it
-    if (!opts.compressing) {
-        do {
-            n = ::write(fd, str + written, total - written);
-            if (n < 0) {
-                if(errno != EWOULDBLOCK)
-                    return (n);
-                else  {
-                    // The write would have blocked
-                    n = -2;
-                    // If we haven't written the total number of bytes planned save the remaining string for the next go around
-                    if(written < total) {
-                        processedOutput = str + written;
-                    }
-                    break;
-                }
-            }
-            written += n;
-        } while (written < total);
+    UnCompressedBytes += processed.length();
+    io->send(processed);
+    auto written = (ssize_t)processed.length();
+
+    if (pSpy)
+        writeToSpies(toWrite);
+
+    // If stripped len is 0, it means we only wrote OOB data, so adjust the return so we don't send another prompt
+    if(!needsPrompt(toWrite))
+        written = -2;
 
-        UnCompressedBytes += written;
+    return (written);
+}
 
-        if(n == -2)
-            written = -2;
+// The bytes are shared with every other socket the broadcast went to that has the same settings
+ssize_t Socket::write(const SharedOutput& toWrite) {
+    std::shared_ptr<const std::string> processed = toWrite.transcode(getColorTable(opts.color), opts.mxp, opts.lastColor);
 
-        if(written >= total && !processedOutput.empty() && !process) {
-            processedOutput.erase();
-        }
-    } else {
-        UnCompressedBytes += total;
-
-        outCompress->next_in = (unsigned char*) str;
-        outCompress->avail_in = total;
-        while (outCompress->avail_in) {
-            outCompress->avail_out =
-                    COMPRESSED_OUTBUF_SIZE
-                            - ((char*) outCompress->next_out
-                                    - (char*) outCompressBuf);
-            if (deflate(outCompress, Z_SYNC_FLUSH) != Z_OK) {
-                return (0);
-            }
-            written += processCompressed();
-            if (written == 0)
-                break;
-        }
-    }
+    UnCompressedBytes += processed->length();
+    auto written = (ssize_t)processed->length();
+    io->send(std::move(processed));
 
-    if (pSpy && !spying.empty()) {
-        std::string forSpy = Socket::stripTelnet(toWrite);
+    writeToSpies(toWrite.getText());
 
-        boost::replace_all(forSpy, "\n", "\n<Spy> ");
-        if(!forSpy.empty()) {
-            for(const auto &sIt : spying) {
-                if (auto sock = sIt.lock())
-                    sock->write("<Spy> " + forSpy, false);
-            }
+    if(!needsPrompt(toWrite.getText()))
+        written = -2;
+
+    return (written);
+}
+
+void Socket::writeToSpies(std::string_view toWrite) {
+    if (spying.empty())
+        return;
+
+    std::string forSpy = Socket::stripTelnet(toWrite);
+
+    boost::replace_all(forSpy, "\n", "\n<Spy> ");
+    if(!forSpy.empty()) {
+        for(const auto &sIt : spying) {
+            if (auto sock = sIt.lock())
+                sock->write("<Spy> " + forSpy, false);
         }
     }
-    // Keep track of total outbytes
-    OutBytes += written;
+}
 
-    // If stripped len is 0, it means we only wrote OOB data, so adjust the return so we don't send another prompt
-    if(!needsPrompt(toWrite))
-        written = -2;
+//********************************************************************
+//                      setOutputHighWater
+//********************************************************************
 
-    return (written);
+void Socket::setOutputHighWater(size_t bytes) {
+    outputHighWater = bytes;
+}
+
+size_t Socket::getPendingOutput() const {
+    size_t pending = output.length() + io->getPending();
+    for (const auto& [at, shared] : sharedOutput)
+        pending += shared->getText().length();
+    return (pending);
+}
+
+bool Socket::isOutputThrottled() const {
+    return (outputHighWater && getPendingOutput() >= outputHighWater);
 }
 
 //--------------------------------------------------------------------
@@ -1572,31 +1198,14 @@ int Socket::startCompress(bool silent) {
     if (opts.compressing)
         return (-1);
 
-    outCompressBuf = new char[COMPRESSED_OUTBUF_SIZE];
-    //out_compress = new z_stream;
-    outCompress = (z_stream *) malloc(sizeof(*outCompress));
-    outCompress->zalloc = telnet::zlib_alloc;
-    outCompress->zfree = telnet::zlib_free;
-    outCompress->opaque = nullptr;
-    outCompress->next_in = nullptr;
-    outCompress->avail_in = 0;
-    outCompress->next_out = (Bytef*) outCompressBuf;
-    outCompress->avail_out = COMPRESSED_OUTBUF_SIZE;
-
-    if (deflateInit(outCompress, 9) != Z_OK) {
-        // Problem with zlib, try to clean up
-        delete outCompressBuf;
-        free(outCompress);
-        return (-1);
-    }
-
     if (!silent) {
         if (opts.mccp == 2)
             write(reinterpret_cast<const char *>(telnet::start_mccp2), false);
         else
             write(reinterpret_cast<const char *>(telnet::start_mccp), false);
     }
-    // We're compressing now
+    // We're compressing now; everything written from here on is compressed by the network thread
+    io->startCompress();
     opts.compressing = true;
 
     return (0);
@@ -1607,27 +1216,9 @@ int Socket::startCompress(bool silent) {
 //********************************************************************
 
 int Socket::endCompress() {
-    if (outCompress && opts.compressing) {
-        unsigned char dummy[1] = { 0 };
-        outCompress->avail_in = 0;
-        outCompress->next_in = dummy;
-        // process any remaining output first?
-        if (deflate(outCompress, Z_FINISH) != Z_STREAM_END) {
-            std::clog << "Error with deflate Z_FINISH\n";
-            return (-1);
-        }
-
-        // Send any residual data
-        if (processCompressed() < 0)
-            return (-1);
-
-        deflateEnd(outCompress);
-
-        delete[] outCompressBuf;
-
-        free(outCompress);
-        outCompress = nullptr;
-        outCompressBuf = nullptr;
+    if (opts.compressing) {
+        // The network thread finishes the stream and sends any residual data
+        io->endCompress();
 
         opts.mccp = 0;
         opts.compressing = false;
@@ -1635,34 +1226,6 @@ int Socket::endCompress() {
     return (-1);
 }
 
-//********************************************************************
-//                      processCompressed
-//********************************************************************
-
-size_t Socket::processCompressed() {
-    auto len = (size_t) ((char*) outCompress->next_out - (char*) outCompressBuf);
-    size_t written = 0;
-    size_t block;
-    ssize_t n, i;
-
-    if (len > 0) {
-        for (i = 0, n = 0; i < len; i += n) {
-            block = std::min<size_t>(len - i, 4096);
-            if ((n = ::write(fd, outCompressBuf + i, block)) < 0)
-                return (-1);
-            written += n;
-            if (n == 0)
-                break;
-        }
-        if (i) {
-            if (i < len)
-                memmove(outCompressBuf, outCompressBuf + i, len - i);
-
-            outCompress->next_out = (Bytef*) outCompressBuf + len - i;
-        }
-    }
-    return (written);
-}
 // End - MCCP
 //--------------------------------------------------------------------
 
@@ -1721,7 +1284,7 @@ bool Socket::loadTelopts(xmlNodePtr rootNode) {
 //********************************************************************
 
 bool Socket::hasOutput() const {
-    return (!processedOutput.empty() || output.rdbuf()->in_avail());
+    return (!output.empty() || !sharedOutput.empty() || io->getPending());
 }
 
 //********************************************************************
@@ -1729,7 +1292,7 @@ bool Socket::hasOutput() const {
 //********************************************************************
 
 bool Socket::hasCommand() const {
-    return (!input.empty());
+    return (io->hasLine());
 }
 
 //********************************************************************
@@ -1759,6 +1322,9 @@ bool Player::isConnected() const {
 int Socket::getFd() const {
     return (fd);
 }
+SocketHandle Socket::getHandle() const {
+    return (handle);
+}
 bool Socket::mxpEnabled() const {
     return (opts.mxp);
 }
@@ -2105,10 +1671,14 @@ void Socket::viewFile(const std::string& str, bool shouldPage) {
     }
     std::string line;
     while(std::getline(file, line)) {
-        if(shouldPage)
+        if(shouldPage) {
             printPaged(line);
-        else
+        } else {
+            // No sense reading the rest of the file if it's just going to be thrown away
+            if(isOutputThrottled())
+                break;
             bprint(fmt::format("{}\n", line));
+        }
     }
 
     if(shouldPage)
@@ -0,0 +1,668 @@
+/*
+ * socketIo.cpp
+ *   The half of a socket that lives on a network thread
+ *   ____            _
+ *  |  _ \ ___  __ _| |_ __ ___  ___
+ *  | |_) / _ \/ _` | | '_ ` _ \/ __|
+ *  |  _ <  __/ (_| | | | | | | \__ \
+ *  |_| \_\___|\__,_|_|_| |_| |_|___/
+ *
+ * Permission to use, modify and distribute is granted via the
+ *  GNU Affero General Public License v3 or later
+ *
+ *  Copyright (C) 2007-2021 Jason Mitchell, Randi Mitchell
+ *     Contributions by Tim Callahan, Jonathan Hseu
+ *  Based on Mordor (C) Brooke Paul, Brett J. Vickers, John P. Freeman
+ *
+ */
+
+#include <arpa/telnet.h>                            // for IAC, SE, WILL, SB
+#include <sys/socket.h>                             // for recv
+#include <zlib.h>                                   // for z_stream, deflate
+#include <cerrno>                                   // for EWOULDBLOCK, errno
+#include <cstdlib>                                  // for malloc, free
+#include <iostream>                                 // for operator<<, clog
+
+#include "networkIo.hpp"                            // for NetworkIo
+#include "socket.hpp"                               // for telnet::zlib_alloc, TELOPT_MSDP
+#include "socketIo.hpp"                             // for SocketIo, InputEvent
+
+const int SocketIo::COMPRESSED_OUTBUF_SIZE = 8192;
+
+enum telnetNegotiation {
+    NEG_NONE,
+    NEG_IAC,
+    NEG_WILL,
+    NEG_WONT,
+    NEG_DO,
+    NEG_DONT,
+
+    NEG_SB,
+    NEG_START_NAWS,
+    NEG_SB_NAWS_COL_HIGH,
+    NEG_SB_NAWS_COL_LOW,
+    NEG_SB_NAWS_ROW_HIGH,
+    NEG_SB_NAWS_ROW_LOW,
+    NEG_END_NAWS,
+
+    NEG_SB_TTYPE,
+    NEG_SB_TTYPE_END,
+
+    NEG_SB_MSDP,
+    NEG_SB_MSDP_END,
+
+    NEG_SB_GMCP,
+    NEG_SB_GMCP_END,
+
+    NEG_SB_CHARSET,
+    NEG_SB_CHARSET_LOOK_FOR_IAC,
+    NEG_SB_CHARSET_END,
+
+    NEG_MXP_SECURE,
+    NEG_MXP_SECURE_TWO,
+    NEG_MXP_SECURE_THREE,
+    NEG_MXP_SECURE_FINISH,
+    NEG_MXP_SECURE_CONSUME,
+
+    NEG_UNUSED
+};
+
+//********************************************************************
+//                      SocketIo
+//********************************************************************
+
+SocketIo::SocketIo(int pFd): fd(pFd) {
+}
+
+// The descriptor isn't ours to close here: it's either been closed on
+// request or is being kept open across a reboot
+SocketIo::~SocketIo() {
+    if(outCompress) {
+        deflateEnd(outCompress);
+        free(outCompress);
+        delete[] outCompressBuf;
+    }
+}
+
+//--------------------------------------------------------------------
+// Game thread
+
+void SocketIo::send(std::string_view data) {
+    if(closed || data.empty())
+        return;
+    unsent.fetch_add(data.size(), std::memory_order_relaxed);
+    queue(OutputEvent{.kind = OutputEvent::Data, .data = std::string(data)});
+}
+
+void SocketIo::send(std::shared_ptr<const std::string> data) {
+    if(closed || !data || data->empty())
+        return;
+    unsent.fetch_add(data->size(), std::memory_order_relaxed);
+    queue(OutputEvent{.kind = OutputEvent::Data, .shared = std::move(data)});
+}
+
+void SocketIo::startCompress() {
+    if(!closed)
+        queue(OutputEvent{.kind = OutputEvent::StartCompress});
+}
+
+void SocketIo::endCompress() {
+    if(!closed)
+        queue(OutputEvent{.kind = OutputEvent::EndCompress});
+}
+
+void SocketIo::close() {
+    if(closed)
+        return;
+    queue(OutputEvent{.kind = OutputEvent::Close});
+    closed = true;
+}
+
+void SocketIo::queue(OutputEvent&& event) {
+    output.push(std::move(event));
+    wake();
+}
+
+// Put the socket on its thread's list to be serviced
+void SocketIo::wake() {
+    // Until the socket has a thread, add() takes care of anything queued
+    if(network && !queued.exchange(true))
+        network->queue(shared_from_this());
+}
+
+bool SocketIo::takeReady() {
+    if(!ready.load(std::memory_order_relaxed))
+        return(false);
+    return(ready.exchange(false, std::memory_order_acquire));
+}
+
+bool SocketIo::takeInput(InputEvent& event) {
+    return(input.pop(event));
+}
+
+bool SocketIo::hasLine() const {
+    return(!inRing.empty());
+}
+
+std::string_view SocketIo::frontLine() const {
+    return(inRing.front());
+}
+
+void SocketIo::popLine() {
+    inRing.pop();
+    // Reading stopped because we'd fallen behind; start it up again
+    if(throttled.load() && throttled.exchange(false) && !closed)
+        wake();
+}
+
+bool SocketIo::isHungUp() const {
+    return(hungUp.load(std::memory_order_acquire));
+}
+
+size_t SocketIo::getPending() const {
+    return(unsent.load(std::memory_order_relaxed) + buffered.load(std::memory_order_relaxed));
+}
+
+//--------------------------------------------------------------------
+// Network thread: input
+
+//********************************************************************
+//                      readInput
+//********************************************************************
+// Edge triggered, so read until the socket is drained, straight into
+// inRing.  If inRing fills up we stop short and let TCP hold the client
+// back; popLine() gets us going again.
+
+void SocketIo::readInput() {
+    paused = false;
+    while(true) {
+        // Anything left over from when the line queue filled up
+        parse();
+
+        size_t n = 0;
+        char* buf = inRing.linesFull() ? nullptr : inRing.readSpace(n);
+        if(!n) {
+            throttled.store(true);
+            // The game may have taken a line since we looked
+            if(!inRing.linesFull() && (buf = inRing.readSpace(n)) && n) {
+                throttled.store(false);
+            } else {
+                paused = true;
+                break;
+            }
+        }
+
+        ssize_t got = ::recv(fd, buf, n, 0);
+        if(got < 0 && errno == EINTR)
+            continue;
+        if(got <= 0) {
+            if(got == 0 || (errno != EWOULDBLOCK && errno != EAGAIN)) {
+                hungUp.store(true, std::memory_order_release);
+                ready.store(true, std::memory_order_release);
+            }
+            break;
+        }
+
+        network->countIn(got);
+        inRing.commitRead(got);
+
+        // A short read means we've drained the socket
+        if((size_t)got < n) {
+            parse();
+            break;
+        }
+    }
+
+    if(framed) {
+        framed = false;
+        ready.store(true, std::memory_order_release);
+    }
+}
+
+void SocketIo::emit(InputEvent&& event) {
+    input.push(std::move(event));
+    ready.store(true, std::memory_order_release);
+}
+
+//********************************************************************
+//                      parse
+//********************************************************************
+// Telnet and MXP sequences are pulled out with a finite state machine and
+// handed to the game as events; everything else is framed into lines in
+// place in inRing.  Each byte is only looked at once.
+
+void SocketIo::parse() {
+    while(inRing.hasRaw()) {
+        // Leave the rest until the game has room for another line
+        if(inRing.linesFull())
+            return;
+
+        unsigned char ch = inRing.nextRaw();
+
+        // Try to handle zMud, cMud & tintin++ which don't seem to double the IAC for NAWS
+        // during my limited testing -JM
+        if(oneIAC && tState > NEG_START_NAWS && tState < NEG_END_NAWS && ch != IAC) {
+            // Broken Client: take the lone IAC as the value
+            std::clog << "NAWS: BUG - Broken Client: Non-doubled IAC\n";
+            parseByte(IAC);
+        }
+        if(watchBrokenClient) {
+            // If we just finished NAWS with a 255 height...keep an eye out for the next
+            // character to be a stray SE
+            if(tState == NEG_NONE && ch == SE) {
+                std::clog << "NAWS: BUG - Stray SE\n";
+                // Set the tState to NEG_IAC as it should have been, and carry gracefully on
+                tState = NEG_IAC;
+            }
+            // It should only be the next character, so if we don't find it...don't keep looking for it
+            watchBrokenClient = false;
+        }
+        parseByte(ch);
+    }
+}
+
+//********************************************************************
+//                      parseText
+//********************************************************************
+// \r\n, \n\r, \r or \n on its own all end a line
+
+void SocketIo::parseText(unsigned char ch) {
+    if(ch == '\r' || ch == '\n') {
+        if(lastEol && lastEol != (char)ch) {
+            lastEol = 0;
+            return;
+        }
+        lastEol = (char)ch;
+        inRing.endLine();
+        framed = true;
+        return;
+    }
+
+    // Telnet sends a bare carriage return as \r\0
+    bool afterCr = (lastEol == '\r');
+    lastEol = 0;
+    if(ch == '\0' && afterCr)
+        return;
+
+    if(ch == '\b' || ch == 127)
+        inRing.backspace();
+    else
+        inRing.put((char)ch);
+}
+
+void SocketIo::parseByte(unsigned char ch) {
+    switch(tState) {
+        case NEG_NONE:
+            // Expecting an IAC here
+            if(ch == IAC) {
+                tState = NEG_IAC;
+            } else if(ch == '\033') {
+                // Goes on the line as text unless it turns out to be \033[1z
+                lastEol = 0;
+                mxpHeld = inRing.put((char)ch);
+                tState = NEG_MXP_SECURE;
+            } else {
+                parseText(ch);
+            }
+            break;
+        case NEG_MXP_SECURE:
+            if(ch == '[') {
+                mxpHeld += inRing.put((char)ch);
+                tState = NEG_MXP_SECURE_TWO;
+                break;
+            }
+            tState = NEG_NONE;
+            parseByte(ch);
+            break;
+        case NEG_MXP_SECURE_TWO:
+            if(ch == '1') {
+                mxpHeld += inRing.put((char)ch);
+                tState = NEG_MXP_SECURE_FINISH;
+                break;
+            }
+            tState = NEG_NONE;
+            parseByte(ch);
+            break;
+        case NEG_MXP_SECURE_FINISH:
+            if(ch == 'z') {
+                inRing.unput(mxpHeld);
+                tState = NEG_MXP_SECURE_CONSUME;
+                std::clog << "Client secure MXP mode enabled" << std::endl;
+                break;
+            }
+            tState = NEG_NONE;
+            parseByte(ch);
+            break;
+        case NEG_MXP_SECURE_CONSUME:
+            if(ch == '\n') {
+                tState = NEG_NONE;
+                emit(InputEvent{.kind = InputEvent::MxpSecure, .data = std::move(sub)});
+                sub.clear();
+            } else {
+                sub += (char)ch;
+            }
+            break;
+        case NEG_IAC:
+            switch(ch) {
+                case WILL:
+                    tState = NEG_WILL;
+                    break;
+                case WONT:
+                    tState = NEG_WONT;
+                    break;
+                case DO:
+                    tState = NEG_DO;
+                    break;
+                case DONT:
+                    tState = NEG_DONT;
+                    break;
+                case SB:
+                    tState = NEG_SB;
+                    sub.clear();
+                    break;
+                case IAC:
+                    // Doubled IAC, send along to parser
+                    parseText(ch);
+                    tState = NEG_NONE;
+                    break;
+                default:
+                    // NOP, IP, GA, SE and anything we don't know
+                    tState = NEG_NONE;
+                    break;
+            }
+            break;
+            // Handle Do and Will
+        case NEG_DO:
+        case NEG_WILL:
+        case NEG_DONT:
+        case NEG_WONT: {
+            unsigned char verb = tState == NEG_DO ? DO : tState == NEG_WILL ? WILL : tState == NEG_DONT ? DONT : WONT;
+            emit(InputEvent{.kind = InputEvent::Negotiate, .verb = verb, .value = ch});
+            tState = NEG_NONE;
+            break;
+        }
+        case NEG_SB:
+            switch(ch) {
+                case NAWS:
+                    tState = NEG_SB_NAWS_COL_HIGH;
+                    break;
+                case TTYPE:
+                    tState = NEG_SB_TTYPE;
+                    break;
+                case CHARSET:
+                    tState = NEG_SB_CHARSET;
+                    break;
+                case MSDP:
+                    tState = NEG_SB_MSDP;
+                    break;
+                case TELOPT_GMCP:
+                    tState = NEG_SB_GMCP;
+                    break;
+                default:
+                    std::clog << "Unknown Sub Negotiation: " << (int)ch << std::endl;
+                    tState = NEG_NONE;
+                    break;
+            }
+            break;
+        case NEG_SB_MSDP:
+            sub += (char)ch;
+            if(ch == IAC)
+                tState = NEG_SB_MSDP_END;
+            break;
+        case NEG_SB_MSDP_END:
+            if(ch == SE) {
+                // We should have a full MDSP command now, hand it over
+                emit(InputEvent{.kind = InputEvent::Msdp, .data = std::move(sub)});
+                sub.clear();
+                tState = NEG_NONE;
+            } else {
+                // Not an SE: The last input was an IAC, so keep going
+                sub += (char)ch;
+                tState = NEG_SB_MSDP;
+            }
+            break;
+        case NEG_SB_GMCP:
+            // We don't handle this right now, but ignoring it because Mudlet likes to send it anyway
+            if(ch == IAC)
+                tState = NEG_SB_GMCP_END;
+            break;
+        case NEG_SB_GMCP_END:
+            // A full GMCP command if this is SE, let's ignore it
+            tState = ch == SE ? NEG_NONE : NEG_SB_GMCP;
+            break;
+        case NEG_SB_CHARSET:
+            // We've only asked for UTF-8, so assume if they respond it's for that and just eat the rest of the input
+            //
+            // Any other sub-negotiations (such as TTABLE-*) are not handled
+            if(ch == ACCEPTED || ch == REJECTED)
+                emit(InputEvent{.kind = InputEvent::Charset, .value = ch});
+            tState = NEG_SB_CHARSET_LOOK_FOR_IAC;
+            break;
+        case NEG_SB_CHARSET_LOOK_FOR_IAC:
+            // Do nothing while we wait for an IAC
+            if(ch == IAC)
+                tState = NEG_SB_CHARSET_END;
+            break;
+        case NEG_SB_CHARSET_END:
+            if(ch == IAC) {
+                // Double IAC, part of the data
+                tState = NEG_SB_CHARSET_LOOK_FOR_IAC;
+                break;
+            } else if(ch != SE) {
+                std::clog << "NEG_SB_CHARSET_END Error: Expected SE, got '" << (int)ch << "'" << std::endl;
+            }
+            tState = NEG_NONE;
+            break;
+        case NEG_SB_TTYPE:
+            // Grab the terminal type
+            if(ch == TELQUAL_IS)
+                sub.clear();
+            else if(ch == IAC)
+                tState = NEG_SB_TTYPE_END;
+            else
+                sub += (char)ch;
+            break;
+        case NEG_SB_TTYPE_END:
+            if(ch == SE) {
+                emit(InputEvent{.kind = InputEvent::TermType, .data = std::move(sub)});
+                sub.clear();
+            } else if(ch == IAC) {
+                // I doubt this will happen
+                std::clog << "NEG_SB_TTYPE: Found double IAC" << std::endl;
+                sub += (char)ch;
+                tState = NEG_SB_TTYPE;
+                break;
+            } else {
+                std::clog << "NEG_SB_TTYPE_END Error: Expected SE, got '" << (int)ch << "'" << std::endl;
+            }
+            tState = NEG_NONE;
+            break;
+        case NEG_SB_NAWS_COL_HIGH:
+            if(handleNaws(cols, ch, true))
+                tState = NEG_SB_NAWS_COL_LOW;
+            break;
+        case NEG_SB_NAWS_COL_LOW:
+            if(handleNaws(cols, ch, false))
+                tState = NEG_SB_NAWS_ROW_HIGH;
+            break;
+        case NEG_SB_NAWS_ROW_HIGH:
+            if(handleNaws(rows, ch, true))
+                tState = NEG_SB_NAWS_ROW_LOW;
+            break;
+        case NEG_SB_NAWS_ROW_LOW:
+            if(handleNaws(rows, ch, false)) {
+                emit(InputEvent{.kind = InputEvent::Naws, .cols = cols, .rows = rows});
+                // Some clients (tintin++, cmud, possibly zmud) don't seem to double an IAC(255) when it's
+                // sent as data, if this happens in the cols...we should be able to gracefully catch it
+                // but if it happens in the rows...it'll eat the IAC from IAC SE and cause problems,
+                // so we set the state machine to keep an eye out for a stray SE if the rows were set to 255
+                if(rows == 255)
+                    watchBrokenClient = true;
+                tState = NEG_NONE;
+            }
+            break;
+        default:
+            std::clog << "Unhandled state" << std::endl;
+            tState = NEG_NONE;
+            break;
+    }
+}
+
+//********************************************************************
+//                      handleNaws
+//********************************************************************
+// Return true if a state should be changed
+
+bool SocketIo::handleNaws(int& colRow, unsigned char chr, bool high) {
+    // If we get an IAC here, we need a double IAC
+    if(chr == IAC) {
+        if(!oneIAC) {
+            oneIAC = true;
+            return(false);
+        } else {
+            oneIAC = false;
+        }
+    } else if(oneIAC) {
+        // Error!
+        std::clog << "NAWS: BUG - Expecting a doubled IAC, got " << (unsigned int)chr << "\n";
+        oneIAC = false;
+    }
+
+    if(high)
+        colRow = chr << 8;
+    else
+        colRow += chr;
+
+    return(true);
+}
+
+//--------------------------------------------------------------------
+// Network thread: output
+
+//********************************************************************
+//                      serviceOutput
+//********************************************************************
+
+bool SocketIo::serviceOutput() {
+    OutputEvent event;
+    bool close = false;
+
+    while(output.pop(event)) {
+        switch(event.kind) {
+            case OutputEvent::Data: {
+                std::string_view data = event.shared ? *event.shared : event.data;
+                unsent.fetch_sub(data.size(), std::memory_order_relaxed);
+                if(outCompress)
+                    compress(data);
+                else if(event.shared)
+                    outQueue.append(std::move(event.shared));
+                else
+                    outQueue.append(data);
+                break;
+            }
+            case OutputEvent::StartCompress:
+                beginCompress();
+                break;
+            case OutputEvent::EndCompress:
+                finishCompress();
+                break;
+            case OutputEvent::Close:
+                close = true;
+                break;
+        }
+    }
+
+    writeOutput();
+    return(close);
+}
+
+//********************************************************************
+//                      writeOutput
+//********************************************************************
+// Write as much of outQueue as the socket will take
+
+void SocketIo::writeOutput() {
+    if(writeReady && !outQueue.empty()) {
+        ssize_t n = outQueue.writeTo(fd);
+        if(n >= 0) {
+            // Keep track of total outbytes
+            network->countOut(n);
+            writeReady = outQueue.empty();
+        }
+    }
+    buffered.store(outQueue.size(), std::memory_order_relaxed);
+}
+
+//--------------------------------------------------------------------
+// MCCP
+
+void SocketIo::beginCompress() {
+    if(outCompress)
+        return;
+
+    outCompressBuf = new char[COMPRESSED_OUTBUF_SIZE];
+    outCompress = (z_stream *) malloc(sizeof(*outCompress));
+    outCompress->zalloc = telnet::zlib_alloc;
+    outCompress->zfree = telnet::zlib_free;
+    outCompress->opaque = nullptr;
+    outCompress->next_in = nullptr;
+    outCompress->avail_in = 0;
+    outCompress->next_out = (Bytef*) outCompressBuf;
+    outCompress->avail_out = COMPRESSED_OUTBUF_SIZE;
+
+    if(deflateInit(outCompress, 9) != Z_OK) {
+        // Problem with zlib, try to clean up
+        std::clog << "Error with deflateInit\n";
+        delete[] outCompressBuf;
+        free(outCompress);
+        outCompressBuf = nullptr;
+        outCompress = nullptr;
+    }
+}
+
+void SocketIo::compress(std::string_view data) {
+    outCompress->next_in = (unsigned char*) data.data();
+    outCompress->avail_in = data.length();
+    bool full;
+    do {
+        outCompress->avail_out = COMPRESSED_OUTBUF_SIZE - ((char*) outCompress->next_out - (char*) outCompressBuf);
+        int ret = deflate(outCompress, Z_SYNC_FLUSH);
+        if(ret != Z_OK && ret != Z_BUF_ERROR)
+            return;
+        // zlib may still be holding output if it filled the buffer
+        full = (outCompress->avail_out == 0);
+        processCompressed();
+    } while(outCompress->avail_in || full);
+}
+
+void SocketIo::finishCompress() {
+    if(!outCompress)
+        return;
+
+    unsigned char dummy[1] = { 0 };
+    outCompress->avail_in = 0;
+    outCompress->next_in = dummy;
+    if(deflate(outCompress, Z_FINISH) != Z_STREAM_END)
+        std::clog << "Error with deflate Z_FINISH\n";
+
+    // Send any residual data
+    processCompressed();
+
+    deflateEnd(outCompress);
+    delete[] outCompressBuf;
+    free(outCompress);
+    outCompress = nullptr;
+    outCompressBuf = nullptr;
+}
+
+// Hand the compressed data over to the output queue and start the buffer over
+void SocketIo::processCompressed() {
+    auto len = (size_t) ((char*) outCompress->next_out - (char*) outCompressBuf);
+    if(len > 0) {
+        outQueue.append(std::string_view(outCompressBuf, len));
+        outCompress->next_out = (Bytef*) outCompressBuf;
+        outCompress->avail_out = COMPRESSED_OUTBUF_SIZE;
+    }
+}
+// End - MCCP
+//--------------------------------------------------------------------
@@ -0,0 +1,137 @@
+/*
+ * transcoder.cpp
+ *   Translates color codes, MXP tags and newlines on their way out to a socket
+ *   ____            _
+ *  |  _ \ ___  __ _| |_ __ ___  ___
+ *  | |_) / _ \/ _` | | '_ ` _ \/ __|
+ *  |  _ <  __/ (_| | | | | | | \__ \
+ *  |_| \_\___|\__,_|_|_| |_| |_|___/
+ *
+ * Permission to use, modify and distribute is granted via the
+ *  GNU Affero General Public License v3 or later
+ *
+ *  Copyright (C) 2007-2021 Jason Mitchell, Randi Mitchell
+ *     Contributions by Tim Callahan, Jonathan Hseu
+ *  Based on Mordor (C) Brooke Paul, Brett J. Vickers, John P. Freeman
+ *
+ */
+
+#ifdef __SSE2__
+#include <emmintrin.h>          // for _mm_cmpeq_epi8, _mm_movemask_epi8
+#endif
+#include <cstring>              // for memchr
+#include <memory>               // for shared_ptr
+#include <string>               // for string
+#include <string_view>          // for string_view
+
+#include "color.hpp"            // for getAnsiColorCode
+#include "login.hpp"            // for NO_COLOR
+#include "socket.hpp"           // for CH_MXP_BEG, CH_MXP_END, MXP_SECURE_OPEN
+#include "transcoder.hpp"       // for ColorTable
+
+//*********************************************************************
+//                      getColorTable
+//*********************************************************************
+
+static ColorTable makeNoColorTable() {
+    ColorTable table{};
+    // Color is not active, only replace a caret
+    table.codes[(unsigned char)'^'] = "^";
+    table.colored = false;
+    return(table);
+}
+
+static ColorTable makeAnsiTable() {
+    ColorTable table{};
+    for(int i = 0; i < 256; i++)
+        table.codes[i] = getAnsiColorCode((unsigned char)i);
+    table.colored = true;
+    return(table);
+}
+
+const ColorTable& getColorTable(int colorOpt) {
+    static const ColorTable noColor = makeNoColorTable();
+    static const ColorTable ansi = makeAnsiTable();
+
+    if(colorOpt == NO_COLOR)
+        return(noColor);
+    return(ansi);
+}
+
+//*********************************************************************
+//                      findSpecial
+//*********************************************************************
+// Find the next byte outside of an MXP tag that needs translating.  Nearly all
+// output is plain text, so check 16 bytes at a time where we can.
+
+static inline const char* findSpecial(const char* p, const char* end) {
+#ifdef __SSE2__
+    const __m128i caret = _mm_set1_epi8('^');
+    const __m128i newline = _mm_set1_epi8('\n');
+    const __m128i mxpBeg = _mm_set1_epi8(CH_MXP_BEG);
+    while(end - p >= 16) {
+        __m128i block = _mm_loadu_si128((const __m128i*)p);
+        __m128i match = _mm_or_si128(_mm_or_si128(_mm_cmpeq_epi8(block, caret), _mm_cmpeq_epi8(block, newline)),
+                                     _mm_cmpeq_epi8(block, mxpBeg));
+        int mask = _mm_movemask_epi8(match);
+        if(mask)
+            return(p + __builtin_ctz(mask));
+        p += 16;
+    }
+#endif
+    while(p < end && *p != '^' && *p != '\n' && *p != CH_MXP_BEG)
+        p++;
+    return(p);
+}
+
+//*********************************************************************
+//                      transcodeOutput
+//*********************************************************************
+
+void transcodeOutput(std::string_view in, std::string& out, const ColorTable& colors, bool mxp, unsigned char& lastColor) {
+    const char* p = in.data();
+    const char* end = p + in.size();
+
+    // Leave room for a few color codes and line endings so we rarely have to grow
+    out.reserve(out.size() + in.size() + in.size() / 8 + 32);
+
+    while(p < end) {
+        const char* special = findSpecial(p, end);
+        out.append(p, special - p);
+        if(special == end)
+            break;
+
+        p = special + 1;
+        switch(*special) {
+            case '\n':
+                out.append("\r\n", 2);
+                break;
+            case '^': {
+                // A trailing caret is treated like the old null terminator was: a reset
+                unsigned char ch = (p < end ? (unsigned char)*p++ : '\0');
+                // Only send a color if it's not the one already active
+                if(!colors.colored) {
+                    out.append(colors.codes[ch]);
+                } else if(lastColor != ch || lastColor == '^') {
+                    lastColor = ch;
+                    out.append(colors.codes[ch]);
+                }
+                break;
+            }
+            case CH_MXP_BEG: {
+                // Everything up to the closing sentinel is the tag; it's only sent to MXP clients
+                auto tagEnd = (const char*)memchr(p, CH_MXP_END, end - p);
+                if(!tagEnd)
+                    tagEnd = end;
+                if(mxp) {
+                    out.append(MXP_SECURE_OPEN "<");
+                    out.append(p, tagEnd - p);
+                    if(tagEnd != end)
+                        out.append(">" MXP_LOCK_CLOSE);
+                }
+                p = (tagEnd == end ? end : tagEnd + 1);
+                break;
+            }
+        }
+    }
+}
@@ -17,15 +17,17 @@
  */
 
 #include <printf.h>                  // for register_printf_specifier, print...
+#include <algorithm>                 // for max
 #include <cstdarg>                   // for va_list, va_end, va_start, va_copy
-#include <cstdio>                    // for asprintf, fprintf, vasprintf, FILE
-#include <cstdlib>                   // for free
+#include <cstdio>                    // for fprintf, FILE
 #include <ostream>                   // for operator<<, ostringstream, endl
 #include <string>                    // for string, basic_string
 #include <string_view>               // for string_view
+#include <utility>                   // for move
 
 #include "creatureStreams.hpp"       // for Streamable, ColorOff, ColorOn
 #include "global.hpp"                // for CAP
+#include "mudFormat.hpp"             // for CrtName, ObjName, formatLegacy
 #include "mudObjects/creatures.hpp"  // for Creature
 #include "mudObjects/objects.hpp"    // for Object
 #include "mudObjects/players.hpp"    // for Player
@@ -53,16 +55,19 @@ void Creature::bPrintPython(const std::string& toPrint) const {
     (Streamable &) *this << ColorOn << toPrint << ColorOff;
 }
 
+// Where print sends a creature's output: its own socket, or its master's if it's a pet
+std::shared_ptr<Socket> Creature::getPrintSock() const {
+    if(isPet())
+        return(getConstMaster()->getSock());
+    return(getSock());
+}
+
 void Creature::print(const char *fmt,...) const {
     // Mad hack, but it'll stop some stupid errors
     if(!this)
         return;
 
-    std::shared_ptr<Socket> printTo = getSock();
-
-    if(isPet())
-        printTo = getConstMaster()->getSock();
-
+    std::shared_ptr<Socket> printTo = getPrintSock();
     if(!printTo)
         return;
 
@@ -77,10 +82,7 @@ void Creature::print(const char *fmt,...) const {
 }
 
 void Creature::printColor(const char *fmt,...) const {
-    std::shared_ptr<Socket> printTo = getSock();
-
-    if(isPet())
-        printTo = getConstMaster()->getSock();
+    std::shared_ptr<Socket> printTo = getPrintSock();
 
     if(!this || !printTo)
         return;
@@ -94,6 +96,27 @@ void Creature::printColor(const char *fmt,...) const {
     printTo->vprint(fmt, ap);
     va_end(ap);
 }
+
+// The display flags printFmt shows names with: those of whoever is reading
+int Creature::getPrintFlags() const {
+    std::shared_ptr<Socket> printTo = getPrintSock();
+    if(!printTo || !printTo->getPlayer())
+        return(0);
+    return(printTo->getPlayer()->displayFlags());
+}
+
+// The rest of what vprint does, for text printFmt has already formatted
+void Creature::printFormatted(std::string msg) const {
+    std::shared_ptr<Socket> printTo = getPrintSock();
+    if(!printTo)
+        return;
+
+    if(isPet()) {
+        printTo->print("Pet> ");
+    }
+    printTo->bprint(Socket::wrapPrint(printTo->getWrapWidth(), std::move(msg)));
+}
+
 void Player::vprint(const char *fmt, va_list ap) const {
     if(this) {
         if (auto sock = mySock.lock()) {
@@ -103,101 +126,95 @@ void Player::vprint(const char *fmt, va_list ap) const {
 }
 
 
-static int VPRINT_flags = 0;
-
-void Socket::vprint(const char *fmt, va_list ap) {
-    char    *msg;
-    va_list aq;
+//*********************************************************************
+//                      renderPrint
+//*********************************************************************
+// Formats a message the way vprint shows it to a viewer with the given display
+// flags, wrapped at the given width (0 = no wrapping).  Broadcasts call this
+// directly so viewers who would see the same text can share one rendering.
 
-    if(!this) {
-        std::clog << "vprint(): called with null this! :(\n";
-        return;
-    }
+std::string Socket::renderPrint(int flags, int wrap, const char *fmt, va_list ap) {
+    // formatLegacy works on a copy of ap, so vprint can be called multiple times with the same ap
+    return(wrapPrint(wrap, formatLegacy(flags, fmt, ap)));
+}
 
-    VPRINT_flags = 0;
-    if(myPlayer)
-        VPRINT_flags = myPlayer->displayFlags();
-    // Incase vprint is called multiple times with the same ap
-    // (in which case ap would be undefined, so make a copy of it
-    va_copy(aq, ap);
-    int n = vasprintf(&msg, fmt, aq);
-    va_end(aq);
-
-    if(n == -1) {
-        std::clog << "Problem with vasprintf in vprint!" << std::endl;
-        return;
-    }
+// Wraps an already formatted message at the given width and resets the color after it
+std::string Socket::wrapPrint(int wrap, std::string msg) {
     std::string toPrint;
 
-    if(!myPlayer || (myPlayer && myPlayer->getWrap() == -1))
-        toPrint = delimit( msg, getTermCols() - 4);
-    else if(myPlayer && myPlayer->getWrap() > 0)
-        toPrint = delimit( msg, myPlayer->getWrap());
+    if(wrap > 0)
+        toPrint = delimit(msg.c_str(), wrap);
     else
-        toPrint = msg;
+        toPrint = std::move(msg);
     toPrint += "^x";
-    bprint(toPrint);
+    return(toPrint);
+}
+
+//*********************************************************************
+//                      getWrapWidth
+//*********************************************************************
 
-    free(msg);
+// Width vprint wraps this socket's text at, or 0 if the player turned wrapping off
+
+int Socket::getWrapWidth() const {
+    int wrap = 0;
+    if(!myPlayer || myPlayer->getWrap() == -1)
+        wrap = std::max(getTermCols() - 4, 1);
+    else if(myPlayer->getWrap() > 0)
+        wrap = myPlayer->getWrap();
+
+    // delimit treats anything this narrow as the default width
+    if(wrap > 0 && wrap <= 10)
+        wrap = 78;
+    return(wrap);
 }
 
+void Socket::vprint(const char *fmt, va_list ap) {
+    if(!this) {
+        std::clog << "vprint(): called with null this! :(\n";
+        return;
+    }
+
+    bprint(renderPrint(myPlayer ? myPlayer->displayFlags() : 0, getWrapWidth(), fmt, ap));
+}
+
+//*********************************************************************
+//                      installPrintfHandlers
+//*********************************************************************
+// Everything that prints to a player goes through formatLegacy now, which knows
+// who it's printing for.  These glibc hooks are only a fallback for anything
+// that still hands a %M to the real printf family (log files and the like), so
+// they show names the way someone with no special display flags would.
+
 int print_objcrt(FILE *stream, const struct printf_info *info, const void *const *args) {
-    char *buffer;
-    int len;
+    std::string tmp;
 
-    if(info->spec == 'B') {
-        const std::string *tmp = *((const std::string **) (args[0]));
-        len = asprintf(&buffer, "%s", tmp->c_str());
+    if(info->spec == 'b') {
+        tmp = **((const std::string **) (args[0]));
     }
     else if(info->spec == 'T') {
-        const std::ostringstream *tmp = *((const std::ostringstream **) (args[0]));
-        len = asprintf(&buffer, "%s", tmp->str().c_str());
+        tmp = (*((const std::ostringstream **) (args[0])))->str();
     }
     // M = Capital Monster; N = small monster
     else if(info->spec == 'M' || info->spec == 'N') {
         const Creature *crt = *((const Creature **) (args[0]));
-        if(info->spec == 'M') {
-            std::string tmp = crt->getCrtStr(nullptr, VPRINT_flags | CAP, info->width);
-            len = asprintf(&buffer, "%s", tmp.c_str());
-        }
-        else {
-            std::string tmp = crt->getCrtStr(nullptr, VPRINT_flags, info->width);
-            len = asprintf(&buffer, "%s", tmp.c_str());
-        }
-        if(len == -1)
-            return(-1);
+        tmp = fmt::format("{}", CrtName(crt, info->spec == 'M' ? CAP : 0, info->width));
     }
     else if(info->spec == 'R') {
         const Creature *crt = *((const Creature **) (args[0]));
-        len = asprintf(&buffer, "%s", crt->getCName());
-        if(len == -1)
-            return(-1);
+        tmp = crt->getCName();
     }
     // O = Capital Object; P = small object
     else if(info->spec == 'O' || info->spec == 'P') {
         const Object *obj = *((const Object **) (args[0]));
-        if(info->spec == 'O') {
-            std::string tmp = obj->getObjStr(nullptr, VPRINT_flags | CAP, info->width);
-            len = asprintf(&buffer, "%s", tmp.c_str());
-        }
-        else {
-            std::string tmp = obj->getObjStr(nullptr, VPRINT_flags, info->width);
-            len = asprintf(&buffer, "%s", tmp.c_str());
-        }
-
-        if(len == -1)
-            return(-1);
+        tmp = fmt::format("{}", ObjName(obj, info->spec == 'O' ? CAP : 0, info->width));
     }
     // Unhandled type
     else {
         return(-1);
     }
 
-    len = fprintf(stream, "%s", buffer);
-
-    // Clean up and return.
-    free(buffer);
-    return(len);
+    return(fprintf(stream, "%s", tmp.c_str()));
 }
 
 int print_arginfo (const struct printf_info *info, size_t n, int *argtypes, int* size) {
@@ -20,7 +20,7 @@
 #include "hooks.hpp"
 
 void to_json(nlohmann::json &j, const Hooks &h) {
-    j = json {h.hooks};
+    j = json {h.hooks.get()};
 }
 
 void from_json(const nlohmann::json &j, Hooks &h) {
@@ -91,7 +91,7 @@ void to_json(nlohmann::json &j, const Object &obj, bool permOnly, LoadType saveT
 
         if(obj.type != ObjectType::LOTTERYTICKET) {
             // Handled elsewhere
-            j["description"] = obj.description;
+            j["description"] = obj.description.get();
         }
 
         if(!obj.alchemyEffects.empty()) {
@@ -111,7 +111,7 @@ void to_json(nlohmann::json &j, const Object &obj, bool permOnly, LoadType saveT
 
     if(obj.type == ObjectType::LOTTERYTICKET) {
         j["lotteryTicket"] = json{
-            {"desc", obj.description},
+            {"desc", obj.description.get()},
             {"lotteryNumbers", obj.lotteryNumbers},
         };
     }
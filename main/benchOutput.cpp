@@ -0,0 +1,126 @@
+/*
+ * benchOutput.cpp
+ *   Microbenchmark for the socket output transcoder
+ *   ____            _
+ *  |  _ \ ___  __ _| |_ __ ___  ___
+ *  | |_) / _ \/ _` | | '_ ` _ \/ __|
+ *  |  _ <  __/ (_| | | | | | | \__ \
+ *  |_| \_\___|\__,_|_|_| |_| |_|___/
+ *
+ * Permission to use, modify and distribute is granted via the
+ *  GNU Affero General Public License v3 or later
+ *
+ *  Copyright (C) 2007-2021 Jason Mitchell, Randi Mitchell
+ *     Contributions by Tim Callahan, Jonathan Hseu
+ *  Based on Mordor (C) Brooke Paul, Brett J. Vickers, John P. Freeman
+ *
+ */
+
+#include <chrono>                   // for steady_clock, duration
+#include <cstdlib>                  // for atoi
+#include <iostream>                 // for operator<<, cout
+#include <memory>                   // for shared_ptr
+#include <sstream>                  // for ostringstream
+#include <string>                   // for string
+#include <string_view>              // for string_view
+
+#include "color.hpp"                // for getAnsiColorCode
+#include "login.hpp"                // for ANSI_COLOR, NO_COLOR
+#include "socket.hpp"               // for CH_MXP_BEG, CH_MXP_END
+#include "transcoder.hpp"           // for transcodeOutput, getColorTable
+
+// The byte at a time ostringstream version Socket::parseForOutput used to use
+std::string legacyParse(std::string_view outBuf, bool color, bool mxp, unsigned char& lastColor) {
+    size_t i = 0, n = outBuf.size();
+    std::ostringstream oStr;
+    bool inTag = false;
+    unsigned char ch;
+    while(i < n) {
+        ch = outBuf[i++];
+        if(inTag) {
+            if(ch == CH_MXP_END) {
+                inTag = false;
+                if(mxp)
+                    oStr << ">" << MXP_LOCK_CLOSE;
+            } else if(mxp)
+                oStr << ch;
+        } else if(ch == CH_MXP_BEG) {
+            inTag = true;
+            if(mxp)
+                oStr << MXP_SECURE_OPEN << "<";
+        } else if(ch == '^') {
+            ch = (i < n ? outBuf[i++] : '\0');
+            std::ostringstream code;
+            if(!color) {
+                if(ch == '^')
+                    code << "^";
+            } else if(lastColor != ch || lastColor == '^') {
+                lastColor = ch;
+                code << getAnsiColorCode(ch);
+            }
+            oStr << code.str();
+        } else if(ch == '\n') {
+            oStr << "\r\n";
+        } else {
+            oStr << ch;
+        }
+    }
+    return(oStr.str());
+}
+
+// Roughly what a busy room looks like: mostly plain text with a color change every line or so
+std::string sampleOutput() {
+    std::string sample;
+    for(int i = 0; i < 40; i++) {
+        sample += "^cThe Town Square^x\n";
+        sample += "You are standing in the middle of a bustling town square. Merchants hawk their wares ";
+        sample += "from wooden stalls while children chase each other around the ^Wmarble fountain^x.\n";
+        sample += "^gObvious exits: " MXP_BEG "send href='north'" MXP_END "north" MXP_BEG "/send" MXP_END ", east, south, west.^x\n";
+        sample += "^yYou see a town guard, a merchant, 2 rats.^x\n";
+        sample += "^^ is a literal caret.\n";
+    }
+    return(sample);
+}
+
+template <typename Fn>
+double timeIt(int iterations, Fn fn) {
+    auto start = std::chrono::steady_clock::now();
+    for(int i = 0; i < iterations; i++)
+        fn();
+    std::chrono::duration<double, std::micro> elapsed = std::chrono::steady_clock::now() - start;
+    return(elapsed.count() / iterations);
+}
+
+int main(int argc, char* argv[]) {
+    int iterations = (argc > 1 ? atoi(argv[1]) : 2000);
+    if(iterations <= 0)
+        iterations = 2000;
+
+    const std::string sample = sampleOutput();
+    std::cout << "Transcoding " << sample.size() << " bytes, " << iterations << " iterations\n";
+
+    for(int colorOpt : { (int)NO_COLOR, (int)ANSI_COLOR }) {
+        for(bool mxp : { false, true }) {
+            unsigned char lastLegacy = 0, lastNew = 0;
+            std::string out;
+            transcodeOutput(sample, out, getColorTable(colorOpt), mxp, lastNew);
+            if(out != legacyParse(sample, colorOpt != NO_COLOR, mxp, lastLegacy)) {
+                std::cout << "Output mismatch (color " << colorOpt << ", mxp " << mxp << ")\n";
+                return(1);
+            }
+
+            double legacy = timeIt(iterations, [&] {
+                std::string result = legacyParse(sample, colorOpt != NO_COLOR, mxp, lastLegacy);
+            });
+            double transcoded = timeIt(iterations, [&] {
+                out.clear();
+                transcodeOutput(sample, out, getColorTable(colorOpt), mxp, lastNew);
+            });
+
+            std::cout << (colorOpt == NO_COLOR ? "no color" : "ansi    ") << (mxp ? ", mxp   " : ", no mxp")
+                      << "   legacy " << legacy << "us   transcoder " << transcoded << "us   ("
+                      << legacy / transcoded << "x)\n";
+        }
+    }
+    return(0);
+}
@@ -35,6 +35,7 @@
 #include "flags.hpp"                   // for O_KEEP, O_DARKMETAL, O_BEING_P...
 #include "global.hpp"                  // for CAP, CreatureClass, CreatureCl...
 #include "hooks.hpp"                   // for Hooks
+#include "keyTxt.hpp"                  // for KeyTxtQuery
 #include "lasttime.hpp"                // for lasttime
 #include "mud.hpp"                     // for LT_ENVEN, ospell, scrollDesc
 #include "mudObjects/container.hpp"    // for ObjectSet, Container, MonsterSet
@@ -471,19 +472,10 @@ bool cantDropInBag(const std::shared_ptr<Object>&  object) {
 //                      findObj
 //*********************************************************************
 
-std::shared_ptr<MudObject> Creature::findObjTarget(ObjectSet &set, int findFlags, const std::string& str, int val, int* match) {
-    if(set.empty())
+std::shared_ptr<MudObject> Creature::findObjTarget(const Container& container, int findFlags, const KeyTxtQuery& query, int val, int* match) {
+    if(container.objects.empty())
         return(nullptr);
-    const auto cThis = getAsConstCreature();
-    for(const auto& obj : set) {
-        if(keyTxtEqual(obj, str.c_str()) || (obj->isLabeledBy(cThis) && obj->isLabelMatch(str))) {
-            (*match)++;
-            if(*match == val) {
-                return(obj);
-            }
-        }
-    }
-    return(nullptr);
+    return(container.findObject(getAsConstCreature(), query, val, *match, false));
 }
 
 //*********************************************************************
@@ -511,8 +503,8 @@ int displayObject(const std::shared_ptr<const Player> &player, const std::shared
     }
     std::ostringstream oStr;
 
-    if(!target->description.empty()) {
-        oStr << target->description << "\n";
+    if(!target->description->empty()) {
+        oStr << *target->description << "\n";
     } else if(!target->getRecipe()) {
         // don't show this message if we have a recipe
         oStr << "You see nothing special about it.\n";
@@ -87,10 +87,24 @@ void Object::setQuestOwner(const std::shared_ptr<Player> player) { questOwner =
 void Object::setLabel(const std::shared_ptr<Player>& player, std::string text) {
     label.playerId = player->getId();
     label.label = text;
+    refreshKeyTxt();
 }
 void Object::removeLabel() {
     label.playerId = "";
     label.label = "";
+    refreshKeyTxt();
+}
+
+const KeyTxt& Object::getKeyTxt() const {
+    if(keyTxt.isStale())
+        keyTxt.set(key[0], key[1], key[2], getName(), !label.label.empty());
+    return(keyTxt);
+}
+
+void Object::refreshKeyTxt() {
+    keyTxt.invalidate();
+    if(std::shared_ptr<Container> container = getParent())
+        container->keyTxtChanged();
 }
 
 void Object::clearEffect() {
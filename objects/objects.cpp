@@ -18,6 +18,7 @@
 
 #include <fmt/format.h>                // for format
 #include <cstring>                     // for strlen, strcpy, memset, strcmp
+#include <iterator>                    // for back_inserter
 #include <list>                        // for list, list<>::const_iterator
 #include <map>                         // for operator==, _Rb_tree_const_ite...
 #include <ostream>                     // for operator<<, basic_ostream, ost...
@@ -93,6 +94,13 @@ std::string Object::getCompareStr() const {
     return(fmt::format("{}-{}-{}-{}", getName(), adjustment, shopValue, getId()));
 }
 
+// The same as getCompareStr, written into the buffer we already have
+const std::string* Object::refreshSortKey() {
+    sortKey.clear();
+    fmt::format_to(std::back_inserter(sortKey), "{}-{}-{}-{}", getName(), adjustment, shopValue, getId());
+    return(&sortKey);
+}
+
 const std::string & DroppedBy::getName() const {
     return(name);
 }
@@ -181,7 +189,8 @@ Object::Object() {
 
     id = "-1";
     version = "0.00";
-    description = effect = "";
+    description.reset();
+    effect = "";
     memset(key, 0, sizeof(key));
     memset(use_output, 0, sizeof(use_output));
     memset(use_attack, 0, sizeof(use_attack));
@@ -366,6 +375,7 @@ void Object::objCopy(const Object& o) {
     for(it = o.randomObjects.begin() ; it != o.randomObjects.end() ; it++) {
         randomObjects.push_back(*it);
     }
+    refreshKeyTxt();
 }
 
 DroppedBy& DroppedBy::operator=(const DroppedBy& o) {
@@ -392,7 +402,7 @@ Object& Object::operator=(const Object& obj) {
 bool Object::operator==(const Object& o) const {
     int     i=0;
 
-    if( description != o.description ||
+    if( *description != *o.description ||
         version != o.version ||
         weight != o.weight ||
         type != o.type ||
@@ -2780,7 +2780,7 @@ void give_money(const std::shared_ptr<Player>& player, cmd* cmnd) {
         bool hasPay = false;
         unsigned long cost=0;
 
-        for(TalkResponse * talkResponse : mTarget->responses) {
+        for(const auto& talkResponse : *mTarget->responses) {
             for(const std::string& keyword : talkResponse->keywords) {
                 if(keyword.starts_with("$pay"))
                     hasPay = true;
@@ -49,6 +49,7 @@
 #include "lasttime.hpp"                     // for lasttime
 #include "levelGain.hpp"                    // for LevelGain
 #include "location.hpp"                     // for Location
+#include "logWriter.hpp"                    // for LogWriter
 #include "magic.hpp"                        // for S_ARMOR, S_BLOODFUSION, S_MAGI...
 #include "money.hpp"                        // for GOLD, Money
 #include "move.hpp"                         // for getRoom
@@ -1735,7 +1736,9 @@ std::string Player::expNeededDisplay() const {
 //*********************************************************************
 
 bool Player::exists(std::string_view name) {
-    return fs::exists((Path::Player / name).replace_extension("xml"));
+    auto filename = (Path::Player / name).replace_extension("xml");
+    gServer->playerSaves.wait(filename);
+    return fs::exists(filename);
 }
 
 //*********************************************************************
@@ -1890,10 +1893,12 @@ void Player::clearWatching() {
 void renamePlayerFiles(const char *old_name, const char *new_name) {
     std::error_code ec;
 
+    gServer->playerSaves.wait((Path::Player / old_name).replace_extension("xml"));
     fs::remove((Path::Player / old_name).replace_extension("xml"), ec);
 
     fs::rename((Path::Post / old_name).replace_extension("txt"),    (Path::Post / new_name).replace_extension("txt"), ec);
     fs::rename((Path::History / old_name).replace_extension("txt"), (Path::History / new_name).replace_extension("txt"), ec);
+    LogWriter::get().release((Path::Bank / old_name).replace_extension("txt"));
     fs::rename((Path::Bank / old_name).replace_extension("txt"),    (Path::Bank / new_name).replace_extension("txt"), ec);
 }
 
@@ -18,6 +18,7 @@
 
 #include <cstring>                   // for strcmp
 #include <ctime>                     // for time, time_t
+#include <set>                       // for set
 #include <string>                    // for allocator, operator==, string
 #include <string_view>               // for string_view
 
@@ -40,6 +41,29 @@ bool Player::operator <(const Player& t) const {
     return(strcmp(this->getCName(), t.getCName()) < 0);
 }
 
+//*********************************************************************
+//                      sortKey
+//*********************************************************************
+// Player sets only hold weak pointers, so their keys can't live in the player:
+// names are interned instead, and never dropped, so a set can still order an
+// entry whose player is gone.
+
+static const std::string* internSortKey(std::string_view name) {
+    static std::set<std::string, std::less<>> names;
+    auto it = names.find(name);
+    if(it == names.end())
+        it = names.emplace(name).first;
+    return(&*it);
+}
+
+const std::string* Player::refreshSortKey() {
+    return(internSortKey(getName()));
+}
+
+const std::string* Player::getSortKey() const {
+    return(internSortKey(getName()));
+}
+
 //*********************************************************************
 //                      regenModifyDuration
 //*********************************************************************
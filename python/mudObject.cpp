@@ -38,7 +38,7 @@ using namespace pybind11::literals;
 
 void init_module_mudObject(py::module &m) {
 
-    py::class_<std::set<std::shared_ptr<Monster> , MonsterPtrLess>> monsterSet(m, "MonsterSet");
+    py::class_<MonsterSet> monsterSet(m, "MonsterSet");
     monsterSet.def("__iter__", [](const MonsterSet &s) { return py::make_iterator(s.begin(), s.end()); },
                  py::keep_alive<0, 1>() /* Essential: keep object alive while iterator exists */);
 
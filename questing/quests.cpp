@@ -82,7 +82,9 @@ CatRef QuestInfo::getQuestId(xmlNodePtr curNode) {
     if(toReturn.id == 0)
         toReturn.id = xml::toNum<short>(curNode);
 
-    xml::copyPropToString(toReturn.area, curNode, "Area");
+    std::string area = toReturn.area;
+    xml::copyPropToString(area, curNode, "Area");
+    toReturn.area = area;
 
     return toReturn;
 }
@@ -1121,13 +1123,13 @@ int cmdTalk(const std::shared_ptr<Player>& player, cmd* cmnd) {
         return(0);
     }
 
-    if(cmnd->num == 2 || target->responses.empty()) {
+    if(cmnd->num == 2 || target->responses->empty()) {
         response = target->getTalk();
         if(response == "$random") {
             std::list<std::string> randomResponses;
             std::list<std::string> randomActions;
             int numResponses=0;
-            for(TalkResponse * talkResponse : target->responses) {
+            for(const auto& talkResponse : *target->responses) {
                 for(std::string_view  keyword : talkResponse->keywords) {
                     if(keyword == "$random") {
                         randomResponses.push_back(talkResponse->response);
@@ -1156,7 +1158,7 @@ int cmdTalk(const std::shared_ptr<Player>& player, cmd* cmnd) {
         question = keyTxtConvert(boost::to_lower_copy(getFullstrText(cmnd->fullstr, 2)));
         broadcast_rom_LangWc(target->current_language, player->getSock(), player->currentLocation, "%M asks %N \"%s\".^x", player.get(), target.get(), question.c_str());
         std::string key, keyword;
-        for(TalkResponse * talkResponse : target->responses) {
+        for(const auto& talkResponse : *target->responses) {
             for(std::string_view keyWrd : talkResponse->keywords) {
                 keyword = boost::to_lower_copy(keyTxtConvert(keyWrd));
 
@@ -1601,7 +1603,7 @@ void Monster::convertOldTalks() {
             break;
         }
 
-        responses.push_back(newResponse);
+        responses.edit().emplace_back(newResponse);
         tp = tp->next_tag;
     }
 
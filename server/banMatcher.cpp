@@ -0,0 +1,295 @@
+/*
+ * banMatcher.cpp
+ *   Indexes for matching connecting sites against the ban list
+ *   ____            _
+ *  |  _ \ ___  __ _| |_ __ ___  ___
+ *  | |_) / _ \/ _` | | '_ ` _ \/ __|
+ *  |  _ <  __/ (_| | | | | | | \__ \
+ *  |_| \_\___|\__,_|_|_| |_| |_|___/
+ *
+ * Permission to use, modify and distribute is granted via the
+ *  GNU Affero General Public License v3 or later
+ *
+ *  Copyright (C) 2007-2021 Jason Mitchell, Randi Mitchell
+ *     Contributions by Tim Callahan, Jonathan Hseu
+ *  Based on Mordor (C) Brooke Paul, Brett J. Vickers, John P. Freeman
+ *
+ */
+
+#include <arpa/inet.h>             // for inet_pton
+#include <algorithm>               // for min
+#include <charconv>                // for from_chars
+#include <cstring>                 // for memcpy
+#include <deque>                   // for deque
+#include <string>                  // for string
+
+#include "banMatcher.hpp"          // for BanMatcher, Cidr
+#include "bans.hpp"                // for Ban
+
+//*********************************************************************
+//                      Cidr
+//*********************************************************************
+
+bool Cidr::parseAddress(std::string_view str, Address& addr) {
+    // inet_pton wants a terminated string; nothing valid is longer than this
+    char buf[INET6_ADDRSTRLEN];
+    if(str.empty() || str.size() >= sizeof(buf))
+        return(false);
+    memcpy(buf, str.data(), str.size());
+    buf[str.size()] = '\0';
+
+    uint8_t v4[4];
+    if(inet_pton(AF_INET, buf, v4) == 1) {
+        addr.fill(0);
+        addr[10] = addr[11] = 0xff;
+        memcpy(&addr[12], v4, 4);
+        return(true);
+    }
+    return(inet_pton(AF_INET6, buf, addr.data()) == 1);
+}
+
+bool Cidr::parse(std::string_view str, Cidr& cidr) {
+    size_t slash = str.find('/');
+    if(slash == std::string_view::npos)
+        return(false);
+
+    std::string_view address = str.substr(0, slash), length = str.substr(slash + 1);
+    int bits = 0;
+    auto [end, ec] = std::from_chars(length.data(), length.data() + length.size(), bits);
+    if(ec != std::errc() || end != length.data() + length.size() || length.empty())
+        return(false);
+    if(!parseAddress(address, cidr.addr))
+        return(false);
+
+    // An IPv4 length counts from the start of the mapped part
+    int maxBits = address.find(':') == std::string_view::npos ? 32 : 128;
+    if(bits < 0 || bits > maxBits)
+        return(false);
+    cidr.bits = bits + (128 - maxBits);
+    return(true);
+}
+
+bool Cidr::contains(const Address& other) const {
+    int whole = bits / 8, rest = bits % 8;
+    if(memcmp(addr.data(), other.data(), whole) != 0)
+        return(false);
+    if(!rest)
+        return(true);
+    auto mask = (uint8_t)(0xff << (8 - rest));
+    return((addr[whole] & mask) == (other[whole] & mask));
+}
+
+//*********************************************************************
+//                      Trie
+//*********************************************************************
+
+BanMatcher::Trie::Trie() {
+    clear();
+}
+
+void BanMatcher::Trie::clear() {
+    nodes.clear();
+    nodes.emplace_back();
+}
+
+uint32_t BanMatcher::Trie::child(uint32_t node, char c) const {
+    for(const auto& [key, next] : nodes[node].next) {
+        if(key == c)
+            return(next);
+    }
+    return(NONE);
+}
+
+uint32_t BanMatcher::Trie::insert(std::string_view pattern, bool reversed) {
+    uint32_t node = 0;
+    for(size_t i = 0; i < pattern.size(); i++) {
+        char c = reversed ? pattern[pattern.size() - 1 - i] : pattern[i];
+        uint32_t next = child(node, c);
+        if(next == NONE) {
+            next = (uint32_t)nodes.size();
+            nodes[node].next.emplace_back(c, next);
+            nodes.emplace_back();
+        }
+        node = next;
+    }
+    return(node);
+}
+
+// Bans are added in list order, so the first one to claim a node keeps it
+void BanMatcher::Trie::addExact(std::string_view pattern, uint32_t ban) {
+    Node& node = nodes[insert(pattern, false)];
+    node.exact = std::min(node.exact, ban);
+}
+
+void BanMatcher::Trie::addPrefix(std::string_view pattern, uint32_t ban, bool reversed) {
+    Node& node = nodes[insert(pattern, reversed)];
+    node.prefix = std::min(node.prefix, ban);
+}
+
+void BanMatcher::Trie::addContains(std::string_view pattern, uint32_t ban) {
+    addPrefix(pattern, ban, false);
+}
+
+//*********************************************************************
+//                      link
+//*********************************************************************
+// Standard Aho-Corasick construction: breadth first, each node's failure link
+// points at the longest proper suffix of its path that's also in the trie.
+
+void BanMatcher::Trie::link() {
+    std::deque<uint32_t> queue;
+    nodes[0].out = nodes[0].prefix;
+    for(const auto& [c, next] : nodes[0].next) {
+        nodes[next].fail = 0;
+        queue.push_back(next);
+    }
+
+    while(!queue.empty()) {
+        uint32_t node = queue.front();
+        queue.pop_front();
+        nodes[node].out = std::min(nodes[node].prefix, nodes[nodes[node].fail].out);
+
+        for(const auto& [c, next] : nodes[node].next) {
+            uint32_t fail = nodes[node].fail;
+            while(fail && child(fail, c) == NONE)
+                fail = nodes[fail].fail;
+            uint32_t target = child(fail, c);
+            nodes[next].fail = (target == NONE || target == next) ? 0 : target;
+            queue.push_back(next);
+        }
+    }
+}
+
+//*********************************************************************
+//                      matchPrefix
+//*********************************************************************
+
+uint32_t BanMatcher::Trie::matchPrefix(std::string_view str, bool reversed) const {
+    uint32_t node = 0, best = nodes[0].prefix;
+    for(size_t i = 0; i < str.size(); i++) {
+        node = child(node, reversed ? str[str.size() - 1 - i] : str[i]);
+        if(node == NONE)
+            return(best);
+        best = std::min(best, nodes[node].prefix);
+    }
+    return(std::min(best, nodes[node].exact));
+}
+
+//*********************************************************************
+//                      matchContains
+//*********************************************************************
+
+uint32_t BanMatcher::Trie::matchContains(std::string_view str) const {
+    uint32_t node = 0, best = nodes[0].out;
+    for(char c : str) {
+        uint32_t next;
+        while((next = child(node, c)) == NONE && node)
+            node = nodes[node].fail;
+        node = next == NONE ? 0 : next;
+        best = std::min(best, nodes[node].out);
+    }
+    return(best);
+}
+
+//*********************************************************************
+//                      AddressTree
+//*********************************************************************
+
+void BanMatcher::AddressTree::clear() {
+    nodes.clear();
+}
+
+void BanMatcher::AddressTree::add(const Cidr& cidr, uint32_t ban) {
+    if(nodes.empty())
+        nodes.emplace_back();
+
+    uint32_t node = 0;
+    for(int bit = 0; bit < cidr.bits; bit++) {
+        int side = (cidr.addr[bit / 8] >> (7 - bit % 8)) & 1;
+        if(nodes[node].child[side] == NONE) {
+            nodes[node].child[side] = (uint32_t)nodes.size();
+            nodes.emplace_back();
+        }
+        node = nodes[node].child[side];
+    }
+    nodes[node].ban = std::min(nodes[node].ban, ban);
+}
+
+uint32_t BanMatcher::AddressTree::match(const Cidr::Address& addr) const {
+    if(nodes.empty())
+        return(NONE);
+
+    uint32_t node = 0, best = nodes[0].ban;
+    for(int bit = 0; bit < 128; bit++) {
+        node = nodes[node].child[(addr[bit / 8] >> (7 - bit % 8)) & 1];
+        if(node == NONE)
+            break;
+        best = std::min(best, nodes[node].ban);
+    }
+    return(best);
+}
+
+//*********************************************************************
+//                      build
+//*********************************************************************
+
+void BanMatcher::clear() {
+    order.clear();
+    everyone = NONE;
+    forward.clear();
+    backward.clear();
+    anywhere.clear();
+    addresses.clear();
+}
+
+void BanMatcher::build(const std::list<Ban*>& bans) {
+    clear();
+
+    for(Ban* ban : bans) {
+        auto index = (uint32_t)order.size();
+        order.push_back(ban);
+        if(!ban)
+            continue;
+
+        Cidr cidr;
+        if(ban->site == "*")
+            everyone = std::min(everyone, index);
+        else if(ban->isPrefix && ban->isSuffix)
+            anywhere.addContains(ban->site, index);
+        else if(ban->isPrefix)
+            forward.addPrefix(ban->site, index);
+        else if(ban->isSuffix)
+            backward.addPrefix(ban->site, index, true);
+        else if(Cidr::parse(ban->site, cidr))
+            addresses.add(cidr, index);
+        else
+            forward.addExact(ban->site, index);
+    }
+    anywhere.link();
+}
+
+//*********************************************************************
+//                      find
+//*********************************************************************
+
+uint32_t BanMatcher::match(std::string_view site) const {
+    uint32_t best = everyone;
+    best = std::min(best, forward.matchPrefix(site));
+    best = std::min(best, backward.matchPrefix(site, true));
+    best = std::min(best, anywhere.matchContains(site));
+
+    Cidr::Address addr;
+    if(Cidr::parseAddress(site, addr))
+        best = std::min(best, addresses.match(addr));
+    return(best);
+}
+
+Ban* BanMatcher::find(std::string_view hostName, std::string_view ip) const {
+    uint32_t best = std::min(match(hostName), match(ip));
+    return(best == NONE ? nullptr : order[best]);
+}
+
+Ban* BanMatcher::find(std::string_view site) const {
+    uint32_t best = match(site);
+    return(best == NONE ? nullptr : order[best]);
+}
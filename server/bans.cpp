@@ -28,6 +28,7 @@
 #include <string>                  // for string, operator<<, char_traits
 #include <string_view>             // for string_view
 
+#include "banMatcher.hpp"          // for Cidr, BanMatcher
 #include "bans.hpp"                // for Ban
 #include "cmd.hpp"                 // for cmd
 #include "config.hpp"              // for Config, gConfig
@@ -35,7 +36,7 @@
 #include "mud.hpp"                 // for questions_to_email
 #include "mudObjects/players.hpp"  // for Player
 #include "proto.hpp"               // for broadcast, isCt, log_immort, logn
-#include "server.hpp"              // for Server, gServer, SocketList
+#include "server.hpp"              // for Server, gServer, SocketTable
 #include "socket.hpp"              // for Socket
 #include "toNum.hpp"
 
@@ -55,10 +56,15 @@ void Ban::reset() {
     isPrefix = isSuffix = false;    
 }
 
+// BanMatcher indexes the ban list and has to agree with this
 bool Ban::matches(std::string_view toMatch) {
+    Cidr cidr;
+    Cidr::Address addr;
 
     if(site == "*")
         return(true);
+    else if(!isPrefix && !isSuffix && Cidr::parse(site, cidr))
+        return(Cidr::parseAddress(toMatch, addr) && cidr.contains(addr));
     else if(isPrefix && isSuffix && toMatch.find(site) != std::string_view::npos)
         return(true);
     else if(isPrefix && toMatch.starts_with(site))
@@ -71,6 +77,10 @@ bool Ban::matches(std::string_view toMatch) {
     return(false);
 }
 
+bool Ban::isExpired(long t) const {
+    return(unbanTime != 0 && t > unbanTime);
+}
+
 
 
 
@@ -392,7 +402,8 @@ int dmUnban(const std::shared_ptr<Player>& player, cmd* cmnd) {
 
 bool Config::addBan(Ban* toAdd) {
     bans.push_back(toAdd);
-    return(true);   
+    rebuildBanIndex();
+    return(true);
 }
 
 bool Config::deleteBan(int toDel) {
@@ -404,6 +415,7 @@ bool Config::deleteBan(int toDel) {
         if(count == toDel) { // We've found the clan to delete, now remove it from the list
             Ban* ban = (*it);
             bans.erase(it);
+            rebuildBanIndex();
             delete ban;
             return(true);
         }
@@ -420,36 +432,10 @@ bool Config::deleteBan(int toDel) {
 // then 2 is returned.  If it's completely locked, 1 is returned.  If
 // it's not locked out at all, 0 is returned.
 int Config::isLockedOut( const std::shared_ptr<Socket>& sock ) {
-    bool match = false;
-    int count=0;
-
-    std::list<Ban*>::iterator it;
-    Ban* ban = nullptr;
-
-    for(it = bans.begin() ; it != bans.end() ; it++) {
-        count++;
-        ban = (*it);
-        // Better safe than sorry
-        if(!ban)
-            continue;
-        
-        if(ban->matches(sock->getHostname()) || ban->matches(sock->getIp())) {
-            match = true;
-            break;
-        }
-    }
-    if(!match)
+    Ban* ban = banIndex.find(sock->getHostname(), sock->getIp());
+    if(!ban)
         return(0);
 
-    if(ban->unbanTime != 0 && time(nullptr) > ban->unbanTime) {
-        // Ban has expired so delete it
-        broadcast(isCt, "^y--- Expiring ban for '%s'", ban->site.c_str());
-        deleteBan(count);
-        saveBans();
-
-        // See if they're effected by another ban
-        return(isLockedOut(sock));
-    }
     if(!ban->password.empty()) {
         strcpy(sock->tempstr[0], ban->password.c_str());
         return (2);
@@ -464,18 +450,41 @@ int Config::isLockedOut( const std::shared_ptr<Socket>& sock ) {
 
 // Returns 1 if the site is on the ban list, 0 otherwise
 bool Config::isBanned(std::string_view site) {
-    std::list<Ban*>::iterator it;
-    Ban* ban;
+    return(banIndex.find(site) != nullptr);
+}
 
-    for(it = bans.begin() ; it != bans.end() ; it++) {
-        ban = (*it);
-        // Better safe than sorry
-        if(!ban)
+//***************************
+// expireBans
+//***************************
+// Run from the scheduler every minute, so lookups never have to worry about
+// a ban having run out.
+
+void Config::expireBans() {
+    long t = time(nullptr);
+    bool expired = false;
+
+    for(auto it = bans.begin() ; it != bans.end() ; ) {
+        Ban* ban = (*it);
+        if(ban && !ban->isExpired(t)) {
+            it++;
             continue;
-        if(ban->matches(site))
-            return(true);
+        }
+        if(ban) {
+            broadcast(isCt, "^y--- Expiring ban for '%s'", ban->site.c_str());
+            delete ban;
+        }
+        it = bans.erase(it);
+        expired = true;
+    }
+
+    if(expired) {
+        rebuildBanIndex();
+        saveBans();
     }
-    return (false);
+}
+
+void Config::rebuildBanIndex() {
+    banIndex.build(bans);
 }
 
 // Clears bans
@@ -488,5 +497,5 @@ void Config::clearBanList() {
         bans.pop_front();
     }
     bans.clear();
+    banIndex.clear();
 }
-
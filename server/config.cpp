@@ -168,6 +168,8 @@ void Config::reset(bool reload) {
     logSuicide = true;
 
     logDeath = true;
+    logJson = false;
+    logRotateSize = logRotateDays = 0;
     autoShutdown = false;
     doAprilFools = false;
     doBonusXP = false;
@@ -252,7 +254,7 @@ void Config::reset(bool reload) {
     proxyManager = nullptr;
 
     tickets.clear();
-    defaultArea = "misc";
+    setDefaultArea("misc");
     swapping = roomSearchFailure = txtOnCrash = false;
 }
 
@@ -417,25 +419,25 @@ bool Config::writeHelpFiles() const {
 //*********************************************************************
 
 fs::path Path::objectPath(const CatRef& cr) {
-    auto path = Path::Object / cr.area;
+    auto path = Path::Object / cr.area.str();
     if(cr.id < 0)
         return path;
     return (path / fmt::format("o{:05d}", cr.id)).replace_extension("xml");
 }
 fs::path Path::monsterPath(const CatRef& cr) {
-    auto path = Path::Monster / cr.area;
+    auto path = Path::Monster / cr.area.str();
     if(cr.id < 0)
         return path;
     return (path / fmt::format("m{:05d}", cr.id)).replace_extension("xml");
 }
 fs::path Path::roomPath(const CatRef& cr) {
-    auto path = Path::UniqueRoom / cr.area;
+    auto path = Path::UniqueRoom / cr.area.str();
     if(cr.id < 0)
         return path;
     return (path / fmt::format("r{:05d}", cr.id)).replace_extension("xml");
 }
 fs::path Path::roomBackupPath(const CatRef& cr) {
-    auto path = Path::UniqueRoom / cr.area / "backup";
+    auto path = Path::UniqueRoom / cr.area.str() / "backup";
     if(cr.id < 0)
         return path;
     return (path / fmt::format("r{:05d}", cr.id)).replace_extension("xml");
@@ -543,6 +545,8 @@ const std::string &Config::getDefaultArea() const {
 
 void Config::setDefaultArea(const std::string &pDefaultArea) {
     Config::defaultArea = pDefaultArea;
+    // Every CatRef starts out here, so keep it in the area table
+    AreaName::intern(defaultArea);
 }
 
 bool Config::hasPort() const {
@@ -27,6 +27,7 @@
 #include "catRef.hpp"                               // for CatRef
 #include "cmd.hpp"                                  // for cmd
 #include "flags.hpp"                                // for M_ANTI_MAGIC_AURA
+#include "keyTxt.hpp"                               // for KeyTxtQuery, KeyTxtSetIndex
 #include "location.hpp"                             // for Location
 #include "mudObjects/areaRooms.hpp"                 // for AreaRoom
 #include "mudObjects/container.hpp"                 // for Container, Contai...
@@ -113,20 +114,15 @@ std::shared_ptr<Container> Container::remove(Containable* toRemove) {
 
     bool toReturn;
     if(remObject) {
-        std::erase_if(objects, [&toRemove](auto& item) {
-            return item.get() == toRemove;
-        });
+        objects.erase(remObject);
+        objectIndex.invalidate();
         toReturn = true;
     } else if(remPlayer) {
-        std::erase_if(players, [&toRemove](auto& item) {
-            auto locked = item.lock();
-            return locked && locked.get() == toRemove;
-        });
+        players.erase(remPlayer);
         toReturn = true;
     } else if(remMonster) {
-        std::erase_if(monsters, [&toRemove](auto& item) {
-            return item.get() == toRemove;
-        });
+        monsters.erase(remMonster);
+        monsterIndex.invalidate();
         toReturn = true;
     } else {
         std::clog << "Don't know how to remove " << toRemove << std::endl;
@@ -162,12 +158,14 @@ bool Container::add(const std::shared_ptr<Containable>& toAdd) {
     bool toReturn;
     if(addObject) {
         std::pair<ObjectSet::iterator, bool> p = objects.insert(addObject);
+        objectIndex.invalidate();
         toReturn = p.second;
     } else if(addPlayer) {
         std::pair<PlayerSet::iterator, bool> p = players.insert(addPlayer);
         toReturn = p.second;
     } else if(addMonster) {
         std::pair<MonsterSet::iterator, bool> p = monsters.insert(addMonster);
+        monsterIndex.invalidate();
         toReturn = p.second;
     } else {
         std::clog << "Don't know how to add " << toAdd << std::endl;
@@ -201,6 +199,11 @@ void Container::unRegisterContainedItems() {
     }
 }
 
+void Container::keyTxtChanged() {
+    monsterIndex.invalidate();
+    objectIndex.invalidate();
+}
+
 
 //*********************************************************************
 //                      wake
@@ -265,25 +268,18 @@ std::shared_ptr<Object>  Container::findObject(const std::shared_ptr<const Creat
             target = checkObjectFilters(searcher, filterString);
     }
    
-    if(!target) {
-        for(const auto& obj : objects) {
-            if(isMatch(searcher, obj, name, exactMatch, true)) {
-                match++;
-                if(match == num) {
-                    if(exactMatch)
-                        return(obj);
-                    else {
-                        target = obj;
-                        break;
-                    }
-                }
-            }
-        }
-    }
+    if(!target)
+        target = findObject(searcher, KeyTxtQuery(name, exactMatch), num, match, true);
 
     return(target);
 }
 
+std::shared_ptr<Object>  Container::findObject(const std::shared_ptr<const Creature>& searcher, const KeyTxtQuery& query, int num, int& match, bool checkVisibility) const {
+    return(objectIndex.find(objects, query, [&](const std::shared_ptr<Object>& obj) {
+        return(isMatch(searcher, obj, query, checkVisibility) && ++match == num);
+    }));
+}
+
 std::shared_ptr<Object> Container::checkObjectFilters(const std::shared_ptr<const Creature>& searcher, std::string filterString) const {
     std::shared_ptr<Object>target = nullptr;
 
@@ -379,31 +375,34 @@ std::shared_ptr<Creature> Container::findCreature(const std::shared_ptr<const Cr
     return(findCreature(searcher, name, num, monFirst, firstAggro, exactMatch, ignored));
 }
 bool isMatch(const std::shared_ptr<const Creature>& searcher, const std::shared_ptr<MudObject>& target, const std::string& name, bool exactMatch, bool checkVisibility) {
+    return(isMatch(searcher, target, KeyTxtQuery(name, exactMatch), checkVisibility));
+}
+
+bool isMatch(const std::shared_ptr<const Creature>& searcher, const std::shared_ptr<MudObject>& target, const KeyTxtQuery& query, bool checkVisibility) {
     if(!target)
         return(false);
     if(checkVisibility && !searcher->canSee(target))
         return(false);
 
     // ID match is exact, regardless of exactMatch option
-    if(target->getId() == name)
+    if(target->getId() == query.raw)
         return(true);
 
-    if(exactMatch) {
-        if(target->getName() == name) {
+    if(query.exact) {
+        if(target->getName() == query.raw) {
             return(true);
         }
 
     } else {
-        if(target->isCreature() && keyTxtEqual(target->getAsCreature(), name.c_str())) {
-            return(true);
-        } else if(
-            target->isObject() &&
-            (
-                keyTxtEqual(target->getAsObject(), name.c_str()) ||
-                (target->getAsObject()->isLabeledBy(searcher) && target->getAsObject()->isLabelMatch(name))
-            )
-        ) {
+        if(target->isCreature() && target->getAsConstCreature()->getKeyTxt().matches(query)) {
             return(true);
+        } else if(target->isObject()) {
+            std::shared_ptr<const Object> object = target->getAsConstObject();
+            if( object->getKeyTxt().matches(query) ||
+                (object->isLabeledBy(searcher) && object->isLabelMatch(std::string(query.raw)))
+            ) {
+                return(true);
+            }
         }
     }
     return(false);
@@ -440,21 +439,9 @@ std::shared_ptr<Monster>  Container::findMonster(std::shared_ptr<const Creature>
     return(findMonster(searcher, name, num, firstAggro, exactMatch, match));
 }
 std::shared_ptr<Monster>  Container::findMonster(const std::shared_ptr<const Creature>& searcher, const std::string& name, const int num, bool firstAggro, bool exactMatch, int& match) const {
-    std::shared_ptr<Monster>  target = nullptr;
-    for(const auto& mons : searcher->getParent()->monsters) {
-        if(isMatch(searcher, mons, name, exactMatch, true)) {
-            match++;
-            if(match == num) {
-                if(exactMatch)
-                    return(mons);
-                else {
-                    target = mons;
-                    break;
-                }
-
-            }
-        }
-    }
+    std::shared_ptr<Monster>  target = searcher->getParent()->findMonster(searcher, KeyTxtQuery(name, exactMatch), num, match, true);
+    if(exactMatch)
+        return(target);
     if(firstAggro && target) {
         if(num < 2 && searcher->pFlagIsSet(P_KILL_AGGROS))
             return(getFirstAggro(target, searcher));
@@ -465,6 +452,12 @@ std::shared_ptr<Monster>  Container::findMonster(const std::shared_ptr<const Cre
     }
 }
 
+std::shared_ptr<Monster>  Container::findMonster(const std::shared_ptr<const Creature>& searcher, const KeyTxtQuery& query, int num, int& match, bool checkVisibility) const {
+    return(monsterIndex.find(monsters, query, [&](const std::shared_ptr<Monster>& mons) {
+        return(isMatch(searcher, mons, query, checkVisibility) && ++match == num);
+    }));
+}
+
 std::shared_ptr<Monster>  Container::findNpcTrader(const std::shared_ptr<const Creature>& searcher, const short profession) const {
     std::shared_ptr<Monster> target=nullptr;
     for(const auto& mons : searcher->getParent()->monsters) {
@@ -486,9 +479,10 @@ std::shared_ptr<Player> Container::findPlayer(const std::shared_ptr<const Creatu
     return(findPlayer(searcher, name, num, exactMatch, match));
 }
 std::shared_ptr<Player> Container::findPlayer(const std::shared_ptr<const Creature>& searcher, const std::string& name, const int num, bool exactMatch, int& match) const {
+    KeyTxtQuery query(name, exactMatch);
     for(const auto& pIt: searcher->getParent()->players) {
         if(auto ply = pIt.lock()) {
-            if (isMatch(searcher, ply, name, exactMatch, true)) {
+            if (isMatch(searcher, ply, query, true)) {
                 match++;
                 if (match == num) {
                     return (ply);
@@ -522,6 +516,19 @@ Containable::Containable() {
 }
 
 
+//*********************************************************************
+//                      sortKey
+//*********************************************************************
+
+const std::string* Containable::refreshSortKey() {
+    sortKey = getName();
+    return(&sortKey);
+}
+
+const std::string* Containable::getSortKey() const {
+    return(&sortKey);
+}
+
 void Containable::removeFromSet() {
     lastParent = removeFrom();
 }
@@ -16,11 +16,14 @@
  *
  */
 
+#include <algorithm>                 // for max
 #include <ctime>                     // for time
+#include <iterator>                  // for prev
 #include <list>                      // for list, operator==, list<>::iterator
 #include <ostream>                   // for operator<<, ostringstream, basic...
 #include <string>                    // for string, allocator, operator+
 #include <string_view>               // for string_view
+#include <utility>                   // for move
 
 #include "cmd.hpp"                   // for cmd
 #include "commands.hpp"              // for cmdProcess, parse
@@ -29,16 +32,7 @@
 #include "mudObjects/mudObject.hpp"  // for MudObject
 #include "proto.hpp"                 // for broadcast, lowercize, stripBadChars
 #include "server.hpp"                // for Server, gServer
-
-
-//*********************************************************************
-//                      Delayed Action Queue
-//*********************************************************************
-
-// TODO: optomize this by making the queue a sorted list based on completion.
-// That way you only have to check the front of the list to see if anything needs to be
-// done - no more looping!
-// std::map<long, action>
+#include "timerWheel.hpp"            // for TimerWheel
 
 
 //*********************************************************************
@@ -52,54 +46,38 @@ bool Server::removeDelayedActions(const std::shared_ptr<MudObject>& target, bool
 bool Server::removeDelayedActions(MudObject* target, bool interruptOnly) {
     bool found = false;
 
-    for(auto it = delayedActionQueue.begin(); it != delayedActionQueue.end(); ) {
-        auto actionTarget = it->target.lock();
-        if(!actionTarget) {
-            // this must be a bug
-            found = true;
-            it = delayedActionQueue.erase(it);
-            broadcast(isCt, "^rA delayed action without a target was discovered and removed from the queue.");
+    // Copy the list: removing an action takes it out of the target's list too
+    std::list<DelayedActionRef> actions = target->getDelayedActions();
+    for(DelayedActionRef action : actions) {
+        // should we remove this action?
+        if(interruptOnly && !action->canInterrupt)
             continue;
-        } else if(actionTarget.get() == target) {
-            // should we remove this action?
-            if(!interruptOnly || (*it).canInterrupt) {
-                // if we're just interrupting, we won't remove-all at the end
-                if(interruptOnly)
-                    target->removeDelayedAction(&(*it));
-
-                found = true;
-                it = delayedActionQueue.erase(it);
-                continue;
-            }
-        }
-        it++;
-    }
 
-    // if we aren't just interrupting, remove all
-    if(!interruptOnly)
-        target->clearDelayedActions();
+        timers.cancel(action->timer);
+        target->removeDelayedAction(action);
+        delayedActionQueue.erase(action);
+        found = true;
+    }
     return(found);
 }
 
 //*********************************************************************
-//                      parseDelayedActions
+//                      runDelayedAction
 //*********************************************************************
-// this function is called once a second from Server::updateGame
-
-void Server::parseDelayedActions(long t) {
-    for(auto it = delayedActionQueue.begin(); it != delayedActionQueue.end(); ) {
-        if(it->whenFinished <= t) {
-            auto actionTarget = it->target.lock();
-            if(actionTarget) {
-                // exectue the callback function
-                ((*it).callback) (&(*it));
-                actionTarget->removeDelayedAction(&(*it));
-            }
-            it = delayedActionQueue.erase(it);
-        } else {
-            it++;
-        }
-    }
+// Called from the timer wheel when an action is finished.  The action is taken
+// off the queue before the callback runs, in case the callback interrupts or
+// queues up actions of its own.
+
+void Server::runDelayedAction(DelayedActionRef ref) {
+    DelayedAction action = std::move(*ref);
+    auto actionTarget = action.target.lock();
+    if(actionTarget)
+        actionTarget->removeDelayedAction(ref);
+    delayedActionQueue.erase(ref);
+
+    // exectue the callback function
+    if(actionTarget)
+        (action.callback) (&action);
 }
 
 
@@ -124,10 +102,10 @@ void Server::addDelayedAction(void (*callback)(DelayedActionFn), const std::shar
             break;
     }
 
-    DelayedAction action = DelayedAction(callback, target, cmnd, type, time(nullptr) + howLong, canInterrupt);
-
-    delayedActionQueue.push_back(action);
-    target->addDelayedAction(&action);
+    delayedActionQueue.emplace_back(callback, target, cmnd, type, time(nullptr) + howLong, canInterrupt);
+    DelayedActionRef action = std::prev(delayedActionQueue.end());
+    action->timer = timers.schedule(std::max<long>(0, howLong) * 1000, [this, action] { runDelayedAction(action); });
+    target->addDelayedAction(action);
 }
 
 //*********************************************************************
@@ -135,10 +113,10 @@ void Server::addDelayedAction(void (*callback)(DelayedActionFn), const std::shar
 //*********************************************************************
 
 void Server::addDelayedScript(void (*callback)(DelayedActionFn), const std::shared_ptr<MudObject>& target, std::string_view script, long howLong, bool canInterrupt) {
-    DelayedAction action = DelayedAction(callback, target, script, time(nullptr) + howLong, canInterrupt);
-
-    delayedActionQueue.push_back(action);
-    target->addDelayedAction(&action);
+    delayedActionQueue.emplace_back(callback, target, script, time(nullptr) + howLong, canInterrupt);
+    DelayedActionRef action = std::prev(delayedActionQueue.end());
+    action->timer = timers.schedule(std::max<long>(0, howLong) * 1000, [this, action] { runDelayedAction(action); });
+    target->addDelayedAction(action);
 }
 
 
@@ -148,20 +126,10 @@ void Server::addDelayedScript(void (*callback)(DelayedActionFn), const std::shar
 // this will inform the calling function that a particular delayed action is in the queue
 
 bool Server::hasAction(const std::shared_ptr<MudObject>& target, DelayedActionType type) {
-    std::list<DelayedAction>::const_iterator it;
-
-    for(it = delayedActionQueue.begin(); it != delayedActionQueue.end();) {
-        auto actionTarget = it->target.lock();
-        if(actionTarget) {
-            if (actionTarget == target && it->type == type)
-                return (true);
-
-            it++;
-        } else {
-            it = delayedActionQueue.erase(it);
-        }
+    for(DelayedActionRef action : target->getDelayedActions()) {
+        if(action->type == type)
+            return(true);
     }
-
     return(false);
 }
 
@@ -172,32 +140,23 @@ bool Server::hasAction(const std::shared_ptr<MudObject>& target, DelayedActionTy
 
 std::string Server::delayedActionStrings(const std::shared_ptr<MudObject>& target) {
     std::ostringstream oStr;
-    std::list<DelayedAction>::const_iterator it;
-
-    for(it = delayedActionQueue.begin(); it != delayedActionQueue.end();) {
-        auto actionTarget = it->target.lock();
-        if(actionTarget) {
-            if (actionTarget == target) {
-                switch ((*it).type) {
-                    case ActionFish:
-                        oStr << " ^C*Fishing*";
-                        break;
-                    case ActionSearch:
-                        oStr << " ^C*Searching*";
-                        break;
-                    case ActionTrack:
-                        oStr << " ^C*Tracking*";
-                        break;
-                    case ActionStudy:
-                        oStr << " ^Y*Studying*";
-                        break;
-                    default:
-                        break;
-                }
-            }
-            it++;
-        } else {
-            it = delayedActionQueue.erase(it);
+
+    for(DelayedActionRef action : target->getDelayedActions()) {
+        switch(action->type) {
+            case ActionFish:
+                oStr << " ^C*Fishing*";
+                break;
+            case ActionSearch:
+                oStr << " ^C*Searching*";
+                break;
+            case ActionTrack:
+                oStr << " ^C*Tracking*";
+                break;
+            case ActionStudy:
+                oStr << " ^Y*Studying*";
+                break;
+            default:
+                break;
         }
     }
 
@@ -227,7 +186,7 @@ void MudObject::interruptDelayedActions() {
 //*********************************************************************
 // ONLY to be called from Server::addDelayedAction
 
-void MudObject::addDelayedAction(DelayedAction* action) {
+void MudObject::addDelayedAction(DelayedActionRef action) {
     delayedActionQueue.push_back(action);
 }
 
@@ -235,10 +194,10 @@ void MudObject::addDelayedAction(DelayedAction* action) {
 //*********************************************************************
 //                      removeDelayedAction
 //*********************************************************************
-// ONLY to be called from Server::parseDelayedActions and Server::removeDelayedActions
+// ONLY to be called from Server::runDelayedAction and Server::removeDelayedActions
 
-void MudObject::removeDelayedAction(DelayedAction* action) {
-    std::list<DelayedAction*>::iterator it;
+void MudObject::removeDelayedAction(DelayedActionRef action) {
+    std::list<DelayedActionRef>::iterator it;
 
     for(it = delayedActionQueue.begin(); it != delayedActionQueue.end(); it++) {
         if((*it) == action) {
@@ -252,12 +211,15 @@ void MudObject::removeDelayedAction(DelayedAction* action) {
 //*********************************************************************
 //                      clearDelayedActions
 //*********************************************************************
-// ONLY to be called from Server::removeDelayedActions
 
 void MudObject::clearDelayedActions() {
     delayedActionQueue.clear();
 }
 
+const std::list<DelayedActionRef>& MudObject::getDelayedActions() const {
+    return(delayedActionQueue);
+}
+
 
 //*********************************************************************
 //                      doDelayedAction
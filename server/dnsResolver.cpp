@@ -0,0 +1,152 @@
+/*
+ * dnsResolver.cpp
+ *   Pool of threads doing reverse DNS lookups for new connections
+ *   ____            _
+ *  |  _ \ ___  __ _| |_ __ ___  ___
+ *  | |_) / _ \/ _` | | '_ ` _ \/ __|
+ *  |  _ <  __/ (_| | | | | | | \__ \
+ *  |_| \_\___|\__,_|_|_| |_| |_|___/
+ *
+ * Permission to use, modify and distribute is granted via the
+ *  GNU Affero General Public License v3 or later
+ *
+ *  Copyright (C) 2007-2021 Jason Mitchell, Randi Mitchell
+ *     Contributions by Tim Callahan, Jonathan Hseu
+ *  Based on Mordor (C) Brooke Paul, Brett J. Vickers, John P. Freeman
+ *
+ */
+
+#include <netdb.h>              // for getnameinfo, NI_MAXHOST, EAI_AGAIN
+#include <algorithm>            // for reverse
+
+#include "dnsResolver.hpp"      // for DnsResolver
+
+//*********************************************************************
+//                      DnsResolver
+//*********************************************************************
+// The threads aren't started until the first lookup
+
+DnsResolver::DnsResolver() = default;
+
+DnsResolver::~DnsResolver() {
+    stop();
+    takeResults();
+}
+
+size_t DnsResolver::getInFlight() const {
+    return(inFlight.size());
+}
+
+//*********************************************************************
+//                      lookup
+//*********************************************************************
+
+bool DnsResolver::lookup(const sockaddr_in& addr, std::string_view ip) {
+    if(!inFlight.emplace(ip).second)
+        return(false);
+
+    std::unique_lock<std::mutex> guard(lock);
+    if(workers.empty() && !stopping) {
+        for(int i = 0; i < DNS_RESOLVER_THREADS; i++)
+            workers.emplace_back(&DnsResolver::run, this);
+    }
+    requests.push_back(Request{addr, std::string(ip)});
+    wake.notify_one();
+    return(true);
+}
+
+//*********************************************************************
+//                      takeResults
+//*********************************************************************
+
+std::vector<DnsResolver::Result> DnsResolver::takeResults() {
+    std::vector<Result> results;
+    // Checked every pass, so don't bother with the exchange when there's nothing there
+    if(!finished.load(std::memory_order_relaxed))
+        return(results);
+
+    Node* node = finished.exchange(nullptr, std::memory_order_acquire);
+    while(node) {
+        Node* next = node->next;
+        inFlight.erase(node->result.ip);
+        results.push_back(std::move(node->result));
+        delete node;
+        node = next;
+    }
+    std::reverse(results.begin(), results.end());
+    return(results);
+}
+
+//*********************************************************************
+//                      stop
+//*********************************************************************
+// Lookups still queued are dropped; ones already running are waited on
+
+void DnsResolver::stop() {
+    {
+        std::unique_lock<std::mutex> guard(lock);
+        stopping = true;
+        requests.clear();
+        wake.notify_all();
+    }
+    for(auto& worker : workers) {
+        if(worker.joinable())
+            worker.join();
+    }
+    workers.clear();
+}
+
+//*********************************************************************
+//                      run
+//*********************************************************************
+
+void DnsResolver::run() {
+    std::unique_lock<std::mutex> guard(lock);
+    while(true) {
+        wake.wait(guard, [this] { return(stopping || !requests.empty()); });
+        if(stopping)
+            break;
+
+        Request request = std::move(requests.front());
+        requests.pop_front();
+        guard.unlock();
+
+        complete(resolve(request));
+
+        guard.lock();
+    }
+}
+
+//*********************************************************************
+//                      complete
+//*********************************************************************
+
+void DnsResolver::complete(Result&& result) {
+    auto* node = new Node{std::move(result)};
+    node->next = finished.load(std::memory_order_relaxed);
+    while(!finished.compare_exchange_weak(node->next, node, std::memory_order_release, std::memory_order_relaxed))
+        ;
+}
+
+//*********************************************************************
+//                      resolve
+//*********************************************************************
+
+DnsResolver::Result DnsResolver::resolve(const Request& request) {
+    Result result{request.ip, request.ip, false};
+    char hbuf[NI_MAXHOST];
+    int res = 0;
+
+    for(int tries = 0; tries < 5; tries++) {
+        res = getnameinfo((const struct sockaddr*)&request.addr, sizeof(request.addr), hbuf, sizeof(hbuf), nullptr, 0, NI_NAMEREQD);
+        // Only a temporary failure is worth asking again
+        if(res != EAI_AGAIN)
+            break;
+    }
+
+    if(res == 0) {
+        result.hostName = hbuf;
+        result.found = true;
+    }
+    return(result);
+}
@@ -51,11 +51,7 @@ Hooks::Hooks(MudObject* target) {
 //*********************************************************************
 
 void Hooks::doCopy(const Hooks& h) {
-    hooks.clear();
-
-    for(const auto& p : h.hooks) {
-        add(p.first, p.second);
-    }
+    hooks = h.hooks;
 }
 
 Hooks& Hooks::operator=(const Hooks& h) {
@@ -79,7 +75,7 @@ void Hooks::setParent(MudObject* target) {
 //*********************************************************************
 
 void Hooks::add(std::string_view event, std::string_view code) {
-    hooks.insert(std::pair<std::string,std::string>(event, code));
+    hooks.edit().insert(std::pair<std::string,std::string>(event, code));
 }
 
 
@@ -89,13 +85,13 @@ void Hooks::add(std::string_view event, std::string_view code) {
 //*********************************************************************
 
 std::string Hooks::display() const {
-    if(hooks.empty())
+    if(hooks->empty())
         return("");
 
     std::ostringstream oStr;
 
     oStr << "^oHooks:^x\n";
-    for( const auto& p : hooks ) {
+    for( const auto& p : *hooks ) {
         oStr << "^WEvent:^x " << p.first << "\n^WCode:^x" << p.second << "\n";
     }
 
@@ -164,10 +160,10 @@ bool Hooks::execute(const std::string &event, const std::shared_ptr<MudObject>&
         hookMudObjName(parent), hookMudObjName(target), params).c_str());
 
     //std::unordered_map<std::string, std::string>::const_iterator it = hooks.find(event);
-    auto it = hooks.find(event);
+    auto it = hooks->find(event);
 
 
-    if(it != hooks.end()) {
+    if(it != hooks->end()) {
         ran = true;
 
         broadcast(seeHooks, fmt::format("^orunning hook {}: {}^o on {}^o{}: ^x{}", event,
@@ -194,10 +190,10 @@ bool Hooks::executeWithReturn(const std::string &event, const std::shared_ptr<Mu
     broadcast(seeAllHooks, fmt::format("^ochecking hook {}: {}^o on {}^o{}", event,
         hookMudObjName(parent), hookMudObjName(target), params).c_str());
 
-    auto it = hooks.find(event);
+    auto it = hooks->find(event);
 
 
-    if(it != hooks.end()) {
+    if(it != hooks->end()) {
         broadcast(seeHooks, fmt::format("^orunning hook {}: {}^o on {}^o{}: ^x", event,
             hookMudObjName(parent), hookMudObjName(target), params).c_str());
 
@@ -224,5 +220,5 @@ bool Hooks::run(const std::shared_ptr<MudObject>& trigger1, const std::string &e
 }
 
 bool Hooks::empty() const {
-    return hooks.empty();
+    return hooks->empty();
 }
@@ -0,0 +1,210 @@
+/*
+ * idIndex.cpp
+ *   Hashed index of registered MudObject IDs
+ *   ____            _
+ *  |  _ \ ___  __ _| |_ __ ___  ___
+ *  | |_) / _ \/ _` | | '_ ` _ \/ __|
+ *  |  _ <  __/ (_| | | | | | | \__ \
+ *  |_| \_\___|\__,_|_|_| |_| |_|___/
+ *
+ * Permission to use, modify and distribute is granted via the
+ *  GNU Affero General Public License v3 or later
+ *
+ *  Copyright (C) 2007-2021 Jason Mitchell, Randi Mitchell
+ *     Contributions by Tim Callahan, Jonathan Hseu
+ *  Based on Mordor (C) Brooke Paul, Brett J. Vickers, John P. Freeman
+ *
+ */
+
+#include <algorithm>            // for sort
+#include <cstdint>              // for uint64_t
+
+#include "idIndex.hpp"          // for IdIndex, MudId
+
+static constexpr size_t INITIAL_SLOTS = 1024;
+
+//*********************************************************************
+//                      MudId
+//*********************************************************************
+
+bool MudId::parse(std::string_view id, MudId& out) {
+    // Anything longer would overflow the counter
+    if(id.size() < 2 || id.size() > 20 || id[0] < 'A' || id[0] > 'Z')
+        return(false);
+
+    uint64_t num = 0;
+    for(size_t i = 1; i < id.size(); i++) {
+        if(id[i] < '0' || id[i] > '9')
+            return(false);
+        num = num * 10 + (id[i] - '0');
+    }
+    out.kind = id[0];
+    out.num = num;
+    return(true);
+}
+
+// splitmix64 finalizer; ids are handed out sequentially so they need mixing
+// before they're any good as a bucket index
+static inline uint64_t hashId(const MudId& id) {
+    uint64_t x = id.num ^ ((uint64_t)(unsigned char)id.kind << 56);
+    x ^= x >> 30;
+    x *= 0xbf58476d1ce4e5b9ULL;
+    x ^= x >> 27;
+    x *= 0x94d049bb133111ebULL;
+    x ^= x >> 31;
+    return(x);
+}
+
+//*********************************************************************
+//                      IdIndex
+//*********************************************************************
+
+IdIndex::IdIndex() {
+    slots.resize(INITIAL_SLOTS);
+    used = deleted = 0;
+}
+
+size_t IdIndex::size() const {
+    return(used + named.size());
+}
+
+//*********************************************************************
+//                      findSlot
+//*********************************************************************
+// Linear probe for the id; returns its slot, or null if it isn't there
+
+IdIndex::Slot* IdIndex::findSlot(const MudId& id) {
+    size_t mask = slots.size() - 1;
+    for(size_t i = hashId(id) & mask; ; i = (i + 1) & mask) {
+        Slot& slot = slots[i];
+        if(slot.state == SlotState::EMPTY)
+            return(nullptr);
+        if(slot.state == SlotState::USED && slot.id == id)
+            return(&slot);
+    }
+}
+
+//*********************************************************************
+//                      grow
+//*********************************************************************
+// Rehash into a table big enough to stay under half full; this also clears out
+// tombstones, so a table that's just churning may stay the same size
+
+void IdIndex::grow() {
+    size_t newSize = slots.size();
+    while(used * 2 >= newSize)
+        newSize *= 2;
+
+    std::vector<Slot> old(newSize);
+    old.swap(slots);
+    deleted = 0;
+
+    size_t mask = slots.size() - 1;
+    for(auto& slot : old) {
+        if(slot.state != SlotState::USED)
+            continue;
+        size_t i = hashId(slot.id) & mask;
+        while(slots[i].state == SlotState::USED)
+            i = (i + 1) & mask;
+        slots[i].id = slot.id;
+        slots[i].state = SlotState::USED;
+        slots[i].mo = std::move(slot.mo);
+    }
+}
+
+//*********************************************************************
+//                      insert
+//*********************************************************************
+// Returns false if the id is already registered
+
+bool IdIndex::insert(std::string_view id, const std::weak_ptr<MudObject>& mo) {
+    MudId mudId;
+    if(!MudId::parse(id, mudId))
+        return(named.emplace(std::string(id), mo).second);
+
+    if(findSlot(mudId))
+        return(false);
+
+    // Keep the table under 70% full, counting tombstones, so probes stay short
+    if((used + deleted + 1) * 10 > slots.size() * 7)
+        grow();
+
+    size_t mask = slots.size() - 1;
+    size_t i = hashId(mudId) & mask;
+    while(slots[i].state == SlotState::USED)
+        i = (i + 1) & mask;
+
+    if(slots[i].state == SlotState::DELETED)
+        deleted--;
+    slots[i].id = mudId;
+    slots[i].state = SlotState::USED;
+    slots[i].mo = mo;
+    used++;
+    return(true);
+}
+
+//*********************************************************************
+//                      find
+//*********************************************************************
+
+std::weak_ptr<MudObject>* IdIndex::find(std::string_view id) {
+    MudId mudId;
+    if(!MudId::parse(id, mudId)) {
+        auto it = named.find(std::string(id));
+        return(it == named.end() ? nullptr : &it->second);
+    }
+
+    Slot* slot = findSlot(mudId);
+    return(slot ? &slot->mo : nullptr);
+}
+
+//*********************************************************************
+//                      erase
+//*********************************************************************
+
+bool IdIndex::erase(std::string_view id) {
+    MudId mudId;
+    if(!MudId::parse(id, mudId))
+        return(named.erase(std::string(id)) > 0);
+
+    Slot* slot = findSlot(mudId);
+    if(!slot)
+        return(false);
+
+    slot->state = SlotState::DELETED;
+    slot->mo.reset();
+    used--;
+    deleted++;
+    return(true);
+}
+
+//*********************************************************************
+//                      ordered
+//*********************************************************************
+
+std::vector<std::pair<std::string, std::weak_ptr<MudObject>>> IdIndex::ordered() const {
+    std::vector<const Slot*> ids;
+    ids.reserve(used);
+    for(const auto& slot : slots) {
+        if(slot.state == SlotState::USED)
+            ids.push_back(&slot);
+    }
+    std::sort(ids.begin(), ids.end(), [](const Slot* a, const Slot* b) { return(a->id < b->id); });
+
+    std::vector<std::pair<std::string, std::weak_ptr<MudObject>>> names(named.begin(), named.end());
+    std::sort(names.begin(), names.end(), [](const auto& a, const auto& b) { return(a.first < b.first); });
+
+    // Numeric ids and names only share a kind letter if someone hand edited an id,
+    // so merging on the first character keeps everything grouped the way it used to be
+    std::vector<std::pair<std::string, std::weak_ptr<MudObject>>> list;
+    list.reserve(ids.size() + names.size());
+    auto name = names.begin();
+    for(const Slot* slot : ids) {
+        while(name != names.end() && name->first[0] < slot->id.kind)
+            list.push_back(std::move(*name++));
+        list.emplace_back(slot->id.kind + std::to_string(slot->id.num), slot->mo);
+    }
+    while(name != names.end())
+        list.push_back(std::move(*name++));
+    return(list);
+}
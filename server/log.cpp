@@ -16,18 +16,17 @@
  *
  */
 
-#include <fcntl.h>    // for open, O_RDWR, O_CREAT
-#include <unistd.h>   // for close, lseek, write
-#include <cstdarg>    // for va_end, va_list, va_start
-#include <cstdio>     // for sprintf, vsnprintf, fclose, fopen, fprintf, snp...
-#include <cstdlib>    // for free
-#include <cstring>    // for strlen, strcpy
-#include <ctime>      // for ctime, time, time_t
-#include <iostream>   // for std::clog
-#include <ostream>    // for operator<<, basic_ostream, char_traits, ostream.
-
-#include "mud.hpp"    // for ACC
-#include "paths.hpp"  // for Log
+#include <cstdarg>        // for va_end, va_list, va_start
+#include <cstdio>         // for vsnprintf, vasprintf
+#include <cstdlib>        // for free
+#include <cstring>        // for strlen, strcpy
+#include <ctime>          // for ctime, time, time_t
+#include <iostream>       // for std::clog
+#include <ostream>        // for operator<<, basic_ostream, char_traits, ostream.
+#include <string>         // for string
+
+#include "logWriter.hpp"  // for LogWriter
+#include "paths.hpp"      // for Log
 
 // TODO: Rework these to avoid redundant code
 
@@ -57,30 +56,20 @@ char *getTimeStr() {
 // "name" in the log directory.
 
 void logn(const char *name, const char *fmt, ...) {
-    char    filename[80];
     char    *str;
-    FILE    *fp;
     va_list ap;
 
     va_start(ap, fmt);
-
-    sprintf(filename, "%s/%s.txt", Path::Log.c_str(), name);
-    fp = fopen(filename, "a");
-    
-    if(fp == nullptr) {
-        std::clog << "Unable to open '" << filename << "'\n";
-        return;
-    }
     if(vasprintf(&str, fmt, ap) == -1) {
+        va_end(ap);
         std::clog << "Error in logn\n";
-        return; 
+        return;
     }
     va_end(ap);
-    // TODO: put the \n at the end of this 
-    fprintf(fp, "%s: %s", getTimeStr(), str);
 
-    free(str);  
-    fclose(fp);
+    // TODO: put the \n at the end of this
+    LogWriter::get().append(Path::Log / (std::string(name) + ".txt"), name, str);
+    free(str);
 }
 
 //**********************************************************************
@@ -90,36 +79,14 @@ void logn(const char *name, const char *fmt, ...) {
 // "log" in the player directory.
 
 void loge(const char *fmt, ...) {
-    char    file[80];
-    char    str[4048];
-    int     fd;
-    time_t  t;
+    char    str[2048];
     va_list ap;
 
     va_start(ap, fmt);
-
-    sprintf(file, "%s/log.txt", Path::Log.c_str());
-    fd = open(file, O_RDWR, 0);
-    if(fd < 0) {
-        fd = open(file, O_RDWR | O_CREAT, ACC);
-        if(fd < 0)
-            return;
-    }
-    lseek(fd, 0L, 2);
-    t = time(nullptr);
-    strcpy(str, ctime(&t));
-    str[24] = ':';
-    str[25] = ' ';
-    vsnprintf(str + 26, 2000, fmt, ap);
+    vsnprintf(str, sizeof(str), fmt, ap);
     va_end(ap);
 
-//  vsnprintf(str, 4000, fmt, ap);
-//  va_end(ap);
-//  snprintf(str, 4195, "%s: %s", getTimeStr(), str);
-    write(fd, str, strlen(str));
-
-    close(fd);
-
+    LogWriter::get().append(Path::Log / "log.txt", "log", str);
 }
 
 //**********************************************************************
@@ -128,27 +95,12 @@ void loge(const char *fmt, ...) {
 // Logs stuff in the active log
 
 void loga(const char *fmt,...) {
-    char    file[80];
-    char    str[4048];
-    int     fd;
+    char    str[4000];
     va_list ap;
 
     va_start(ap, fmt);
-
-    sprintf(file, "%s/log.active.txt", Path::Log.c_str());
-    fd = open(file, O_RDWR, 0);
-    if(fd < 0) {
-        fd = open(file, O_RDWR | O_CREAT, ACC);
-        if(fd < 0)
-            return;
-    }
-    lseek(fd, 0L, 2);
-    
-    vsnprintf(str, 4000, fmt, ap);
+    vsnprintf(str, sizeof(str), fmt, ap);
     va_end(ap);
-    snprintf(str, 4045, "%s: %s", getTimeStr(), str);
-
-    write(fd, str, strlen(str));
 
-    close(fd);
+    LogWriter::get().append(Path::Log / "log.active.txt", "log.active", str);
 }
@@ -0,0 +1,461 @@
+/*
+ * logWriter.cpp
+ *   Background writer for log files
+ *   ____            _
+ *  |  _ \ ___  __ _| |_ __ ___  ___
+ *  | |_) / _ \/ _` | | '_ ` _ \/ __|
+ *  |  _ <  __/ (_| | | | | | | \__ \
+ *  |_| \_\___|\__,_|_|_| |_| |_|___/
+ *
+ * Permission to use, modify and distribute is granted via the
+ *  GNU Affero General Public License v3 or later
+ *
+ *  Copyright (C) 2007-2021 Jason Mitchell, Randi Mitchell
+ *     Contributions by Tim Callahan, Jonathan Hseu
+ *  Based on Mordor (C) Brooke Paul, Brett J. Vickers, John P. Freeman
+ *
+ */
+
+#include <fcntl.h>              // for open, O_WRONLY, O_APPEND, O_CREAT
+#include <sys/stat.h>           // for fstat
+#include <sys/uio.h>            // for writev, iovec
+#include <unistd.h>             // for write, close, getpid
+#include <algorithm>            // for min
+#include <cerrno>               // for errno, EINTR
+#include <climits>              // for IOV_MAX
+#include <cstdio>               // for snprintf, rename
+#include <cstring>              // for strerror
+#include <iostream>             // for operator<<, clog
+
+#include "logWriter.hpp"        // for LogWriter, LogKind
+#include "mud.hpp"              // for ACC
+
+// Lines are taken off the ring this many at a time
+static constexpr size_t MAX_BATCH = 512;
+// Files the writer hasn't touched in this long are closed, which also lets go
+// of any file that's been rotated or removed out from under us
+static constexpr time_t IDLE_CLOSE = 60;
+
+//*********************************************************************
+//                      LogWriter
+//*********************************************************************
+
+LogWriter& LogWriter::get() {
+    static LogWriter logWriter;
+    return(logWriter);
+}
+
+LogWriter::LogWriter() : ring(new Slot[RING_SIZE]) {
+    for(uint64_t i = 0; i < RING_SIZE; i++)
+        ring[i].sequence.store(i, std::memory_order_relaxed);
+    owner = getpid();
+    writer = std::thread(&LogWriter::run, this);
+}
+
+LogWriter::~LogWriter() {
+    stop();
+    // A forked child copied the thread object but not the thread, and stop()
+    // can't join from the writer thread itself; destroying it still joinable
+    // would terminate on the way out of exit() before stdio is flushed
+    if(writer.joinable())
+        writer.detach();
+}
+
+bool LogWriter::isAsync() const {
+    return(!stopping.load(std::memory_order_acquire) && owner == getpid());
+}
+
+void LogWriter::setRotation(off_t maxBytes, long maxAge) {
+    rotateBytes = maxBytes;
+    rotateAge = maxAge;
+}
+
+void LogWriter::setJson(bool pJson) {
+    json = pJson;
+}
+
+//*********************************************************************
+//                      append
+//*********************************************************************
+
+void LogWriter::append(const fs::path& file, std::string_view name, std::string text, LogKind kind) {
+    Entry entry{file.string(), std::string(name), std::move(text), time(nullptr), kind};
+
+    if(!isAsync() || !push(std::move(entry))) {
+        writeNow(entry);
+        return;
+    }
+    wake.fetch_add(1, std::memory_order_release);
+    wake.notify_one();
+}
+
+//*********************************************************************
+//                      push / pop
+//*********************************************************************
+// A bounded ring where each slot's sequence number says whose turn it is:
+// a producer may fill slot n when its sequence is n, the writer may empty
+// it once it's n + 1.  Producers only ever contend on claiming head.
+
+bool LogWriter::push(Entry&& entry) {
+    uint64_t pos = head.load(std::memory_order_relaxed);
+    while(true) {
+        Slot& slot = ring[pos & (RING_SIZE - 1)];
+        uint64_t sequence = slot.sequence.load(std::memory_order_acquire);
+        auto diff = (int64_t)(sequence - pos);
+        if(diff == 0) {
+            if(head.compare_exchange_weak(pos, pos + 1, std::memory_order_relaxed)) {
+                slot.entry = std::move(entry);
+                slot.sequence.store(pos + 1, std::memory_order_release);
+                return(true);
+            }
+        } else if(diff < 0) {
+            // Full
+            return(false);
+        } else {
+            pos = head.load(std::memory_order_relaxed);
+        }
+    }
+}
+
+bool LogWriter::pop(Entry& entry) {
+    Slot& slot = ring[tail & (RING_SIZE - 1)];
+    if(slot.sequence.load(std::memory_order_acquire) != tail + 1)
+        return(false);
+    entry = std::move(slot.entry);
+    slot.sequence.store(tail + RING_SIZE, std::memory_order_release);
+    tail++;
+    return(true);
+}
+
+//*********************************************************************
+//                      flush
+//*********************************************************************
+
+void LogWriter::flush() {
+    if(!isAsync())
+        return;
+    uint64_t target = head.load(std::memory_order_acquire);
+    uint64_t done;
+    while((done = written.load(std::memory_order_acquire)) < target)
+        written.wait(done, std::memory_order_acquire);
+}
+
+void LogWriter::release(const fs::path& file) {
+    if(!isAsync())
+        return;
+    Entry entry;
+    entry.file = file.string();
+    entry.close = true;
+    if(push(std::move(entry))) {
+        wake.fetch_add(1, std::memory_order_release);
+        wake.notify_one();
+    }
+    flush();
+}
+
+//*********************************************************************
+//                      stop
+//*********************************************************************
+// Called from crash() and shutdown_now as well as at exit, so whatever was
+// logged on the way down makes it to disk
+
+void LogWriter::stop() {
+    if(owner != getpid() || stopping.exchange(true))
+        return;
+
+    wake.fetch_add(1, std::memory_order_release);
+    wake.notify_one();
+    // Crashing on the writer thread itself: nothing to wait for
+    if(writer.get_id() == std::this_thread::get_id())
+        return;
+    if(writer.joinable())
+        writer.join();
+
+    // Anything that slipped in while the writer was finishing up
+    std::vector<Entry> batch;
+    Entry entry;
+    while(pop(entry))
+        batch.push_back(std::move(entry));
+    writeBatch(batch);
+
+    for(auto& [name, file] : files)
+        close(file.fd);
+    files.clear();
+}
+
+//*********************************************************************
+//                      run
+//*********************************************************************
+
+void LogWriter::run() {
+    std::vector<Entry> batch;
+    batch.reserve(MAX_BATCH);
+
+    while(true) {
+        uint32_t seen = wake.load(std::memory_order_acquire);
+
+        Entry entry;
+        while(batch.size() < MAX_BATCH && pop(entry))
+            batch.push_back(std::move(entry));
+
+        if(!batch.empty()) {
+            size_t count = batch.size();
+            writeBatch(batch);
+            written.fetch_add(count, std::memory_order_release);
+            written.notify_all();
+            continue;
+        }
+
+        closeIdle(time(nullptr));
+        if(stopping.load(std::memory_order_acquire))
+            break;
+        wake.wait(seen, std::memory_order_acquire);
+    }
+}
+
+//*********************************************************************
+//                      writeBatch
+//*********************************************************************
+// Lines are grouped by file, keeping their order within each file, and
+// each file gets as few writev calls as it takes.
+
+static bool writeAll(int fd, std::vector<iovec>& iov) {
+    size_t start = 0;
+    while(start < iov.size()) {
+        int count = (int)std::min<size_t>(iov.size() - start, IOV_MAX);
+        ssize_t n = writev(fd, &iov[start], count);
+        if(n < 0) {
+            if(errno == EINTR)
+                continue;
+            return(false);
+        }
+        // Step past whatever was written, including part of an iovec
+        while(n > 0 && start < iov.size()) {
+            if((size_t)n >= iov[start].iov_len) {
+                n -= (ssize_t)iov[start].iov_len;
+                start++;
+            } else {
+                iov[start].iov_base = (char*)iov[start].iov_base + n;
+                iov[start].iov_len -= n;
+                n = 0;
+            }
+        }
+    }
+    return(true);
+}
+
+void LogWriter::writeBatch(std::vector<Entry>& batch) {
+    std::unordered_map<std::string_view, std::vector<size_t>> byFile;
+    std::vector<std::string_view> fileOrder;
+    for(size_t i = 0; i < batch.size(); i++) {
+        auto [it, added] = byFile.try_emplace(batch[i].file);
+        if(added)
+            fileOrder.push_back(batch[i].file);
+        it->second.push_back(i);
+    }
+
+    std::vector<std::string> lines;
+    std::vector<iovec> iov;
+    for(std::string_view name : fileOrder) {
+        const std::vector<size_t>& entries = byFile[name];
+        std::string fileName(name);
+        size_t next = 0;
+
+        while(next < entries.size()) {
+            lines.clear();
+            iov.clear();
+
+            // Everything up to the next close request
+            LogKind kind = batch[entries[next]].kind;
+            for(; next < entries.size() && !batch[entries[next]].close; next++)
+                lines.push_back(format(batch[entries[next]]));
+
+            if(!lines.empty()) {
+                OpenFile* file = open(fileName, kind);
+                if(file) {
+                    off_t size = 0;
+                    for(std::string& line : lines) {
+                        iov.push_back({line.data(), line.size()});
+                        size += (off_t)line.size();
+                    }
+                    if(!writeAll(file->fd, iov))
+                        std::clog << "LogWriter: Error writing " << fileName << ": " << strerror(errno) << std::endl;
+                    file->size += size;
+                    file->lastWrite = time(nullptr);
+                }
+            }
+
+            if(next < entries.size()) {
+                // A close request: the caller is about to read, move or remove the file
+                auto it = files.find(fileName);
+                if(it != files.end()) {
+                    close(it->second.fd);
+                    files.erase(it);
+                }
+                next++;
+            }
+        }
+    }
+    batch.clear();
+}
+
+//*********************************************************************
+//                      format
+//*********************************************************************
+
+static void jsonEscape(std::string& out, std::string_view str) {
+    for(char c : str) {
+        switch(c) {
+            case '"':  out += "\\\""; break;
+            case '\\': out += "\\\\"; break;
+            case '\n': out += "\\n"; break;
+            case '\r': out += "\\r"; break;
+            case '\t': out += "\\t"; break;
+            default:
+                if((unsigned char)c < 0x20) {
+                    char buf[8];
+                    snprintf(buf, sizeof(buf), "\\u%04x", (unsigned char)c);
+                    out += buf;
+                } else {
+                    out += c;
+                }
+        }
+    }
+}
+
+std::string LogWriter::format(const Entry& entry) const {
+    std::string line;
+    if(entry.kind == LogKind::Game && json.load(std::memory_order_relaxed)) {
+        char stamp[32];
+        struct tm tm{};
+        gmtime_r(&entry.time, &tm);
+        strftime(stamp, sizeof(stamp), "%Y-%m-%dT%H:%M:%SZ", &tm);
+
+        std::string_view text = entry.text;
+        while(!text.empty() && (text.back() == '\n' || text.back() == '\r'))
+            text.remove_suffix(1);
+
+        line.reserve(text.size() + entry.name.size() + 48);
+        line += "{\"time\":\"";
+        line += stamp;
+        line += "\",\"log\":\"";
+        jsonEscape(line, entry.name);
+        line += "\",\"message\":\"";
+        jsonEscape(line, text);
+        line += "\"}\n";
+        return(line);
+    }
+
+    // Same as it's always been: ctime, minus its newline, then the text
+    char stamp[32];
+    ctime_r(&entry.time, stamp);
+    stamp[24] = '\0';
+    line.reserve(entry.text.size() + 26);
+    line += stamp;
+    line += ": ";
+    line += entry.text;
+    return(line);
+}
+
+//*********************************************************************
+//                      open
+//*********************************************************************
+
+LogWriter::OpenFile* LogWriter::open(const std::string& name, LogKind kind) {
+    time_t now = time(nullptr);
+    auto it = files.find(name);
+
+    if(it != files.end() && kind == LogKind::Game) {
+        off_t maxBytes = rotateBytes.load(std::memory_order_relaxed);
+        long maxAge = rotateAge.load(std::memory_order_relaxed);
+        OpenFile& file = it->second;
+        if(file.size > 0 && ((maxBytes && file.size >= maxBytes) || (maxAge && now - file.opened >= maxAge))) {
+            rotate(name, file);
+            files.erase(it);
+            it = files.end();
+        }
+    }
+    if(it != files.end())
+        return(&it->second);
+
+    int fd = ::open(name.c_str(), O_WRONLY | O_APPEND | O_CREAT | O_CLOEXEC, ACC);
+    if(fd < 0) {
+        std::clog << "Unable to open '" << name << "'\n";
+        return(nullptr);
+    }
+
+    OpenFile file;
+    file.fd = fd;
+    file.opened = file.lastWrite = now;
+    struct stat st{};
+    if(fstat(fd, &st) == 0)
+        file.size = st.st_size;
+    return(&files.insert_or_assign(name, file).first->second);
+}
+
+//*********************************************************************
+//                      rotate
+//*********************************************************************
+// log.txt becomes log.20211231-235959.txt and a fresh log.txt is started
+
+void LogWriter::rotate(const std::string& name, OpenFile& file) {
+    close(file.fd);
+    file.fd = -1;
+
+    char stamp[32];
+    struct tm tm{};
+    time_t now = time(nullptr);
+    localtime_r(&now, &tm);
+    strftime(stamp, sizeof(stamp), "%Y%m%d-%H%M%S", &tm);
+
+    // More than one rotation in a second gets a counter as well
+    fs::path path = name;
+    std::string base = (path.parent_path() / path.stem()).string() + "." + stamp;
+    std::string extension = path.extension().string();
+    fs::path rotated = base + extension;
+    std::error_code ec;
+    for(int n = 1; fs::exists(rotated, ec); n++)
+        rotated = base + "." + std::to_string(n) + extension;
+
+    if(::rename(name.c_str(), rotated.c_str()) != 0)
+        std::clog << "LogWriter: Unable to rotate " << name << ": " << strerror(errno) << std::endl;
+}
+
+//*********************************************************************
+//                      closeIdle
+//*********************************************************************
+
+void LogWriter::closeIdle(time_t now) {
+    std::erase_if(files, [now](auto& entry) {
+        if(now - entry.second.lastWrite < IDLE_CLOSE)
+            return(false);
+        close(entry.second.fd);
+        return(true);
+    });
+}
+
+//*********************************************************************
+//                      writeNow
+//*********************************************************************
+
+void LogWriter::writeNow(const Entry& entry) {
+    int fd = ::open(entry.file.c_str(), O_WRONLY | O_APPEND | O_CREAT | O_CLOEXEC, ACC);
+    if(fd < 0) {
+        std::clog << "Unable to open '" << entry.file << "'\n";
+        return;
+    }
+    std::string line = format(entry);
+    const char* data = line.data();
+    size_t left = line.size();
+    while(left) {
+        ssize_t n = ::write(fd, data, left);
+        if(n < 0) {
+            if(errno == EINTR)
+                continue;
+            break;
+        }
+        data += n;
+        left -= n;
+    }
+    close(fd);
+}
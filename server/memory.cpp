@@ -82,7 +82,7 @@ void Server::showMemory(std::shared_ptr<Socket> sock, bool extended) {
     ttag    *tlk;
 
     for(const auto& it : roomCache) {
-        std::shared_ptr<UniqueRoom>& r = it.second->second;
+        const std::shared_ptr<UniqueRoom>& r = it.second;
         if(!r)
             continue;
         rooms++;
@@ -159,10 +159,18 @@ void Server::showMemory(std::shared_ptr<Socket> sock, bool extended) {
     sock->print("Total Memory:    %ld  (%s)\n\n", total, sizeInfo(total).c_str());
 
     sock->print("\n\n");
+    showCacheStats(sock, extended);
+}
+
+//*********************************************************************
+//                      showCacheStats
+//*********************************************************************
+
+void Server::showCacheStats(std::shared_ptr<Socket> sock, bool extended) {
     sock->print("Cache Stats:\n");
-    sock->print("Room: %s\n", gServer->roomCache.get_stat_info(extended).c_str());
-    sock->print("Monster: %s\n", gServer->monsterCache.get_stat_info(extended).c_str());
-    sock->print("Object: %s\n", gServer->objectCache.get_stat_info(extended).c_str());
+    sock->print("Room: %s\n", roomCache.get_stat_info(extended).c_str());
+    sock->print("Monster: %s\n", monsterCache.get_stat_info(extended).c_str());
+    sock->print("Object: %s\n", objectCache.get_stat_info(extended).c_str());
 }
 
 //*********************************************************************
@@ -177,3 +185,16 @@ int dmMemory(const std::shared_ptr<Player>& player, cmd* cmnd) {
 	gServer->showMemory(player->getSock(), extended);
     return(0);
 }
+
+//*********************************************************************
+//                      dmCacheStats
+//*********************************************************************
+
+int dmCacheStats(const std::shared_ptr<Player>& player, cmd* cmnd) {
+	bool extended = false;
+	if(cmnd->num==2 && !strcmp(cmnd->str[1], "-h"))
+		extended = true;
+
+	gServer->showCacheStats(player->getSock(), extended);
+    return(0);
+}
@@ -17,6 +17,7 @@
  */
 
 #include <arpa/telnet.h>               // for IAC, SB, SE
+#include <chrono>                      // for steady_clock, milliseconds
 #include <cmath>                       // for floor, round
 #include <functional>                  // for function, operator==
 #include <list>                        // for operator==, list, _List_const_...
@@ -41,31 +42,165 @@
 #include "mudObjects/players.hpp"      // for Player
 #include "mudObjects/rooms.hpp"        // for BaseRoom, ExitList
 #include "mudObjects/uniqueRooms.hpp"  // for UniqueRoom
-#include "server.hpp"                  // for Server, SocketList
+#include "server.hpp"                  // for Server, SocketTable
 #include "socket.hpp"                  // for Socket, MSDP_VAL, MSDP_VAR
 #include "stats.hpp"                   // for Stat
-#include "timer.hpp"                   // for Timer
 
 #define MSDP_DEBUG
 
+void debugMsdp(std::string_view str);
+
+//*********************************************************************
+//                      processMsdp
+//*********************************************************************
+// Sockets are queued when something they report on publishes a change, or
+// when one of their polled variables comes due.  Each queued socket gets a
+// single MSDP frame with everything that changed.
+
 void Server::processMsdp() {
+    long now = msdp::now();
+
     for(const auto& sock : sockets) {
-        if(sock->getState() == CON_DISCONNECTING)
-            continue;
+        if(sock->msdpPollDue(now))
+            queueMsdp(sock);
+    }
+
+    std::vector<std::weak_ptr<Socket>> toFlush;
+    toFlush.swap(msdpQueue);
+    for(const auto& weakSock : toFlush) {
+        if(auto sock = weakSock.lock())
+            sock->msdpFlush(now);
+    }
+}
+
+void Server::queueMsdp(const std::shared_ptr<Socket>& sock) {
+    if(sock->msdpQueued)
+        return;
+    sock->msdpQueued = true;
+    msdpQueue.push_back(sock);
+}
 
-        if(sock->mccpEnabled()) {
-            for(auto& [vName, var] : sock->msdpReporting) {
-                if(var.getRequiresPlayer() && (!sock->getPlayer() || sock->getState() != CON_PLAYING)) continue;
-                if(!var.checkTimer()) continue;
+//*********************************************************************
+//                      publishMsdp
+//*********************************************************************
+// Let anyone whose MSDP variables depend on this creature know it changed:
+// the creature's own socket, anyone targeting it, and its group.
 
-                var.update();
-                if(!var.isDirty()) continue;
+void Creature::publishMsdp(MsdpEvent event) {
+    if(auto sock = getSock())
+        sock->msdpNotify(event);
 
-                var.send(*sock);
-                var.setDirty(false);
-            }
+    if(event == MsdpEvent::Health || event == MsdpEvent::Stats) {
+        MsdpEvent targetEvent = event == MsdpEvent::Health ? MsdpEvent::TargetHealth : MsdpEvent::TargetStats;
+        for(const auto& weakTargeter : targetingThis) {
+            auto targeter = weakTargeter.lock();
+            if(auto sock = targeter ? targeter->getSock() : nullptr)
+                sock->msdpNotify(targetEvent);
+        }
+    }
+
+    if(event == MsdpEvent::Health || event == MsdpEvent::Mana || event == MsdpEvent::Room || event == MsdpEvent::Affects) {
+        if(Group* group = getGroup())
+            group->publishMsdp();
+    }
+}
+
+void Creature::statChanged(const Stat& stat) {
+    if(&stat == &hp)
+        publishMsdp(MsdpEvent::Health);
+    else if(&stat == &mp)
+        publishMsdp(MsdpEvent::Mana);
+    else if(&stat == &strength || &stat == &dexterity || &stat == &constitution || &stat == &intelligence || &stat == &piety)
+        publishMsdp(MsdpEvent::Stats);
+}
+
+void Group::publishMsdp() {
+    for(const auto& weakMember : members) {
+        auto member = weakMember.lock();
+        if(auto sock = member ? member->getSock() : nullptr)
+            sock->msdpNotify(MsdpEvent::Group);
+    }
+}
+
+//*********************************************************************
+//                      msdpNotify
+//*********************************************************************
+
+void Socket::msdpNotify(MsdpEvent event) {
+    uint32_t bit = msdpEventBit(event);
+    if(!(msdpSubscribed & bit))
+        return;
+    msdpPending |= bit;
+    gServer->queueMsdp(shared_from_this());
+}
+
+//*********************************************************************
+//                      msdpResubscribe
+//*********************************************************************
+// Recalculate which events we care about after the reported list changes
+
+void Socket::msdpResubscribe() {
+    msdpSubscribed = 0;
+    msdpNextPoll = 0;
+    for(auto& [vName, var] : msdpReporting) {
+        msdpSubscribed |= var.getEvents();
+        if(var.isPolled() && (!msdpNextPoll || var.getNextUpdate() < msdpNextPoll))
+            msdpNextPoll = var.getNextUpdate();
+    }
+}
+
+bool Socket::msdpPollDue(long now) const {
+    return(msdpNextPoll && msdpNextPoll <= now);
+}
+
+//*********************************************************************
+//                      msdpFlush
+//*********************************************************************
+
+void Socket::msdpFlush(long now) {
+    uint32_t events = msdpPending;
+    msdpPending = 0;
+    msdpQueued = false;
+    msdpNextPoll = 0;
+
+    if(getState() == CON_DISCONNECTING || !msdpEnabled())
+        return;
+
+    bool playing = (getPlayer() && getState() == CON_PLAYING);
+    std::string frame;
+    for(auto& [vName, var] : msdpReporting) {
+        if(var.getRequiresPlayer() && !playing) {
+            // Try again once they've finished logging in
+            if(!msdpNextPoll || now + 1000 < msdpNextPoll)
+                msdpNextPoll = now + 1000;
+            continue;
         }
+
+        bool due = var.isPolled() && var.checkTimer(now);
+        if(due || var.isStale() || (events & var.getEvents()))
+            var.update();
+        if(var.isPolled() && (!msdpNextPoll || var.getNextUpdate() < msdpNextPoll))
+            msdpNextPoll = var.getNextUpdate();
+
+        if(!var.isDirty())
+            continue;
+        frame += (char)MSDP_VAR;
+        frame += var.getName();
+        frame += (char)MSDP_VAL;
+        frame += var.getValue();
+        var.setDirty(false);
     }
+
+    if(frame.empty())
+        return;
+
+    frame.insert(frame.begin(), {(char)IAC, (char)SB, (char)TELOPT_MSDP});
+    frame += (char)IAC;
+    frame += (char)SE;
+#ifdef MSDP_DEBUG
+    debugMsdp(frame);
+#endif
+    write(frame);
 }
 
 bool Socket::processMsdpVarVal(const std::string &variable, const std::string &value) {
@@ -108,6 +243,7 @@ bool Socket::processMsdpVarVal(const std::string &variable, const std::string &v
                     return(false);
 
                 reportedVar->setValue(value);
+                gServer->queueMsdp(shared_from_this());
 #ifdef MSDP_DEBUG
                 std::clog << "processMsdpVarVal: Set configurable variable '" << variable << "' to '" << value << "'" << std::endl;
 #endif
@@ -222,6 +358,9 @@ ReportedMsdpVariable* Socket::msdpReport(const std::string &value) {
     }
 
     msdpReporting.emplace(msdpVar->getName(), ReportedMsdpVariable(msdpVar, shared_from_this()));
+    msdpResubscribe();
+    // Send the current value right away
+    gServer->queueMsdp(shared_from_this());
 #ifdef MSDP_DEBUG
     std::clog << "MsdpHandleReport: Now Reporting '" << msdpVar->getName() << "'" << std::endl;
 #endif
@@ -238,6 +377,7 @@ bool Socket::msdpReset(std::string& value) {
 
 void Socket::msdpClearReporting() {
     msdpReporting.clear();
+    msdpResubscribe();
 }
 
 bool Socket::msdpSend(const std::string &variable) {
@@ -262,6 +402,7 @@ bool Socket::msdpUnReport(const std::string &value) {
         std::clog << "MsdpHandleUnReport: No longer reporting '" << value << "'" << std::endl;
 #endif
         msdpReporting.erase(it);
+        msdpResubscribe();
         return (true);
     }
 }
@@ -378,9 +519,12 @@ ReportedMsdpVariable::ReportedMsdpVariable(const MsdpVariable* mv, std::shared_p
     updateable = mv->updateable;
     updateInterval = mv->getUpdateInterval();
     reportable = mv->isReportable();
-    timer.setDelay(updateInterval);
+    requiresPlayer = mv->getRequiresPlayer();
+    events = mv->getEvents();
+    nextUpdate = msdp::now();
 
     dirty = true;
+    stale = true;
     value = "unknown";
 }
 
@@ -408,6 +552,14 @@ int MsdpVariable::getUpdateInterval() const {
     return(updateInterval);
 }
 
+uint32_t MsdpVariable::getEvents() const {
+    return(events);
+}
+
+bool MsdpVariable::isPolled() const {
+    return(updateable && !events);
+}
+
 bool MsdpVariable::hasValueFn() const {
     return(valueFn != nullptr);
 }
@@ -442,13 +594,24 @@ std::string ReportedMsdpVariable::getValue() const {
     return(value);
 }
 
-bool ReportedMsdpVariable::checkTimer() {
-    if(timer.hasExpired()) {
-        timer.update(getUpdateInterval());
-        return(true);
-    } else {
+bool ReportedMsdpVariable::checkTimer(long now) {
+    if(now < nextUpdate)
         return(false);
-    }
+    // updateInterval is in tenths of a second
+    nextUpdate = now + getUpdateInterval() * 100L;
+    return(true);
+}
+
+long ReportedMsdpVariable::getNextUpdate() const {
+    return(nextUpdate);
+}
+
+bool ReportedMsdpVariable::isStale() const {
+    return(stale);
+}
+
+void ReportedMsdpVariable::setStale() {
+    stale = true;
 }
 
 void ReportedMsdpVariable::setValue(std::string_view newValue) {
@@ -471,11 +634,11 @@ bool ReportedMsdpVariable::isDirty() const {
 }
 
 void ReportedMsdpVariable::update() {
+    stale = false;
     if(!isUpdatable()) return;
     auto sock = parentSock.lock();
     if(!sock) return;
 
-    std::string oldValue = value;
     setValue(MsdpVariable::valueFn(*sock, sock->getPlayer()));
 }
 
@@ -679,6 +842,10 @@ namespace msdp {
     const std::string UNKNOWN_STR = "unknown";
     const std::string NONE_STR = "none";
 
+    long now() {
+        return(std::chrono::duration_cast<std::chrono::milliseconds>(std::chrono::steady_clock::now().time_since_epoch()).count());
+    }
+
     std::string getServerId(Socket &sock, const std::shared_ptr<Player>& player) {
         return (gConfig->getMudNameAndVersion());
     }
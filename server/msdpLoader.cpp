@@ -43,34 +43,42 @@ bool Config::initMsdp() {
     addToSet(MsdpBuilder().name("HEALTH").valueFn(msdp::getHealth)
         .reportable(true).requiresPlayer(true).configurable(false)
         .writeOnce(false).updateInterval(5).updateable(true).isGroup(false)
+        .on(MsdpEvent::Health)
       , msdpVariables);
     addToSet(MsdpBuilder().name("HEALTH_MAX").valueFn(msdp::getHealthMax)
         .reportable(true).requiresPlayer(true).configurable(false)
         .writeOnce(false).updateInterval(5).updateable(true).isGroup(false)
+        .on(MsdpEvent::Health)
       , msdpVariables);
     addToSet(MsdpBuilder().name("MANA").valueFn(msdp::getMana)
         .reportable(true).requiresPlayer(true).configurable(false)
         .writeOnce(false).updateInterval(5).updateable(true).isGroup(false)
+        .on(MsdpEvent::Mana)
       , msdpVariables);
     addToSet(MsdpBuilder().name("MANA_MAX").valueFn(msdp::getManaMax)
         .reportable(true).requiresPlayer(true).configurable(false)
         .writeOnce(false).updateInterval(5).updateable(true).isGroup(false)
+        .on(MsdpEvent::Mana)
       , msdpVariables);
     addToSet(MsdpBuilder().name("EXPERIENCE").valueFn(msdp::getExperience)
         .reportable(true).requiresPlayer(true).configurable(false)
         .writeOnce(false).updateInterval(10).updateable(true).isGroup(false)
+        .on(MsdpEvent::Experience)
       , msdpVariables);
     addToSet(MsdpBuilder().name("EXPERIENCE_MAX").valueFn(msdp::getExperienceMax)
         .reportable(true).requiresPlayer(true).configurable(false)
         .writeOnce(false).updateInterval(10).updateable(true).isGroup(false)
+        .on(MsdpEvent::Experience)
       , msdpVariables);
     addToSet(MsdpBuilder().name("EXPERIENCE_TNL").valueFn(msdp::getExperienceTNL)
         .reportable(true).requiresPlayer(true).configurable(false)
         .writeOnce(false).updateInterval(10).updateable(true).isGroup(false)
+        .on(MsdpEvent::Experience)
       , msdpVariables);
     addToSet(MsdpBuilder().name("EXPERIENCE_TNL_MAX").valueFn(msdp::getExperienceTNLMax)
         .reportable(true).requiresPlayer(true).configurable(false)
         .writeOnce(false).updateInterval(10).updateable(true).isGroup(false)
+        .on(MsdpEvent::Experience)
       , msdpVariables);
     addToSet(MsdpBuilder().name("WIMPY").valueFn(msdp::getWimpy)
         .reportable(true).requiresPlayer(true).configurable(false)
@@ -95,30 +103,40 @@ bool Config::initMsdp() {
     addToSet(MsdpBuilder().name("GROUP").valueFn(msdp::getGroup)
         .reportable(true).requiresPlayer(true).configurable(false)
         .writeOnce(false).updateInterval(10).updateable(true).isGroup(true)
+        .on(MsdpEvent::Group)
       , msdpVariables);
     addToSet(MsdpBuilder().name("TARGET").valueFn(msdp::getTarget)
         .reportable(true).requiresPlayer(true).configurable(false)
         .writeOnce(false).updateInterval(5).updateable(true).isGroup(false)
+        .on(MsdpEvent::Target)
       , msdpVariables);
     addToSet(MsdpBuilder().name("TARGET_ID").valueFn(msdp::getTargetID)
         .reportable(true).requiresPlayer(true).configurable(false)
         .writeOnce(false).updateInterval(5).updateable(true).isGroup(false)
+        .on(MsdpEvent::Target)
       , msdpVariables);
     addToSet(MsdpBuilder().name("TARGET_HEALTH").valueFn(msdp::getTargetHealth)
         .reportable(true).requiresPlayer(true).configurable(false)
         .writeOnce(false).updateInterval(5).updateable(true).isGroup(false)
+        .on(MsdpEvent::Target)
+        .on(MsdpEvent::TargetHealth)
       , msdpVariables);
     addToSet(MsdpBuilder().name("TARGET_HEALTH_MAX").valueFn(msdp::getTargetHealthMax)
         .reportable(true).requiresPlayer(true).configurable(false)
         .writeOnce(false).updateInterval(10).updateable(true).isGroup(false)
+        .on(MsdpEvent::Target)
+        .on(MsdpEvent::TargetHealth)
       , msdpVariables);
     addToSet(MsdpBuilder().name("TARGET_STRENGTH").valueFn(msdp::getTargetStrength)
         .reportable(true).requiresPlayer(true).configurable(false)
         .writeOnce(false).updateInterval(10).updateable(true).isGroup(false)
+        .on(MsdpEvent::Target)
+        .on(MsdpEvent::TargetStats)
       , msdpVariables);
     addToSet(MsdpBuilder().name("ROOM").valueFn(msdp::getRoom)
         .reportable(true).requiresPlayer(true).configurable(false)
         .writeOnce(false).updateInterval(5).updateable(true).isGroup(false)
+        .on(MsdpEvent::Room)
       , msdpVariables);
     addToSet(MsdpBuilder().name("CLIENT_ID")
         .reportable(true).requiresPlayer(false).configurable(true)
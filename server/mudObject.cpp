@@ -24,7 +24,7 @@
 #include <typeinfo>                    // for type_info
 #include "hooks.hpp"                   // for Hooks
 #include "mudObjects/areaRooms.hpp"    // for AreaRoom
-#include "mudObjects/container.hpp"    // for MonsterPtrLess, ObjectPtrLess
+#include "mudObjects/container.hpp"    // for Container
 #include "mudObjects/creatures.hpp"    // for Creature
 #include "mudObjects/exits.hpp"        // for Exit
 #include "mudObjects/monsters.hpp"     // for Monster
@@ -40,6 +40,7 @@
 void MudObject::setName(std::string_view newName) {
     removeFromSet();
     name = newName;
+    refreshKeyTxt();
     addToSet();
 }
 
@@ -55,6 +56,9 @@ void MudObject::removeFromSet() {
 }
 void MudObject::addToSet() {
 
+}
+void MudObject::refreshKeyTxt() {
+
 }
 
 
@@ -101,21 +105,6 @@ void MudObject::registerContainedItems() {
 void MudObject::unRegisterContainedItems() {
 }
 
-bool PlayerPtrLess::operator()(const std::weak_ptr<Player>& lhs, const std::weak_ptr<Player>& rhs) const {
-    auto llhs = lhs.lock(), lrhs = rhs.lock();
-    return *llhs < *lrhs;
-}
-
-bool MonsterPtrLess::operator()(const std::shared_ptr<Monster>&  lhs, const std::shared_ptr<Monster>&  rhs) const {
-    std::string lhsStr = lhs->getName() + lhs->id;
-    std::string rhsStr = rhs->getName() + rhs->id;
-    return(lhsStr.compare(rhsStr) < 0);
-}
-
-bool ObjectPtrLess::operator()(const std::shared_ptr<Object>&  lhs, const std::shared_ptr<Object>&  rhs) const {
-    return *lhs < *rhs;
-}
-
 MudObject::MudObject(): hooks(this) {
     moReset();
 }
@@ -0,0 +1,272 @@
+/*
+ * networkIo.cpp
+ *   Threads that read from and write to the players' sockets
+ *   ____            _
+ *  |  _ \ ___  __ _| |_ __ ___  ___
+ *  | |_) / _ \/ _` | | '_ ` _ \/ __|
+ *  |  _ <  __/ (_| | | | | | | \__ \
+ *  |_| \_\___|\__,_|_|_| |_| |_|___/
+ *
+ * Permission to use, modify and distribute is granted via the
+ *  GNU Affero General Public License v3 or later
+ *
+ *  Copyright (C) 2007-2021 Jason Mitchell, Randi Mitchell
+ *     Contributions by Tim Callahan, Jonathan Hseu
+ *  Based on Mordor (C) Brooke Paul, Brett J. Vickers, John P. Freeman
+ *
+ */
+
+#include <sys/epoll.h>             // for EPOLLIN, EPOLLOUT, EPOLLRDHUP
+#include <sys/eventfd.h>           // for eventfd, eventfd_read, eventfd_write
+#include <unistd.h>                // for close
+#include <cstring>                 // for strerror
+#include <iostream>                // for operator<<, clog
+
+#include "networkIo.hpp"           // for NetworkIo
+#include "socketIo.hpp"            // for SocketIo
+
+//*********************************************************************
+//                      NetworkIo
+//*********************************************************************
+// The threads aren't started until the first socket is added
+
+NetworkIo::NetworkIo() = default;
+
+NetworkIo::~NetworkIo() {
+    stop();
+    for(auto& worker : workers)
+        ::close(worker->wakeFd);
+}
+
+void NetworkIo::start() {
+    for(int i = 0; i < NETWORK_IO_THREADS; i++) {
+        auto worker = std::make_unique<Worker>();
+        worker->wakeFd = eventfd(0, EFD_NONBLOCK | EFD_CLOEXEC);
+        if(worker->wakeFd < 0)
+            std::clog << "NetworkIo: Error with eventfd: " << strerror(errno) << std::endl;
+        worker->reactor.watch(worker->wakeFd, WatchType::WAKEUP);
+        workers.push_back(std::move(worker));
+    }
+    // Too late for threads; queue() will do the work itself
+    if(stopped)
+        return;
+    for(auto& worker : workers)
+        worker->thread = std::thread(&NetworkIo::run, this, std::ref(*worker));
+}
+
+//*********************************************************************
+//                      add
+//*********************************************************************
+
+void NetworkIo::add(const std::shared_ptr<SocketIo>& sock) {
+    if(workers.empty())
+        start();
+
+    sock->network = this;
+    sock->worker = nextWorker;
+    nextWorker = (nextWorker + 1) % NETWORK_IO_THREADS;
+
+    // Whatever was written before now goes out with the first service
+    sock->queued.store(true);
+    queue(sock);
+}
+
+//*********************************************************************
+//                      queue
+//*********************************************************************
+
+void NetworkIo::queue(const std::shared_ptr<SocketIo>& sock) {
+    Worker& worker = *workers[sock->worker];
+    // The threads are gone, so it's safe to do the work here
+    if(stopped) {
+        service(worker, sock);
+        return;
+    }
+    worker.pending.push(sock);
+    worker.dirty.store(true, std::memory_order_release);
+}
+
+//*********************************************************************
+//                      kick
+//*********************************************************************
+// Called once a pass, after the game has done its writing
+
+void NetworkIo::kick() {
+    for(auto& worker : workers) {
+        if(worker->dirty.load(std::memory_order_relaxed) && worker->dirty.exchange(false, std::memory_order_acq_rel))
+            eventfd_write(worker->wakeFd, 1);
+    }
+}
+
+//*********************************************************************
+//                      stats
+//*********************************************************************
+
+void NetworkIo::collectStats(long& inBytes, long& outBytes) {
+    inBytes += bytesIn.exchange(0, std::memory_order_relaxed);
+    outBytes += bytesOut.exchange(0, std::memory_order_relaxed);
+}
+
+void NetworkIo::countIn(long n) {
+    bytesIn.fetch_add(n, std::memory_order_relaxed);
+}
+
+void NetworkIo::countOut(long n) {
+    bytesOut.fetch_add(n, std::memory_order_relaxed);
+}
+
+//*********************************************************************
+//                      stop
+//*********************************************************************
+
+void NetworkIo::stop() {
+    if(stopped)
+        return;
+    stopping.store(true, std::memory_order_release);
+    for(auto& worker : workers) {
+        eventfd_write(worker->wakeFd, 1);
+        if(worker->thread.joinable())
+            worker->thread.join();
+    }
+    stopped = true;
+}
+
+//*********************************************************************
+//                      run
+//*********************************************************************
+
+void NetworkIo::run(Worker& worker) {
+    while(true) {
+        // Checked before draining, so everything queued before stop() still gets done
+        bool finishing = stopping.load(std::memory_order_acquire);
+        drain(worker);
+        if(finishing)
+            break;
+
+        expireLingering(worker, false);
+        if(worker.reactor.wait(1000) < 0)
+            continue;
+
+        for(const Reactor::Event& event : worker.reactor.getEvents()) {
+            if(event.type == WatchType::WAKEUP) {
+                eventfd_t count;
+                eventfd_read(worker.wakeFd, &count);
+                continue;
+            }
+
+            auto it = worker.sockets.find(event.fd);
+            if(it == worker.sockets.end())
+                continue;
+            std::shared_ptr<SocketIo> sock = it->second;
+
+            if(sock->closing) {
+                linger(worker, sock);
+                continue;
+            }
+
+            // Errors and hangups get picked up by the read
+            if(event.events & (EPOLLIN | EPOLLRDHUP | EPOLLHUP | EPOLLERR))
+                sock->readInput();
+            if(event.events & EPOLLOUT) {
+                sock->writeReady = true;
+                sock->writeOutput();
+                worker.reactor.setWriteInterest(sock->fd, !sock->writeReady);
+            }
+        }
+    }
+    expireLingering(worker, true);
+}
+
+void NetworkIo::drain(Worker& worker) {
+    std::shared_ptr<SocketIo> sock;
+    while(worker.pending.pop(sock))
+        service(worker, sock);
+}
+
+//*********************************************************************
+//                      service
+//*********************************************************************
+// Starts watching new sockets, sends whatever the game has queued, closes
+// the socket if it asked to be and picks up reading where it left off
+
+void NetworkIo::service(Worker& worker, const std::shared_ptr<SocketIo>& sock) {
+    // Cleared first: anything queued from here on gets the socket put back on the list
+    sock->queued.store(false);
+
+    if(!sock->watched && !sock->closing && !stopped) {
+        // If there's input already waiting the reactor reports it straight away
+        worker.reactor.watch(sock->fd, WatchType::SOCKET);
+        worker.sockets[sock->fd] = sock;
+        sock->watched = true;
+    }
+
+    if(sock->closing)
+        return;
+    if(sock->serviceOutput()) {
+        sock->closing = true;
+        sock->closeBy = std::chrono::steady_clock::now() + NETWORK_IO_LINGER;
+        if(sock->watched && !stopped)
+            worker.lingering.push_back(sock);
+        linger(worker, sock);
+        return;
+    }
+
+    // Reading stopped when the socket's input filled up, and the game has since taken a line
+    if(sock->paused && sock->watched && !stopped && !sock->throttled.load())
+        sock->readInput();
+
+    if(sock->watched)
+        worker.reactor.setWriteInterest(sock->fd, !sock->writeReady);
+}
+
+//*********************************************************************
+//                      linger
+//*********************************************************************
+// A socket the game has closed stays watched until the last of its output
+// has gone out (or can't), so a goodbye isn't cut off; input is ignored.
+
+void NetworkIo::linger(Worker& worker, const std::shared_ptr<SocketIo>& sock) {
+    if(!sock->watched || stopped) {
+        finishClose(worker, sock);
+        return;
+    }
+
+    sock->writeReady = true;
+    sock->writeOutput();
+    // Still ready with output left means the write failed
+    if(sock->outQueue.empty() || sock->writeReady) {
+        finishClose(worker, sock);
+        return;
+    }
+    worker.reactor.setWriteInterest(sock->fd, true);
+}
+
+void NetworkIo::finishClose(Worker& worker, const std::shared_ptr<SocketIo>& sock) {
+    if(sock->fdClosed)
+        return;
+    if(sock->watched) {
+        worker.reactor.unwatch(sock->fd);
+        worker.sockets.erase(sock->fd);
+        sock->watched = false;
+    }
+    ::close(sock->fd);
+    sock->fdClosed = true;
+}
+
+//*********************************************************************
+//                      expireLingering
+//*********************************************************************
+// Closes the sockets that are done or out of time (or all of them, when the
+// thread is on its way out)
+
+void NetworkIo::expireLingering(Worker& worker, bool all) {
+    if(worker.lingering.empty())
+        return;
+    auto now = std::chrono::steady_clock::now();
+    std::erase_if(worker.lingering, [&](const std::shared_ptr<SocketIo>& sock) {
+        if(sock->watched && !all && now < sock->closeBy)
+            return(false);
+        finishClose(worker, sock);
+        return(true);
+    });
+}
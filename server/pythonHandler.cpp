@@ -16,8 +16,12 @@
  *
  */
 
+#include <algorithm>                 // for sort
 #include <array>                     // for array
+#include <chrono>                    // for steady_clock, duration
 #include <cstdlib>                   // for getenv, setenv
+#include <cstring>                   // for strcmp
+#include <ctime>                     // for time, time_t
 #include <ostream>                   // for operator<<, basic_ostream, endl
 #include <pybind11/cast.h>           // for cast, operator>>_a, object_api::...
 #include <pybind11/detail/common.h>  // for PYBIND11_CONCAT
@@ -27,17 +31,20 @@
 #include <pybind11/pytypes.h>        // for object, dict, error_already_set
 #include <string>                    // for string, allocator, char_traits
 
+#include "cmd.hpp"                   // for cmd
 #include "config.hpp"                // for gConfig
 #include "mudObjects/areaRooms.hpp"  // for AreaRoom
 #include "mudObjects/mudObject.hpp"  // for MudObject
 #include "mudObjects/monsters.hpp"   // for Monster
 #include "mudObjects/objects.hpp"    // for Object
+#include "mudObjects/players.hpp"    // for Player
 #include "mudObjects/uniqueRooms.hpp"// for UniqueRoom
 #include "paths.hpp"                 // for Python
 #include "proto.hpp"                 // for broadcast, isDm
 #include "pythonHandler.hpp"         // for PythonHandler
 #include "pythonrun.h"               // for PyErr_Print
 #include "server.hpp"                // for Server, gServer
+#include "socket.hpp"                // for Socket
 #include "tupleobject.h"             // for PyTuple_New
 
 class AreaRoom;
@@ -64,6 +71,13 @@ REALMS_MODULE(effects);
 REALMS_MODULE(stats);
 REALMS_MODULE(mudObject);
 
+// Most compiled scripts kept before the idle ones are thrown out
+static constexpr size_t MAX_SCRIPTS = 4096;
+// A script that hasn't run in this many seconds can be thrown out
+static constexpr time_t SCRIPT_IDLE = 3600;
+// Most locals dictionaries kept for reuse; more than scripts ever nest
+static constexpr size_t MAX_POOLED_LOCALS = 16;
+
 
 bool PythonHandler::initPython() {
     try {
@@ -122,24 +136,18 @@ bool PythonHandler::addMudObjectToDictionary(py::object& dictionary, const std::
         return true;
     }
 
-    std::shared_ptr<Monster>  mPtr = myObject->getAsMonster();
-    std::shared_ptr<Player> pPtr = myObject->getAsPlayer();
-    std::shared_ptr<Object>  oPtr = myObject->getAsObject();
-    std::shared_ptr<UniqueRoom> rPtr = myObject->getAsUniqueRoom();
-    std::shared_ptr<AreaRoom> aPtr = myObject->getAsAreaRoom();
-    std::shared_ptr<Exit> xPtr = myObject->getAsExit();
-
-    if (mPtr) {
-        dictionary[key.c_str()] = py::cast(mPtr);
-    } else if (pPtr) {
+    // Stop at the first cast that works; most scripts are handed players and monsters
+    if (auto pPtr = myObject->getAsPlayer()) {
         dictionary[key.c_str()] = py::cast(pPtr);
-    } else if (oPtr) {
+    } else if (auto mPtr = myObject->getAsMonster()) {
+        dictionary[key.c_str()] = py::cast(mPtr);
+    } else if (auto oPtr = myObject->getAsObject()) {
         dictionary[key.c_str()] = py::cast(oPtr);
-    } else if (rPtr) {
+    } else if (auto rPtr = myObject->getAsUniqueRoom()) {
         dictionary[key.c_str()] = py::cast(rPtr);
-    } else if (aPtr) {
+    } else if (auto aPtr = myObject->getAsAreaRoom()) {
         dictionary[key.c_str()] = py::cast(aPtr);
-    } else if (xPtr) {
+    } else if (auto xPtr = myObject->getAsExit()) {
         dictionary[key.c_str()] = py::cast(xPtr);
     } else {
         dictionary[key.c_str()] = py::cast(myObject);
@@ -147,11 +155,176 @@ bool PythonHandler::addMudObjectToDictionary(py::object& dictionary, const std::
     return true;
 }
 
+//*********************************************************************
+//                      getScript
+//*********************************************************************
+// Compile each distinct script once; after that every run is just an eval of
+// the cached code object.  A compile error isn't cached, so it is reported
+// every time the script is run, same as before.
+
+CompiledScript* PythonHandler::getScript(const std::string& pyScript, bool expression) {
+    time_t t = time(nullptr);
+    size_t key = std::hash<std::string>{}(pyScript) ^ (expression ? 0x9e3779b97f4a7c15UL : 0);
+
+    auto it = scripts.find(key);
+    if(it != scripts.end() && it->second.expression == expression && it->second.source == pyScript) {
+        it->second.lastUsed = t;
+        return(&it->second);
+    }
+
+    PyObject* code = Py_CompileString(pyScript.c_str(), "<script>", expression ? Py_eval_input : Py_file_input);
+    if(!code)
+        throw py::error_already_set();
+
+    if(it == scripts.end()) {
+        if(scripts.size() >= MAX_SCRIPTS)
+            pruneScripts(t);
+        it = scripts.emplace(key, CompiledScript()).first;
+    }
+
+    // New, or a hash collision with another script: this one takes the slot
+    CompiledScript& script = it->second;
+    script.source = pyScript;
+    script.code = py::reinterpret_steal<py::object>(code);
+    script.expression = expression;
+    script.calls = script.errors = 0;
+    script.totalTime = 0;
+    script.lastUsed = t;
+    return(&script);
+}
+
+//*********************************************************************
+//                      pruneScripts
+//*********************************************************************
+// Drop anything that hasn't run in a while; if that doesn't make room, drop the
+// least recently run script.  Scripts that are running are never touched.
+
+void PythonHandler::pruneScripts(time_t t) {
+    auto oldest = scripts.end();
+    for(auto it = scripts.begin(); it != scripts.end(); ) {
+        if(it->second.running) {
+            it++;
+        } else if(t - it->second.lastUsed >= SCRIPT_IDLE) {
+            it = scripts.erase(it);
+        } else {
+            if(oldest == scripts.end() || it->second.lastUsed < oldest->second.lastUsed)
+                oldest = it;
+            it++;
+        }
+    }
+
+    if(scripts.size() >= MAX_SCRIPTS && oldest != scripts.end())
+        scripts.erase(oldest);
+}
+
+void PythonHandler::clearScripts() {
+    for(auto it = scripts.begin(); it != scripts.end(); ) {
+        if(it->second.running)
+            it++;
+        else
+            it = scripts.erase(it);
+    }
+}
+
+//*********************************************************************
+//                      runCompiled
+//*********************************************************************
+
+py::object PythonHandler::runCompiled(const std::string& pyScript, py::object& locals, bool expression) {
+    CompiledScript* script = getScript(pyScript, expression);
+    // Hold our own reference in case a nested script replaces this entry
+    py::object code = script->code;
+
+    script->running++;
+    auto start = std::chrono::steady_clock::now();
+    PyObject* result = PyEval_EvalCode(code.ptr(), mainNamespace.ptr(), locals.ptr());
+    std::chrono::duration<double, std::micro> elapsed = std::chrono::steady_clock::now() - start;
+    script->running--;
+
+    script->calls++;
+    script->totalTime += elapsed.count();
+    if(!result) {
+        script->errors++;
+        throw py::error_already_set();
+    }
+    return(py::reinterpret_steal<py::object>(result));
+}
+
+//*********************************************************************
+//                      acquireLocals
+//*********************************************************************
+
+py::dict PythonHandler::acquireLocals() {
+    if(localsPool.empty())
+        return(py::dict());
+
+    py::dict locals = std::move(localsPool.back());
+    localsPool.pop_back();
+    return(locals);
+}
+
+void PythonHandler::releaseLocals(py::dict& locals) {
+    // If the script held on to its locals somewhere, let it keep them
+    if(!locals || locals.ref_count() != 1 || localsPool.size() >= MAX_POOLED_LOCALS)
+        return;
+
+    PyDict_Clear(locals.ptr());
+    localsPool.push_back(std::move(locals));
+}
+
+PooledLocals::PooledLocals() : py::dict(gServer->pythonHandler->acquireLocals()) {}
+
+PooledLocals::~PooledLocals() {
+    gServer->pythonHandler->releaseLocals(*this);
+}
+
+//*********************************************************************
+//                      showScriptStats
+//*********************************************************************
+
+void PythonHandler::showScriptStats(const std::shared_ptr<Socket>& sock, bool all) const {
+    std::vector<const CompiledScript*> sorted;
+    sorted.reserve(scripts.size());
+    for(const auto& [key, script] : scripts)
+        sorted.push_back(&script);
+    std::sort(sorted.begin(), sorted.end(), [](const CompiledScript* a, const CompiledScript* b) {
+        return(a->totalTime > b->totalTime);
+    });
+
+    sock->print("Python Scripts: %d compiled, %d pooled locals\n\n", (int)scripts.size(), (int)localsPool.size());
+    sock->print("%-9s %-6s %-10s %-9s %s\n", "Calls", "Errors", "Total ms", "Avg us", "Script");
+
+    size_t shown = 0;
+    for(const CompiledScript* script : sorted) {
+        if(!all && shown++ >= 20)
+            break;
+        // First line of the script is usually enough to recognize it
+        std::string name = script->source.substr(0, script->source.find('\n'));
+        if(name.size() > 40)
+            name = name.substr(0, 37) + "...";
+        sock->print("%-9ld %-6ld %-10.2f %-9.1f %s\n", script->calls, script->errors, script->totalTime / 1000,
+            script->calls ? script->totalTime / script->calls : 0.0, name.c_str());
+    }
+}
+
+//*********************************************************************
+//                      dmScriptStats
+//*********************************************************************
+
+int dmScriptStats(const std::shared_ptr<Player>& player, cmd* cmnd) {
+    if(cmnd->num == 2 && !strcmp(cmnd->str[1], "-clear")) {
+        gServer->pythonHandler->clearScripts();
+        player->print("Compiled python scripts cleared.\n");
+        return(0);
+    }
+
+    gServer->pythonHandler->showScriptStats(player->getSock(), cmnd->num == 2 && !strcmp(cmnd->str[1], "-a"));
+    return(0);
+}
+
 bool PythonHandler::runPython(const std::string& pyScript, py::object& locals) {
     try {
-        // Say hello
-        py::exec(pyScript, gServer->pythonHandler->mainNamespace, locals);
-
+        runCompiled(pyScript, locals, false);
     }  catch (py::error_already_set &e) {
         handlePythonError(e);
         return false;
@@ -167,7 +340,8 @@ bool PythonHandler::runPython(const std::string& pyScript, py::object& locals) {
 //  target:     The target of the script
 
 bool PythonHandler::runPython(const std::string& pyScript, const std::string &args, std::shared_ptr<MudObject>actor, std::shared_ptr<MudObject>target) {
-    auto locals = py::dict("args"_a=args);
+    PooledLocals locals;
+    locals["args"] = args;
 
     addMudObjectToDictionary(locals, "actor", actor);
     addMudObjectToDictionary(locals, "target", target);
@@ -177,9 +351,9 @@ bool PythonHandler::runPython(const std::string& pyScript, const std::string &ar
 
 bool PythonHandler::runPythonWithReturn(const std::string& pyScript, py::object& locals) {
     try {
-        // Note: Using eval here without specifying py::eval_statements; so it'll need to be one line
+        // Note: Compiled as an expression rather than statements; so it'll need to be one line
         // Additionally, we're expecting to call a function that returns a bool
-        return(py::eval(pyScript, gServer->pythonHandler->mainNamespace, locals).cast<bool>());
+        return(runCompiled(pyScript, locals, true).cast<bool>());
     }  catch (py::error_already_set &e) {
         handlePythonError(e);
         return false;
@@ -195,7 +369,8 @@ bool PythonHandler::runPythonWithReturn(const std::string& pyScript, py::object&
 bool PythonHandler::runPythonWithReturn(const std::string& pyScript, const std::string &args, std::shared_ptr<MudObject>actor, std::shared_ptr<MudObject>target) {
 
     try {
-        auto locals = py::dict("args"_a=args);
+        PooledLocals locals;
+        locals["args"] = args;
 
         addMudObjectToDictionary(locals, "actor", actor);
         addMudObjectToDictionary(locals, "target", target);
@@ -77,7 +77,7 @@ void Server::killMortalObjects() {
     std::list<std::shared_ptr<AreaRoom>> toDelete;
 
     for(const auto& it : roomCache) {
-        std::shared_ptr<UniqueRoom>& r = it.second->second;
+        const std::shared_ptr<UniqueRoom>& r = it.second;
         if(!r)
             continue;
         r->killMortalObjects();
@@ -109,7 +109,7 @@ void Server::killMortalObjects() {
 
 void Server::resaveAllRooms(char permonly) {
     for(const auto& it : roomCache) {
-        std::shared_ptr<UniqueRoom>& r = it.second->second;
+        const std::shared_ptr<UniqueRoom>& r = it.second;
         if(!r)
             continue;
 		r->saveToFile(permonly);
@@ -0,0 +1,162 @@
+/*
+ * reactor.cpp
+ *   Edge triggered epoll event loop for the server's descriptors
+ *   ____            _
+ *  |  _ \ ___  __ _| |_ __ ___  ___
+ *  | |_) / _ \/ _` | | '_ ` _ \/ __|
+ *  |  _ <  __/ (_| | | | | | | \__ \
+ *  |_| \_\___|\__,_|_|_| |_| |_|___/
+ *
+ * Permission to use, modify and distribute is granted via the
+ *  GNU Affero General Public License v3 or later
+ *
+ *  Copyright (C) 2007-2021 Jason Mitchell, Randi Mitchell
+ *     Contributions by Tim Callahan, Jonathan Hseu
+ *  Based on Mordor (C) Brooke Paul, Brett J. Vickers, John P. Freeman
+ *
+ */
+
+#include <sys/epoll.h>      // for epoll_create1, epoll_ctl, epoll_wait
+#include <unistd.h>         // for close
+#include <cerrno>           // for errno, EINTR
+#include <cstring>          // for strerror
+#include <iostream>         // for operator<<, clog
+
+#include "reactor.hpp"      // for Reactor, WatchType
+
+// Max events pulled off the kernel per epoll_wait; anything left over is
+// picked up on the next call
+static constexpr int MAX_EVENTS = 256;
+
+//********************************************************************
+//                      Reactor
+//********************************************************************
+// The epoll descriptor is close-on-exec so it doesn't leak into the new
+// process image on a reboot or into any exec'd children
+
+Reactor::Reactor() {
+    numWatched = 0;
+    epollFd = epoll_create1(EPOLL_CLOEXEC);
+    if(epollFd < 0)
+        std::clog << "Reactor: Error with epoll_create1: " << strerror(errno) << std::endl;
+    events.reserve(MAX_EVENTS);
+}
+
+Reactor::~Reactor() {
+    if(epollFd > -1)
+        close(epollFd);
+}
+
+bool Reactor::isValid() const {
+    return(epollFd > -1);
+}
+
+size_t Reactor::getNumWatched() const {
+    return(numWatched);
+}
+
+//********************************************************************
+//                      watch
+//********************************************************************
+// Start watching the given descriptor.  Everything is edge triggered, so
+// whoever handles the descriptor must drain it until EWOULDBLOCK (or remember
+// that there is more to do) before it will be reported again.
+
+bool Reactor::watch(int fd, WatchType type, const std::shared_ptr<Socket>& sock) {
+    if(fd < 0 || !isValid())
+        return(false);
+
+    struct epoll_event ev{};
+    ev.data.fd = fd;
+    ev.events = EPOLLIN | EPOLLET;
+    if(type == WatchType::SOCKET)
+        ev.events |= EPOLLRDHUP;
+
+    if(epoll_ctl(epollFd, EPOLL_CTL_ADD, fd, &ev) != 0) {
+        std::clog << "Reactor: Unable to watch fd " << fd << ": " << strerror(errno) << std::endl;
+        return(false);
+    }
+
+    if((size_t)fd >= watches.size())
+        watches.resize(fd + 1);
+    watches[fd].type = type;
+    watches[fd].wantWrite = false;
+    watches[fd].sock = sock;
+    numWatched++;
+    return(true);
+}
+
+//********************************************************************
+//                      unwatch
+//********************************************************************
+// Must be called before the descriptor is closed: forked children may still
+// hold a copy of it, in which case the kernel would keep reporting events for it.
+
+void Reactor::unwatch(int fd) {
+    if(fd < 0 || (size_t)fd >= watches.size() || watches[fd].type == WatchType::NONE)
+        return;
+
+    epoll_ctl(epollFd, EPOLL_CTL_DEL, fd, nullptr);
+    watches[fd].type = WatchType::NONE;
+    watches[fd].sock.reset();
+    numWatched--;
+}
+
+//********************************************************************
+//                      setWriteInterest
+//********************************************************************
+
+void Reactor::setWriteInterest(int fd, bool wantWrite) {
+    if(fd < 0 || (size_t)fd >= watches.size() || watches[fd].type != WatchType::SOCKET)
+        return;
+    if(watches[fd].wantWrite == wantWrite)
+        return;
+
+    struct epoll_event ev{};
+    ev.data.fd = fd;
+    ev.events = EPOLLIN | EPOLLRDHUP | EPOLLET;
+    if(wantWrite)
+        ev.events |= EPOLLOUT;
+
+    if(epoll_ctl(epollFd, EPOLL_CTL_MOD, fd, &ev) != 0) {
+        std::clog << "Reactor: Unable to modify fd " << fd << ": " << strerror(errno) << std::endl;
+        return;
+    }
+    watches[fd].wantWrite = wantWrite;
+}
+
+//********************************************************************
+//                      wait
+//********************************************************************
+
+int Reactor::wait(int timeout) {
+    struct epoll_event ready[MAX_EVENTS];
+    events.clear();
+
+    int n = epoll_wait(epollFd, ready, MAX_EVENTS, timeout < 0 ? 0 : timeout);
+    if(n < 0) {
+        if(errno == EINTR)
+            return(0);
+        std::clog << "Reactor: Error with epoll_wait: " << strerror(errno) << std::endl;
+        return(-1);
+    }
+
+    for(int i = 0; i < n; i++) {
+        int fd = ready[i].data.fd;
+        // Unwatched after the kernel queued the event, ignore it
+        if((size_t)fd >= watches.size() || watches[fd].type == WatchType::NONE)
+            continue;
+        events.push_back({fd, ready[i].events, watches[fd].type});
+    }
+    return((int)events.size());
+}
+
+const std::vector<Reactor::Event>& Reactor::getEvents() const {
+    return(events);
+}
+
+std::shared_ptr<Socket> Reactor::getSocket(int fd) const {
+    if(fd < 0 || (size_t)fd >= watches.size())
+        return(nullptr);
+    return(watches[fd].sock.lock());
+}
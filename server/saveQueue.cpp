@@ -0,0 +1,228 @@
+/*
+ * saveQueue.cpp
+ *   Background writer for player files
+ *   ____            _
+ *  |  _ \ ___  __ _| |_ __ ___  ___
+ *  | |_) / _ \/ _` | | '_ ` _ \/ __|
+ *  |  _ <  __/ (_| | | | | | | \__ \
+ *  |_| \_\___|\__,_|_|_| |_| |_|___/
+ *
+ * Permission to use, modify and distribute is granted via the
+ *  GNU Affero General Public License v3 or later
+ *
+ *  Copyright (C) 2007-2021 Jason Mitchell, Randi Mitchell
+ *     Contributions by Tim Callahan, Jonathan Hseu
+ *  Based on Mordor (C) Brooke Paul, Brett J. Vickers, John P. Freeman
+ *
+ */
+
+#include <fcntl.h>              // for open, O_WRONLY, O_CREAT
+#include <unistd.h>             // for write, fsync, close, getpid
+#include <cerrno>               // for errno, EINTR
+#include <cstring>              // for strerror
+#include <iostream>             // for operator<<, clog
+
+#include "saveQueue.hpp"        // for SaveQueue
+
+//*********************************************************************
+//                      SaveQueue
+//*********************************************************************
+// The writer thread isn't started until the first save is queued
+
+SaveQueue::SaveQueue() = default;
+
+SaveQueue::~SaveQueue() {
+    stop();
+}
+
+bool SaveQueue::isAsync() const {
+    return(!stopping && (owner == -1 || owner == getpid()));
+}
+
+//*********************************************************************
+//                      push
+//*********************************************************************
+
+void SaveQueue::push(const fs::path& filename, std::string contents, int backups) {
+    Job job{std::move(contents), backups};
+    if(!isAsync()) {
+        writeFile(filename, job);
+        return;
+    }
+
+    std::unique_lock<std::mutex> guard(lock);
+    if(!writer.joinable()) {
+        owner = getpid();
+        writer = std::thread(&SaveQueue::run, this);
+    }
+
+    auto it = pending.find(filename.string());
+    if(it != pending.end()) {
+        // Not written yet: the newer copy replaces it and keeps its place in line
+        it->second = std::move(job);
+        coalesced++;
+        return;
+    }
+    order.push_back(filename.string());
+    pending.emplace(filename.string(), std::move(job));
+    wake.notify_one();
+}
+
+//*********************************************************************
+//                      flush
+//*********************************************************************
+
+void SaveQueue::flush() {
+    if(!isAsync())
+        return;
+    std::unique_lock<std::mutex> guard(lock);
+    done.wait(guard, [this] { return(order.empty() && writing.empty()); });
+}
+
+//*********************************************************************
+//                      wait
+//*********************************************************************
+
+void SaveQueue::wait(const fs::path& filename) {
+    if(!isAsync())
+        return;
+    const std::string name = filename.string();
+    std::unique_lock<std::mutex> guard(lock);
+    done.wait(guard, [&] { return(writing != name && !pending.contains(name)); });
+}
+
+//*********************************************************************
+//                      stop
+//*********************************************************************
+
+void SaveQueue::stop() {
+    if(owner != -1 && owner != getpid())
+        return;
+    {
+        std::unique_lock<std::mutex> guard(lock);
+        stopping = true;
+        wake.notify_one();
+    }
+    if(writer.joinable())
+        writer.join();
+}
+
+size_t SaveQueue::getPending() {
+    std::unique_lock<std::mutex> guard(lock);
+    return(order.size());
+}
+
+unsigned long SaveQueue::getWritten() {
+    std::unique_lock<std::mutex> guard(lock);
+    return(written);
+}
+
+unsigned long SaveQueue::getCoalesced() {
+    std::unique_lock<std::mutex> guard(lock);
+    return(coalesced);
+}
+
+//*********************************************************************
+//                      run
+//*********************************************************************
+// The writer thread: drains the queue, and only exits once it's empty
+// and we've been told to stop.
+
+void SaveQueue::run() {
+    std::unique_lock<std::mutex> guard(lock);
+    while(true) {
+        wake.wait(guard, [this] { return(stopping || !order.empty()); });
+        if(order.empty())
+            break;
+
+        writing = std::move(order.front());
+        order.pop_front();
+        auto node = pending.extract(writing);
+        guard.unlock();
+
+        writeFile(writing, node.mapped());
+
+        guard.lock();
+        written++;
+        writing.clear();
+        done.notify_all();
+    }
+}
+
+//*********************************************************************
+//                      rotateBackups
+//*********************************************************************
+// name.bak.xml -> name.bak.1.xml -> name.bak.2.xml ...; the oldest falls off the end
+
+void SaveQueue::rotateBackups(const fs::path& filename, int backups) {
+    std::error_code ec;
+    if(!fs::exists(filename, ec))
+        return;
+
+    auto numbered = [&](int n) {
+        fs::path rotated = filename;
+        return(rotated.replace_extension(std::to_string(n) + filename.extension().string()));
+    };
+
+    fs::remove(numbered(backups), ec);
+    for(int n = backups - 1; n > 0; n--)
+        fs::rename(numbered(n), numbered(n + 1), ec);
+    fs::rename(filename, numbered(1), ec);
+}
+
+//*********************************************************************
+//                      writeFile
+//*********************************************************************
+
+bool SaveQueue::writeFile(const fs::path& filename, const Job& job) {
+    fs::path temp = filename;
+    temp += ".tmp";
+
+    int fd = open(temp.c_str(), O_WRONLY | O_CREAT | O_TRUNC | O_CLOEXEC, 0644);
+    if(fd < 0) {
+        std::clog << "SaveQueue: Unable to open " << temp << ": " << strerror(errno) << std::endl;
+        return(false);
+    }
+
+    const char* data = job.contents.data();
+    size_t left = job.contents.size();
+    while(left) {
+        ssize_t n = ::write(fd, data, left);
+        if(n < 0) {
+            if(errno == EINTR)
+                continue;
+            std::clog << "SaveQueue: Error writing " << temp << ": " << strerror(errno) << std::endl;
+            close(fd);
+            unlink(temp.c_str());
+            return(false);
+        }
+        data += n;
+        left -= n;
+    }
+
+    bool synced = (fsync(fd) == 0);
+    if(close(fd) != 0)
+        synced = false;
+    if(!synced) {
+        std::clog << "SaveQueue: Error syncing " << temp << ": " << strerror(errno) << std::endl;
+        unlink(temp.c_str());
+        return(false);
+    }
+
+    if(job.backups > 0)
+        rotateBackups(filename, job.backups);
+
+    if(rename(temp.c_str(), filename.c_str()) != 0) {
+        std::clog << "SaveQueue: Unable to rename " << temp << ": " << strerror(errno) << std::endl;
+        unlink(temp.c_str());
+        return(false);
+    }
+
+    // Make sure the rename itself survives a crash
+    int dirFd = open(filename.parent_path().empty() ? "." : filename.parent_path().c_str(), O_RDONLY | O_DIRECTORY | O_CLOEXEC);
+    if(dirFd > -1) {
+        fsync(dirFd);
+        close(dirFd);
+    }
+    return(true);
+}
@@ -21,10 +21,9 @@
 #include <libxml/parser.h>                          // for xmlFreeDoc, xmlDo...
 #include <netdb.h>                                  // for getnameinfo, EAI_...
 #include <netinet/in.h>                             // for sockaddr_in, htons
-#include <poll.h>                                   // for pollfd, poll, POL...
 #include <csignal>                                  // for sigaction, signal
 #include <sys/resource.h>                           // for rlimit, setrlimit
-#include <sys/select.h>                             // for FD_ZERO, FD_ISSET
+#include <sys/epoll.h>                              // for EPOLLIN, EPOLLOUT
 #include <sys/socket.h>                             // for AF_INET, accept
 #include <sys/stat.h>                               // for umask
 #include <sys/time.h>                               // for timeval
@@ -35,6 +34,7 @@
 #include <boost/iterator/iterator_traits.hpp>       // for iterator_value<>:...
 #include <boost/lexical_cast/bad_lexical_cast.hpp>  // for bad_lexical_cast
 #include <cerrno>                                   // for EWOULDBLOCK, errno
+#include <chrono>                                   // for milliseconds, ste...
 #include <cstdio>                                   // for snprintf, sprintf
 #include <cstdlib>                                  // for exit, abort, srand
 #include <cstring>                                  // for memset, strcpy
@@ -80,6 +80,7 @@
 #include "proto.hpp"                                // for broadcast, isDay
 #include "pythonHandler.hpp"                        // for PythonHandler
 #include "random.hpp"                               // for Random
+#include "reactor.hpp"                              // for Reactor, WatchType
 #include "ships.hpp"                                // for Ship
 #include "server.hpp"                               // for Server, Server::c...
 #include "serverTimer.hpp"                          // for ServerTimer
@@ -112,6 +113,8 @@ void CleanupRoomFn::operator()(const std::shared_ptr<UniqueRoom>& r ) {
 	r->saveToFile(PERMONLY);
 }
 
+size_t RoomCostFn::operator()(const std::shared_ptr<UniqueRoom>& r ) { return r->getCacheCost(); }
+
 
 //--------------------------------------------------------------------
 // Constructors, Destructors, etc
@@ -120,11 +123,8 @@ void CleanupRoomFn::operator()(const std::shared_ptr<UniqueRoom>& r ) {
 //                      Server
 //********************************************************************
 
-Server::Server(): roomCache(RQMAX, true), monsterCache(MQMAX, false), objectCache(OQMAX, false) {
+Server::Server(): roomCache(0, true, RQMAX_BYTES), monsterCache(MQMAX, false), objectCache(OQMAX, false) {
 	std::clog << "Constructing the Server." << std::endl;
-    FD_ZERO(&inSet);
-    FD_ZERO(&outSet);
-    FD_ZERO(&excSet);
     rebooting = GDB = valgrind = false;
 
     running = false;
@@ -152,7 +152,11 @@ Server::~Server() {
     if(running) {
         // Do shutdown here
     }
+    // Anything still queued has to reach the disk before we go
+    playerSaves.stop();
     sockets.clear();
+    // After the sockets, so their output and closes go out first
+    network.stop();
     players.clear();
     areas.clear();
     activeList.clear();
@@ -164,8 +168,6 @@ Server::~Server() {
     cleanupDiscordBot();
     cleanupHttpServer();
 
-
-    delete vSockets;
 #ifdef SQL_LOGGER
     cleanUpSql();
 #endif // SQL_LOGGER
@@ -328,16 +330,6 @@ void Server::destroyInstance() {
 
 
 
-void Server::populateVSockets() {
-    if(vSockets)
-        return;
-    vSockets = new SocketVector();
-    for(auto &sock : sockets) vSockets->push_back(sock);
-
-    Random::shuffle(vSockets->begin(), vSockets->end());
-}
-
-
 //********************************************************************
 //                      run
 //********************************************************************
@@ -352,16 +344,19 @@ void Server::run() {
     if(httpServer)
         httpServer->run();
 
+    scheduleUpdates();
+
     std::clog << "Starting Sock Loop\n";
     while(running) {
         if(!children.empty()) reapChildren();
 
         processChildren();
+        finishDnsLookups();
         timer.start(); // Start the timer
 
-        populateVSockets();
-
-        poll();
+        // Nothing is looping over the sockets here, so clear out last pass's disconnects
+        sockets.compact();
+        sockets.shuffle();
 
         checkNew();
 
@@ -384,11 +379,11 @@ void Server::run() {
 
         checkWebInterface();
 
-        delete vSockets;
-        vSockets = nullptr;
-
         timer.end(); // End the timer
-        timer.sleep();
+
+        // Wait out the rest of the pulse on the reactor; anything that becomes
+        // ready in the meantime is handled at the top of the next pass
+        poll(timer.getTimeLeft());
     }
 
 }
@@ -437,6 +432,7 @@ int Server::addListenPort(int port) {
 
     // TODO: Leaky, make sure to erase these when the server shuts down
     controlSocks.emplace_back(port, control);
+    reactor.watch(control, WatchType::LISTENER);
     running = true;
 
     return(0);
@@ -445,41 +441,63 @@ int Server::addListenPort(int port) {
 //********************************************************************
 //                      poll
 //********************************************************************
+// Waits on the reactor until the timeout has elapsed. Nothing is read or
+// written here, readiness is just recorded for checkNew, processInput,
+// processOutput and the child handlers to act on.
 
-int Server::poll() {
+int Server::poll(int timeout) {
     if(controlSocks.empty()) {
         std::clog << "Not bound to any ports, nothing to poll.\n";
         exit(0);
     }
 
-    int maxFd = 0;
+    auto deadline = std::chrono::steady_clock::now() + std::chrono::milliseconds(timeout);
+    do {
+        if(reactor.wait(timeout) < 0)
+            return(-1);
 
-    struct timeval noTime{};
-    noTime.tv_sec = 0;
-    noTime.tv_usec = 0;
+        for(const Reactor::Event& event : reactor.getEvents())
+            dispatchEvent(event);
 
-    FD_ZERO(&inSet);
-    FD_ZERO(&outSet);
-    FD_ZERO(&excSet);
+        timeout = (int)std::chrono::duration_cast<std::chrono::milliseconds>(deadline - std::chrono::steady_clock::now()).count();
+    } while(running && timeout > 0);
 
-    for(controlSock & cs : controlSocks) {
-        if(cs.control > maxFd)
-            maxFd = cs.control;
-        FD_SET(cs.control, &inSet);
-    }
+    return(0);
+}
 
-    for(const auto &sock : sockets) {
-        if(sock->getFd() > maxFd)
-            maxFd = sock->getFd();
-        FD_SET(sock->getFd(), &inSet);
-        FD_SET(sock->getFd(), &outSet);
-        FD_SET(sock->getFd(), &excSet);
+//********************************************************************
+//                      dispatchEvent
+//********************************************************************
+
+void Server::dispatchEvent(const Reactor::Event& event) {
+    switch(event.type) {
+        case WatchType::LISTENER:
+            for(controlSock & cs : controlSocks) {
+                if(cs.control == event.fd)
+                    cs.pending = true;
+            }
+            break;
+        case WatchType::CHILD:
+            for(childProcess & child : children) {
+                if(child.fd == event.fd) {
+                    if(event.events & EPOLLIN)
+                        child.readable = true;
+                    if(event.events & (EPOLLHUP | EPOLLERR))
+                        child.hungUp = true;
+                }
+            }
+            break;
+        default:
+            break;
     }
+}
 
-    if(select(maxFd+1, &inSet, &outSet, &excSet, &noTime) < 0)
-        return(-1);
+//********************************************************************
+//                      unwatch
+//********************************************************************
 
-    return(0);
+void Server::unwatch(int fd) {
+    reactor.unwatch(fd);
 }
 
 //********************************************************************
@@ -488,9 +506,11 @@ int Server::poll() {
 
 int Server::checkNew() {
     for(controlSock & cs : controlSocks) {
-        if(FD_ISSET(cs.control, &inSet)) { // We have a new connection waiting
-            std::clog << "Got a new connection on port " << cs.port << ", control sock " << cs.control << std::endl;
-            handleNewConnection(cs);
+        if(cs.pending) { // We have a new connection waiting
+            // Edge triggered, so accept everything that's queued up
+            while(handleNewConnection(cs) >= 0)
+                ;
+            cs.pending = false;
         }
     }
     return(0);
@@ -499,6 +519,7 @@ int Server::checkNew() {
 //********************************************************************
 //                      handleNewConnection
 //********************************************************************
+// Returns -1 once there are no more connections waiting to be accepted
 
 int Server::handleNewConnection(controlSock& cs) {
     int fd;
@@ -514,15 +535,17 @@ int Server::handleNewConnection(controlSock& cs) {
     if(( fd = accept(cs.control, (struct sockaddr *) &addr, (socklen_t *) &len)) < 0) {
         return(-1);
     }
+    std::clog << "Got a new connection on port " << cs.port << ", control sock " << cs.control << std::endl;
 
     // Game's full, drop the connection
     if(getNumSockets() > Tablesize-10) {
         close(fd);
-        return -1;
+        return(1);
     }
     auto sock = std::make_shared<Socket>(fd, addr);
+    network.add(sock->io);
     sock->showLoginScreen();
-    sockets.emplace_back(sock);
+    sockets.add(sock);
     if(sock->dnsDone) sock->checkLockOut();
     return(0);
 }
@@ -530,29 +553,21 @@ int Server::handleNewConnection(controlSock& cs) {
 //********************************************************************
 //                      processInput
 //********************************************************************
+// The network threads do the reading; only sockets they've flagged as
+// having something for us are touched here.
 
 int Server::processInput() {
+    network.collectStats(InBytes, OutBytes);
 
-    for(const auto &sock : sockets) {
-        if(sock->getState() == CON_DISCONNECTING)
+    for(size_t pos = 0; pos < sockets.extent(); pos++) {
+        SocketIo* io = sockets.ioAt(pos);
+        if(!io || !io->takeReady() || sockets.stateAt(pos) == CON_DISCONNECTING)
             continue;
 
-        // Clear out the descriptor of we have an exception
-        if(FD_ISSET(sock->getFd(), &excSet)) {
-            FD_CLR(sock->getFd(), &inSet);
-            FD_CLR(sock->getFd(), &outSet);
+        const std::shared_ptr<Socket>& sock = sockets.at(pos);
+        if(sock->processInput() != 0) {
+            std::clog << "Error reading from socket " << sock->getFd() << std::endl;
             sock->setState(CON_DISCONNECTING);
-            std::clog << "Exception found\n";
-            continue;
-        }
-        // Try to read something
-        if(FD_ISSET(sock->getFd(), &inSet)) {
-            if(sock->processInput() != 0) {
-                FD_CLR(sock->getFd(), &outSet);
-                std::clog << "Error reading from socket " << sock->getFd() << std::endl;
-                sock->setState(CON_DISCONNECTING);
-                continue;
-            }
         }
     }
     return(0);
@@ -563,13 +578,15 @@ int Server::processInput() {
 //********************************************************************
 
 int Server::processCommands() {
-    for(const auto &unlockedSock : *vSockets) {
-        if(auto sock = unlockedSock.lock()) {
-            if(sock->hasCommand() && sock->getState() != CON_DISCONNECTING && sock->processOneCommand() == -1) {
-                sock->setState(CON_DISCONNECTING);
-                continue;
-            }
-        }
+    for(uint32_t pos : sockets.passOrder()) {
+        SocketIo* io = sockets.ioAt(pos);
+        if(!io || !io->hasLine() || sockets.stateAt(pos) == CON_DISCONNECTING)
+            continue;
+
+        // Held onto, since the command might disconnect it
+        std::shared_ptr<Socket> sock = sockets.at(pos);
+        if(sock->processOneCommand() == -1)
+            sock->setState(CON_DISCONNECTING);
     }
     return(0);
 }
@@ -579,20 +596,19 @@ int Server::processCommands() {
 //********************************************************************
 
 int Server::updatePlayerCombat() {
-    for(const auto &unlockedSock : *vSockets) {
-        if(auto sock = unlockedSock.lock()) {
-            if(auto player = sock->getPlayer()) {
-                if (player->isFleeing() && player->canFlee(false)) {
-                    player->doFlee();
-                } else if (player->autoAttackEnabled() && !player->isFleeing() && player->hasAttackableTarget() && player->isAttackingTarget()) {
-                    if (!player->checkAttackTimer(false))
-                        continue;
-                    
-                    player->attackCreature(player->getTarget(), ATTACK_NORMAL);
-                }
+    for(uint32_t pos : sockets.passOrder()) {
+        const std::shared_ptr<Socket>& sock = sockets.at(pos);
+        if(!sock)
+            continue;
+        if(auto player = sock->getPlayer()) {
+            if (player->isFleeing() && player->canFlee(false)) {
+                player->doFlee();
+            } else if (player->autoAttackEnabled() && !player->isFleeing() && player->hasAttackableTarget() && player->isAttackingTarget()) {
+                if (!player->checkAttackTimer(false))
+                    continue;
+
+                player->attackCreature(player->getTarget(), ATTACK_NORMAL);
             }
-        } else {
-            std::clog << "Error locking socket" << std::endl;
         }
     }
     return(0);
@@ -602,17 +618,17 @@ int Server::updatePlayerCombat() {
 //********************************************************************
 //                      processOutput
 //********************************************************************
+// Hands each socket's output to its network thread; a client that isn't
+// keeping up only backs up its own queue there
 
 int Server::processOutput() {
-    // This can be called outside of the normal server loop so verify VSockets is populated
-    populateVSockets();
-    for(const auto& unlockedSock : *vSockets) {
-        if(auto sock = unlockedSock.lock()) {
-            if (sock->getFd() != -1 && FD_ISSET(sock->getFd(), &outSet) && sock->hasOutput()) {
-                sock->flush();
-            }
-        }
+    // Every position, not just this pass's order: this can be called outside of the normal server loop
+    for(size_t pos = 0; pos < sockets.extent(); pos++) {
+        if(sockets.hasOutputAt(pos) && sockets.fdAt(pos) != -1)
+            sockets.at(pos)->flush();
     }
+    // Wake the network threads once for everything written this pass
+    network.kick();
     return(0);
 }
 
@@ -633,17 +649,19 @@ void Server::disconnectAll() {
 //                      cleanUp
 //********************************************************************
 
-bool isDisconnecting(const std::shared_ptr<Socket>& sock) {
-    if(sock->getState() == CON_DISCONNECTING) {
-        // Flush any residual data
-        sock->flush();
-        return true;
-    }
-    return false;
-}
+// Disconnected sockets only leave a tombstone, so this is safe to call from
+// inside a loop over the sockets
 
 int Server::cleanUp() {
-    sockets.remove_if(isDisconnecting);
+    for(size_t pos = 0; pos < sockets.extent(); pos++) {
+        if(!sockets.at(pos) || sockets.stateAt(pos) != CON_DISCONNECTING)
+            continue;
+        // Flush any residual data
+        sockets.at(pos)->flush();
+        sockets.removeAt(pos);
+    }
+    // So the last of their output and the closes don't wait for the next pass
+    network.kick();
     return(0);
 }
 
@@ -660,8 +678,8 @@ std::string Server::getDnsCacheString() {
     dnsStr << "---------------------------------------------------------------\n";
 
     dnsStr.setf(std::ios::left, std::ios::adjustfield);
-    for(dnsCache & dns : cachedDns) {
-        dnsStr << "^c" << std::setw(16) << dns.ip << " | ^C" << dns.hostName << "\n";
+    for(const auto& [ip, dns] : cachedDns) {
+        dnsStr << "^c" << std::setw(16) << dns.ip << " | ^C" << dns.hostName << (dns.found ? "" : " ^x(lookup failed)") << "\n";
         num++;
     }
 
@@ -674,15 +692,30 @@ std::string Server::getDnsCacheString() {
 //********************************************************************
 
 bool Server::getDnsCache(std::string &ip, std::string &hostName) {
-    for(dnsCache & dns : cachedDns) {
-        if(dns.ip == ip) {
-            // Got a match
-            hostName = dns.hostName;
-            std::clog << "DNS: Found " << ip << " in dns cache\n";
-            return(true);
-        }
+    auto it = cachedDns.find(ip);
+    if(it == cachedDns.end())
+        return(false);
+
+    if(it->second.isExpired(time(nullptr))) {
+        cachedDns.erase(it);
+        return(false);
     }
-    return(false);
+    hostName = it->second.hostName;
+    std::clog << "DNS: Found " << ip << " in dns cache\n";
+    return(true);
+}
+
+//********************************************************************
+//                      isExpired
+//********************************************************************
+// Failed lookups are only remembered for an hour, so a host whose reverse
+// dns gets fixed (or a nameserver that was down) is tried again soon
+
+static constexpr long DNS_CACHE_TTL = 60*60*24*15;
+static constexpr long DNS_FAILED_TTL = 60*60;
+
+bool Server::dnsCache::isExpired(time_t t) const {
+    return(t - time >= (found ? DNS_CACHE_TTL : DNS_FAILED_TTL));
 }
 
 //********************************************************************
@@ -690,18 +723,10 @@ bool Server::getDnsCache(std::string &ip, std::string &hostName) {
 //********************************************************************
 
 void Server::pruneDns() {
-    long fifteenDays = 60*60*24*15;
     long currentTime = time(nullptr);
-    std::list<dnsCache>::iterator it;
-    std::list<dnsCache>::iterator oldIt;
 
     std::clog << "Pruning DNS\n";
-    for( it = cachedDns.begin(); it != cachedDns.end() ; ) {
-        oldIt = it++;
-        if(currentTime - (*oldIt).time >= fifteenDays) {
-            cachedDns.erase(oldIt);
-        }
-    }
+    std::erase_if(cachedDns, [currentTime](const auto& entry) { return(entry.second.isExpired(currentTime)); });
     saveDnsCache();
     lastDnsPrune = currentTime;
 }
@@ -712,8 +737,8 @@ void Server::pruneDns() {
 
 void Server::pulseTicks(long t) {
 
-    for(const auto& unlockedSock : *vSockets) {
-        if(auto sock = unlockedSock.lock()) {
+    for(uint32_t pos : sockets.passOrder()) {
+        if(const std::shared_ptr<Socket>& sock = sockets.at(pos)) {
             std::shared_ptr<Player> player = sock->getPlayer();
             if (player) {
                 player->pulseTick(t);
@@ -734,8 +759,8 @@ void Server::updateUsers(long t) {
     int tout;
     lastUserUpdate = t;
 
-    for(const auto& unlockedSock : *vSockets) {
-        if(auto sock = unlockedSock.lock()) {
+    for(uint32_t pos : sockets.passOrder()) {
+        if(const std::shared_ptr<Socket>& sock = sockets.at(pos)) {
             std::shared_ptr<Player> player = sock->getPlayer();
 
             if (player) {
@@ -777,8 +802,8 @@ void Server::updateRandom(long t) {
     lastRandomUpdate = t;
 
     std::shared_ptr<Player> player;
-    for(const auto &unlockedSock : *vSockets) {
-        if(auto sock = unlockedSock.lock()) {
+    for(uint32_t pos : sockets.passOrder()) {
+        if(const std::shared_ptr<Socket>& sock = sockets.at(pos)) {
             player = sock->getPlayer();
 
             if (!player || !player->getRoomParent())
@@ -870,6 +895,9 @@ void Server::updateRandom(long t) {
     }
 }
 
+// How often, in seconds, monsters a room or two away from a player are updated
+static constexpr long NEARBY_UPDATE_INTERVAL = 5;
+
 //*********************************************************************
 //                      update_active
 //*********************************************************************
@@ -884,6 +912,7 @@ void Server::updateActive(long t) {
     long    tt = gConfig->currentHour();
     int     timetowander=0, immort=0;
     bool    shouldoPrint=false;
+    static const EffectId slow = Effect::intern("slow"), haste = Effect::intern("haste");
 
     lastActiveUpdate = t;
 
@@ -935,22 +964,36 @@ void Server::updateActive(long t) {
 
         }
 
-        // fast wanderers and pets always stay active
-        if( room->players.empty() &&
-            !monster->flagIsSet(M_ALWAYS_ACTIVE) &&
-            !monster->flagIsSet(M_FAST_WANDER) &&
-            !monster->flagIsSet(M_FAST_TICK) &&
-            !monster->flagIsSet(M_REGENERATES) &&
-            !monster->isPet() &&
-            !monster->isPoisoned() &&
-            !monster->isEffected("slow") &&
-            !monster->flagIsSet(M_PERMANENT_MONSTER) &&
-            !monster->flagIsSet(M_AGGRESSIVE))
-        {
-            std::clog << "Removing " << monster->getName() << " from active list" << std::endl;
-            it = activeList.erase(it);
-            continue;
+        if(room->players.empty()) {
+            if(!monster->staysActive()) {
+                std::clog << "Removing " << monster->getName() << " from active list" << std::endl;
+                it = activeList.erase(it);
+                continue;
+            }
+
+            // fast wanderers and pets always stay at full rate; anything busy fighting does too
+            if( !monster->isPet() &&
+                !monster->flagIsSet(M_ALWAYS_ACTIVE) &&
+                !monster->flagIsSet(M_FAST_WANDER) &&
+                !monster->flagIsSet(M_KILL_PERMS) &&
+                !monster->flagIsSet(M_KILL_NON_ASSIST_MOBS) &&
+                !monster->isPoisoned() &&
+                !monster->hasEnemy())
+            {
+                // Nobody within reach: park it until a player comes close
+                if(!room->getNearbyPlayers()) {
+                    monster->goDormant(t);
+                    it = activeList.erase(it);
+                    continue;
+                }
+                // A player a room or two away: update it now and then
+                if(t - monster->getLastSimulated() < NEARBY_UPDATE_INTERVAL) {
+                    it++;
+                    continue;
+                }
+            }
         }
+        monster->setLastSimulated(t);
 
         // Lets see if we'll attack any other monsters in this room
         if(monster->checkEnemyMobs()) {
@@ -1040,9 +1083,9 @@ void Server::updateActive(long t) {
         }
 
         monster->updateAttackTimer();
-        if(monster->dexterity.getCur() > 200 || monster->isEffected("haste"))
+        if(monster->dexterity.getCur() > 200 || monster->isEffected(haste))
             monster->modifyAttackDelay(-10);
-        if(monster->isEffected("slow"))
+        if(monster->isEffected(slow))
             monster->modifyAttackDelay(10);
 
 
@@ -1140,6 +1183,9 @@ void Server::addActive(const std::shared_ptr<Monster>& monster) {
     if(isActive(monster.get()))
         return;
 
+    if(monster->isDormant())
+        monster->fastForward(time(nullptr));
+
     monster->validateId();
 
     activeList.push_back(monster);
@@ -1207,113 +1253,59 @@ bool Server::isActive(Monster* monster) {
 
 int Server::reapChildren() {
     int status;
-    bool dnsChild = false;
     childProcess myChild;
     const childProcess* cp;
     bool found=false;
-    std::cout << "Reaping Children (maybe)\n";
-    pollfd *fds = nullptr;
-
-    while(!children.empty()) {
-        delete[] fds;
-        fds = new pollfd[children.size()];
-        int i = 0;
-        for(const childProcess& c : children) {
-            fds[i].fd = c.fd;
-            fds[i++].events = POLLHUP;
-        }
-        int ret = ::poll(fds, i, 0);
-        if (ret <= 0) break;
 
-        std::list<childProcess>::const_iterator it, oldIt;
-        for( it = children.begin(), i=0; it != children.end() ; i++) {
-            cp = &*it;
-            oldIt = it++;
+    std::list<childProcess>::const_iterator it, oldIt;
+    for( it = children.begin(); it != children.end() ; ) {
+        cp = &*it;
+        oldIt = it++;
 
-            if(fds[i].revents == 0) {
-                continue;
-            } else if (fds[i].revents != POLLHUP) {
-                std::cout << "Unexpected revent " << fds[i].revents << std::endl;
-                continue;
-            }
+        // The reactor flags a child once it closes its end of the pipe
+        if(!cp->hungUp)
+            continue;
 
-            std::cout << "waitpid " << cp->pid << std::endl;
-            waitpid(cp->pid, &status, WNOHANG);
-
-            if(cp->type == ChildType::DNS_RESOLVER) {
-                char tmpBuf[1024];
-                memset(tmpBuf, '\0', sizeof(tmpBuf));
-                // Read in the results from the resolver
-                size_t n = read(cp->fd, tmpBuf, 1023);
-
-                // Close the read fd in the pipe now, won't need it anymore
-                close(cp->fd);
-                // If we have an error reading, just use the ip address then
-                if( n <= 0 ) {
-                    if(errno == EWOULDBLOCK)
-                        std::clog << "DNS ReapChildren: Error would block\n";
-                    else
-                        std::clog << "DNS ReapChildren: Error\n";
-                    strcpy(tmpBuf, cp->extra.c_str());
-                }
+        std::cout << "waitpid " << cp->pid << std::endl;
+        unwatch(cp->fd);
+        waitpid(cp->pid, &status, WNOHANG);
+
+        if(cp->type == ChildType::LISTER) {
+            std::clog << "Reaping LISTER child (" << cp->pid << "-" << cp->extra << ")" << std::endl;
+            processListOutput(*cp);
+            // Don't forget to close the pipe!
+            close(cp->fd);
+        } else if(cp->type == ChildType::SWAP_FINISH) {
+            std::clog << "Reaping MoveRoom Finish child (" << cp->pid << "-" << cp->extra << ")" << std::endl;
+            myChild = *cp;
+            found = true;
+        } else if(cp->type == ChildType::PRINT) {
+            //broadcast(isDm, "Reaping Print Child (%d-%s)",pid, cp->extra.c_str());
+            std::clog << "Reaping Print child (" << cp->pid << "-" << cp->extra << ")" << std::endl;
+            myChild = *cp;
+            found = true;
+        } else {
+            std::clog << "ReapChildren: Unknown child type " << (int)cp->type << std::endl;
+        }
+        children.erase(oldIt);
 
-                // Add dns to cache
-                addCache(cp->extra, tmpBuf);
-                dnsChild = true;
-
-                // Now we want to look through all connected sockets and update dns where appropriate
-                for(const auto &sock : sockets) {
-                    if(sock->getState() == LOGIN_DNS_LOOKUP && sock->getIp() == cp->extra) {
-                        // Be sure to set the hostname first, then check for lockout
-                        sock->dnsDone = true;
-                        sock->setHostname(tmpBuf);
-                        sock->checkLockOut();
-                    }
-                }
-                std::clog << "Reaped DNS child (" << cp->pid << "-" << tmpBuf << ")\n";
-            } else if(cp->type == ChildType::LISTER) {
-                std::clog << "Reaping LISTER child (" << cp->pid << "-" << cp->extra << ")" << std::endl;
-                processListOutput(*cp);
-                // Don't forget to close the pipe!
-                close(cp->fd);
-            } else if(cp->type == ChildType::SWAP_FINISH) {
-                std::clog << "Reaping MoveRoom Finish child (" << cp->pid << "-" << cp->extra << ")" << std::endl;
-                myChild = *it;
-                found = true;
-            } else if(cp->type == ChildType::PRINT) {
-                //broadcast(isDm, "Reaping Print Child (%d-%s)",pid, cp->extra.c_str());
-                std::clog << "Reaping Print child (" << cp->pid << "-" << cp->extra << ")" << std::endl;
-                myChild = *it;
-                found = true;
-            } else {
-                std::clog << "ReapChildren: Unknown child type " << (int)cp->type << std::endl;
-            }
-            children.erase(oldIt);
-
-            // finish swap after they've been deleted from the list
-            if(found) {
-                found = false;
-                if(myChild.type == ChildType::SWAP_FIND) {
-                    gConfig->findNextEmpty(myChild, true);
-                } else if(myChild.type == ChildType::SWAP_FINISH) {
-                    gConfig->offlineSwap(myChild, true);
-                } else if(myChild.type == ChildType::PRINT) {
-                    const std::shared_ptr<Player> player = gServer->findPlayer(myChild.extra);
-                    std::string output = gServer->simpleChildRead(myChild);
-                    if(player && !output.empty())
-                        player->printColor("%s\n", output.c_str());
-                }
-                // Don't forget to close the pipe!
-                close(myChild.fd);
+        // finish swap after they've been deleted from the list
+        if(found) {
+            found = false;
+            if(myChild.type == ChildType::SWAP_FIND) {
+                gConfig->findNextEmpty(myChild, true);
+            } else if(myChild.type == ChildType::SWAP_FINISH) {
+                gConfig->offlineSwap(myChild, true);
+            } else if(myChild.type == ChildType::PRINT) {
+                const std::shared_ptr<Player> player = gServer->findPlayer(myChild.extra);
+                std::string output = gServer->simpleChildRead(myChild);
+                if(player && !output.empty())
+                    player->printColor("%s\n", output.c_str());
             }
+            // Don't forget to close the pipe!
+            close(myChild.fd);
         }
     }
-    if(dnsChild)
-        saveDnsCache();
-    if(fds != nullptr) {
-        delete[] fds;
-        fds = nullptr;
-    }
     // just in case, kill off any zombies
     wait3(&status, WNOHANG, (struct rusage *)nullptr);
     return(0);
@@ -1359,9 +1351,12 @@ int Server::processListOutput(const childProcess &lister) {
 
 int Server::processChildren() {
     for(childProcess & child : children) {
-        if(child.type == ChildType::DNS_RESOLVER) {
-            // Ignore, will be handled by reapChildren
-        } else if(child.type == ChildType::LISTER) {
+        // Nothing new on the pipe since we last looked
+        if(!child.readable)
+            continue;
+        child.readable = false;
+
+        if(child.type == ChildType::LISTER) {
             processListOutput(child);
         } else if(child.type == ChildType::SWAP_FIND) {
             gConfig->findNextEmpty(child, false);
@@ -1385,76 +1380,47 @@ int Server::processChildren() {
 //********************************************************************
 
 int Server::startDnsLookup(Socket *sock, struct sockaddr_in addr) {
-    int fds[2];
-    int pid;
-
-    // We're going to make a pipe here.
-    // The child process will write the
-    if(pipe(fds) == -1) {
-        std::clog << "DNS: Error with pipe!\n";
-        abort();
-    }
-    pid = fork();
-    if(!pid) {
-        // Child Process: Close the reading end, we'll only be writing
-        close(fds[0]);
-        int tries = 0, res = 0;
-        char hbuf[NI_MAXHOST], sbuf[NI_MAXSERV];
-
-        while(tries < 5 && tries >= 0) {
-            res = getnameinfo((struct sockaddr*) &addr, sizeof(addr), hbuf, sizeof(hbuf), sbuf, sizeof(sbuf), NI_NAMEREQD);
-
-            if (res != 0) {
-                switch(res) {
-                    case EAI_FAIL:
-                    case EAI_BADFLAGS:
-                    case EAI_MEMORY:
-                    case EAI_OVERFLOW:
-                    case EAI_SYSTEM:
-                        std::clog << "DNS Error: Unrecoverable error for " << sock->getIp() << std::endl;
-                        tries = -1;
-                        break;
-                    case EAI_NONAME:
-                        std::clog << "DNS Error: Host not found for " << sock->getIp() << std::endl;
-                        tries = -1;
-                        break;
-                    case EAI_AGAIN:
-                    default:
-                        std::clog << "DNS Error: Try again for " << sock->getIp() << std::endl;
-                        tries++;
-                        break;
-                }
-            } else {
-                break;
+    if(resolver.lookup(addr, sock->getIp()))
+        std::clog << "DNS: Looking up " << sock->getIp() << " (" << resolver.getInFlight() << " in flight)" << std::endl;
+    // Otherwise a lookup for this ip is already running and will finish this socket too
+    return(0);
+}
+
+//********************************************************************
+//                      finishDnsLookups
+//********************************************************************
+// Collect whatever the resolver threads have finished and let any sockets
+// that were waiting on them carry on with logging in.
+
+void Server::finishDnsLookups() {
+    std::vector<DnsResolver::Result> results = resolver.takeResults();
+    if(results.empty())
+        return;
+
+    for(const auto& result : results) {
+        std::clog << "DNS: Resolver finished for " << result.ip << " (" << result.hostName << ")" << std::endl;
+        addCache(result.ip, result.hostName, -1, result.found);
+
+        for(const auto &sock : sockets) {
+            if(sock->getState() == LOGIN_DNS_LOOKUP && sock->getIp() == result.ip) {
+                // Be sure to set the hostname first, then check for lockout
+                sock->dnsDone = true;
+                sock->setHostname(result.hostName);
+                sock->checkLockOut();
             }
         }
-        std::clog << "DNS: Resolver finished for " << sock->getIp() << "(" << (!res ? hbuf : sock->getIp()) << ")" << std::endl;
-        if(res == 0) {
-            // Found a hostname so print it
-            write(fds[1], hbuf, strlen(hbuf));
-        } else {
-            // Didn't find a hostname, print the ip
-            write(fds[1], sock->getIp().data(), sock->getIp().length());
-        }
-        exit(0);
-    } else { // pid != 0
-        // Parent Process: Close the writing end, we'll only be reading
-        close(fds[1]);
-        std::clog << "Watching Child DNS Resolver for(" << sock->getIp() << ") running with pid " << pid << " reading from fd " << fds[0] << std::endl;
-        // Let the server know we're monitoring this child process
-        addChild(pid, ChildType::DNS_RESOLVER, fds[0], sock->getIp());
     }
-    return(0);
+    saveDnsCache();
 }
 
 //********************************************************************
 //                      addCache
 //********************************************************************
 
-void Server::addCache(std::string_view ip, std::string_view hostName, time_t t) {
+void Server::addCache(std::string_view ip, std::string_view hostName, time_t t, bool found) {
     if(t == -1)
         t = time(nullptr);
-    cachedDns.emplace_back(ip, hostName, t);
+    cachedDns.insert_or_assign(std::string(ip), dnsCache(ip, hostName, t, found));
 }
 
 //********************************************************************
@@ -1464,6 +1430,7 @@ void Server::addCache(std::string_view ip, std::string_view hostName, time_t t)
 void Server::addChild(int pid, ChildType pType, int pFd, std::string_view pExtra) {
     std::clog << "Adding pid " << pid << " as child type " << (int)pType << ", watching " << pFd << "\n";
     children.emplace_back(pid, pType, pFd, pExtra);
+    reactor.watch(pFd, WatchType::CHILD);
 }
 
 // End - Children Control
@@ -1483,12 +1450,13 @@ void Server::saveDnsCache() {
     rootNode = xmlNewDocNode(xmlDoc, nullptr, BAD_CAST "DnsCache", nullptr);
     xmlDocSetRootElement(xmlDoc, rootNode);
 
-    std::list<dnsCache>::iterator it;
-    for( it = cachedDns.begin(); it != cachedDns.end() ; it++) {
+    for(const auto& [ip, dns] : cachedDns) {
         curNode = xmlNewChild(rootNode, nullptr, BAD_CAST"Dns", nullptr);
-        xml::newStringChild(curNode, "Ip", (*it).ip);
-        xml::newStringChild(curNode, "HostName", (*it).hostName);
-        xml::newNumChild(curNode, "Time", (long)(*it).time);
+        xml::newStringChild(curNode, "Ip", dns.ip);
+        xml::newStringChild(curNode, "HostName", dns.hostName);
+        xml::newNumChild(curNode, "Time", (long)dns.time);
+        if(!dns.found)
+            xml::newBoolChild(curNode, "Failed", true);
     }
 
     sprintf(filename, "%s/dns.xml", Path::Config.c_str());
@@ -1525,6 +1493,7 @@ void Server::loadDnsCache() {
         if(NODE_NAME(curNode, "Dns")) {
             std::string ip, hostname;
             long time=0;
+            bool failed=false;
             childNode = curNode->children;
             while(childNode != nullptr) {
                 if(NODE_NAME(childNode, "Ip")) {
@@ -1533,10 +1502,13 @@ void Server::loadDnsCache() {
                     xml::copyToString(hostname, childNode);
                 } else if(NODE_NAME(childNode, "Time")) {
                     xml::copyToNum(time, childNode);
-                    addCache(ip, hostname, time);
+                } else if(NODE_NAME(childNode, "Failed")) {
+                    xml::copyToBool(failed, childNode);
                 }
                 childNode = childNode->next;
             }
+            if(!ip.empty())
+                addCache(ip, hostname, time, !failed);
         }
         curNode = curNode->next;
     }
@@ -1590,6 +1562,9 @@ bool Server::startReboot(bool resetShips) {
 
     processOutput();
     cleanUp();
+    // Everything queued has to be written before exec, and the surviving sockets stay open
+    network.stop();
+    playerSaves.flush();
 
     if(resetShips)
         Config::resetShipsFile();
@@ -1707,6 +1682,7 @@ int Server::finishReboot() {
                     int port = xml::getIntProp(childNode, "Port");
                     int control = xml::getIntProp(childNode, "Control");
                     controlSocks.emplace_back(port, control);
+                    reactor.watch(control, WatchType::LISTENER);
                     running = true;
                 }
                 else if(NODE_NAME(childNode, "StartTime"))
@@ -1743,7 +1719,8 @@ int Server::finishReboot() {
                 else if(NODE_NAME(childNode, "Fd")) {
                     short fd;
                     xml::copyToNum(fd, childNode);
-                    sock = sockets.emplace_back(std::make_shared<Socket>(fd));
+                    sock = sockets.add(std::make_shared<Socket>(fd));
+                    network.add(sock->io);
                     if(!player || !sock)
                         throw std::runtime_error("finishReboot: No Sock/Player");
 
@@ -2057,8 +2034,7 @@ bool Server::registerMudObject(const std::shared_ptr<MudObject>& toRegister, boo
     if(toRegister->getId() =="-1")
         return(false);
 
-    auto it =registeredIds.find(toRegister->getId());
-    if(it != registeredIds.end()) {
+    if(registeredIds.find(toRegister->getId())) {
         std::ostringstream oStr;
         oStr << "ERROR: ID: " << toRegister->getId() << " is already registered!";
         if(toRegister->isMonster() || toRegister->isObject()) {
@@ -2079,7 +2055,7 @@ bool Server::registerMudObject(const std::shared_ptr<MudObject>& toRegister, boo
     if(!reassignId)
         toRegister->setRegistered();
 
-    registeredIds.insert(IdMap::value_type(toRegister->getId(), toRegister));
+    registeredIds.insert(toRegister->getId(), toRegister);
     //std::clog << "Registered: " << toRegister->getId() << " - " << toRegister->getName() << std::endl;
     return(true);
 }
@@ -2090,7 +2066,7 @@ bool Server::unRegisterMudObject(MudObject* toUnRegister) {
     if(toUnRegister->getId() == "-1")
         return(false);
 
-    auto it = registeredIds.find(toUnRegister->getId());
+    std::weak_ptr<MudObject>* found = registeredIds.find(toUnRegister->getId());
     bool registered = toUnRegister->isRegistered();
     if(!registered) {
         std::ostringstream oStr;
@@ -2099,7 +2075,7 @@ bool Server::unRegisterMudObject(MudObject* toUnRegister) {
         std::clog << oStr.str() << std::endl;
 
     }
-    if(it == registeredIds.end()) {
+    if(!found) {
         if(registered) {
             std::ostringstream oStr;
             oStr << "ERROR: ID: " << toUnRegister->getId() << " is not registered!";
@@ -2111,7 +2087,7 @@ bool Server::unRegisterMudObject(MudObject* toUnRegister) {
     if(!registered) {
         std::ostringstream oStr;
 
-        if(!it->second.expired() && it->second.lock().get() == toUnRegister) {
+        if(!found->expired() && found->lock().get() == toUnRegister) {
             oStr << "ERROR: ID: " << toUnRegister->getId() << " thought it wasn't registered, but the server thought it was.";
             broadcast(isDm, "%s", oStr.str().c_str());
             std::clog << oStr.str() << std::endl;
@@ -2125,7 +2101,7 @@ bool Server::unRegisterMudObject(MudObject* toUnRegister) {
         }
     }
     toUnRegister->setUnRegistered();
-    registeredIds.erase(it);
+    registeredIds.erase(toUnRegister->getId());
     //std::clog << "Unregistered: " << toUnRegister->getId() << " - " << toUnRegister->getName() << std::endl;
     return(true);
 }
@@ -2134,12 +2110,12 @@ std::shared_ptr<Object>  Server::lookupObjId(const std::string &toLookup) {
     if(toLookup[0] != 'O')
         return(nullptr);
 
-    auto it = registeredIds.find(toLookup);
+    std::weak_ptr<MudObject>* found = registeredIds.find(toLookup);
 
-    if(it == registeredIds.end())
+    if(!found)
         return(nullptr);
     else {
-        auto res = it->second.lock();
+        auto res = found->lock();
         return res ? res->getAsObject() : nullptr;
     }
 }
@@ -2148,30 +2124,30 @@ std::shared_ptr<Creature> Server::lookupCrtId(const std::string &toLookup) {
     if(toLookup[0] != 'M' && toLookup[0] != 'P')
         return(nullptr);
 
-    auto it = registeredIds.find(toLookup);
+    std::weak_ptr<MudObject>* found = registeredIds.find(toLookup);
 
-    if(it == registeredIds.end())
+    if(!found)
         return(nullptr);
     else {
-        auto res = it->second.lock();
+        auto res = found->lock();
         return res ? res->getAsCreature() : nullptr;
     }
 }
 std::shared_ptr<Player> Server::lookupPlyId(const std::string &toLookup) {
     if(toLookup[0] != 'P')
         return(nullptr);
-    auto it = registeredIds.find(toLookup);
+    std::weak_ptr<MudObject>* found = registeredIds.find(toLookup);
 
-    if(it == registeredIds.end())
+    if(!found)
         return(nullptr);
     else{
-        auto res = it->second.lock();
+        auto res = found->lock();
         return res ? res->getAsPlayer() : nullptr;
     }
 }
 std::string Server::getRegisteredList() {
     std::ostringstream oStr;
-    for(const auto& [id, mo] : registeredIds) {
+    for(const auto& [id, mo] : registeredIds.ordered()) {
         if(auto locked = mo.lock())
             oStr << id << " - " << locked->getName() << std::endl;
     }
@@ -2418,5 +2394,6 @@ int Server::saveStorage(const CatRef& cr) {
 
 void Server::stop() {
     if(httpServer) httpServer->stop();
+    network.stop();
 
 }
@@ -16,7 +16,6 @@
  *
  */
 
-#include <sys/select.h>     // for select
 #include <sys/time.h>       // for timeval, gettimeofday
 
 #include "serverTimer.hpp"  // for ServerTimer
@@ -85,19 +84,16 @@ void ServerTimer::end() {
 }
 
 //*********************************************************************
-//                          sleep
+//                          getTimeLeft
 //*********************************************************************
+// How long the server should wait for network activity before starting the
+// next pulse.  Pulses are 100ms; if we've already run over, don't wait at all.
 
-void ServerTimer::sleep() {
-    // Only sleep if we're not running!
+int ServerTimer::getTimeLeft() const {
+    // Only wait if we're not running!
     if(running)
-        return;
-    if(timePassed.tv_sec > 0 || timePassed.tv_usec > 100000) {
-        //Do nothing
-    } else {
-        struct timeval toSleep{};
-        timeZero(toSleep);
-        toSleep.tv_usec = 100000 - timePassed.tv_usec;
-        select(0,nullptr,nullptr,nullptr,&toSleep);
-    }
+        return(0);
+    if(timePassed.tv_sec > 0 || timePassed.tv_usec >= 100000)
+        return(0);
+    return((int)((100000 - timePassed.tv_usec + 999) / 1000));
 }
@@ -0,0 +1,210 @@
+/*
+ * socketTable.cpp
+ *   The server's table of connected sockets
+ *   ____            _
+ *  |  _ \ ___  __ _| |_ __ ___  ___
+ *  | |_) / _ \/ _` | | '_ ` _ \/ __|
+ *  |  _ <  __/ (_| | | | | | | \__ \
+ *  |_| \_\___|\__,_|_|_| |_| |_|___/
+ *
+ * Permission to use, modify and distribute is granted via the
+ *  GNU Affero General Public License v3 or later
+ *
+ *  Copyright (C) 2007-2021 Jason Mitchell, Randi Mitchell
+ *     Contributions by Tim Callahan, Jonathan Hseu
+ *  Based on Mordor (C) Brooke Paul, Brett J. Vickers, John P. Freeman
+ *
+ */
+
+#include "random.hpp"           // for Random
+#include "socket.hpp"           // for Socket
+#include "socketTable.hpp"      // for SocketTable, SocketHandle
+
+//********************************************************************
+//                      iterator
+//********************************************************************
+
+SocketTable::iterator::iterator(const SocketTable* pTable, size_t pPos): table(pTable), pos(pPos) {
+    skip();
+}
+
+const std::shared_ptr<Socket>& SocketTable::iterator::operator*() const {
+    return(table->socks[pos]);
+}
+
+SocketTable::iterator& SocketTable::iterator::operator++() {
+    pos++;
+    skip();
+    return(*this);
+}
+
+// Step over tombstones.  Goes by index, so sockets added mid loop are still safe.
+void SocketTable::iterator::skip() {
+    while(pos < table->socks.size() && !table->socks[pos])
+        pos++;
+}
+
+//********************************************************************
+//                      add
+//********************************************************************
+
+const std::shared_ptr<Socket>& SocketTable::add(std::shared_ptr<Socket> sock) {
+    uint32_t index;
+    if(!freeSlots.empty()) {
+        index = freeSlots.back();
+        freeSlots.pop_back();
+    } else {
+        index = (uint32_t)slots.size();
+        slots.emplace_back();
+    }
+
+    auto pos = (uint32_t)socks.size();
+    slots[index].pos = pos;
+    sock->table = this;
+    sock->handle = SocketHandle{index, slots[index].generation};
+
+    slotOf.push_back(index);
+    ios.push_back(sock->io.get());
+    states.push_back(sock->getState());
+    fds.push_back(sock->getFd());
+    outputs.push_back(!sock->output.empty());
+    socks.push_back(std::move(sock));
+    live++;
+    return(socks.back());
+}
+
+//********************************************************************
+//                      get
+//********************************************************************
+
+const SocketTable::Slot* SocketTable::find(SocketHandle handle) const {
+    if(handle.index >= slots.size())
+        return(nullptr);
+    const Slot& slot = slots[handle.index];
+    if(slot.generation != handle.generation || slot.pos == SocketHandle::NONE)
+        return(nullptr);
+    return(&slot);
+}
+
+std::shared_ptr<Socket> SocketTable::get(SocketHandle handle) const {
+    const Slot* slot = find(handle);
+    return(slot ? socks[slot->pos] : nullptr);
+}
+
+//********************************************************************
+//                      remove
+//********************************************************************
+
+void SocketTable::remove(SocketHandle handle) {
+    if(const Slot* slot = find(handle))
+        removeAt(slot->pos);
+}
+
+// The slot can be reused straight away, but the position stays a tombstone
+// until compact()
+void SocketTable::removeAt(size_t pos) {
+    if(!socks[pos])
+        return;
+
+    // Out of the table before it's destroyed, in case that looks at the table
+    std::shared_ptr<Socket> doomed = std::move(socks[pos]);
+    Slot& slot = slots[slotOf[pos]];
+    slot.generation++;
+    slot.pos = SocketHandle::NONE;
+    freeSlots.push_back(slotOf[pos]);
+    ios[pos] = nullptr;
+    outputs[pos] = false;
+    live--;
+
+    doomed->table = nullptr;
+    doomed->handle = SocketHandle{};
+}
+
+void SocketTable::clear() {
+    std::vector<std::shared_ptr<Socket>> doomed;
+    doomed.swap(socks);
+    for(auto& sock : doomed) {
+        if(sock) {
+            sock->table = nullptr;
+            sock->handle = SocketHandle{};
+        }
+    }
+    for(Slot& slot : slots) {
+        slot.generation++;
+        slot.pos = SocketHandle::NONE;
+    }
+    freeSlots.clear();
+    for(uint32_t i = slots.size(); i > 0; i--)
+        freeSlots.push_back(i - 1);
+    slotOf.clear();
+    ios.clear();
+    states.clear();
+    fds.clear();
+    outputs.clear();
+    order.clear();
+    live = 0;
+}
+
+//********************************************************************
+//                      compact
+//********************************************************************
+
+void SocketTable::compact() {
+    if(live == socks.size())
+        return;
+
+    size_t to = 0;
+    for(size_t from = 0; from < socks.size(); from++) {
+        if(!socks[from])
+            continue;
+        if(to != from) {
+            socks[to] = std::move(socks[from]);
+            slotOf[to] = slotOf[from];
+            ios[to] = ios[from];
+            states[to] = states[from];
+            fds[to] = fds[from];
+            outputs[to] = outputs[from];
+            slots[slotOf[to]].pos = (uint32_t)to;
+        }
+        to++;
+    }
+    socks.resize(to);
+    slotOf.resize(to);
+    ios.resize(to);
+    states.resize(to);
+    fds.resize(to);
+    outputs.resize(to);
+    order.clear();
+}
+
+//********************************************************************
+//                      shuffle
+//********************************************************************
+
+void SocketTable::shuffle() {
+    order.clear();
+    for(size_t pos = 0; pos < socks.size(); pos++) {
+        if(socks[pos])
+            order.push_back((uint32_t)pos);
+    }
+    Random::shuffle(order.begin(), order.end());
+}
+
+//********************************************************************
+//                      Socket updates
+//********************************************************************
+
+void SocketTable::setState(SocketHandle handle, int state) {
+    if(const Slot* slot = find(handle))
+        states[slot->pos] = state;
+}
+
+void SocketTable::setFd(SocketHandle handle, int fd) {
+    if(const Slot* slot = find(handle))
+        fds[slot->pos] = fd;
+}
+
+void SocketTable::setHasOutput(SocketHandle handle, bool hasOutput) {
+    if(const Slot* slot = find(handle))
+        outputs[slot->pos] = hasOutput;
+}
@@ -1115,6 +1115,7 @@ void Server::endSwap() {
     std::list<childProcess>::iterator it;
     for(it = children.begin(); it != children.end() ;) {
         if((*it).type == ChildType::SWAP_FIND || (*it).type == ChildType::SWAP_FINISH) {
+            unwatch((*it).fd);
             close((*it).fd);
             kill((*it).pid, 9);
             it = children.erase(it);
@@ -1369,7 +1370,7 @@ bool Hooks::swap(const Swap& s) {
     std::string param;
     CatRef cr;
 
-    for(std::pair<std::string,std::string> p : hooks ) {
+    for(std::pair<std::string,std::string> p : *hooks ) {
         if(s.type == SwapRoom) {
             param = getParamFromCode(p.second, "spawnObjects", s.type);
             if(!param.empty()) {
@@ -1395,7 +1396,7 @@ bool Hooks::swapIsInteresting(const Swap& s) const {
     std::string param;
     CatRef cr;
 
-    for(const auto& p : hooks) {
+    for(const auto& p : *hooks) {
         if(s.type == SwapRoom) {
             param = getParamFromCode(p.second, "spawnObjects", s.type);
             if(!param.empty()) {
@@ -0,0 +1,278 @@
+/*
+ * timerWheel.cpp
+ *   Hierarchical timing wheel for delayed actions and periodic game updates
+ *   ____            _
+ *  |  _ \ ___  __ _| |_ __ ___  ___
+ *  | |_) / _ \/ _` | | '_ ` _ \/ __|
+ *  |  _ <  __/ (_| | | | | | | \__ \
+ *  |_| \_\___|\__,_|_|_| |_| |_|___/
+ *
+ * Permission to use, modify and distribute is granted via the
+ *  GNU Affero General Public License v3 or later
+ *
+ *  Copyright (C) 2007-2021 Jason Mitchell, Randi Mitchell
+ *     Contributions by Tim Callahan, Jonathan Hseu
+ *  Based on Mordor (C) Brooke Paul, Brett J. Vickers, John P. Freeman
+ *
+ */
+
+#include <algorithm>            // for fill, max
+#include <chrono>               // for steady_clock, duration_cast
+#include <iterator>             // for begin, end
+#include <utility>              // for move
+
+#include "timerWheel.hpp"       // for TimerWheel, TimerHandle
+
+// Five levels of 64 slots at 1ms resolution reach about 12 days out; anything
+// further waits in the top level and is placed again each time it cascades
+static constexpr uint64_t WHEEL_SPAN = 1ULL << (6 * 5);
+
+//*********************************************************************
+//                      TimerWheel
+//*********************************************************************
+
+TimerWheel::TimerWheel() {
+    for(auto& level : buckets)
+        std::fill(std::begin(level), std::end(level), NIL);
+    current = clock();
+    pending = 0;
+}
+
+uint64_t TimerWheel::clock() {
+    static const auto epoch = std::chrono::steady_clock::now();
+    return((uint64_t)std::chrono::duration_cast<std::chrono::milliseconds>(std::chrono::steady_clock::now() - epoch).count());
+}
+
+size_t TimerWheel::size() const {
+    return(pending);
+}
+
+//*********************************************************************
+//                      schedule
+//*********************************************************************
+
+TimerHandle TimerWheel::schedule(uint64_t delay, Callback callback) {
+    return(add(clock() + delay, 0, std::move(callback)));
+}
+
+TimerHandle TimerWheel::repeat(uint64_t interval, Callback callback, uint64_t firstDelay) {
+    return(add(clock() + firstDelay, std::max<uint64_t>(1, interval), std::move(callback)));
+}
+
+TimerHandle TimerWheel::repeat(uint64_t interval, Callback callback) {
+    return(repeat(interval, std::move(callback), interval));
+}
+
+bool TimerWheel::setInterval(const TimerHandle& handle, uint64_t interval) {
+    uint32_t index = find(handle);
+    if(index == NIL || !timers[index].interval)
+        return(false);
+    timers[index].interval = std::max<uint64_t>(1, interval);
+    return(true);
+}
+
+TimerHandle TimerWheel::add(uint64_t expires, uint64_t interval, Callback callback) {
+    uint32_t index;
+    if(!freeTimers.empty()) {
+        index = freeTimers.back();
+        freeTimers.pop_back();
+    } else {
+        index = (uint32_t)timers.size();
+        timers.emplace_back();
+    }
+
+    Timer& timer = timers[index];
+    timer.expires = expires;
+    timer.interval = interval;
+    timer.callback = std::move(callback);
+    pending++;
+    link(index);
+
+    TimerHandle handle;
+    handle.index = index;
+    handle.generation = timer.generation;
+    return(handle);
+}
+
+//*********************************************************************
+//                      cancel
+//*********************************************************************
+// The timer is unlinked straight out of whatever slot it's waiting in.  A timer
+// cancelled from inside its own callback is cleaned up once the callback returns.
+
+bool TimerWheel::cancel(TimerHandle& handle) {
+    uint32_t index = find(handle);
+    handle.reset();
+    if(index == NIL)
+        return(false);
+
+    Timer& timer = timers[index];
+    if(timer.firing) {
+        if(++timer.generation == 0)
+            timer.generation = 1;
+        return(true);
+    }
+    unlink(index);
+    release(index);
+    return(true);
+}
+
+//*********************************************************************
+//                      find
+//*********************************************************************
+
+uint32_t TimerWheel::find(const TimerHandle& handle) const {
+    if(!handle.isSet() || handle.index >= timers.size())
+        return(NIL);
+    return(timers[handle.index].generation == handle.generation ? handle.index : NIL);
+}
+
+bool TimerWheel::isPending(const TimerHandle& handle) const {
+    return(find(handle) != NIL);
+}
+
+uint64_t TimerWheel::timeLeft(const TimerHandle& handle) const {
+    uint32_t index = find(handle);
+    if(index == NIL)
+        return(0);
+    uint64_t now = clock();
+    return(timers[index].expires > now ? timers[index].expires - now : 0);
+}
+
+//*********************************************************************
+//                      link
+//*********************************************************************
+// Timers due within 64ms go in level 0, one slot per millisecond; each level
+// above covers 64 times the span of the one below.  Slots are picked off the
+// absolute expiry time, so a timer cascades down exactly when the wheel
+// reaches the start of its slot.
+
+void TimerWheel::link(uint32_t index) {
+    Timer& timer = timers[index];
+    if(timer.expires <= current)
+        timer.expires = current + 1;
+
+    uint64_t placeAt = timer.expires;
+    if(placeAt - current >= WHEEL_SPAN)
+        placeAt = current + WHEEL_SPAN - 1;
+
+    int level = 0;
+    while(level < LEVELS - 1 && placeAt - current >= (1ULL << (SLOT_BITS * (level + 1))))
+        level++;
+
+    uint32_t* bucket = &buckets[level][(placeAt >> (SLOT_BITS * level)) & (SLOTS - 1)];
+    timer.bucket = bucket;
+    timer.prev = NIL;
+    timer.next = *bucket;
+    if(*bucket != NIL)
+        timers[*bucket].prev = index;
+    *bucket = index;
+}
+
+void TimerWheel::unlink(uint32_t index) {
+    Timer& timer = timers[index];
+    if(!timer.bucket)
+        return;
+
+    if(timer.prev != NIL)
+        timers[timer.prev].next = timer.next;
+    else
+        *timer.bucket = timer.next;
+    if(timer.next != NIL)
+        timers[timer.next].prev = timer.prev;
+
+    timer.prev = timer.next = NIL;
+    timer.bucket = nullptr;
+}
+
+void TimerWheel::release(uint32_t index) {
+    Timer& timer = timers[index];
+    timer.callback = nullptr;
+    timer.interval = 0;
+    if(++timer.generation == 0)
+        timer.generation = 1;
+    freeTimers.push_back(index);
+    pending--;
+}
+
+//*********************************************************************
+//                      cascade
+//*********************************************************************
+
+void TimerWheel::cascade(int level) {
+    uint32_t* bucket = &buckets[level][(current >> (SLOT_BITS * level)) & (SLOTS - 1)];
+    uint32_t index = *bucket;
+    *bucket = NIL;
+
+    while(index != NIL) {
+        uint32_t next = timers[index].next;
+        timers[index].bucket = nullptr;
+        link(index);
+        index = next;
+    }
+}
+
+//*********************************************************************
+//                      fire
+//*********************************************************************
+
+size_t TimerWheel::fire(uint32_t* bucket) {
+    size_t fired = 0;
+
+    while(*bucket != NIL) {
+        uint32_t index = *bucket;
+        unlink(index);
+
+        // Callbacks are free to add and cancel timers; the deque keeps this
+        // reference good while they do
+        Timer& timer = timers[index];
+        uint32_t generation = timer.generation;
+        timer.firing = true;
+        timer.callback();
+        timer.firing = false;
+        fired++;
+
+        if(timer.generation != generation || !timer.interval) {
+            release(index);
+        } else {
+            // If we've fallen behind (a long save, say) skip the missed runs rather than replaying them
+            timer.expires += timer.interval;
+            if(timer.expires <= current)
+                timer.expires = current + timer.interval;
+            link(index);
+        }
+    }
+    return(fired);
+}
+
+//*********************************************************************
+//                      advance
+//*********************************************************************
+
+size_t TimerWheel::advance() {
+    return(advance(clock()));
+}
+
+size_t TimerWheel::advance(uint64_t now) {
+    size_t fired = 0;
+
+    while(current < now) {
+        // Nothing waiting, so there's no need to step through the slots
+        if(!pending) {
+            current = now;
+            break;
+        }
+
+        current++;
+        int slot = (int)(current & (SLOTS - 1));
+        if(!slot) {
+            for(int level = 1; level < LEVELS; level++) {
+                cascade(level);
+                if((current >> (SLOT_BITS * level)) & (SLOTS - 1))
+                    break;
+            }
+        }
+        fired += fire(&buckets[0][slot]);
+    }
+    return(fired);
+}
@@ -17,6 +17,7 @@
  */
 
 #include <unistd.h>                              // for getpid
+#include <algorithm>                             // for max, clamp
 #include <boost/algorithm/string/case_conv.hpp>  // for to_lower_copy
 #include <boost/iterator/iterator_facade.hpp>    // for operator!=
 #include <cctype>                                // for isdigit
@@ -42,6 +43,7 @@
 #include "hooks.hpp"                             // for Hooks
 #include "lasttime.hpp"                          // for lasttime
 #include "libxml/parser.h"                       // for xmlCleanupParser
+#include "logWriter.hpp"                         // for LogWriter
 #include "mud.hpp"                               // for Weather, DL_BROAD
 #include "mudObjects/container.hpp"              // for PlayerSet, MonsterSet
 #include "mudObjects/creatures.hpp"              // for Creature
@@ -56,6 +58,7 @@
 #include "socket.hpp"                            // for Socket, InBytes, Out...
 #include "structs.hpp"                           // for ttag, daily
 #include "threat.hpp"                            // for ThreatTable
+#include "timerWheel.hpp"                        // for TimerWheel
 #include "weather.hpp"                           // for WEATHER_SUNRISE, WEA...
 #include "web.hpp"                               // for webCrash
 #include "toNum.hpp"
@@ -68,7 +71,6 @@ long            last_weather_update=0;
 static long     lastTickUpdate=0;
 static long     last_update=0;
 static long     last_shutdown_update=0;
-static long     last_action_update=0;
 long            TX_interval = 4200;
 short           Random_update_interval = 6;
 short           Action_update_interval = 6;
@@ -77,6 +79,66 @@ short           Action_update_interval = 6;
 // off from the main clock. this variable will help us keep
 // things in check
 
+//*********************************************************************
+//                      scheduleLottery
+//*********************************************************************
+// A DM can run the lottery early, which pushes the run time back; if that's
+// happened by the time this fires, just wait for the new time.
+
+static void scheduleLottery() {
+    long delay = std::max<long>(1, gConfig->getLotteryRunTime() - time(nullptr) + 1);
+    gServer->timers.schedule(delay * 1000, [] {
+        if(time(nullptr) > gConfig->getLotteryRunTime())
+            gConfig->runLottery();
+        scheduleLottery();
+    });
+}
+
+//*********************************************************************
+//                      randomInterval
+//*********************************************************************
+// Random_update_interval is set by hand, so never wander more than once a second
+
+static long randomInterval() {
+    return(std::max<long>(Random_update_interval, 1) * 1000L);
+}
+
+//*********************************************************************
+//                      scheduleUpdates
+//*********************************************************************
+// Updates that run on a fixed cycle are put on the timer wheel when the game
+// loop starts; updateGame only handles what still has to be looked at every
+// second.  Most of them run right away, same as when they were all polled.
+
+void Server::scheduleUpdates() {
+    long t = time(nullptr);
+
+    // Run ships every other second.
+    timers.repeat(2000, [this] { updateShips(); });
+    // Prune Dns once a day
+    timers.repeat(86400 * 1000L, [this] { pruneDns(); }, 0);
+    // Lift bans that have run out
+    timers.repeat(60 * 1000, [] { gConfig->expireBans(); }, 0);
+
+    timers.repeat(20 * 1000, [this] { updateUsers(time(nullptr)); }, 0);
+    // same cycle length as user updates, but offset 10 seconds
+    timers.repeat(20 * 1000, [this] { pulseRoomEffects(time(nullptr)); }, 10 * 1000);
+    timers.repeat(20 * 1000, [this] { updateTrack(time(nullptr)); }, 0);
+
+    // The last weather update survives a reboot, so pick up where it left off
+    long weatherDelay = std::clamp<long>(60 - (t - last_weather_update), 0, 60);
+    timers.repeat(60 * 1000, [this] { updateWeather(time(nullptr)); }, weatherDelay * 1000);
+
+    randomTimer = timers.repeat(randomInterval(), [this] {
+        updateRandom(time(nullptr));
+        // The wander interval can be changed on the fly
+        timers.setInterval(randomTimer, randomInterval());
+    }, 0);
+    actionTimer = timers.repeat(Action_update_interval * 1000L, [this] { updateAction(time(nullptr)); }, 0);
+
+    scheduleLottery();
+}
+
 //*********************************************************************
 //                      update_game
 //*********************************************************************
@@ -86,12 +148,13 @@ short           Action_update_interval = 6;
 void Server::updateGame() {
     long    t = time(nullptr);
 
+    // Delayed actions and everything put on the wheel by scheduleUpdates
+    timers.advance();
+
     if(t == last_update)
         return;
     last_update = t;
 
-    gServer->parseDelayedActions(t);
-
     // update on the hour: ie, 3:00
     // Sometimes on startup, we don't get to this section of the code in 1 second,
     // meaning this won't run until 1 hour after the game has started. Throwing in
@@ -99,41 +162,15 @@ void Server::updateGame() {
     if(!gConfig->currentMinutes() && (!(t%2) || firstLoop))
         update_time(t);
 
-    // Run ships every other second.
-    if(t%2)
-        gServer->updateShips();
-
-    // Prune Dns once a day
-    if(t - lastDnsPrune >= 86400)
-        pruneDns();
-
     if(t - lastTickUpdate >= 1) {
         pulseTicks(t);
         pulseCreatureEffects(t);
     }
 
-    // pulse effects
-    if(t - lastUserUpdate >= 20) {
-        updateUsers(t);
-    }
-    // same cycle length as creature pulses, but offset 10 seconds
-    if(t - lastRoomPulseUpdate >= 20)
-        pulseRoomEffects(t);
-
-    if(t - last_track_update >= 20)
-        gServer->updateTrack(t);
-    if(t - lastRandomUpdate >= Random_update_interval)
-        updateRandom(t);
     if(t != lastActiveUpdate)
         updateActive(t);
-    if(t - last_weather_update >= 60)
-        gServer->updateWeather(t);
-    if(t - last_action_update >= Action_update_interval)
-        gServer->updateAction(t);
     if(last_dust_output && last_dust_output < t)
         update_dust_oldPrint(t);
-    if(t > gConfig->getLotteryRunTime())
-        gConfig->runLottery();
 
     if(Shutdown.ltime && t - last_shutdown_update >= 30)
         if(Shutdown.ltime + Shutdown.interval <= t+500)
@@ -618,7 +655,6 @@ void Server::updateAction(long t) {
     cmd     cmnd;
 
 
-    last_action_update = t;
 
     auto it = activeList.begin();
     while(it != activeList.end()) {
@@ -921,6 +957,7 @@ void doCrash(int sig) {
     logn("log.crash", oStr.str().c_str());
 
     std::clog << "The mud has crashed :(.\n";
+    LogWriter::get().stop();
 
     if(sig != -69) {
         signal(sig, SIG_DFL);
@@ -189,7 +189,7 @@ int SkillCommand::getFailCooldown() const {
 
 bool SkillCommand::runScript(std::shared_ptr<Creature> actor, std::shared_ptr<MudObject> target, Skill* skill) const {
     try {
-        auto locals = py::dict();
+        PooledLocals locals;
         auto skillLibModule = py::module::import("skillLib");
         locals["skillLib"] = skillLibModule;
         locals["skill"] = skill;
@@ -792,6 +792,7 @@ void Config::clearSkills() {
     // Clear & delete skills
     skills.clear();
     skillCommands.clear();
+    rebuildCommandIndex();
 }
 
 //********************************************************************
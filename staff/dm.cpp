@@ -20,6 +20,7 @@
 #include <unistd.h>                                 // for getpid
 #include <boost/lexical_cast/bad_lexical_cast.hpp>  // for bad_lexical_cast
 #include <cctype>                                   // for tolower
+#include <climits>                                  // for SHRT_MAX
 #include <cstdio>                                   // for sprintf
 #include <cstring>                                  // for strcmp, strlen
 #include <ctime>                                    // for time
@@ -46,6 +47,7 @@
 #include "global.hpp"                               // for CreatureClass
 #include "lasttime.hpp"                             // for crlasttime, lasttime
 #include "location.hpp"                             // for Location
+#include "logWriter.hpp"                            // for LogWriter
 #include "magic.hpp"                                // for S_ANNUL_MAGIC
 #include "mud.hpp"                                  // for StartTime, LT_OUTLAW
 #include "mudObjects/areaRooms.hpp"                 // for AreaRoom
@@ -1504,6 +1506,10 @@ int dmParam(const std::shared_ptr<Player>& player, cmd* cmnd) {
 
     switch(low(cmnd->str[1][0])) {
     case 'r':
+        if(cmnd->val[1] < 1 || cmnd->val[1] > SHRT_MAX) {
+            player->print("The random update interval must be at least 1 second.\n");
+            return(0);
+        }
         Random_update_interval = (short) cmnd->val[1];
         return(PROMPT);
     case 'd':
@@ -2248,6 +2254,7 @@ int dmLog(const std::shared_ptr<Player>& player, cmd* cmnd) {
     } else
         strcpy(player->getSock()->tempstr[3], "\0");
 
+    LogWriter::get().flush();
     player->getSock()->viewFileReverse(filename);
 
 
@@ -2307,8 +2314,10 @@ int dmInfo(const std::shared_ptr<Player>& player, cmd* cmnd) {
         player->print("Uptime: %ld days %02ld:%02ld:%02ld\n", days, hours, minutes, (t - StartTime) % 60L);
     player->print("\n    Bytes in:  %9ld\n    Bytes out: %9ld(%ld)[%f]\n", InBytes, OutBytes, UnCompressedBytes, (OutBytes*1.0)/(UnCompressedBytes*1.0));
     player->print("\nInternal Cache Queue Sizes:\n");
-    player->print("   Rooms: %-5d   Monsters: %-5d   Objects: %-5d\n\n",
+    player->print("   Rooms: %-5d   Monsters: %-5d   Objects: %-5d\n",
             gServer->roomCache.size(), gServer->monsterCache.size(), gServer->objectCache.size());
+    player->print("Player saves: %lu queued, %lu written, %lu coalesced\n\n",
+            gServer->playerSaves.getPending(), gServer->playerSaves.getWritten(), gServer->playerSaves.getCoalesced());
     player->print("Wander update: %d\n", Random_update_interval);
     if(player->isDm())
         player->print("      Players: %d\n\n", Socket::getNumSockets());
@@ -2314,6 +2314,7 @@ int dmCrtName(const std::shared_ptr<Player>& player, cmd* cmnd) {
         if(num) {
             if(text == "0" && target->key[num-1][0]) {
                 zero(target->key[num-1], sizeof(target->key[num-1]));
+                target->refreshKeyTxt();
                 *player << "Key #" << num << " string cleared.\n";
                 return(0);
             } else {
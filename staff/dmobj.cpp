@@ -143,7 +143,7 @@ std::string Object::statObj(int statFlags) {
         objStr << "\nLast modified by: " << lastMod;
     objStr << "\n";
 
-    objStr << "Desc: " << description.c_str() << "\n";
+    objStr << "Desc: " << description->c_str() << "\n";
 
     if(type == ObjectType::WEAPON)
         objStr << "Weapon type: " << getWeaponType().c_str() << "\n";
@@ -1401,7 +1401,7 @@ int dmObjName(const std::shared_ptr<Player>& player, cmd* cmnd) {
         *player << "\nName ";
         break;
     case 1:
-        if(text == "0" && !object->description.empty()) {
+        if(text == "0" && !object->description->empty()) {
             object->description = "";
             *player << "Item description cleared.\n";
             return(0);
@@ -1410,7 +1410,7 @@ int dmObjName(const std::shared_ptr<Player>& player, cmd* cmnd) {
             return(0);
         } else {
             object->description = text;
-            boost::replace_all(object->description, "*CR*", "\n");
+            boost::replace_all(object->description.edit(), "*CR*", "\n");
         }
         *player << "\nDescription ";
         break;
@@ -1445,6 +1445,7 @@ int dmObjName(const std::shared_ptr<Player>& player, cmd* cmnd) {
         if(num) {
             if(text == "0" && object->key[num-1][0]) {
                 zero(object->key[num-1], sizeof(object->key[num-1]));
+                object->refreshKeyTxt();
                 *player << "Key #" << num << " string cleared.\n";
                 return(0);
             } else {
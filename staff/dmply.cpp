@@ -2585,6 +2585,7 @@ int dmBackupPlayer(const std::shared_ptr<Player>& player, cmd* cmnd) {
                 return(0);
             }
 
+            gServer->playerSaves.flush();
             if(fs::exists(restoredFile))
                 unlink(restoredFile);
 
@@ -2613,6 +2614,7 @@ int dmBackupPlayer(const std::shared_ptr<Player>& player, cmd* cmnd) {
 
     if(cmnd->num > 2 && !strcmp(cmnd->str[2], "-d")) {
         sprintf(filename, "%s/%s.bak.xml", Path::PlayerBackup.c_str(), target->getCName());
+        gServer->playerSaves.wait(filename);
         if(fs::exists(filename)) {
             unlink(filename);
             broadcast(isDm, "^g*** %s deleted %s's backup file.", player->getCName(), target->getCName());
@@ -17,13 +17,13 @@
  */
 
 #include <cstdarg>                   // for va_end, va_list, va_start
-#include <cstdio>                    // for sprintf, vasprintf
-#include <cstdlib>                   // for free
+#include <cstdio>                    // for sprintf
 #include <ostream>                   // for operator<<, ostream
 #include <string>                    // for string, operator==, allocator
 
 #include "flags.hpp"                 // for P_EAVESDROPPER, P_LOG_WATCH, P_P...
 #include "global.hpp"                // for CreatureClass, CreatureClass::BU...
+#include "mudFormat.hpp"             // for formatLegacy
 #include "mudObjects/creatures.hpp"  // for Creature
 #include "mudObjects/players.hpp"    // for Player
 #include "proto.hpp"                 // for broadcast, stripLineFeeds, logn
@@ -40,7 +40,7 @@ int log_immort(int broad, std::shared_ptr<Player> player, const char *fmt,...) {
     // broad==0 - no broadcast
     // broad==1 - broadcast
     // broad==2 - more needs to be done
-    char    *str, name[42];
+    char    name[42];
     va_list ap;
     std::string txt = "";
 
@@ -48,10 +48,7 @@ int log_immort(int broad, std::shared_ptr<Player> player, const char *fmt,...) {
         return(0);
 
     va_start(ap, fmt);
-    if(vasprintf(&str, fmt, ap) == -1) {
-        std::clog << "Error in log_immort\n";
-        return(0);
-    }
+    std::string str = formatLegacy(0, fmt, ap);
     va_end(ap);
 
     txt = str;
@@ -70,14 +67,13 @@ int log_immort(int broad, std::shared_ptr<Player> player, const char *fmt,...) {
 
     if(broad) {
         if(player->isDm())
-            broadcast(isDm, watchingLog, "^g*** %s", stripLineFeeds(str));
+            broadcast(isDm, watchingLog, "^g*** %s", stripLineFeeds(str.data()));
         else if(player->isCt())
-            broadcast(isCt, watchingLog, "^g*** %s", stripLineFeeds(str));
+            broadcast(isCt, watchingLog, "^g*** %s", stripLineFeeds(str.data()));
         else
-            broadcast(isStaff, watchingLog, "^g*** %s", stripLineFeeds(str));
+            broadcast(isStaff, watchingLog, "^g*** %s", stripLineFeeds(str.data()));
     }
 
-    free(str);
     return(1);
 }
 
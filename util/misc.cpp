@@ -41,6 +41,7 @@
 #include "flags.hpp"                             // for P_STUNNED
 #include "global.hpp"                            // for MAXALVL, FATAL, FIND...
 #include "group.hpp"                             // for CreatureList, Group
+#include "keyTxt.hpp"                            // for KeyTxtQuery
 #include "lasttime.hpp"                          // for lasttime
 #include "money.hpp"                             // for GOLD, Money
 #include "mud.hpp"                               // for dmname, LT_KICK, LT_...
@@ -693,28 +694,16 @@ char *ltoa(
 //                      findCrt
 //*********************************************************************
 
-std::shared_ptr<MudObject> findMonTarget(std::shared_ptr<Creature> player, MonsterSet& set, int findFlags, const char *str, int val, int* match) {
+std::shared_ptr<MudObject> findMonTarget(std::shared_ptr<Creature> player, const Container& container, int findFlags, const KeyTxtQuery& query, int val, int* match) {
 
-    if(!player || !str || set.empty())
+    if(!player || container.monsters.empty())
         return(nullptr);
 
-    for(auto crt : set) {
-        if(!crt) continue;
-        if(!player->canSee(crt)) continue;
-
-        if(keyTxtEqual(crt, str)) {
-            (*match)++;
-            if(*match == val) {
-                return(crt);
-            }
-        }
-
-    }
-    return(nullptr);
+    return(container.findMonster(player, query, val, *match, true));
 }
-std::shared_ptr<MudObject> findPlyTarget(std::shared_ptr<Creature> player, PlayerSet& set, int findFlags, const char *str, int val, int* match) {
+std::shared_ptr<MudObject> findPlyTarget(std::shared_ptr<Creature> player, PlayerSet& set, int findFlags, const KeyTxtQuery& query, int val, int* match) {
 
-    if(!player || !str || set.empty())
+    if(!player || set.empty())
         return(nullptr);
 
     for(auto pIt = set.begin() ; pIt != set.end() ; ) {
@@ -728,7 +717,7 @@ std::shared_ptr<MudObject> findPlyTarget(std::shared_ptr<Creature> player, Playe
         if(!crt) continue;
         if(!player->canSee(crt)) continue;
 
-        if(keyTxtEqual(crt, str)) {
+        if(keyTxtEqual(crt, query)) {
             (*match)++;
             if(*match == val) {
                 return(crt);
@@ -817,11 +806,12 @@ bool isUseableFilterString(std::shared_ptr<Creature> searcher, std::string fs, b
 std::shared_ptr<MudObject> Creature::findTarget(int findWhere, int findFlags, const std::string& str, int val) {
     int match=0;
     std::shared_ptr<MudObject> target;
+    KeyTxtQuery query(str);
 
     const auto cThis = getAsConstCreature();
     do {
         if(findWhere & FIND_OBJ_INVENTORY) {
-            if((target = findObjTarget(objects, findFlags, str, val, &match))) {
+            if((target = findObjTarget(*this, findFlags, query, val, &match))) {
                 break;
             }
         }
@@ -833,7 +823,7 @@ std::shared_ptr<MudObject> Creature::findTarget(int findWhere, int findFlags, co
             for(n=0; n<MAXWEAR; n++) {
                 if(!ready[n])
                     continue;
-                if(keyTxtEqual(ready[n], str.c_str()) || (ready[n]->isLabeledBy(cThis) && ready[n]->isLabelMatch(str)))
+                if(keyTxtEqual(ready[n], query) || (ready[n]->isLabeledBy(cThis) && ready[n]->isLabelMatch(str)))
                     match++;
                 else
                     continue;
@@ -848,19 +838,19 @@ std::shared_ptr<MudObject> Creature::findTarget(int findWhere, int findFlags, co
         }
 
         if(findWhere & FIND_OBJ_ROOM) {
-            if((target = findObjTarget(getRoomParent()->objects, findFlags, str, val, &match))) {
+            if((target = findObjTarget(*getRoomParent(), findFlags, query, val, &match))) {
                 break;
             }
         }
 
         if(findWhere & FIND_MON_ROOM) {
-            if((target = findMonTarget(getAsCreature(), getParent()->monsters, findFlags, str.c_str(), val, &match))) {
+            if((target = findMonTarget(getAsCreature(), *getParent(), findFlags, query, val, &match))) {
                 break;
             }
         }
 
         if(findWhere & FIND_PLY_ROOM) {
-            if((target = findPlyTarget(getAsCreature(), getParent()->players, findFlags, str.c_str(), val, &match))) {
+            if((target = findPlyTarget(getAsCreature(), getParent()->players, findFlags, query, val, &match))) {
                 break;
             }
         }
@@ -64,6 +64,7 @@ bool Config::loadBans() {
         }
         cur = cur->next;
     }
+    rebuildBanIndex();
     xmlFreeDoc(xmlDoc);
     xmlCleanupParser();
     return(true);
@@ -27,6 +27,7 @@
 #include <utility>                                  // for pair
 
 #include "calendar.hpp"                             // for cSeason
+#include "catRef.hpp"                               // for AreaName
 #include "catRefInfo.hpp"                           // for CatRefInfo
 #include "config.hpp"                               // for Config, gConfig
 #include "paths.hpp"                                // for Game
@@ -151,6 +152,7 @@ bool Config::loadCatRefInfo() {
         if(NODE_NAME(curNode, "Info")) {
             cri = new CatRefInfo;
             cri->load(curNode);
+            AreaName::intern(cri->getArea());
             catRefInfo.push_back(cri);
         }
         curNode = curNode->next;
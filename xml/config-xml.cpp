@@ -27,6 +27,7 @@
 #include <string>                                   // for allocator, basic_...
 
 #include "config.hpp"                               // for Config, DiscordTo...
+#include "logWriter.hpp"                            // for LogWriter
 #include "paths.hpp"                                // for Config
 #include "xml.hpp"                                  // for NODE_NAME, copyTo...
 
@@ -111,6 +112,9 @@ void Config::loadGeneral(xmlNodePtr rootNode) {
         else if(NODE_NAME(curNode, "LogDatabasePassword")) xml::copyToString(logDbPass, curNode);
         else if(NODE_NAME(curNode, "LogDatabaseDatabase")) xml::copyToString(logDbDatabase, curNode);
         else if(NODE_NAME(curNode, "LogDeath")) xml::copyToBool(logDeath, curNode);
+        else if(NODE_NAME(curNode, "LogJson")) xml::copyToBool(logJson, curNode);
+        else if(NODE_NAME(curNode, "LogRotateSize")) xml::copyToNum(logRotateSize, curNode);
+        else if(NODE_NAME(curNode, "LogRotateDays")) xml::copyToNum(logRotateDays, curNode);
         else if(NODE_NAME(curNode, "PkillInCombatDisabled")) xml::copyToBool(pkillInCombatDisabled, curNode);
         else if(NODE_NAME(curNode, "RecordAll")) xml::copyToBool(recordAll, curNode);
         else if(NODE_NAME(curNode, "LogSuicide")) xml::copyToBool(logSuicide, curNode);
@@ -133,6 +137,9 @@ void Config::loadGeneral(xmlNodePtr rootNode) {
 
         curNode = curNode->next;
     }
+
+    LogWriter::get().setJson(logJson);
+    LogWriter::get().setRotation((off_t)logRotateSize * 1024 * 1024, (long)logRotateDays * 60 * 60 * 24);
 }
 
 
@@ -234,6 +241,9 @@ bool Config::saveConfig() const {
     xml::newBoolChild(curNode, "GetHostByName", getHostByName);
     xml::newBoolChild(curNode, "LessExpLoss", lessExpLoss);
     xml::newBoolChild(curNode, "LogDeath", logDeath);
+    xml::newBoolChild(curNode, "LogJson", logJson);
+    xml::saveNonZeroNum(curNode, "LogRotateSize", logRotateSize);
+    xml::saveNonZeroNum(curNode, "LogRotateDays", logRotateDays);
     xml::newBoolChild(curNode, "PkillInCombatDisabled", pkillInCombatDisabled);
     xml::newBoolChild(curNode, "RecordAll", recordAll);
     xml::newBoolChild(curNode, "LogSuicide", logSuicide);
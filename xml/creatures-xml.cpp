@@ -86,7 +86,7 @@ int Creature::readFromXml(xmlNodePtr rootNode, bool offline) {
         // Name will only be loaded for Monsters
         if(NODE_NAME(curNode, "Name")) setName(xml::getString(curNode));
         else if(NODE_NAME(curNode, "Id")) setId(xml::getString(curNode));
-        else if(NODE_NAME(curNode, "Description")) xml::copyToString(description, curNode);
+        else if(NODE_NAME(curNode, "Description")) xml::copyToString(description.edit(), curNode);
         else if(NODE_NAME(curNode, "Keys")) {
             loadStringArray(curNode, key, CRT_KEY_LENGTH, "Key", 3);
         }
@@ -72,6 +72,7 @@ void Effects::load(xmlNodePtr rootNode, const std::shared_ptr<MudObject>& pParen
         }
         curNode = curNode->next;
     }
+    reindex();
 }
 
 
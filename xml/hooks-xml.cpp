@@ -46,14 +46,14 @@ void Hooks::load(xmlNodePtr curNode) {
 //*********************************************************************
 
 void Hooks::save(xmlNodePtr curNode, const char* name) const {
-    if(hooks.empty())
+    if(hooks->empty())
         return;
 
     xmlNodePtr childNode, subNode;
 
     childNode = xml::newStringChild(curNode, name);
 
-    for( const auto& p: hooks ) {
+    for( const auto& p: *hooks ) {
         subNode = xml::newStringChild(childNode, "Hook", p.second);
         xml::newProp(subNode, "event", p.first);
     }
@@ -61,3 +61,17 @@ std::shared_ptr<BaseRoom> Location::loadRoom(const std::shared_ptr<Player>& play
 
     return(nullptr);
 }
+
+// Like loadRoom, but only returns the room if it's already in memory
+std::shared_ptr<BaseRoom> Location::findRoom() const {
+    if(room.id)
+        return(gServer->roomCache.fetch(room, false));
+
+    std::shared_ptr<Area> area = gServer->getArea(mapmarker.getArea());
+    if(area) {
+        auto it = area->rooms.find(mapmarker.str());
+        if(it != area->rooms.end())
+            return(it->second);
+    }
+    return(nullptr);
+}
@@ -161,7 +161,7 @@ void Monster::readXml(xmlNodePtr curNode, bool offline) {
         while(childNode) {
             if(NODE_NAME(childNode, "TalkResponse")) {
                 if((newTalk = new TalkResponse(childNode)) != nullptr) {
-                    responses.push_back(newTalk);
+                    responses.edit().emplace_back(newTalk);
                     if (newTalk->quest != nullptr) {
                         quests.push_back(newTalk->quest);
                     }
@@ -289,7 +289,7 @@ void Monster::saveXml(xmlNodePtr curNode) const {
     xml::saveNonNullString(curNode, "LastMod", last_mod);
     xml::saveNonNullString(curNode, "Talk", talk);
     xmlNodePtr talkNode = xml::newStringChild(curNode, "TalkResponses");
-    for(TalkResponse * talkResponse : responses)
+    for(const auto& talkResponse : *responses)
         talkResponse->saveToXml(talkNode);
 
     xml::saveNonNullString(curNode, "TradeTalk", ttalk);
@@ -172,7 +172,7 @@ int Object::readFromXml(xmlNodePtr rootNode, std::list<std::string> *idList, boo
         }
         else if(NODE_NAME(curNode, "Plural")) xml::copyToString(plural, curNode);
         else if(NODE_NAME(curNode, "DroppedBy")) droppedBy.load(curNode);
-        else if(NODE_NAME(curNode, "Description")) xml::copyToString(description, curNode);
+        else if(NODE_NAME(curNode, "Description")) xml::copyToString(description.edit(), curNode);
         else if(NODE_NAME(curNode, "LotteryNumbers")) {
             xml::loadNumArray<short>(curNode, lotteryNumbers, "LotteryNum", 6);
         }
@@ -72,6 +72,9 @@ bool loadPlayer(std::string_view name, std::shared_ptr<Player>& player, enum Loa
     else // LoadType::LS_NORMAL
         filename = (Path::Player / name).replace_extension("xml");
 
+    // Don't read it back while a newer copy is still waiting to be written
+    gServer->playerSaves.wait(filename);
+
     if((xmlDoc = xml::loadFile(filename.c_str(), "Player")) == nullptr)
         return(false);
 
@@ -351,10 +354,14 @@ void loadRanges(xmlNodePtr curNode, Player* player) {
 // NOTE: For now, it will ignore equiped equipment, so be sure to
 // remove the equiped equipment and put it in the inventory before
 // calling this function otherwise it will be lost
+// The player is serialized here; the file itself is written by the
+// server's save queue.
 
 int Player::saveToFile(LoadType saveType) {
     xmlDocPtr   xmlDoc;
     xmlNodePtr  rootNode;
+    xmlChar*    contents;
+    int         len;
     char        filename[256];
 
     if( getName().empty() || !isPlayer())
@@ -380,8 +387,13 @@ int Player::saveToFile(LoadType saveType) {
         sprintf(filename, "%s/%s.xml", Path::Player.c_str(), getCName());
     }
 
-    xml::saveFile(filename, xmlDoc);
+    xmlDocDumpFormatMemory(xmlDoc, &contents, &len, 1);
     xmlFreeDoc(xmlDoc);
+    if(!contents)
+        return(-1);
+
+    gServer->playerSaves.push(filename, std::string((char*)contents, len), saveType == LoadType::LS_BACKUP ? PLAYER_BACKUPS : 0);
+    xmlFree(contents);
     return(0);
 }
 
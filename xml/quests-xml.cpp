@@ -39,7 +39,7 @@ QuestCatRef::QuestCatRef(xmlNodePtr rootNode) {
     // And then read in the XML file
     xmlNodePtr curNode = rootNode->children;
     while(curNode) {
-        if(NODE_NAME(curNode, "Area")) xml::copyToString(area, curNode);
+        if(NODE_NAME(curNode, "Area")) area = xml::getString(curNode);
         else if(NODE_NAME(curNode, "Id")) xml::copyToNum(id, curNode);
         else if(NODE_NAME(curNode, "ReqAmt")) xml::copyToNum(reqNum, curNode);
         else if(NODE_NAME(curNode, "CurAmt")) xml::copyToNum(curNum, curNode);
@@ -63,6 +63,7 @@ bool Config::loadSocials() {
         }
         curNode = curNode->next;
     }
+    rebuildCommandIndex();
     xmlFreeDoc(xmlDoc);
     xmlCleanupParser();
     return(true);
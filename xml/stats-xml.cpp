@@ -17,7 +17,6 @@
  */
 
 #include <boost/lexical_cast/bad_lexical_cast.hpp>  // for bad_lexical_cast
-#include <map>                                      // for operator==, _Rb_t...
 #include <ostream>                                  // for basic_ostream::op...
 #include <stats.hpp>                                // for StatModifier, Stat
 #include <string>                                   // for allocator, string
@@ -48,9 +47,9 @@ bool Stat::loadModifiers(xmlNodePtr curNode) {
     xmlNodePtr childNode = curNode->children;
     while(childNode) {
         if(NODE_NAME(childNode, "StatModifier")) {
-            auto mod = std::make_shared<StatModifier>(childNode);
-            if(!mod->getName().empty()) {
-                modifiers.insert(ModifierMap::value_type(mod->getName(), mod));
+            StatModifier mod(childNode);
+            if(!mod.getName().empty()) {
+                insertModifier(mod);
             }
             childNode = childNode->next;
         }
@@ -59,6 +58,8 @@ bool Stat::loadModifiers(xmlNodePtr curNode) {
 }
 StatModifier::StatModifier(xmlNodePtr curNode) {
     xmlNodePtr childNode = curNode->children;
+    std::string name;
+    modType = MOD_NONE;
 
     while(childNode) {
         if(NODE_NAME(childNode, "Name")) xml::copyToString(name, childNode);
@@ -67,6 +68,7 @@ StatModifier::StatModifier(xmlNodePtr curNode) {
 
         childNode = childNode->next;
     }
+    key = intern(name);
 }
 
 //*********************************************************************
@@ -79,14 +81,14 @@ void Stat::save(xmlNodePtr parentNode, const char* statName) const {
 
     xml::newNumChild(curNode, "Initial", initial);
     xmlNodePtr modNode = xml::newStringChild(curNode, "Modifiers");
-    for(ModifierMap::value_type p: modifiers) {
-        p.second->save(modNode);
+    for(const StatModifier* mod : sortedModifiers()) {
+        mod->save(modNode);
     }
 }
 
-void StatModifier::save(xmlNodePtr parentNode) {
+void StatModifier::save(xmlNodePtr parentNode) const {
     xmlNodePtr curNode = xml::newStringChild(parentNode, "StatModifier");
-    xml::newStringChild(curNode, "Name", name);
+    xml::newStringChild(curNode, "Name", getName());
     xml::newNumChild(curNode, "ModAmt", modAmt);
     xml::newNumChild(curNode, "ModType", modType);
 }